@@ -0,0 +1,115 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+#include "hmi3/components/trend_component.hpp"
+#include "hmi3/components/value_display_component.hpp"
+#include "hmi3/render_batch.hpp"
+
+namespace {
+
+// Шрифт для замеров текста: HMI3_BENCH_FONT=путь/к/шрифту.ttf, иначе пустой
+std::shared_ptr<const sf::Font> benchFont() {
+    static std::shared_ptr<const sf::Font> font = [] {
+        const char* path = std::getenv("HMI3_BENCH_FONT");
+        auto loaded = path ? hmi3::GlyphCache::loadFont(path) : nullptr;
+        return loaded ? loaded : std::make_shared<const sf::Font>();
+    }();
+    return font;
+}
+
+// Кадр тренда: 8 перьев по 1M выборок, в каждое приходит 1000 новых,
+// затем геометрия на 1600 px
+void BM_TrendFrame(benchmark::State& state) {
+    const std::size_t pens = 8;
+    const std::size_t history = 1 << 20;
+    const std::size_t perFrame = 1000;
+
+    hmi3::TrendComponent trend("trend", history);
+    trend.setSize({1600.0f, 400.0f});
+    trend.setRange(-1.0f, 1.0f);
+    std::vector<float> samples(history);
+    for (std::size_t i = 0; i < history; ++i) {
+        samples[i] = std::sin(static_cast<float>(i) * 0.001f);
+    }
+    for (std::size_t pen = 0; pen < pens; ++pen) {
+        trend.addPen(sf::Color::Green);
+        trend.addSamples(pen, samples.data(), samples.size());
+    }
+    trend.setVisibleSamples(static_cast<std::size_t>(state.range(0)));
+
+    hmi3::RenderBatch batch;
+    std::size_t offset = 0;
+    for (auto _ : state) {
+        for (std::size_t pen = 0; pen < pens; ++pen) {
+            trend.addSamples(pen, samples.data() + offset, perFrame);
+        }
+        offset = (offset + perFrame) % (history - perFrame);
+        batch.clear();
+        trend.appendGeometry(batch);
+        benchmark::DoNotOptimize(batch.getVertexCount());
+    }
+    state.counters["vertices"] = static_cast<double>(batch.getVertexCount());
+    state.counters["level_builds"] = static_cast<double>(trend.getStats().levelBuilds);
+}
+
+// 5k индикаторов меняют значение каждый кадр
+void BM_ValueDisplayFrame(benchmark::State& state) {
+    const int count = 5000;
+    std::vector<std::unique_ptr<hmi3::ValueDisplayComponent>> readouts;
+    for (int i = 0; i < count; ++i) {
+        auto display = std::make_unique<hmi3::ValueDisplayComponent>("v" + std::to_string(i));
+        display->setFont(benchFont(), 14);
+        display->setPosition({static_cast<float>(i % 50 * 60), static_cast<float>(i / 50 * 16)});
+        display->setSize({56.0f, 16.0f});
+        readouts.push_back(std::move(display));
+    }
+
+    hmi3::RenderBatch batch;
+    double value = 0.0;
+    for (auto _ : state) {
+        batch.clear();
+        for (auto& display : readouts) {
+            value += 0.37;
+            display->setValue(std::fmod(value, 1000.0));
+            display->appendGeometry(batch);
+        }
+        benchmark::DoNotOptimize(batch.getVertexCount());
+    }
+    state.counters["batches"] = static_cast<double>(batch.getBatchCount());
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+// Для сравнения: те же 5k значений через sf::Text
+void BM_TextReadoutFrame(benchmark::State& state) {
+    const int count = 5000;
+    auto font = benchFont();
+    std::vector<sf::Text> texts;
+    texts.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        texts.emplace_back(*font, "", 14);
+        texts.back().setPosition({static_cast<float>(i % 50 * 60), static_cast<float>(i / 50 * 16)});
+    }
+
+    double value = 0.0;
+    for (auto _ : state) {
+        for (auto& text : texts) {
+            value += 0.37;
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), "%.1f", std::fmod(value, 1000.0));
+            text.setString(buffer);
+            // Геометрия sf::Text пересобирается при первом обращении
+            benchmark::DoNotOptimize(text.getLocalBounds());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(BM_TrendFrame)->Arg(1 << 20)->Arg(1 << 16)->Arg(1000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ValueDisplayFrame)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_TextReadoutFrame)->Unit(benchmark::kMicrosecond);
+
+} // namespace
\ No newline at end of file
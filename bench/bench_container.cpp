@@ -0,0 +1,344 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "hmi3/components/rectangle_component.hpp"
+#include "hmi3/container.hpp"
+#include "hmi3/render_batch.hpp"
+#include "hmi3/worker_pool.hpp"
+
+namespace {
+
+// Простой компонент с границами: update() и события только считаются
+class CountingComponent : public hmi3::Component {
+public:
+    explicit CountingComponent(std::string id) : Component(std::move(id)) {}
+    void update(float dt) override { m_time += dt; }
+    void handleEvent(const sf::Event&) override { ++m_events; }
+    void draw(sf::RenderTarget&, sf::RenderStates) const override {}
+
+private:
+    float m_time = 0.0f;
+    std::size_t m_events = 0;
+};
+
+// Тяжёлый update() без общих данных: годится для пула потоков
+class HeavyComponent : public hmi3::Component {
+public:
+    HeavyComponent(std::string id, int work) : Component(std::move(id)), m_work(work) {}
+
+    bool isUpdateThreadSafe() const override { return true; }
+    void update(float dt) override {
+        double value = m_state;
+        for (int i = 0; i < m_work; ++i) {
+            value = std::sin(value + dt) * 0.5 + std::sqrt(static_cast<double>(i % 17) + value * value);
+        }
+        m_state = value;
+    }
+    void handleEvent(const sf::Event&) override {}
+    void draw(sf::RenderTarget&, sf::RenderStates) const override {}
+
+private:
+    int m_work;
+    double m_state = 0.0;
+};
+
+// Компоненты раскладываются сеткой 10x10 px, как лампы на мнемосхеме
+template <typename T>
+std::vector<std::shared_ptr<hmi3::Component>> makeComponents(std::size_t count) {
+    std::vector<std::shared_ptr<hmi3::Component>> components;
+    components.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        std::shared_ptr<hmi3::Component> component;
+        if constexpr (std::is_same_v<T, hmi3::RectangleComponent>) {
+            component = std::make_shared<T>("c" + std::to_string(i), sf::Vector2f(8, 8), sf::Color::Green);
+        } else {
+            component = std::make_shared<T>("c" + std::to_string(i));
+            component->setSize({8, 8});
+        }
+        component->setPosition({static_cast<float>(i % 300 * 10), static_cast<float>(i / 300 * 10)});
+        components.push_back(std::move(component));
+    }
+    return components;
+}
+
+void fill(hmi3::Container& container, const std::vector<std::shared_ptr<hmi3::Component>>& components) {
+    for (const auto& component : components) {
+        container.addComponent(component);
+    }
+}
+
+void BM_ContainerAdd(benchmark::State& state) {
+    auto components = makeComponents<CountingComponent>(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        hmi3::Container container;
+        fill(container, components);
+        benchmark::DoNotOptimize(container.getComponentCount());
+        state.PauseTiming();
+        container.clear();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_ContainerRemove(benchmark::State& state) {
+    auto components = makeComponents<CountingComponent>(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        state.PauseTiming();
+        hmi3::Container container;
+        fill(container, components);
+        state.ResumeTiming();
+        for (const auto& component : components) {
+            container.removeComponent(component->getHandle());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_ContainerLookupById(benchmark::State& state) {
+    auto components = makeComponents<CountingComponent>(static_cast<std::size_t>(state.range(0)));
+    hmi3::Container container;
+    fill(container, components);
+
+    std::mt19937 random(42);
+    std::vector<std::string> ids;
+    for (int i = 0; i < 1024; ++i) {
+        ids.push_back(components[random() % components.size()]->getId());
+    }
+    std::size_t next = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(container.getComponent(ids[next++ & 1023]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_ContainerLookupByHandle(benchmark::State& state) {
+    auto components = makeComponents<CountingComponent>(static_cast<std::size_t>(state.range(0)));
+    hmi3::Container container;
+    fill(container, components);
+
+    std::mt19937 random(42);
+    std::vector<hmi3::ComponentHandle> handles;
+    for (int i = 0; i < 1024; ++i) {
+        handles.push_back(components[random() % components.size()]->getHandle());
+    }
+    std::size_t next = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(container.getComponent(handles[next++ & 1023]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Компоненты разложены по областям по 100 штук, поиск - по полному пути
+void BM_ContainerLookupByPath(benchmark::State& state) {
+    auto components = makeComponents<CountingComponent>(static_cast<std::size_t>(state.range(0)));
+    hmi3::Container root;
+    std::vector<std::shared_ptr<hmi3::Container>> areas;
+    for (std::size_t i = 0; i < components.size(); ++i) {
+        if (i % 100 == 0) {
+            areas.push_back(std::make_shared<hmi3::Container>("area" + std::to_string(i / 100)));
+            root.addComponent(areas.back());
+        }
+        areas.back()->addComponent(components[i]);
+    }
+
+    std::mt19937 random(42);
+    std::vector<std::string> paths;
+    for (int i = 0; i < 1024; ++i) {
+        std::size_t index = random() % components.size();
+        paths.push_back("area" + std::to_string(index / 100) + "/" + components[index]->getId());
+    }
+    std::size_t next = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(root.findByPath(paths[next++ & 1023]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_ContainerUpdate(benchmark::State& state) {
+    auto components = makeComponents<CountingComponent>(static_cast<std::size_t>(state.range(0)));
+    hmi3::Container container;
+    fill(container, components);
+    for (auto _ : state) {
+        container.update(0.016f);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// 400 тяжёлых компонентов разной стоимости, половина во вложенной панели;
+// range(0) = 0 - последовательно, 1 - через WorkerPool
+void BM_ContainerUpdateParallel(benchmark::State& state) {
+    hmi3::WorkerPool pool;
+    hmi3::Container screen("screen");
+    screen.setWorkerPool(state.range(0) ? &pool : nullptr);
+    auto panel = std::make_shared<hmi3::Container>("panel");
+    screen.addComponent(panel);
+    for (int i = 0; i < 400; ++i) {
+        auto heavy = std::make_shared<HeavyComponent>("h" + std::to_string(i), 2000 * (1 + i % 3));
+        (i % 2 ? screen : *panel).addComponent(heavy);
+    }
+
+    for (auto _ : state) {
+        screen.update(0.016f);
+    }
+    state.counters["threads"] = static_cast<double>(state.range(0) ? pool.getThreadCount() + 1 : 1);
+}
+
+// Мнемосхема в покое: 1% анимаций, 1% раз в секунду, остальные спят
+void BM_ContainerUpdateMostlyIdle(benchmark::State& state) {
+    auto components = makeComponents<CountingComponent>(static_cast<std::size_t>(state.range(0)));
+    hmi3::Container container;
+    fill(container, components);
+    for (std::size_t i = 0; i < components.size(); ++i) {
+        if (i % 100 == 1) {
+            components[i]->setUpdateInterval(1.0f);
+        } else if (i % 100 != 0) {
+            components[i]->sleep();
+        }
+    }
+    for (auto _ : state) {
+        container.update(0.016f);
+    }
+    state.counters["awake"] = static_cast<double>(container.getAwakeCount());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Событие указателя идёт одному компоненту под курсором
+void BM_ContainerPointerEvent(benchmark::State& state) {
+    auto components = makeComponents<CountingComponent>(static_cast<std::size_t>(state.range(0)));
+    hmi3::Container container;
+    fill(container, components);
+
+    std::mt19937 random(42);
+    std::vector<sf::Event> events;
+    for (int i = 0; i < 1024; ++i) {
+        sf::Vector2i position(static_cast<int>(random() % 3000), static_cast<int>(random() % 3400));
+        events.emplace_back(sf::Event::MouseMoved{position});
+    }
+    std::size_t next = 0;
+    for (auto _ : state) {
+        container.handleEvent(events[next++ & 1023]);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Кадр с 32 движениями мыши: при сведении компонент получает одно
+void BM_ContainerCoalescedMotion(benchmark::State& state) {
+    auto components = makeComponents<CountingComponent>(static_cast<std::size_t>(state.range(0)));
+    hmi3::Container container;
+    fill(container, components);
+    container.setMotionCoalescing(true);
+
+    std::mt19937 random(42);
+    std::vector<sf::Event> events;
+    for (int i = 0; i < 1024; ++i) {
+        sf::Vector2i position(static_cast<int>(random() % 3000), static_cast<int>(random() % 3400));
+        events.emplace_back(sf::Event::MouseMoved{position});
+    }
+    std::size_t next = 0;
+    for (auto _ : state) {
+        for (int i = 0; i < 32; ++i) {
+            container.handleEvent(events[next++ & 1023]);
+        }
+        container.flushPendingMotion();
+    }
+    state.SetItemsProcessed(state.iterations() * 32);
+}
+
+// Клавиатура без фокуса рассылается всем видимым компонентам
+void BM_ContainerBroadcastEvent(benchmark::State& state) {
+    auto components = makeComponents<CountingComponent>(static_cast<std::size_t>(state.range(0)));
+    hmi3::Container container;
+    fill(container, components);
+
+    sf::Event event(sf::Event::KeyPressed{});
+    for (auto _ : state) {
+        container.handleEvent(event);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Отрисовка без GPU: сборка пакета, как в Container::draw, и счётчики
+// того, что ушло бы в цель отрисовки
+void BM_ContainerDraw(benchmark::State& state) {
+    auto components = makeComponents<hmi3::RectangleComponent>(static_cast<std::size_t>(state.range(0)));
+    hmi3::Container container;
+    fill(container, components);
+
+    hmi3::RenderBatch batch;
+    for (auto _ : state) {
+        batch.clear();
+        container.appendGeometry(batch);
+        benchmark::DoNotOptimize(batch.getVertexCount());
+    }
+    state.counters["draw_calls"] = static_cast<double>(batch.getDrawCallCount());
+    state.counters["vertices"] = static_cast<double>(batch.getVertexCount());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Страница с фоном и вложенной панелью, половина ламп - в панели:
+// вложенный контейнер попадает в тот же пакет
+void BM_ContainerDrawNested(benchmark::State& state) {
+    auto components = makeComponents<hmi3::RectangleComponent>(static_cast<std::size_t>(state.range(0)));
+    hmi3::Container page("page");
+    page.setBackgroundColor(sf::Color(40, 40, 80));
+    auto panel = std::make_shared<hmi3::Container>("panel");
+    panel->setBackgroundColor(sf::Color(60, 60, 60));
+    page.addComponent(panel);
+    for (std::size_t i = 0; i < components.size(); ++i) {
+        (i % 2 ? page : *panel).addComponent(components[i]);
+    }
+
+    hmi3::RenderBatch batch;
+    for (auto _ : state) {
+        batch.clear();
+        page.appendGeometry(batch);
+        benchmark::DoNotOptimize(batch.getVertexCount());
+    }
+    state.counters["draw_calls"] = static_cast<double>(batch.getDrawCallCount());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Обзор 20k символов (сетка 300 в ряд, 3000x670), окно 1600x900 увеличено
+// в range(0) раз на середину схемы
+void BM_ContainerDrawZoomed(benchmark::State& state) {
+    auto components = makeComponents<hmi3::RectangleComponent>(20000);
+    hmi3::Container overview;
+    overview.setSize({1600, 900});
+    overview.setClipEnabled(true);
+    fill(overview, components);
+    float zoom = static_cast<float>(state.range(0));
+    overview.setZoom(zoom);
+    overview.setScroll({1500.0f - 800.0f / zoom, 335.0f - 450.0f / zoom});
+
+    hmi3::RenderBatch batch;
+    for (auto _ : state) {
+        batch.clear();
+        batch.setVisibleArea(sf::FloatRect({0, 0}, {1600, 900}));
+        overview.appendGeometry(batch);
+        benchmark::DoNotOptimize(batch.getVertexCount());
+    }
+    state.counters["drawn"] = static_cast<double>(batch.getVertexCount() / 6);
+}
+
+#define HMI3_CONTAINER_SIZES RangeMultiplier(10)->Range(1000, 100000)
+
+BENCHMARK(BM_ContainerAdd)->HMI3_CONTAINER_SIZES;
+BENCHMARK(BM_ContainerRemove)->HMI3_CONTAINER_SIZES;
+BENCHMARK(BM_ContainerLookupById)->HMI3_CONTAINER_SIZES;
+BENCHMARK(BM_ContainerLookupByHandle)->HMI3_CONTAINER_SIZES;
+BENCHMARK(BM_ContainerLookupByPath)->HMI3_CONTAINER_SIZES;
+BENCHMARK(BM_ContainerUpdate)->HMI3_CONTAINER_SIZES;
+BENCHMARK(BM_ContainerUpdateMostlyIdle)->HMI3_CONTAINER_SIZES;
+BENCHMARK(BM_ContainerUpdateParallel)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_ContainerPointerEvent)->HMI3_CONTAINER_SIZES;
+BENCHMARK(BM_ContainerCoalescedMotion)->HMI3_CONTAINER_SIZES;
+BENCHMARK(BM_ContainerBroadcastEvent)->HMI3_CONTAINER_SIZES;
+BENCHMARK(BM_ContainerDraw)->HMI3_CONTAINER_SIZES;
+BENCHMARK(BM_ContainerDrawNested)->Arg(5000);
+BENCHMARK(BM_ContainerDrawZoomed)->Arg(1)->Arg(4)->Arg(16)->Unit(benchmark::kMicrosecond);
+
+} // namespace
\ No newline at end of file
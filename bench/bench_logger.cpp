@@ -0,0 +1,35 @@
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include "hmi3/logger.hpp"
+
+namespace {
+
+// Вызов журнала при выводе 2 мс на строку, как у медленной консоли:
+// вызывающий платит только за форматирование и очередь
+void BM_LoggerSlowSink(benchmark::State& state) {
+    hmi3::Logger& logger = hmi3::Logger::instance();
+    hmi3::LogLevel previousLevel = logger.getLevel();
+    logger.setLevel(hmi3::LogLevel::Info);
+    logger.setSink([](hmi3::LogLevel, const std::string& message) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        benchmark::DoNotOptimize(message.size());
+    });
+
+    std::uint64_t droppedBefore = logger.getDroppedCount();
+    int line = 0;
+    for (auto _ : state) {
+        HMI3_LOG_INFO("line " << line++);
+    }
+    state.counters["dropped"] = static_cast<double>(logger.getDroppedCount() - droppedBefore);
+
+    logger.setSink([](hmi3::LogLevel, const std::string&) {});
+    logger.flush();
+    logger.setSink(nullptr);
+    logger.setLevel(previousLevel);
+}
+
+BENCHMARK(BM_LoggerSlowSink)->Iterations(200)->Unit(benchmark::kMicrosecond);
+
+} // namespace
\ No newline at end of file
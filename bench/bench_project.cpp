@@ -0,0 +1,155 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "hmi3/compiled_project.hpp"
+#include "hmi3/container.hpp"
+#include "hmi3/project_loader.hpp"
+#include "hmi3/scene_stager.hpp"
+
+namespace {
+
+// Панели по 100 компонентов: контейнер и 99 ламп
+std::string makePanels(int count) {
+    std::string text = "root background=40,40,80\n";
+    for (int panel = 0; panel < count / 100; ++panel) {
+        text += "container p" + std::to_string(panel) + " position=0,0 size=1000,1000\n";
+        for (int i = 1; i < 100; ++i) {
+            text += "rectangle r" + std::to_string(panel * 100 + i) + " parent=p" + std::to_string(panel) +
+                    " position=" + std::to_string(i % 10 * 10) + "," + std::to_string(i / 10 * 10) +
+                    " size=8,8 fill=0,255,0\n";
+        }
+    }
+    return text;
+}
+
+// Запуск из текста команды: разбор и построение дерева
+void BM_ProjectStartupText(benchmark::State& state) {
+    hmi3::ProjectLoadCommand command;
+    command.projectData = makePanels(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        hmi3::Container root("root");
+        hmi3::ProjectLoader loader;
+        if (!loader.apply(root, command).success) {
+            state.SkipWithError("text project failed to load");
+            return;
+        }
+        benchmark::DoNotOptimize(root.getComponentCount());
+        state.PauseTiming();
+        root.clear();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Запуск из скомпилированного файла: mmap, проверка и построение дерева
+void BM_ProjectStartupCompiled(benchmark::State& state) {
+    hmi3::ProjectDescription description;
+    std::vector<char> data;
+    std::string error;
+    if (!hmi3::parseProject(makePanels(static_cast<int>(state.range(0))), description, error) ||
+        !hmi3::compileProject(description, 1, data, error)) {
+        state.SkipWithError(error.c_str());
+        return;
+    }
+    std::string path = (std::filesystem::temp_directory_path() /
+                        ("hmi3_bench_" + std::to_string(std::random_device{}()) + ".hmi3c"))
+                           .string();
+    {
+        std::ofstream out(path, std::ios::binary);
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+
+    for (auto _ : state) {
+        hmi3::Container root("root");
+        hmi3::ProjectLoader loader;
+        hmi3::CompiledProject project;
+        if (!project.open(path, error) || !loader.apply(root, project).success) {
+            state.SkipWithError("compiled project failed to load");
+            break;
+        }
+        benchmark::DoNotOptimize(root.getComponentCount());
+        state.PauseTiming();
+        root.clear();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    std::remove(path.c_str());
+}
+
+// Перезагрузка проекта из 10k компонентов, в котором поменялся цвет одного
+void BM_ProjectReload(benchmark::State& state) {
+    std::string text;
+    for (int i = 0; i < 10000; ++i) {
+        text += "rectangle r" + std::to_string(i) + " position=" + std::to_string(i % 100 * 10) + "," +
+                std::to_string(i / 100 * 10) + " size=8,8 fill=0,255,0\n";
+    }
+    std::string changed = text;
+    changed.replace(changed.find("r5000 position=0,500 size=8,8 fill=0,255,0"), 42,
+                    "r5000 position=0,500 size=8,8 fill=255,0,0");
+    hmi3::ProjectLoadCommand commands[2];
+    commands[0].projectData = text;
+    commands[1].projectData = changed;
+
+    hmi3::Container root("root");
+    hmi3::ProjectLoader loader;
+    if (!loader.apply(root, commands[0]).success) {
+        state.SkipWithError("project failed to load");
+        return;
+    }
+    std::size_t next = 1;
+    for (auto _ : state) {
+        auto result = loader.apply(root, commands[next]);
+        benchmark::DoNotOptimize(result.updated);
+        next ^= 1;
+    }
+}
+
+// Кадры потока отрисовки, пока SceneStager собирает range(0) компонентов:
+// время итерации - самый медленный кадр, включая замену поддерева
+void BM_SceneStagerFrames(benchmark::State& state) {
+    using Clock = std::chrono::steady_clock;
+    hmi3::ProjectLoadCommand command;
+    command.projectData = makePanels(static_cast<int>(state.range(0)));
+    hmi3::Container container("main");
+    hmi3::ComponentHandle handle = container.addComponent(std::make_shared<hmi3::Container>("project"));
+    hmi3::SceneStager stager;
+
+    std::size_t frames = 0;
+    double buildSeconds = 0.0;
+    for (auto _ : state) {
+        stager.submit(command);
+        std::shared_ptr<hmi3::SceneStager::Scene> scene;
+        double slowest = 0.0;
+        while (!scene) {
+            auto start = Clock::now();
+            scene = stager.acquire();
+            if (scene) {
+                stager.retire(container.replaceComponent(handle, scene->root));
+            }
+            container.update(1.0f / 60.0f);
+            slowest = std::max(slowest, std::chrono::duration<double>(Clock::now() - start).count());
+            ++frames;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        buildSeconds += scene->buildSeconds;
+        state.SetIterationTime(slowest);
+    }
+    stager.waitIdle();
+    state.counters["frames"] = benchmark::Counter(static_cast<double>(frames), benchmark::Counter::kAvgIterations);
+    state.counters["build_ms"] = benchmark::Counter(buildSeconds * 1000.0, benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_ProjectStartupText)->Arg(50000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ProjectStartupCompiled)->Arg(50000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ProjectReload)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SceneStagerFrames)->Arg(100000)->UseManualTime()->Iterations(3)->Unit(benchmark::kMillisecond);
+
+} // namespace
\ No newline at end of file
@@ -0,0 +1,142 @@
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include "hmi3/command_receiver.hpp"
+#include "hmi3/protocol.hpp"
+
+namespace {
+
+// Приёмник на свободном loopback-порту и постоянное соединение клиента
+class LoopbackReceiver {
+public:
+    LoopbackReceiver() : m_receiver(0, 1024) {
+        m_receiver.setCommandCallback([this](const hmi3::ProjectLoadCommand&) {
+            m_received.fetch_add(1, std::memory_order_release);
+        });
+    }
+
+    ~LoopbackReceiver() {
+        m_socket.disconnect();
+        m_receiver.stop();
+    }
+
+    bool start() {
+        return m_receiver.start() &&
+               m_socket.connect(sf::IpAddress::LocalHost, m_receiver.getLocalPort()) == sf::Socket::Status::Done;
+    }
+
+    bool send(const hmi3::ProjectLoadCommand& command) {
+        return hmi3::sendFrame(m_socket, command) == sf::Socket::Status::Done;
+    }
+
+    // false - команды не дошли за отведённое время
+    bool waitFor(std::size_t count) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (m_received.load(std::memory_order_acquire) < count) {
+            if (std::chrono::steady_clock::now() > deadline) return false;
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+private:
+    hmi3::NetworkCommandReceiver m_receiver;
+    sf::TcpSocket m_socket;
+    std::atomic<std::size_t> m_received{0};
+};
+
+hmi3::ProjectLoadCommand makeCommand(std::size_t payloadSize) {
+    hmi3::ProjectLoadCommand command;
+    command.projectName = "bench";
+    command.projectData = std::string(payloadSize, 'x');
+    return command;
+}
+
+// Кадры идут подряд без ожидания ответа
+void BM_ReceiverThroughput(benchmark::State& state) {
+    LoopbackReceiver loopback;
+    if (!loopback.start()) {
+        state.SkipWithError("cannot start loopback receiver");
+        return;
+    }
+    hmi3::ProjectLoadCommand command = makeCommand(static_cast<std::size_t>(state.range(0)));
+
+    std::size_t sent = 0;
+    for (auto _ : state) {
+        if (!loopback.send(command)) {
+            state.SkipWithError("send failed");
+            return;
+        }
+        ++sent;
+    }
+    if (!loopback.waitFor(sent)) {
+        state.SkipWithError("receiver did not deliver all commands");
+        return;
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(sent));
+    state.SetBytesProcessed(static_cast<std::int64_t>(sent) * state.range(0));
+}
+
+// Время от начала отправки кадра до вызова обработчика
+void BM_ReceiverLatency(benchmark::State& state) {
+    LoopbackReceiver loopback;
+    if (!loopback.start()) {
+        state.SkipWithError("cannot start loopback receiver");
+        return;
+    }
+    hmi3::ProjectLoadCommand command = makeCommand(static_cast<std::size_t>(state.range(0)));
+
+    std::size_t sent = 0;
+    for (auto _ : state) {
+        if (!loopback.send(command) || !loopback.waitFor(++sent)) {
+            state.SkipWithError("command was not delivered");
+            return;
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(sent));
+}
+
+// Разбор готового кадра так, как его читает приёмник: окнами из сокета.
+// Аргумент 1 - нагрузка сжата LZ4; байты считаются по распакованному тексту
+void BM_FrameParserPayload(benchmark::State& state) {
+    std::string text;
+    while (text.size() < (4u << 20)) {
+        text += "rectangle lamp" + std::to_string(text.size()) + " position=20,20 size=10,10 fill=0,255,0\n";
+    }
+    hmi3::ProjectLoadCommand command;
+    command.projectName = "bench";
+    command.projectData = text;
+    command.compression = state.range(0) ? hmi3::PayloadCompression::Lz4 : hmi3::PayloadCompression::None;
+    std::string frame = hmi3::encodeFrame(command);
+
+    hmi3::FrameParser parser;
+    for (auto _ : state) {
+        std::size_t consumed = 0;
+        parser.feed(frame.data(), hmi3::protocol::kHeaderSize + command.projectName.size(), consumed);
+        std::size_t offset = consumed;
+        auto result = hmi3::FrameParser::Result::NeedMoreData;
+        while (result == hmi3::FrameParser::Result::NeedMoreData) {
+            std::size_t window = 0;
+            char* data = parser.payloadWindow(window);
+            std::size_t count = std::min({window, frame.size() - offset, std::size_t(64 * 1024)});
+            std::memcpy(data, frame.data() + offset, count);
+            offset += count;
+            result = parser.commitPayload(count);
+        }
+        benchmark::DoNotOptimize(parser.takeCommand());
+    }
+    state.counters["wire_ratio"] = static_cast<double>(frame.size()) / text.size();
+    state.counters["peak_kb"] = static_cast<double>(parser.getFrameStats().peakMemory) / 1024;
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+
+BENCHMARK(BM_ReceiverThroughput)->RangeMultiplier(16)->Range(64, 1 << 20)->UseRealTime();
+BENCHMARK(BM_ReceiverLatency)->RangeMultiplier(16)->Range(64, 1 << 20)->UseRealTime();
+BENCHMARK(BM_FrameParserPayload)->Arg(0)->Arg(1);
+
+} // namespace
\ No newline at end of file
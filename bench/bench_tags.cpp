@@ -0,0 +1,59 @@
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+#include "hmi3/tag_database.hpp"
+
+namespace {
+
+// 20k тегов по 5 подписчиков, как у крупной мнемосхемы
+struct TagSetup {
+    explicit TagSetup(std::size_t count) : tags(count) {
+        for (std::size_t i = 0; i < count; ++i) {
+            ids.push_back(tags.addTag("tag" + std::to_string(i), 0.0));
+            for (int s = 0; s < 5; ++s) {
+                subscriptions.push_back(tags.subscribe(ids.back(), [this](hmi3::TagId, const hmi3::TagValue&) {
+                    ++handlerCalls;
+                }));
+            }
+        }
+    }
+
+    hmi3::TagDatabase tags;
+    std::vector<hmi3::TagId> ids;
+    std::vector<hmi3::TagSubscription> subscriptions;
+    std::size_t handlerCalls = 0;
+};
+
+// Публикация производителя в 1000 часто меняющихся тегов
+void BM_TagPublish(benchmark::State& state) {
+    TagSetup setup(20000);
+    std::size_t i = 0;
+    for (auto _ : state) {
+        setup.tags.publish(setup.ids[(i * 7919) % 1000], static_cast<double>(i));
+        ++i;
+    }
+    setup.tags.dispatch();
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Рассылка кадра, в котором изменилось range(0) тегов из 20k
+void BM_TagDispatch(benchmark::State& state) {
+    TagSetup setup(20000);
+    std::size_t changed = static_cast<std::size_t>(state.range(0));
+    double value = 0.0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        value += 1.0;
+        for (std::size_t i = 0; i < changed; ++i) {
+            setup.tags.publish(setup.ids[i], value);
+        }
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(setup.tags.dispatch());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_TagPublish);
+BENCHMARK(BM_TagDispatch)->Arg(0)->Arg(100)->Arg(1000);
+
+} // namespace
\ No newline at end of file
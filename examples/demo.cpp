@@ -1,197 +1,351 @@
-#include <SFML/Graphics.hpp>
-#include <iostream>
-#include <memory>
-#include <functional>
-#include <cmath>
-#include "hmi3/container.hpp"
-#include "hmi3/command_receiver.hpp"
-
-// Простой компонент для демонстрации работы контейнера
-class DemoComponent : public hmi3::Component {
-public:
-    DemoComponent(const std::string& id, const sf::Vector2f& size, sf::Color color) 
-        : hmi3::Component(id), m_shape(size), m_originalColor(color) {
-        m_shape.setFillColor(color);
-        m_shape.setOutlineColor(sf::Color::White);
-        m_shape.setOutlineThickness(2.0f);
-    }
-    
-    void update(float dt) override {
-        // Упрощенная анимация - только пульсация прозрачности
-        static float time = 0;
-        time += dt;
-        
-        if (!m_clicked) {
-            // Простая пульсация прозрачности
-            uint8_t alpha = 150 + static_cast<uint8_t>(100 * std::sin(time));
-            m_shape.setFillColor(sf::Color(m_originalColor.r, m_originalColor.g, m_originalColor.b, alpha));
-        }
-    }
-    
-    void handleEvent(const sf::Event& event) override {
-        if (!isVisible()) return;
-
-        // используем getIf для проверки типа события
-        if (auto* mousePressed = event.getIf<sf::Event::MouseButtonPressed>()) {
-            if (mousePressed->button == sf::Mouse::Button::Left) {
-                sf::Vector2f mousePos(static_cast<float>(mousePressed->position.x), 
-                                     static_cast<float>(mousePressed->position.y));
-                
-                sf::FloatRect bounds(getPosition(), m_shape.getSize());
-                if (bounds.contains(mousePos)) {
-                    // меняем цвет при клике
-                    m_shape.setFillColor(sf::Color::Yellow);
-                    m_clicked = true;
-                    std::cout << "Component" << getId() << "clicked!" << std::endl;
-                    
-                    // Вызываем callback
-                    if (m_callback) {
-                        m_callback();
-                    }
-                }
-            }
-        }
-        else if (auto* mouseReleased = event.getIf<sf::Event::MouseButtonReleased>()) {
-            m_clicked = false;
-            m_shape.setFillColor(m_originalColor);
-        }
-    }
-    
-    void draw(sf::RenderTarget& target, sf::RenderStates states) const override {
-        if (!isVisible()) return;
-        
-        states.transform.translate(getPosition());
-        target.draw(m_shape, states);
-    }
-    
-    void setCallback(std::function<void()> callback) {
-        m_callback = std::move(callback);
-    }
-
-private:
-    sf::RectangleShape m_shape;
-    sf::Color m_originalColor;
-    bool m_clicked = false;
-    std::function<void()> m_callback;
-};
-
-int main() {
-    sf::RenderWindow window(sf::VideoMode({800, 600}), "HMI3 - Container & Command System Demo");
-    
-    // Демонстрация контейнера
-    
-    // Создаем контейнер с видимым фоном
-    auto container = std::make_shared<hmi3::Container>("main_container");
-    container->setSize(sf::Vector2f(800, 600));
-    container->setBackgroundColor(sf::Color(40, 40, 80));
-    
-    // Добавляем компоненты в контейнер
-    auto redComp = std::make_shared<DemoComponent>("red_component", sf::Vector2f(100, 50), sf::Color::Red);
-    redComp->setPosition({50, 50});
-    
-    auto greenComp = std::make_shared<DemoComponent>("green_component", sf::Vector2f(100, 50), sf::Color::Green);
-    greenComp->setPosition({200, 50});
-    
-    auto blueComp = std::make_shared<DemoComponent>("blue_component", sf::Vector2f(100, 50), sf::Color::Blue);
-    blueComp->setPosition({350, 50});
-    
-    container->addComponent(redComp);
-    container->addComponent(greenComp);
-    container->addComponent(blueComp);
-    
-    std::cout << "Container Demo Started!" << std::endl;
-    std::cout << "Container has " << container->getComponentCount() << " components" << std::endl;
-    std::cout << "Click on colored components to see interaction" << std::endl;
-    
-    // Демонстрация системы команд
-    
-    hmi3::NetworkCommandReceiver receiver(8080);
-    
-    // Callback для визуального отображения команд
-    receiver.setCommandCallback([container](const hmi3::ProjectLoadCommand& cmd) {
-        std::cout << "📨 Received command: " << cmd.projectName << std::endl;
-        std::cout << "   Data size: " << cmd.projectData.size() << " bytes" << std::endl;
-        
-        // Визуальная реакция на команду - меняем цвет контейнера
-        static int colorIndex = 0;
-        sf::Color colors[] = {
-            sf::Color(40, 40, 80),   // исходный
-            sf::Color(80, 40, 40),   // красноватый
-            sf::Color(40, 80, 40),   // зеленоватый
-            sf::Color(40, 40, 120)   // синеватый
-        };
-        container->setBackgroundColor(colors[colorIndex % 4]);
-        colorIndex++;
-        
-        std::cout << "Container background color changed!" << std::endl;
-    });
-    
-    if (receiver.start()) {
-        std::cout << "Command receiver started on port 8080" << std::endl;
-        std::cout << "Send test command: echo 'Hello HMI3!' | nc localhost 8080" << std::endl;
-        std::cout << "Or click the 'Test Command' button below" << std::endl;
-    }
-    
-    // Тестовая кнопка для симуляции команд
-    auto testButton = std::make_shared<DemoComponent>("test_button", sf::Vector2f(150, 40), sf::Color::Magenta);
-    testButton->setPosition({50, 150});
-    testButton->setCallback([&receiver]() {
-        std::cout << "Simulating command via test button..." << std::endl;
-        
-        // Создаем тестовую команду
-        hmi3::ProjectLoadCommand cmd;
-        cmd.projectName = "TestProject";
-        cmd.projectData = "Simulated command data from test button";
-        cmd.version = 1;
-        cmd.forceLoad = true;
-        
-        // Используем callback напрямую для демонстрации
-        if (auto callback = receiver.getCommandCallback()) {
-            callback(cmd);
-        }
-    });
-    container->addComponent(testButton);
-    
-    // Главный цикл
-    
-    sf::Clock clock;
-    sf::Clock removeTimer;
-    bool componentRemoved = false;
-    
-    while (window.isOpen()) {
-        // Обработка событий
-        for (auto event = window.pollEvent(); event.has_value(); event = window.pollEvent()) {
-            if (event->is<sf::Event::Closed>()) {
-                window.close();
-            }
-            
-            // Контейнер обрабатывает события для всех дочерних компонентов
-            container->handleEvent(*event);
-        }
-        
-        float dt = clock.restart().asSeconds();
-        
-        // Демонстрация динамического управления контейнером
-        if (!componentRemoved && removeTimer.getElapsedTime().asSeconds() > 8.0f) {
-            if (container->removeComponent("green_component")) {
-                std::cout << "Component 'green_component' automatically removed after 8 seconds!" << std::endl;
-                std::cout << "Container now has " << container->getComponentCount() << " components" << std::endl;
-                componentRemoved = true;
-            }
-        }
-        
-        // Обновление контейнера и всех компонентов
-        container->update(dt);
-        
-        // Отрисовка
-        window.clear(sf::Color(20, 20, 20));
-        window.draw(*container);
-        window.display();
-    }
-    
-    // Остановка системы команд
-    receiver.stop();
-    std::cout << "Demo finished!" << std::endl;
-    
-    return 0;
+#include <SFML/Graphics.hpp>
+#include <iostream>
+#include <memory>
+#include <functional>
+#include <cmath>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "hmi3/container.hpp"
+#include "hmi3/components/rectangle_component.hpp"
+#include "hmi3/command_journal.hpp"
+#include "hmi3/command_receiver.hpp"
+#include "hmi3/profiler.hpp"
+#include "hmi3/project_loader.hpp"
+#include "hmi3/scene_stager.hpp"
+#include "hmi3/session_recorder.hpp"
+#include "hmi3/tag_database.hpp"
+#include "hmi3/view_server.hpp"
+
+// Простой компонент для демонстрации работы контейнера
+class DemoComponent : public hmi3::Component {
+public:
+    DemoComponent(const std::string& id, const sf::Vector2f& size, sf::Color color) 
+        : hmi3::Component(id), m_shape(size), m_originalColor(color) {
+        m_shape.setFillColor(color);
+        m_shape.setOutlineColor(sf::Color::White);
+        m_shape.setOutlineThickness(2.0f);
+        // Границы нужны контейнеру для доставки событий мыши
+        setSize(size);
+    }
+    
+    void update(float dt) override {
+        // Упрощенная анимация - только пульсация прозрачности
+        static float time = 0;
+        time += dt;
+        
+        if (!m_clicked) {
+            // Простая пульсация прозрачности
+            uint8_t alpha = 150 + static_cast<uint8_t>(100 * std::sin(time));
+            m_shape.setFillColor(sf::Color(m_originalColor.r, m_originalColor.g, m_originalColor.b, alpha));
+            markDirty();
+        }
+    }
+    
+    void handleEvent(const sf::Event& event) override {
+        if (!isVisible()) return;
+
+        // используем getIf для проверки типа события
+        if (auto* mousePressed = event.getIf<sf::Event::MouseButtonPressed>()) {
+            if (mousePressed->button == sf::Mouse::Button::Left) {
+                sf::Vector2f mousePos(static_cast<float>(mousePressed->position.x), 
+                                     static_cast<float>(mousePressed->position.y));
+                
+                sf::FloatRect bounds(getPosition(), m_shape.getSize());
+                if (bounds.contains(mousePos)) {
+                    // меняем цвет при клике
+                    m_shape.setFillColor(sf::Color::Yellow);
+                    m_clicked = true;
+                    markDirty();
+                    std::cout << "Component" << getId() << "clicked!" << std::endl;
+                    
+                    // Вызываем callback
+                    if (m_callback) {
+                        m_callback();
+                    }
+                }
+            }
+        }
+        else if (event.is<sf::Event::MouseButtonReleased>()) {
+            // Отпускание приходит только нажатому компоненту (захват указателя)
+            m_clicked = false;
+            m_shape.setFillColor(m_originalColor);
+            markDirty();
+        }
+    }
+    
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override {
+        if (!isVisible()) return;
+        
+        states.transform.translate(getPosition());
+        target.draw(m_shape, states);
+    }
+    
+    void setCallback(std::function<void()> callback) {
+        m_callback = std::move(callback);
+    }
+
+private:
+    sf::RectangleShape m_shape;
+    sf::Color m_originalColor;
+    bool m_clicked = false;
+    std::function<void()> m_callback;
+};
+
+int main() {
+    sf::RenderWindow window(sf::VideoMode({800, 600}), "HMI3 - Container & Command System Demo");
+    
+    // R - запись сеанса для воспроизведения: ./build/hmi3_replay hmi3_session.hms
+    hmi3::SessionRecorder sessionRecorder;
+    
+    // Демонстрация контейнера
+    
+    // Создаем контейнер с видимым фоном
+    auto container = std::make_shared<hmi3::Container>("main_container");
+    container->setSize(sf::Vector2f(800, 600));
+    container->setBackgroundColor(sf::Color(40, 40, 80));
+    // Десятки MouseMoved за кадр доходят до компонентов одним событием
+    container->setMotionCoalescing(true);
+    // Пока запись не открыта, рекордер ничего не пишет
+    container->setSessionRecorder(&sessionRecorder);
+    
+    // Загруженный проект живёт в своём контейнере под остальными
+    // компонентами; новая сцена целиком подменяет его между кадрами
+    auto project = std::make_shared<hmi3::Container>("project");
+    project->setSize(sf::Vector2f(800, 600));
+    hmi3::ComponentHandle projectHandle = container->addComponent(project);
+    
+    // Добавляем компоненты в контейнер
+    auto redComp = std::make_shared<DemoComponent>("red_component", sf::Vector2f(100, 50), sf::Color::Red);
+    redComp->setPosition({50, 50});
+    
+    auto greenComp = std::make_shared<DemoComponent>("green_component", sf::Vector2f(100, 50), sf::Color::Green);
+    greenComp->setPosition({200, 50});
+    
+    auto blueComp = std::make_shared<DemoComponent>("blue_component", sf::Vector2f(100, 50), sf::Color::Blue);
+    blueComp->setPosition({350, 50});
+    
+    container->addComponent(redComp);
+    container->addComponent(greenComp);
+    container->addComponent(blueComp);
+    
+    // Ряд ламп - простые примитивы рисуются одним пакетом, а статичная
+    // панель целиком берётся из кэша
+    auto lampPanel = std::make_shared<hmi3::Container>("lamp_panel");
+    lampPanel->setPosition({40, 510});
+    lampPanel->setSize({690, 44});
+    lampPanel->setBackgroundColor(sf::Color(30, 30, 30));
+    lampPanel->setCacheEnabled(true);
+    for (int i = 0; i < 20; ++i) {
+        auto lamp = std::make_shared<hmi3::RectangleComponent>(
+            "lamp_" + std::to_string(i), sf::Vector2f(24, 24), i % 3 ? sf::Color::Green : sf::Color::Red);
+        lamp->setPosition({50.0f + i * 34.0f, 520.0f});
+        lamp->setOutlineColor(sf::Color::White);
+        lamp->setOutlineThickness(2.0f);
+        lampPanel->addComponent(lamp);
+    }
+    container->addComponent(lampPanel);
+    
+    // Демонстрация тегов: уровень в баке публикуется из отдельного потока,
+    // столбик обновляется раз в кадр последним значением
+    
+    hmi3::TagDatabase tags;
+    hmi3::TagId levelTag = tags.addTag("tank1.level", 0.0);
+    
+    auto levelBar = std::make_shared<hmi3::RectangleComponent>("tank1_level", sf::Vector2f(40, 0), sf::Color::Cyan);
+    levelBar->setPosition({700, 450});
+    container->addComponent(levelBar);
+    
+    auto levelSubscription = tags.subscribe(levelTag, [levelBar](hmi3::TagId, const hmi3::TagValue& value) {
+        float height = static_cast<float>(std::get<double>(value)) * 3.0f;
+        levelBar->setPosition({700, 450 - height});
+        levelBar->setSize({40, height});
+    });
+    
+    std::atomic<bool> producing{true};
+    std::thread producer([&tags, levelTag, &producing]() {
+        double phase = 0;
+        while (producing) {
+            tags.publish(levelTag, 50.0 + 45.0 * std::sin(phase));
+            phase += 0.001;
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    });
+    
+    std::cout << "Container Demo Started!" << std::endl;
+    std::cout << "Container has " << container->getComponentCount() << " components" << std::endl;
+    std::cout << "Click on colored components to see interaction" << std::endl;
+    
+    // Демонстрация системы команд
+    
+    hmi3::NetworkCommandReceiver receiver(8080);
+    
+    // Обработчик меняет контейнер, поэтому вызывается из цикла отрисовки через pump()
+    receiver.setDispatchMode(hmi3::DispatchMode::Pump);
+    // Счётчики приёмника: curl http://127.0.0.1:8082/metrics
+    receiver.setMetricsPort(8082);
+    receiver.setSessionRecorder(&sessionRecorder);
+    
+    // Проект собирается в фоновом потоке; цикл отрисовки только забирает
+    // готовую сцену, поэтому большой проект не останавливает кадры
+    hmi3::SceneStager stager;
+    
+    // Последний рабочий проект поднимается из снимка до приёма команд
+    hmi3::ProjectLoader loader;
+    hmi3::CommandJournal journal("hmi3_state");
+    std::string journalError;
+    if (!journal.open(journalError)) {
+        std::cout << "Command journal disabled: " << journalError << std::endl;
+    } else if (journal.restore(loader, *project, journalError)) {
+        std::cout << "Restored last project from " << journal.getSnapshotPath() << std::endl;
+    }
+    
+    receiver.setCommandCallback([&stager](const hmi3::ProjectLoadCommand& cmd) {
+        std::cout << "📨 Received command: " << cmd.projectName << std::endl;
+        std::cout << "   Data size: " << cmd.projectData.size() << " bytes" << std::endl;
+        stager.submit(cmd);
+    });
+    
+    if (receiver.start()) {
+        std::cout << "Command receiver started on port 8080" << std::endl;
+        std::cout << "Send test command: echo 'Hello HMI3!' | nc localhost 8080" << std::endl;
+        std::cout << "Or click the 'Test Command' button below" << std::endl;
+    }
+    
+    // Удалённый просмотр: ./build/hmi3_viewer 127.0.0.1 8081
+    hmi3::ViewServer viewServer(8081);
+    // Демо слушает только localhost, поэтому зрителю можно нажимать кнопки
+    viewServer.setInputEnabled(true);
+    if (viewServer.start()) {
+        std::cout << "View server started on port " << viewServer.getLocalPort() << std::endl;
+    }
+    
+    // Тестовая кнопка для симуляции команд
+    auto testButton = std::make_shared<DemoComponent>("test_button", sf::Vector2f(150, 40), sf::Color::Magenta);
+    testButton->setPosition({50, 150});
+    testButton->setCallback([&receiver]() {
+        std::cout << "Simulating command via test button..." << std::endl;
+        
+        // Создаем тестовую команду: меняется только цвет фона проекта
+        static int colorIndex = 0;
+        const char* colors[] = {"40,40,80", "80,40,40", "40,80,40", "40,40,120"};
+        hmi3::ProjectLoadCommand cmd;
+        cmd.projectName = "TestProject";
+        cmd.projectData = std::string("root size=800,600 background=") + colors[colorIndex++ % 4] + "\n"
+                          "container status_panel position=600,20 size=180,60 background=30,30,30\n"
+                          "rectangle status_lamp parent=status_panel position=610,30 size=40,40 fill=0,200,0\n";
+        cmd.version = 1;
+        cmd.forceLoad = false;
+        
+        // Используем callback напрямую для демонстрации
+        if (auto callback = receiver.getCommandCallback()) {
+            callback(cmd);
+        }
+    });
+    container->addComponent(testButton);
+    
+    // Главный цикл
+    
+    sf::Clock clock;
+    sf::Clock removeTimer;
+    bool componentRemoved = false;
+    
+    while (window.isOpen()) {
+        // Обработка событий
+        for (auto event = window.pollEvent(); event.has_value(); event = window.pollEvent()) {
+            if (event->is<sf::Event::Closed>()) {
+                window.close();
+            }
+            
+#ifdef HMI3_ENABLE_PROFILER
+            // P - сводка профилировщика и трасса для chrome://tracing
+            if (auto* key = event->getIf<sf::Event::KeyPressed>(); key && key->code == sf::Keyboard::Key::P) {
+                auto frames = hmi3::Profiler::instance().getFrameStats();
+                std::cout << "Frames: " << frames.frames << ", p50 " << frames.p50Ms << " ms, p95 " << frames.p95Ms
+                          << " ms, p99 " << frames.p99Ms << " ms" << std::endl;
+                auto summary = hmi3::Profiler::instance().getSummary();
+                for (std::size_t i = 0; i < summary.size() && i < 10; ++i) {
+                    std::cout << "  " << summary[i].category << " " << summary[i].name << ": " << summary[i].calls
+                              << " calls, " << summary[i].totalMs << " ms" << std::endl;
+                }
+                if (hmi3::Profiler::instance().writeChromeTrace("hmi3_trace.json")) {
+                    std::cout << "Trace written to hmi3_trace.json" << std::endl;
+                }
+            }
+#endif
+            
+            if (auto* key = event->getIf<sf::Event::KeyPressed>(); key && key->code == sf::Keyboard::Key::R) {
+                std::string recordError;
+                if (sessionRecorder.isOpen()) {
+                    sessionRecorder.close();
+                    std::cout << "Session recording stopped" << std::endl;
+                } else if (sessionRecorder.open("hmi3_session.hms", recordError)) {
+                    std::cout << "Recording session to hmi3_session.hms" << std::endl;
+                } else {
+                    std::cout << "Cannot record session: " << recordError << std::endl;
+                }
+            }
+            
+            // Контейнер обрабатывает события для всех дочерних компонентов
+            container->handleEvent(*event);
+        }
+        
+        // Ввод удалённых зрителей идёт тем же путём, что и локальный
+        viewServer.pumpInput(*container);
+        
+        // Команды, пришедшие по сети, применяются в потоке отрисовки
+        receiver.pump();
+        tags.dispatch();
+        
+        // Готовая сцена подменяет прежнюю, а та освобождается в фоне
+        if (auto scene = stager.acquire()) {
+            const auto& result = scene->result;
+            if (!result.success) {
+                std::cout << "   Project rejected: " << result.error << std::endl;
+            } else {
+                stager.retire(container->replaceComponent(projectHandle, scene->root));
+                sessionRecorder.recordScene(scene->command);
+                if (journal.isOpen()) {
+                    journal.record(scene->command);
+                }
+                std::cout << "   Built " << result.created << " components in " << scene->buildSeconds * 1000.0
+                          << " ms off the render thread" << std::endl;
+                for (const auto& warning : result.warnings) {
+                    std::cout << "   Warning: " << warning << std::endl;
+                }
+            }
+            stager.retire(std::move(scene));
+        }
+        
+        float dt = clock.restart().asSeconds();
+        
+        // Демонстрация динамического управления контейнером
+        if (!componentRemoved && removeTimer.getElapsedTime().asSeconds() > 8.0f) {
+            if (container->removeComponent("green_component")) {
+                std::cout << "Component 'green_component' automatically removed after 8 seconds!" << std::endl;
+                std::cout << "Container now has " << container->getComponentCount() << " components" << std::endl;
+                componentRemoved = true;
+            }
+        }
+        
+        // Обновление контейнера и всех компонентов
+        container->update(dt);
+        
+        // Отрисовка
+        window.clear(sf::Color(20, 20, 20));
+        window.draw(*container);
+        window.display();
+        viewServer.capture(*container);
+        HMI3_PROFILE_FRAME();
+    }
+    
+    // Остановка системы команд
+    receiver.stop();
+    viewServer.stop();
+    journal.close();
+    producing = false;
+    producer.join();
+    std::cout << "Demo finished!" << std::endl;
+    
+    return 0;
 }
\ No newline at end of file
@@ -0,0 +1,91 @@
+#ifndef HMI3_ATOM_TABLE_HPP
+#define HMI3_ATOM_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace hmi3 {
+
+using Atom = std::uint32_t;
+
+// Таблица интернирования идентификаторов: строка -> компактный номер.
+// Одинаковые строки получают один атом, сравнение и хэш атомов - как у
+// чисел. Таблица общая для процесса и доступна из любых потоков (поиск -
+// под разделяемой блокировкой).
+//
+// Компонент держит атом своего id ссылкой (acquire/release), и атом
+// освобождается вместе с последним компонентом с этим id: проекты,
+// приходящие по сети, не растят таблицу за время работы панели, она
+// держит только живые id. Освобождённый номер отдаётся другой строке.
+// intern() закрепляет атом навсегда - для кода, который сохраняет атом
+// и ищет по нему повторно; таких строк должно быть ограниченное число
+class AtomTable {
+public:
+    static constexpr Atom kInvalidAtom = 0xFFFFFFFFu;
+
+    struct Stats {
+        // Строк в таблице; из них закреплено intern()
+        std::size_t live = 0;
+        std::size_t pinned = 0;
+        // Занятые номера, включая свободные для повторной выдачи
+        std::size_t slots = 0;
+        std::uint64_t released = 0;
+    };
+
+    static AtomTable& global();
+
+    AtomTable() = default;
+    AtomTable(const AtomTable&) = delete;
+    AtomTable& operator=(const AtomTable&) = delete;
+
+    // Закреплённый атом: не освобождается никогда
+    Atom intern(std::string_view name);
+    // Атом со ссылкой; каждому acquire() - свой release()
+    Atom acquire(std::string_view name);
+    void release(Atom atom);
+    // kInvalidAtom, если строки нет в таблице: поиск таблицу не растит
+    Atom find(std::string_view name) const;
+    // Ссылка действительна, пока атом удерживается
+    const std::string& name(Atom atom) const;
+    std::size_t size() const;
+    Stats getStats() const;
+    // Gauge и counter в текстовом формате Prometheus
+    static std::string formatStats(const Stats& stats);
+
+private:
+    static constexpr std::uint32_t kPinned = 0xFFFFFFFFu;
+
+    struct Entry {
+        std::string name;
+        // Число ссылок; kPinned - закреплён, 0 - номер свободен
+        std::uint32_t refs = 0;
+    };
+
+    Atom insert(std::string_view name, bool pin);
+
+    mutable std::shared_mutex m_mutex;
+    // deque не перемещает строки, ключи карты ссылаются на них
+    std::deque<Entry> m_entries;
+    std::unordered_map<std::string_view, Atom> m_atoms;
+    std::vector<Atom> m_free;
+    std::size_t m_pinned = 0;
+    std::uint64_t m_released = 0;
+};
+
+inline Atom internAtom(std::string_view name) {
+    return AtomTable::global().intern(name);
+}
+
+inline Atom findAtom(std::string_view name) {
+    return AtomTable::global().find(name);
+}
+
+} // namespace hmi3
+
+#endif // HMI3_ATOM_TABLE_HPP
\ No newline at end of file
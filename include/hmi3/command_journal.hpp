@@ -0,0 +1,124 @@
+#ifndef HMI3_COMMAND_JOURNAL_HPP
+#define HMI3_COMMAND_JOURNAL_HPP
+
+#include "compiled_project.hpp"
+#include "project_load_command.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace hmi3 {
+
+class Container;
+class ProjectLoader;
+
+// Журнал принятых команд на диске и снимок последнего рабочего проекта.
+//
+// record() только ставит команду в очередь; фоновый поток забирает всё
+// накопившееся, дописывает одной записью в файл и делает один fsync на
+// группу. Затем он сохраняет новейшую команду группы как скомпилированный
+// проект (snapshot.hmi3c, атомарной заменой файла) с номером её записи в
+// хвосте файла. При старте restore() отображает снимок в память и строит
+// дерево без сети и разбора текста - если журнал не успел уйти дальше.
+//
+// Запись журнала (little-endian):
+//   0  4  магия "HMJ1"
+//   4  4  длина тела
+//   8  4  CRC-32 тела
+//  12     тело: номер (8), версия (4), forceLoad (1), длина имени (2),
+//         имя, данные проекта
+// open() проверяет все записи; первая битая или недописанная запись и всё
+// после неё считаются оборванным хвостом и отрезаются.
+class CommandJournal {
+public:
+    struct Stats {
+        std::uint64_t records = 0;
+        // Групп, записанных одним fsync
+        std::uint64_t commits = 0;
+        std::uint64_t bytes = 0;
+        std::uint64_t snapshots = 0;
+    };
+
+    struct ReplayResult {
+        std::size_t records = 0;
+        // Байты оборванного хвоста
+        std::size_t skippedBytes = 0;
+    };
+
+    static constexpr std::uint64_t kDefaultMaxJournalSize = 64ull * 1024 * 1024;
+
+    explicit CommandJournal(std::string directory);
+    ~CommandJournal();
+
+    CommandJournal(const CommandJournal&) = delete;
+    CommandJournal& operator=(const CommandJournal&) = delete;
+
+    // Создаёт каталог, проверяет журнал, отрезает битый хвост и запускает
+    // поток записи
+    bool open(std::string& error);
+    // Дописывает очередь и останавливает поток
+    void close();
+    bool isOpen() const { return m_file != nullptr; }
+
+    // Из любого потока; на диск команда попадёт позже
+    void record(const ProjectLoadCommand& command);
+    // Ждёт, пока всё, переданное в record() до вызова, окажется на диске.
+    // false - запись на диск не удалась
+    bool flush();
+
+    // Снимок последнего рабочего проекта, отображённый в память
+    bool loadSnapshot(CompiledProject& project, std::string& error) const;
+    // Старт панели: новейшее из снимка и последней целой записи журнала;
+    // если новейшее не строится - другое
+    bool restore(ProjectLoader& loader, Container& root, std::string& error) const;
+    // Целые записи журнала по порядку
+    ReplayResult replay(const std::function<void(const ProjectLoadCommand&)>& callback) const;
+
+    // Журнал больше предела после сохранения снимка переписывается с одной
+    // последней записью
+    void setMaxJournalSize(std::uint64_t bytes) { m_maxJournalSize = bytes; }
+    // Сколько байт хвоста отрезал open()
+    std::size_t getSkippedBytes() const { return m_skippedBytes; }
+    const std::string& getJournalPath() const { return m_journalPath; }
+    const std::string& getSnapshotPath() const { return m_snapshotPath; }
+    Stats getStats() const;
+
+private:
+    struct Pending {
+        std::uint64_t sequence;
+        ProjectLoadCommand command;
+    };
+
+    void writerLoop();
+    bool commit(const std::vector<Pending>& batch);
+    bool writeSnapshot(const Pending& pending);
+    bool compact(const Pending& last);
+
+    std::string m_directory;
+    std::string m_journalPath;
+    std::string m_snapshotPath;
+    std::uint64_t m_maxJournalSize;
+    std::size_t m_skippedBytes;
+    std::FILE* m_file;
+    std::uint64_t m_fileSize;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_pendingChanged;
+    std::condition_variable m_durableChanged;
+    std::vector<Pending> m_pending;
+    std::uint64_t m_nextSequence;
+    std::uint64_t m_durableSequence;
+    bool m_failed;
+    bool m_stopping;
+    Stats m_stats;
+    std::thread m_writer;
+};
+
+} // namespace hmi3
+
+#endif // HMI3_COMMAND_JOURNAL_HPP
\ No newline at end of file
@@ -1,67 +1,200 @@
-#ifndef HMI3_COMMAND_RECEIVER_HPP
-#define HMI3_COMMAND_RECEIVER_HPP
-
-#include <string>
-#include <memory>
-#include <vector>
-#include <functional>
-#include <mutex>
-#include <thread>
-
-namespace hmi3 {
-
-struct ProjectLoadCommand {
-    std::string projectName;
-    std::string projectData;
-    std::string checksum;
-    uint32_t version;
-    bool forceLoad;
-    
-    ProjectLoadCommand() : version(1), forceLoad(false) {}
-};
-
-class AbstractCommandReceiver {
-public:
-    virtual ~AbstractCommandReceiver() = default;
-    virtual bool start() = 0;
-    virtual void stop() = 0;
-    virtual bool isRunning() const = 0;
-    virtual std::vector<ProjectLoadCommand> getCommands() = 0;
-
-    void setCommandCallback(std::function<void(const ProjectLoadCommand&)> callback) {
-        m_commandCallback = std::move(callback);
-    }
-
-    std::function<void(const ProjectLoadCommand&)> getCommandCallback() const {
-        return m_commandCallback;
-    }
-
-protected:
-    std::function<void(const ProjectLoadCommand&)> m_commandCallback;
-};
-
-class NetworkCommandReceiver : public AbstractCommandReceiver {
-public:
-    explicit NetworkCommandReceiver(unsigned short port = 8080);
-    ~NetworkCommandReceiver();
-
-    bool start() override;
-    void stop() override;
-    bool isRunning() const override;
-    std::vector<ProjectLoadCommand> getCommands() override;
-    void setReceiveTimeout(int timeout) { m_receiveTimeout = timeout; }
-
-private:
-    void receiveLoop();
-
-    unsigned short m_port;
-    int m_receiveTimeout;
-    bool m_running;
-    std::vector<ProjectLoadCommand> m_commands;
-    mutable std::mutex m_commandsMutex;
-    std::thread m_receiveThread;
-};
-
-} // namespace hmi3
-
+#ifndef HMI3_COMMAND_RECEIVER_HPP
+#define HMI3_COMMAND_RECEIVER_HPP
+
+#include "metrics.hpp"
+#include "mpsc_queue.hpp"
+#include "project_load_command.hpp"
+#include "protocol.hpp"
+#include <SFML/Network.hpp>
+#include <string>
+#include <memory>
+#include <vector>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+
+namespace hmi3 {
+
+class SessionRecorder;
+
+// Способ доставки команд обработчику
+enum class DispatchMode {
+    // Обработчик вызывается в потоке приёмника, и команда, как и раньше,
+    // остаётся в очереди для getCommands(). Очередь, которую никто не
+    // разбирает, не тормозит приём: при заполненной очереди копия для
+    // getCommands() отбрасывается (queue_full_total), обработчик получает всё
+    ReceiverThread,
+    // Команды копятся в очереди; pump(), вызванный раз в кадр из потока
+    // отрисовки, вызывает обработчик в этом потоке
+    Pump
+};
+
+// Команды проходят через ограниченную очередь без блокировок: потребитель
+// никогда не ждёт сетевой поток. Заполненная до предела очередь отказывает
+// в приёме, и приёмник перестаёт читать сокет, пока место не освободится.
+//
+// Счётчики и гистограммы пишутся relaxed-атомиками из сетевого потока и
+// читаются снимком getStats() из любого потока.
+class AbstractCommandReceiver {
+public:
+    static constexpr std::size_t kDefaultQueueCapacity = 64;
+
+    struct Stats {
+        std::uint64_t connectionsAccepted = 0;
+        // Отказано из-за предела соединений
+        std::uint64_t connectionsRejected = 0;
+        std::uint64_t connectionsActive = 0;
+        std::uint64_t bytesReceived = 0;
+        // Поставлены в очередь или отданы обработчику
+        std::uint64_t commandsAccepted = 0;
+        // Отвергнутые кадры и ошибки протокола
+        std::uint64_t commandsRejected = 0;
+        std::uint64_t commandsDispatched = 0;
+        // Попытки поставить команду в заполненную очередь
+        std::uint64_t queueFull = 0;
+        std::size_t queueDepth = 0;
+        std::size_t queueCapacity = 0;
+        // От приёма команды до вызова обработчика или getCommands(), мкс
+        HistogramSnapshot dispatchLatencyUs;
+        HistogramSnapshot payloadBytes;
+    };
+
+    explicit AbstractCommandReceiver(std::size_t queueCapacity = kDefaultQueueCapacity)
+        : m_queue(queueCapacity) {}
+    virtual ~AbstractCommandReceiver() = default;
+    virtual bool start() = 0;
+    virtual void stop() = 0;
+    virtual bool isRunning() const = 0;
+    virtual std::vector<ProjectLoadCommand> getCommands();
+
+    std::size_t pump(std::size_t maxCommands = std::numeric_limits<std::size_t>::max());
+
+    // Обработчик и режим задаются до start()
+    void setCommandCallback(std::function<void(const ProjectLoadCommand&)> callback) {
+        m_commandCallback = std::move(callback);
+    }
+
+    std::function<void(const ProjectLoadCommand&)> getCommandCallback() const {
+        return m_commandCallback;
+    }
+
+    // Команды пишутся в рекордер в момент доставки - из pump(),
+    // getCommands() или потока приёмника. Задаётся до start()
+    void setSessionRecorder(SessionRecorder* recorder) { m_sessionRecorder = recorder; }
+
+    void setDispatchMode(DispatchMode mode) { m_dispatchMode = mode; }
+    DispatchMode getDispatchMode() const { return m_dispatchMode; }
+    std::size_t getQueueDepth() const { return m_queue.size(); }
+    std::size_t getQueueCapacity() const { return m_queue.capacity(); }
+
+    Stats getStats() const;
+    // Текстовый формат Prometheus, имена с префиксом hmi3_receiver_
+    static std::string formatStats(const Stats& stats);
+
+protected:
+    using Clock = std::chrono::steady_clock;
+
+    struct QueuedCommand {
+        ProjectLoadCommand command;
+        // Для гистограммы задержки доставки
+        Clock::time_point receivedAt;
+        // Уже отдана обработчику в потоке приёмника - getCommands() не
+        // считает и не записывает её повторно
+        bool dispatched = false;
+    };
+
+    struct Counters {
+        std::atomic<std::uint64_t> connectionsAccepted{0};
+        std::atomic<std::uint64_t> connectionsRejected{0};
+        std::atomic<std::uint64_t> connectionsClosed{0};
+        std::atomic<std::uint64_t> bytesReceived{0};
+        std::atomic<std::uint64_t> commandsAccepted{0};
+        std::atomic<std::uint64_t> commandsRejected{0};
+        std::atomic<std::uint64_t> commandsDispatched{0};
+        std::atomic<std::uint64_t> queueFull{0};
+        Histogram dispatchLatencyUs;
+        Histogram payloadBytes;
+    };
+
+    // false - очередь заполнена, команда остаётся у вызывающего
+    bool enqueueCommand(ProjectLoadCommand&& command);
+    bool enqueueCommand(QueuedCommand&& queued);
+
+    std::function<void(const ProjectLoadCommand&)> m_commandCallback;
+    Counters m_counters;
+
+private:
+    void recordDispatch(const QueuedCommand& queued);
+
+    DispatchMode m_dispatchMode = DispatchMode::ReceiverThread;
+    SessionRecorder* m_sessionRecorder = nullptr;
+    BoundedMpscQueue<QueuedCommand> m_queue;
+};
+
+// Принимает команды от нескольких клиентов одновременно: один поток
+// мультиплексирует слушающий сокет и все соединения через sf::SocketSelector.
+// Клиент держит постоянное соединение и шлёт кадры protocol.hpp; поток без
+// магии кадра читается по-старому - до закрытия соединения как одна команда.
+class NetworkCommandReceiver : public AbstractCommandReceiver {
+public:
+    explicit NetworkCommandReceiver(unsigned short port = 8080,
+                                    std::size_t queueCapacity = kDefaultQueueCapacity);
+    ~NetworkCommandReceiver();
+
+    bool start() override;
+    void stop() override;
+    bool isRunning() const override;
+    // Таймаут и предел соединений можно менять и после start()
+    void setReceiveTimeout(int timeout) { m_receiveTimeout = timeout; }
+    // Простой постоянного соединения между кадрами, мс; 0 - без ограничения
+    void setKeepAliveTimeout(int timeout) { m_keepAliveTimeout = timeout; }
+    void setMaxConnections(std::size_t count) { m_maxConnections = count; }
+    unsigned short getLocalPort() const { return m_localPort; }
+    std::size_t getConnectionCount() const { return m_connectionCount; }
+    // Сводка formatStats() по HTTP на 127.0.0.1 (curl, nc, Prometheus).
+    // Задаётся до start(); 0 - любой свободный порт
+    void setMetricsPort(unsigned short port);
+    unsigned short getMetricsPort() const { return m_localMetricsPort; }
+
+private:
+    struct Connection;
+    struct MetricsClient;
+
+    void receiveLoop();
+    void acceptConnection();
+    bool readConnection(Connection& connection);
+    bool consumeData(Connection& connection, const char* data, std::size_t size);
+    bool consumeFrames(Connection& connection, const char* data, std::size_t size);
+    bool handleFrameResult(Connection& connection, FrameParser::Result result);
+    void dispatchCommand(Connection& connection, ProjectLoadCommand&& command);
+    bool flushStalledConnections();
+    void closeConnection(std::size_t index);
+    void acceptMetricsClient();
+    void serviceMetricsClients();
+    void wakeUp();
+
+    unsigned short m_port;
+    unsigned short m_localPort;
+    std::atomic<int> m_receiveTimeout;
+    std::atomic<int> m_keepAliveTimeout;
+    std::atomic<std::size_t> m_maxConnections;
+    bool m_metricsEnabled;
+    unsigned short m_metricsPort;
+    unsigned short m_localMetricsPort;
+    std::atomic<bool> m_running;
+    std::atomic<std::size_t> m_connectionCount;
+    sf::TcpListener m_listener;
+    sf::SocketSelector m_selector;
+    std::vector<std::unique_ptr<Connection>> m_connections;
+    sf::TcpListener m_metricsListener;
+    std::vector<std::unique_ptr<MetricsClient>> m_metricsClients;
+    std::vector<char> m_buffer;
+    std::thread m_receiveThread;
+};
+
+} // namespace hmi3
+
 #endif // HMI3_COMMAND_RECEIVER_HPP
\ No newline at end of file
@@ -0,0 +1,89 @@
+#ifndef HMI3_COMPILED_PROJECT_HPP
+#define HMI3_COMPILED_PROJECT_HPP
+
+#include "project_description.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace hmi3 {
+
+// Скомпилированный проект: плоские таблицы фиксированных записей со
+// смещениями и общий пул строк, одинаковые строки хранятся один раз.
+//
+//   заголовок | компоненты | свойства | строки (смещение, длина) | данные строк
+//
+// Все поля - uint32 в порядке байтов платформы (little-endian), родитель
+// всегда раньше детей. Файл отображается в память как есть, при открытии
+// проверяются только границы таблиц; строки отдаются string_view прямо
+// из отображения, без копирования и разбора.
+struct CompiledProperty {
+    std::string_view name;
+    std::string_view value;
+};
+
+class CompiledProject {
+public:
+    static constexpr std::uint32_t noParent = 0xFFFFFFFFu;
+
+    CompiledProject() = default;
+    ~CompiledProject();
+    CompiledProject(CompiledProject&& other) noexcept;
+    CompiledProject& operator=(CompiledProject&& other) noexcept;
+    CompiledProject(const CompiledProject&) = delete;
+    CompiledProject& operator=(const CompiledProject&) = delete;
+
+    // Отображает файл в память только для чтения
+    bool open(const std::string& path, std::string& error);
+    // Проект в чужом буфере; буфер должен жить, пока проект открыт
+    bool openMemory(const void* data, std::size_t size, std::string& error);
+    void close();
+    bool isOpen() const { return m_data != nullptr; }
+
+    // Версия проекта, указанная при компиляции
+    std::uint32_t getVersion() const;
+    std::size_t getComponentCount() const;
+    std::string_view getType(std::size_t component) const;
+    std::string_view getId(std::size_t component) const;
+    // Индекс родительского компонента или noParent для корня
+    std::uint32_t getParent(std::size_t component) const;
+    std::size_t getPropertyCount(std::size_t component) const;
+    CompiledProperty getProperty(std::size_t component, std::size_t property) const;
+    std::size_t getRootPropertyCount() const;
+    CompiledProperty getRootProperty(std::size_t property) const;
+    // Размер пула строк - для статистики компилятора
+    std::size_t getStringCount() const;
+
+    // Начинается ли буфер с сигнатуры скомпилированного проекта
+    static bool isCompiled(std::string_view data);
+
+private:
+    struct ComponentRecord;
+
+    bool validate(std::string& error);
+    ComponentRecord component(std::size_t index) const;
+    CompiledProperty property(std::size_t index) const;
+    std::string_view string(std::uint32_t index) const;
+    std::uint32_t field(std::size_t offset) const;
+
+    const unsigned char* m_data = nullptr;
+    std::size_t m_size = 0;
+    // Отображение файла, если проект открыт через open()
+    void* m_mapping = nullptr;
+    std::size_t m_mappingSize = 0;
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mappingHandle = nullptr;
+#endif
+};
+
+// Компиляция текстового описания. false - ссылка на неизвестного родителя
+// или проект не помещается в 32-битные смещения
+bool compileProject(const ProjectDescription& description, std::uint32_t version, std::vector<char>& output,
+                    std::string& error);
+
+} // namespace hmi3
+
+#endif // HMI3_COMPILED_PROJECT_HPP
\ No newline at end of file
@@ -0,0 +1,31 @@
+#ifndef HMI3_COMPONENT_FACTORY_HPP
+#define HMI3_COMPONENT_FACTORY_HPP
+
+#include "components/component.hpp"
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace hmi3 {
+
+// Создание компонентов по имени типа из описания проекта
+class ComponentFactory {
+public:
+    using Creator = std::function<std::shared_ptr<Component>(const std::string& id)>;
+
+    // Встроенные типы: container, rectangle, trend, value
+    static ComponentFactory withBuiltins();
+
+    void registerType(const std::string& type, Creator creator);
+    bool hasType(const std::string& type) const { return m_creators.count(type) != 0; }
+    // nullptr для неизвестного типа
+    std::shared_ptr<Component> create(const std::string& type, const std::string& id) const;
+
+private:
+    std::unordered_map<std::string, Creator> m_creators;
+};
+
+} // namespace hmi3
+
+#endif // HMI3_COMPONENT_FACTORY_HPP
\ No newline at end of file
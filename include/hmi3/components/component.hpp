@@ -1,32 +1,132 @@
-#ifndef HMI3_COMPONENT_HPP
-#define HMI3_COMPONENT_HPP
-
-#include <SFML/Graphics.hpp>
-#include <memory>
-#include <string>
-
-namespace hmi3 {
-
-class Component : public sf::Drawable {
-public:
-    virtual ~Component() = default;
-    virtual void update(float dt) = 0;
-    virtual void handleEvent(const sf::Event& event) = 0;
-    
-    void setPosition(const sf::Vector2f& position) { m_position = position; }
-    void setVisible(bool visible) { m_visible = visible; }
-    bool isVisible() const { return m_visible; }
-    const sf::Vector2f& getPosition() const { return m_position; }
-    const std::string& getId() const { return m_id; }
-
-protected:
-    explicit Component(std::string id) : m_id(std::move(id)) {}
-    
-    sf::Vector2f m_position;
-    bool m_visible = true;
-    std::string m_id;
-};
-
-} // namespace hmi3
-
+#ifndef HMI3_COMPONENT_HPP
+#define HMI3_COMPONENT_HPP
+
+#include "../atom_table.hpp"
+#include "../slot_map.hpp"
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace hmi3 {
+
+class Container;
+class RenderBatch;
+
+using ComponentHandle = SlotHandle;
+
+class Component : public sf::Drawable {
+public:
+    // Освобождает атом id
+    virtual ~Component();
+    Component(const Component&) = delete;
+    Component& operator=(const Component&) = delete;
+
+    virtual void update(float dt) = 0;
+    virtual void handleEvent(const sf::Event& event) = 0;
+
+    // true - update() трогает только собственное состояние компонента и
+    // может идти в пуле потоков параллельно с соседями. Всё, что касается
+    // общего состояния (теги, родитель, другие компоненты), переносится в
+    // commitUpdate(), который вызывается после параллельной фазы в потоке
+    // интерфейса в порядке отрисовки
+    virtual bool isUpdateThreadSafe() const { return false; }
+    virtual void commitUpdate() {}
+
+    // Планирование update(). По умолчанию компонент обновляется каждый кадр.
+    // Спящий не получает update(), пока его не разбудят: wake(), markDirty()
+    // (смена данных или вида), событие, адресованное ему контейнером, или
+    // таймер sleepFor(). Кадр контейнера стоит столько, сколько в нём
+    // бодрствующих компонентов. Из параллельной фазы update() не вызывать -
+    // только из commitUpdate() и потока интерфейса
+    void sleep();
+    // Таймер идёт по часам родителя; вне контейнера - то же, что sleep()
+    void sleepFor(float seconds);
+    void wake();
+    bool isSleeping() const { return m_sleeping; }
+    // update() раз в seconds с dt, накопленным с прошлого вызова; 0 - каждый кадр
+    void setUpdateInterval(float seconds);
+    float getUpdateInterval() const { return m_updateInterval; }
+
+    void setPosition(const sf::Vector2f& position);
+    void setVisible(bool visible);
+    // Нулевой размер - границы не заданы, компонент сам проверяет попадание
+    void setSize(const sf::Vector2f& size);
+    bool isVisible() const { return m_visible; }
+    const sf::Vector2f& getPosition() const { return m_position; }
+    const sf::Vector2f& getSize() const { return m_size; }
+    const std::string& getId() const { return m_id; }
+    // Интернированный id - ключ компонента в контейнере
+    Atom getAtom() const { return m_atom; }
+    Container* getParent() const { return m_parent; }
+    // Дескриптор в родительском контейнере, недействителен вне контейнера
+    ComponentHandle getHandle() const { return m_handle; }
+
+    // Изменение вида компонента: помечает его и всех предков, чтобы
+    // кэширующий контейнер перерисовал своё поддерево
+    void markDirty();
+    bool isDirty() const { return m_dirty; }
+
+    // Указатель вошёл в границы компонента или покинул их
+    virtual void onHoverChanged(bool hovered) { (void)hovered; }
+    // Компонент получил или потерял клавиатурный фокус родителя
+    virtual void onFocusChanged(bool focused) { (void)focused; }
+
+    // Область, по которой контейнер направляет события указателя
+    virtual sf::FloatRect getBounds() const { return sf::FloatRect(m_position, m_size); }
+    bool hasBounds() const;
+
+    // Свойство из описания проекта. Базовый класс знает position, size и
+    // visible; наследник обрабатывает свои и передаёт остальные сюда.
+    // false - неизвестное свойство или неверное значение
+    virtual bool applyProperty(std::string_view name, std::string_view value);
+
+    // Пакетная отрисовка: компонент дописывает свою геометрию в batch и
+    // возвращает true. По умолчанию контейнер рисует компонент через draw()
+    virtual bool appendGeometry(RenderBatch& batch) const {
+        (void)batch;
+        return false;
+    }
+
+protected:
+    explicit Component(std::string id) : m_id(std::move(id)), m_atom(AtomTable::global().acquire(m_id)) {}
+
+    // Вызывается наследником, если getBounds() изменился помимо setPosition/setSize
+    void notifyBoundsChanged();
+
+    sf::Vector2f m_position;
+    sf::Vector2f m_size;
+    bool m_visible = true;
+    std::string m_id;
+
+private:
+    friend class Container;
+
+    // Снимает отметку после перерисовки кэша; контейнер - со всего поддерева
+    virtual void clearDirty() const { m_dirty = false; }
+    // Передаёт новое расписание родителю; delay < 0 - без таймера
+    void reschedule(double delay);
+
+    Atom m_atom;
+    Container* m_parent = nullptr;
+    ComponentHandle m_handle;
+    // Путь от корня дерева ("area1/pump3/status"); хранит ключ индекса путей
+    std::string m_path;
+    mutable bool m_dirty = true;
+    // Порядок отрисовки внутри родителя: больше - выше
+    std::uint64_t m_order = 0;
+    bool m_sleeping = false;
+    float m_updateInterval = 0.0f;
+    // Растёт при каждой смене расписания: записи колеса таймеров родителя
+    // со старым номером не действуют
+    std::uint32_t m_scheduleTicket = 0;
+    // Время последнего update() по часам родителя
+    double m_lastUpdate = 0.0;
+    // dt для update() текущего кадра, выставляет родитель
+    float m_pendingDt = 0.0f;
+};
+
+} // namespace hmi3
+
 #endif // HMI3_COMPONENT_HPP
\ No newline at end of file
@@ -0,0 +1,39 @@
+#ifndef HMI3_RECTANGLE_COMPONENT_HPP
+#define HMI3_RECTANGLE_COMPONENT_HPP
+
+#include "component.hpp"
+
+namespace hmi3 {
+
+// Прямоугольник с заливкой и рамкой (индикаторы, лампы, подложки).
+// Рисуется пакетно вместе с соседними простыми примитивами.
+class RectangleComponent : public Component {
+public:
+    RectangleComponent(std::string id, const sf::Vector2f& size, const sf::Color& fillColor);
+
+    // Нечего анимировать: после изменения - один update() и снова сон
+    void update(float dt) override {
+        (void)dt;
+        sleep();
+    }
+    void handleEvent(const sf::Event& event) override { (void)event; }
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+    bool appendGeometry(RenderBatch& batch) const override;
+    // fill, outline, outlineThickness
+    bool applyProperty(std::string_view name, std::string_view value) override;
+
+    void setFillColor(const sf::Color& color);
+    void setOutlineColor(const sf::Color& color);
+    // Рамка рисуется внутрь прямоугольника
+    void setOutlineThickness(float thickness);
+    const sf::Color& getFillColor() const { return m_fillColor; }
+
+private:
+    sf::Color m_fillColor;
+    sf::Color m_outlineColor = sf::Color::Transparent;
+    float m_outlineThickness = 0.0f;
+};
+
+} // namespace hmi3
+
+#endif // HMI3_RECTANGLE_COMPONENT_HPP
\ No newline at end of file
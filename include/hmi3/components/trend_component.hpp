@@ -0,0 +1,110 @@
+#ifndef HMI3_TREND_COMPONENT_HPP
+#define HMI3_TREND_COMPONENT_HPP
+
+#include "component.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace hmi3 {
+
+// Наименьшее и наибольшее значение блока (SSE2, где доступно)
+void findMinMax(const float* data, std::size_t count, float& min, float& max);
+
+// Тренд: история каждого пера в кольцевом буфере фиксированной ёмкости.
+// Перья пишутся с общим периодом, последняя выборка - у правого края.
+//
+// Для отрисовки история прореживается до пар min/max по корзинам: в корзине
+// степень двойки выборок, корзин не меньше, чем пикселей по ширине. Прореженный
+// ряд кэшируется для каждого масштаба и дополняется только новыми выборками,
+// поэтому кадр с миллионами точек стоит порядка ширины окна.
+class TrendComponent : public Component {
+public:
+    struct Bucket {
+        float min;
+        float max;
+    };
+
+    struct Stats {
+        // Ряды масштаба, построенные с нуля
+        std::uint64_t levelBuilds = 0;
+        // Выборок, просмотренных при прореживании
+        std::uint64_t scannedSamples = 0;
+    };
+
+    static constexpr std::size_t kDefaultCapacity = 1 << 20;
+    static constexpr std::size_t kMaxCachedLevels = 4;
+
+    explicit TrendComponent(std::string id, std::size_t capacity = kDefaultCapacity);
+
+    // Нечего анимировать: после изменения - один update() и снова сон
+    void update(float dt) override {
+        (void)dt;
+        sleep();
+    }
+    void handleEvent(const sf::Event& event) override { (void)event; }
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+    bool appendGeometry(RenderBatch& batch) const override;
+    // range, visibleSamples, background
+    bool applyProperty(std::string_view name, std::string_view value) override;
+
+    std::size_t addPen(const sf::Color& color);
+    std::size_t getPenCount() const { return m_pens.size(); }
+    void addSample(std::size_t pen, float value) { addSamples(pen, &value, 1); }
+    void addSamples(std::size_t pen, const float* values, std::size_t count);
+    // Выборок в истории пера, не больше ёмкости
+    std::size_t getSampleCount(std::size_t pen) const;
+    std::size_t getCapacity() const { return m_capacity; }
+
+    // Масштаб: сколько последних выборок занимает ширину; 0 - вся ёмкость
+    void setVisibleSamples(std::size_t count);
+    std::size_t getVisibleSamples() const { return m_visibleSamples; }
+    void setRange(float min, float max);
+    void setBackground(const sf::Color& color);
+
+    // Прореженная история пера с bucketSize выборок в корзине (степень
+    // двойки), от самой старой корзины. Идёт через кэш масштабов
+    const std::deque<Bucket>& getBuckets(std::size_t pen, std::size_t bucketSize) const;
+    Stats getStats() const { return m_stats; }
+
+private:
+    struct Level {
+        std::size_t bucketSize = 0;
+        // Абсолютный номер первой корзины
+        std::uint64_t firstBucket = 0;
+        // Сколько выборок пера уже учтено
+        std::uint64_t covered = 0;
+        // Начало окна, по которому последний раз пересчитана первая корзина
+        std::uint64_t clippedAt = 0;
+        std::uint64_t lastUse = 0;
+        std::deque<Bucket> buckets;
+    };
+
+    struct Pen {
+        sf::Color color;
+        std::vector<float> samples;
+        // Выборок записано за всё время; выборка n лежит в samples[n % ёмкость]
+        std::uint64_t total = 0;
+        std::vector<Level> levels;
+    };
+
+    std::uint64_t historyStart(const Pen& pen) const;
+    Level& level(Pen& pen, std::size_t bucketSize) const;
+    void catchUp(const Pen& pen, Level& level) const;
+    Bucket scan(const Pen& pen, std::uint64_t begin, std::uint64_t end) const;
+
+    std::size_t m_capacity;
+    std::size_t m_visibleSamples = 0;
+    float m_rangeMin = 0.0f;
+    float m_rangeMax = 100.0f;
+    sf::Color m_background = sf::Color::Transparent;
+    // Кэш масштабов меняется при отрисовке; всё - из потока интерфейса
+    mutable std::vector<Pen> m_pens;
+    mutable std::uint64_t m_useCounter = 0;
+    mutable Stats m_stats;
+};
+
+} // namespace hmi3
+
+#endif // HMI3_TREND_COMPONENT_HPP
\ No newline at end of file
@@ -0,0 +1,86 @@
+#ifndef HMI3_VALUE_DISPLAY_COMPONENT_HPP
+#define HMI3_VALUE_DISPLAY_COMPONENT_HPP
+
+#include "../glyph_cache.hpp"
+#include "component.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace hmi3 {
+
+// Числовой индикатор. Значение форматируется std::to_chars в буфер
+// фиксированного размера, квады символов хранятся готовыми и при новом
+// значении переписываются только те, у которых сменился символ или место.
+// Геометрия текстурирована атласом шрифта, поэтому все индикаторы одного
+// шрифта и размера подряд попадают в один пакет RenderBatch.
+class ValueDisplayComponent : public Component {
+public:
+    enum class Alignment {
+        Left,
+        Right
+    };
+
+    // Число и единица измерения вместе; длиннее - обрезается
+    static constexpr std::size_t kMaxChars = 32;
+
+    explicit ValueDisplayComponent(std::string id);
+
+    // Нечего анимировать: после изменения - один update() и снова сон
+    void update(float dt) override {
+        (void)dt;
+        sleep();
+    }
+    void handleEvent(const sf::Event& event) override { (void)event; }
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+    bool appendGeometry(RenderBatch& batch) const override;
+    // value, precision, unit, color, align (left/right), font (путь), characterSize
+    bool applyProperty(std::string_view name, std::string_view value) override;
+
+    // Без шрифта индикатор форматирует значение, но ничего не рисует
+    void setFont(std::shared_ptr<const sf::Font> font, unsigned int characterSize);
+    void setValue(double value);
+    // Знаков после запятой, 0..9
+    void setPrecision(int precision);
+    // Дописывается после числа как есть, например " bar"
+    void setUnit(std::string_view unit);
+    void setColor(const sf::Color& color);
+    void setAlignment(Alignment alignment);
+
+    double getValue() const { return m_value; }
+    std::string_view getText() const { return std::string_view(m_text.data(), m_length); }
+    // Сколько раз квады символов переписывались - для проверки и замеров
+    std::uint64_t getGlyphWrites() const { return m_glyphWrites; }
+
+private:
+    void format();
+    void layout();
+    void writeQuad(std::size_t index, char c, float pen);
+
+    std::shared_ptr<const sf::Font> m_font;
+    unsigned int m_characterSize = 14;
+    std::shared_ptr<const GlyphCache> m_glyphs;
+    double m_value = 0.0;
+    int m_precision = 1;
+    std::array<char, kMaxChars> m_unit{};
+    std::size_t m_unitLength = 0;
+    sf::Color m_color = sf::Color::White;
+    Alignment m_alignment = Alignment::Right;
+
+    std::array<char, kMaxChars> m_text{};
+    std::size_t m_length = 0;
+    // Что лежит в квадах сейчас: символ и его место. При выравнивании
+    // вправо места отсчитываются от правого края, и смена размера
+    // компонента квады не трогает
+    std::array<char, kMaxChars> m_laidOut{};
+    std::array<float, kMaxChars> m_pen{};
+    std::size_t m_laidOutLength = 0;
+    // Шесть вершин на символ, координаты относительно точки привязки
+    std::array<sf::Vertex, kMaxChars * 6> m_vertices{};
+    std::uint64_t m_glyphWrites = 0;
+};
+
+} // namespace hmi3
+
+#endif // HMI3_VALUE_DISPLAY_COMPONENT_HPP
\ No newline at end of file
@@ -0,0 +1,71 @@
+#ifndef HMI3_COMPRESSION_HPP
+#define HMI3_COMPRESSION_HPP
+
+#include "payload_buffer.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace hmi3 {
+
+// Способ сжатия нагрузки кадра; значение передаётся битами флагов кадра
+enum class PayloadCompression : std::uint8_t {
+    None = 0,
+    // Кадр LZ4 frame format - совместим с утилитой lz4
+    Lz4 = 1
+};
+
+const char* compressionName(PayloadCompression compression);
+
+// Сжимает данные целиком - для отправителя. None возвращает копию данных;
+// false - способ не поддерживается или LZ4 вернул ошибку
+bool compressPayload(PayloadCompression compression, std::string_view data, PayloadBuffer& out,
+                     std::string& error);
+
+// Потоковая распаковка: сжатые байты подаются порциями по мере прихода из
+// сокета, распакованные сразу дописываются в PayloadWriter. Целиком сжатые
+// данные нигде не собираются. Если в заголовке LZ4 указан исходный размер,
+// блок под результат выделяется один раз - но не больше кратности длины
+// сжатого потока, когда она известна: заголовку из сети верить нельзя.
+class StreamDecompressor {
+public:
+    explicit StreamDecompressor(PayloadCompression compression);
+    ~StreamDecompressor();
+
+    StreamDecompressor(const StreamDecompressor&) = delete;
+    StreamDecompressor& operator=(const StreamDecompressor&) = delete;
+
+    // false - поток повреждён или распакованное превысило limit; дальнейшие
+    // вызовы ничего не делают до reset()
+    bool feed(const char* data, std::size_t size, PayloadWriter& out, std::uint64_t limit);
+    // Конец потока сжатия достигнут, хвостовая контрольная сумма сошлась
+    bool isComplete() const { return m_complete; }
+    const std::string& getError() const { return m_error; }
+    PayloadCompression getCompression() const { return m_compression; }
+    // Оценка памяти распаковщика: внутренние буферы блока и словарь
+    std::size_t getWorkingMemory() const;
+    // inputSize - длина сжатого потока, 0 - неизвестна
+    void reset(std::uint64_t inputSize = 0);
+
+private:
+    struct Context;
+
+    bool readFrameInfo(const char*& data, std::size_t& size, PayloadWriter& out, std::uint64_t limit);
+    bool applyFrameInfo(int blockSizeId, std::uint64_t contentSize, PayloadWriter& out, std::uint64_t limit);
+
+    PayloadCompression m_compression;
+    std::unique_ptr<Context> m_context;
+    bool m_infoKnown;
+    bool m_contentSizeKnown;
+    std::uint64_t m_contentSize;
+    std::uint64_t m_inputSize;
+    std::size_t m_blockSize;
+    bool m_complete;
+    std::string m_error;
+};
+
+} // namespace hmi3
+
+#endif // HMI3_COMPRESSION_HPP
\ No newline at end of file
@@ -1,38 +1,221 @@
-#ifndef HMI3_CONTAINER_HPP
-#define HMI3_CONTAINER_HPP
-
-#include "components/component.hpp"
-#include <SFML/Graphics.hpp>
-#include <memory>
-#include <unordered_map>
-#include <vector>
-
-namespace hmi3 {
-
-class Container : public Component {
-public:
-    explicit Container(std::string id = "container");
-    virtual ~Container() = default;
-
-    void update(float dt) override;
-    void handleEvent(const sf::Event& event) override;
-    void draw(sf::RenderTarget& target, sf::RenderStates states = sf::RenderStates::Default) const override;
-    
-    void addComponent(std::shared_ptr<Component> component);
-    bool removeComponent(const std::string& id);
-    std::shared_ptr<Component> getComponent(const std::string& id) const;
-    void setSize(const sf::Vector2f& size) { m_size = size; }
-    void setBackgroundColor(const sf::Color& color) { m_backgroundColor = color; }
-    void clear();
-    size_t getComponentCount() const { return m_components.size(); }
-
-private:
-    sf::Vector2f m_size;
-    sf::Color m_backgroundColor;
-    std::vector<std::shared_ptr<Component>> m_components;
-    std::unordered_map<std::string, std::shared_ptr<Component>> m_componentMap;
-};
-
-} // namespace hmi3
-
+#ifndef HMI3_CONTAINER_HPP
+#define HMI3_CONTAINER_HPP
+
+#include "components/component.hpp"
+#include "render_batch.hpp"
+#include "slot_map.hpp"
+#include "spatial_grid.hpp"
+#include "timing_wheel.hpp"
+#include "worker_pool.hpp"
+#include <SFML/Graphics.hpp>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace hmi3 {
+
+class SessionRecorder;
+
+class Container : public Component {
+public:
+    explicit Container(std::string id = "container");
+    virtual ~Container();
+
+    // Обновляются только бодрствующие компоненты и те, чей таймер истёк
+    // (см. Component::sleep). Сначала update() потокобезопасных (в пуле, если
+    // задан), затем их commitUpdate() и update() остальных - в порядке отрисовки
+    void update(float dt) override;
+    // События указателя получает верхний компонент под курсором (и компоненты
+    // без границ), а после нажатия - захвативший указатель компонент.
+    // Клавиатура идёт компоненту с фокусом, остальные события - всем видимым
+    void handleEvent(const sf::Event& event) override;
+    void onHoverChanged(bool hovered) override;
+    void onFocusChanged(bool focused) override;
+    // Компоненты с границами вне вида цели не рисуются
+    void draw(sf::RenderTarget& target, sf::RenderStates states = sf::RenderStates::Default) const override;
+    // Фон и дочерние компоненты в порядке отрисовки; вложенные контейнеры
+    // раскрываются в тот же список. Если у batch задана видимая область,
+    // компоненты вне её пропускаются - через пространственный индекс,
+    // когда видна малая часть. Контейнер, который нельзя раскрыть
+    // (isFlattenable), рисуется родителем через draw()
+    bool appendGeometry(RenderBatch& batch) const override;
+    // Наследник с собственным draw() раскрывать нельзя - переопределение
+    // было бы пропущено. Поэтому по умолчанию раскрывается только сам
+    // Container; наследник, который рисует как базовый класс, возвращает true
+    virtual bool isFlattenable() const;
+    // background, cache, scroll, zoom и clip вдобавок к свойствам Component
+    bool applyProperty(std::string_view name, std::string_view value) override;
+
+    // Недействительный дескриптор, если компонент с таким id уже есть
+    ComponentHandle addComponent(std::shared_ptr<Component> component);
+    bool removeComponent(ComponentHandle handle);
+    // Ставит component на место прежнего с тем же дескриптором и порядком
+    // отрисовки и возвращает прежний - например, чтобы освободить его вне
+    // потока отрисовки. nullptr, если дескриптор недействителен или id
+    // нового занят другим компонентом
+    std::shared_ptr<Component> replaceComponent(ComponentHandle handle, std::shared_ptr<Component> component);
+    Component* getComponent(ComponentHandle handle) const;
+    // Доступ по строковому id - надстройка над дескрипторами
+    bool removeComponent(const std::string& id);
+    std::shared_ptr<Component> getComponent(const std::string& id) const;
+    ComponentHandle getHandle(const std::string& id) const;
+    // Без хэширования строки - для частых обращений по заранее полученному атому
+    ComponentHandle getHandle(Atom id) const;
+    // Компонент по пути из id через '/' ("area1/pump3/status") в любом месте
+    // поддерева. Корень дерева держит индекс всех путей и отвечает за одно
+    // хэширование пути; вложенный контейнер спускается по уровням
+    Component* findByPath(std::string_view path) const;
+    // Переносит компонент поверх остальных, дескриптор сохраняется
+    bool bringToFront(ComponentHandle handle);
+    // Верхний видимый компонент с границами, содержащими точку
+    Component* hitTest(const sf::Vector2f& point) const;
+    // Фокус получает компонент под курсором при нажатии кнопки мыши.
+    // Вложенный контейнер с фокусом передаёт клавиатуру своему фокусу;
+    // пока фокуса нет, клавиатура рассылается всем видимым компонентам.
+    // Недействительный дескриптор снимает фокус
+    bool setFocus(ComponentHandle handle);
+    Component* getFocus() const { return getComponent(m_focus); }
+    Component* getHovered() const { return getComponent(m_hovered); }
+    // Компонент, получивший нажатие: движения и отпускание кнопки идут ему,
+    // даже если курсор ушёл за его границы
+    Component* getPointerCapture() const { return getComponent(m_capture); }
+    // Движения мыши копятся, и компоненты получают только последнее - перед
+    // событием другого типа или в начале update(). Включается у корня
+    void setMotionCoalescing(bool enabled);
+    bool isMotionCoalescing() const { return m_coalesceMotion; }
+    void flushPendingMotion();
+    void setBackgroundColor(const sf::Color& color);
+    // Прокрутка и масштаб содержимого. Компоненты остаются в своих
+    // координатах; точка position + scroll выводится в левый верхний угол
+    // контейнера с увеличением zoom. События указателя пересчитываются
+    // обратно, hitTest() принимает координаты содержимого
+    void setScroll(const sf::Vector2f& scroll);
+    const sf::Vector2f& getScroll() const { return m_scroll; }
+    void setZoom(float zoom);
+    float getZoom() const { return m_zoom; }
+    // Из координат содержимого в координаты родителя
+    sf::Transform getContentTransform() const;
+    // Компоненты обрезаются по границам контейнера, указатель вне границ их
+    // не задевает. Отсечение вложенных контейнеров пересекается
+    void setClipEnabled(bool enabled);
+    bool isClipEnabled() const { return m_clipEnabled; }
+    // Пул для параллельной фазы update(); без своего берётся пул предка.
+    // Пул должен жить дольше контейнера
+    void setWorkerPool(WorkerPool* pool) { m_workerPool = pool; }
+    WorkerPool* getWorkerPool() const;
+    // Всё, что получают handleEvent() и update() этого контейнера (обычно
+    // корня), пишется в рекордер до обработки. Рекордер должен жить дольше
+    // контейнера; nullptr выключает запись
+    void setSessionRecorder(SessionRecorder* recorder) { m_sessionRecorder = recorder; }
+    // Статичное поддерево рисуется в RenderTexture и выводится одним
+    // текстурированным прямоугольником, пока что-то в нём не изменится.
+    // Кэшируется только область контейнера (позиция и размер)
+    void setCacheEnabled(bool enabled);
+    bool isCacheEnabled() const { return m_cacheEnabled; }
+    // Сколько раз кэш перерисовывался
+    std::size_t getCacheRenderCount() const { return m_cacheRenderCount; }
+    void clear();
+    size_t getComponentCount() const { return m_components.size(); }
+    // Часы контейнера - сумма dt его update(), по ним идут таймеры компонентов
+    double getTime() const { return m_time; }
+    // Компоненты, обновляемые каждый кадр, и ждущие таймеры
+    std::size_t getAwakeCount() const { return m_awake.size(); }
+    std::size_t getTimerCount() const { return m_timers.size(); }
+
+    // Обход в порядке отрисовки без копирования shared_ptr. Компонент,
+    // удалённый в f, освобождается после обхода; добавленные в f компоненты
+    // в этот обход не попадают
+    template <typename F>
+    void forEachComponent(F&& f) const {
+        m_components.forEach([&f](ComponentHandle, const std::shared_ptr<Component>& component) {
+            f(*component);
+        });
+    }
+
+private:
+    friend class Component;
+
+    void onChildChanged(Component& child);
+    void scheduleChild(Component& child, double delay);
+    void dispatchEvent(const sf::Event& event);
+    void setHovered(Component* component);
+    void releaseChild(Component& child);
+    // Снимает дочерний компонент со всех индексов, слот не трогает
+    void detachChild(Component& child);
+    Container& getRootContainer();
+    void indexSubtree(const Container& root, Component& component) const;
+    void unindexSubtree(const Container& root, Component& component) const;
+    void rebuildPathIndex() const;
+    void clearDirty() const override;
+    // Кэш или содержимое контейнера - для draw() и appendGeometry()
+    void appendSelf(RenderBatch& batch) const;
+    void appendContents(RenderBatch& batch) const;
+    void appendChildren(RenderBatch& batch) const;
+    bool hasContentLayer() const;
+    bool refreshCache() const;
+
+    sf::Color m_backgroundColor;
+    sf::Vector2f m_scroll;
+    float m_zoom = 1.0f;
+    bool m_clipEnabled = false;
+    SlotMap<std::shared_ptr<Component>> m_components;
+    std::unordered_map<Atom, ComponentHandle> m_componentMap;
+    // Только у корня: путь -> компонент всего дерева. Ключи ссылаются на
+    // Component::m_path. Отсоединённое поддерево перестраивает индекс лениво
+    mutable std::unordered_map<std::string_view, Component*> m_pathIndex;
+    mutable bool m_pathIndexStale = false;
+    SpatialGrid m_spatialIndex;
+    // Видимые компоненты без границ в порядке отрисовки
+    std::map<std::uint64_t, Component*> m_unbounded;
+    // Вложенные контейнеры без отсечения: дети могут выходить за их
+    // границы, поэтому по границам они не отсекаются
+    std::map<std::uint64_t, Component*> m_unclipped;
+    std::uint64_t m_nextOrder = 0;
+    mutable std::vector<Component*> m_hits;
+    // Видимые компоненты кадра, отобранные индексом
+    mutable std::vector<Component*> m_drawList;
+    WorkerPool* m_workerPool = nullptr;
+    SessionRecorder* m_sessionRecorder = nullptr;
+
+    struct ScheduledWake {
+        ComponentHandle handle;
+        std::uint32_t ticket;
+    };
+    struct DueUpdate {
+        Component* component;
+        ComponentHandle handle;
+    };
+
+    double m_time = 0.0;
+    // Бодрствующие компоненты без интервала в порядке отрисовки
+    std::map<std::uint64_t, Component*> m_awake;
+    // sleepFor() и тики по интервалу
+    TimingWheel<ScheduledWake> m_timers;
+    std::vector<ScheduledWake> m_expiredTimers;
+    // Обновляемые в текущем кадре, в порядке отрисовки
+    std::vector<DueUpdate> m_dueUpdates;
+    // Тики по интервалу этого кадра: после update() снова встают в колесо
+    std::vector<ScheduledWake> m_periodicUpdates;
+    // Растёт при каждом удалении: пока не менялся, указатели в
+    // m_dueUpdates действительны и дескрипторы можно не разрешать
+    std::uint64_t m_removalCount = 0;
+    std::vector<Component*> m_parallelUpdates;
+    ComponentHandle m_focus;
+    ComponentHandle m_hovered;
+    ComponentHandle m_capture;
+    sf::Mouse::Button m_captureButton = sf::Mouse::Button::Left;
+    bool m_coalesceMotion = false;
+    std::optional<sf::Vector2i> m_pendingMotion;
+    mutable RenderBatch m_renderBatch;
+    bool m_cacheEnabled = false;
+    mutable std::unique_ptr<sf::RenderTexture> m_cache;
+    mutable RenderBatch m_cacheBatch;
+    mutable std::size_t m_cacheRenderCount = 0;
+};
+
+} // namespace hmi3
+
 #endif // HMI3_CONTAINER_HPP
\ No newline at end of file
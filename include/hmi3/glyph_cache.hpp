@@ -0,0 +1,49 @@
+#ifndef HMI3_GLYPH_CACHE_HPP
+#define HMI3_GLYPH_CACHE_HPP
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <memory>
+#include <string>
+
+namespace hmi3 {
+
+// Готовые квады печатных символов ASCII для одного шрифта и размера. Кэш
+// общий для всех компонентов с этим шрифтом: все глифы заносятся в текстуру
+// шрифта сразу при создании, поэтому текстура потом не меняется и текст
+// разных компонентов рисуется одним пакетом.
+class GlyphCache {
+public:
+    struct Quad {
+        // Относительно точки на базовой линии
+        sf::FloatRect bounds;
+        sf::FloatRect textureRect;
+        float advance = 0.0f;
+    };
+
+    // Один кэш на пару (шрифт, размер), пока на него есть ссылки
+    static std::shared_ptr<const GlyphCache> get(std::shared_ptr<const sf::Font> font, unsigned int characterSize);
+    // Шрифт из файла, один объект на путь; nullptr - файл не открылся
+    static std::shared_ptr<const sf::Font> loadFont(const std::string& path);
+
+    GlyphCache(std::shared_ptr<const sf::Font> font, unsigned int characterSize);
+
+    // Непечатные и не-ASCII символы - как '?'
+    const Quad& glyph(char c) const;
+    const sf::Texture& getTexture() const { return m_font->getTexture(m_characterSize); }
+    unsigned int getCharacterSize() const { return m_characterSize; }
+    float getLineSpacing() const { return m_lineSpacing; }
+
+private:
+    static constexpr char kFirstChar = ' ';
+    static constexpr char kLastChar = '~';
+
+    std::shared_ptr<const sf::Font> m_font;
+    unsigned int m_characterSize;
+    float m_lineSpacing;
+    std::array<Quad, kLastChar - kFirstChar + 1> m_quads;
+};
+
+} // namespace hmi3
+
+#endif // HMI3_GLYPH_CACHE_HPP
\ No newline at end of file
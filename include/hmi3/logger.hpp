@@ -0,0 +1,98 @@
+#ifndef HMI3_LOGGER_HPP
+#define HMI3_LOGGER_HPP
+
+#include "mpsc_queue.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace hmi3 {
+
+enum class LogLevel {
+    Debug,
+    Info,
+    Warning,
+    Error,
+    Off
+};
+
+const char* logLevelName(LogLevel level);
+
+// Журнал сообщений с выводом в отдельном потоке. log() только кладёт
+// запись в ограниченную очередь без блокировок: сетевой поток и цикл
+// отрисовки не ждут консоли. При переполненной очереди запись теряется и
+// учитывается в getDroppedCount(). Сообщения ниже уровня отсекаются
+// макросами HMI3_LOG_* ещё до форматирования.
+class Logger {
+public:
+    using Sink = std::function<void(LogLevel level, const std::string& message)>;
+
+    static constexpr std::size_t kQueueCapacity = 1024;
+
+    static Logger& instance();
+    ~Logger();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    void setLevel(LogLevel level) { m_level.store(level, std::memory_order_relaxed); }
+    LogLevel getLevel() const { return m_level.load(std::memory_order_relaxed); }
+    bool isEnabled(LogLevel level) const {
+        return level != LogLevel::Off && level >= m_level.load(std::memory_order_relaxed);
+    }
+
+    void log(LogLevel level, std::string message);
+    // Ждёт, пока выведется всё, что уже стоит в очереди
+    void flush();
+    // Вызывается в потоке журнала; по умолчанию Debug и Info идут в stdout,
+    // остальное - в stderr. Пустой sink восстанавливает вывод по умолчанию
+    void setSink(Sink sink);
+    std::uint64_t getDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Record {
+        LogLevel level = LogLevel::Info;
+        std::string message;
+    };
+
+    Logger();
+    void writerLoop();
+
+    BoundedMpscQueue<Record> m_queue;
+    std::atomic<LogLevel> m_level{LogLevel::Info};
+    std::atomic<std::uint64_t> m_dropped{0};
+    std::atomic<std::uint64_t> m_pushed{0};
+    std::atomic<std::uint64_t> m_written{0};
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_flushed;
+    Sink m_sink;
+    bool m_stopping = false;
+    std::thread m_writer;
+};
+
+} // namespace hmi3
+
+// Аргумент - цепочка для operator<<: HMI3_LOG_INFO("port " << port)
+#define HMI3_LOG(level, message)                                           \
+    do {                                                                   \
+        if (::hmi3::Logger::instance().isEnabled(level)) {                 \
+            std::ostringstream hmi3LogStream;                              \
+            hmi3LogStream << message;                                      \
+            ::hmi3::Logger::instance().log(level, hmi3LogStream.str());    \
+        }                                                                  \
+    } while (false)
+
+#define HMI3_LOG_DEBUG(message) HMI3_LOG(::hmi3::LogLevel::Debug, message)
+#define HMI3_LOG_INFO(message) HMI3_LOG(::hmi3::LogLevel::Info, message)
+#define HMI3_LOG_WARNING(message) HMI3_LOG(::hmi3::LogLevel::Warning, message)
+#define HMI3_LOG_ERROR(message) HMI3_LOG(::hmi3::LogLevel::Error, message)
+
+#endif // HMI3_LOGGER_HPP
\ No newline at end of file
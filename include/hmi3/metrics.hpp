@@ -0,0 +1,54 @@
+#ifndef HMI3_METRICS_HPP
+#define HMI3_METRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace hmi3 {
+
+// Снимок гистограммы; перцентиль - верхняя граница корзины, не больше max
+struct HistogramSnapshot {
+    std::uint64_t count = 0;
+    std::uint64_t sum = 0;
+    std::uint64_t max = 0;
+    std::vector<std::uint64_t> buckets;
+
+    double mean() const { return count ? static_cast<double>(sum) / static_cast<double>(count) : 0.0; }
+    // fraction от 0 до 1
+    std::uint64_t percentile(double fraction) const;
+};
+
+// Гистограмма без блокировок для записи из горячего пути: значения до 16
+// хранятся точно, дальше каждая степень двойки делится на 8 корзин
+// (погрешность не больше 12.5%). Запись - несколько relaxed-атомиков,
+// снимок может быть чуть несогласован с идущими записями.
+class Histogram {
+public:
+    static constexpr std::size_t kLinearBuckets = 16;
+    static constexpr std::size_t kSubBuckets = 8;
+    static constexpr std::size_t kBucketCount = kLinearBuckets + (64 - 4) * kSubBuckets;
+
+    Histogram() = default;
+    Histogram(const Histogram&) = delete;
+    Histogram& operator=(const Histogram&) = delete;
+
+    void record(std::uint64_t value);
+    HistogramSnapshot snapshot() const;
+    void reset();
+
+    static std::size_t bucketIndex(std::uint64_t value);
+    // Наибольшее значение, попадающее в корзину
+    static std::uint64_t bucketUpperBound(std::size_t index);
+
+private:
+    std::array<std::atomic<std::uint64_t>, kBucketCount> m_buckets{};
+    std::atomic<std::uint64_t> m_sum{0};
+    std::atomic<std::uint64_t> m_max{0};
+};
+
+} // namespace hmi3
+
+#endif // HMI3_METRICS_HPP
\ No newline at end of file
@@ -0,0 +1,89 @@
+#ifndef HMI3_MPSC_QUEUE_HPP
+#define HMI3_MPSC_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace hmi3 {
+
+// Ограниченная очередь без блокировок (схема Вьюкова): ячейки несут номер
+// последовательности, производители захватывают позицию через CAS.
+// Несколько производителей, один потребитель; переполнение - отказ в tryPush.
+template <typename T>
+class BoundedMpscQueue {
+public:
+    explicit BoundedMpscQueue(std::size_t capacity)
+        : m_capacity(capacity > 0 ? capacity : 1)
+        , m_cells(new Cell[m_capacity])
+        , m_enqueuePos(0)
+        , m_dequeuePos(0) {
+        for (std::size_t i = 0; i < m_capacity; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedMpscQueue(const BoundedMpscQueue&) = delete;
+    BoundedMpscQueue& operator=(const BoundedMpscQueue&) = delete;
+
+    // При отказе value остаётся нетронутым
+    bool tryPush(T&& value) {
+        std::size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = m_cells[pos % m_capacity];
+            std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool tryPop(T& value) {
+        std::size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        Cell& cell = m_cells[pos % m_capacity];
+        std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if (static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1) < 0) {
+            return false;
+        }
+
+        value = std::move(cell.value);
+        // Освобождаем ресурсы элемента сразу, а не при следующей записи в ячейку
+        cell.value = T();
+        m_dequeuePos.store(pos + 1, std::memory_order_relaxed);
+        cell.sequence.store(pos + m_capacity, std::memory_order_release);
+        return true;
+    }
+
+    // Приблизительно: производители могут менять очередь параллельно
+    std::size_t size() const {
+        std::size_t enqueued = m_enqueuePos.load(std::memory_order_relaxed);
+        std::size_t dequeued = m_dequeuePos.load(std::memory_order_relaxed);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+    std::size_t capacity() const { return m_capacity; }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    const std::size_t m_capacity;
+    std::unique_ptr<Cell[]> m_cells;
+    alignas(64) std::atomic<std::size_t> m_enqueuePos;
+    alignas(64) std::atomic<std::size_t> m_dequeuePos;
+};
+
+} // namespace hmi3
+
+#endif // HMI3_MPSC_QUEUE_HPP
\ No newline at end of file
@@ -0,0 +1,126 @@
+#ifndef HMI3_PAYLOAD_BUFFER_HPP
+#define HMI3_PAYLOAD_BUFFER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace hmi3 {
+
+namespace detail {
+
+struct PayloadBlock {
+    std::unique_ptr<char[]> storage;
+    std::size_t capacity = 0;
+    std::size_t size = 0;
+    std::atomic<long> references{0};
+};
+
+} // namespace detail
+
+// Пул блоков под полезную нагрузку. Блоки группируются по классам размера
+// (степени двойки), поэтому повторные приёмы проектов не ходят в кучу.
+class PayloadPool {
+public:
+    struct Stats {
+        std::uint64_t allocations = 0;
+        std::uint64_t reuses = 0;
+        std::uint64_t copiedBytes = 0;
+    };
+
+    static PayloadPool& instance();
+
+    detail::PayloadBlock* acquire(std::size_t capacity);
+    void release(detail::PayloadBlock* block);
+    void recordCopy(std::size_t bytes) { m_copiedBytes += bytes; }
+
+    Stats getStats() const;
+    void setRetainLimit(std::size_t bytes);
+    void trim();
+
+private:
+    PayloadPool() = default;
+
+    static std::size_t sizeClass(std::size_t capacity);
+
+    std::size_t m_retainLimit = 64 * 1024 * 1024;
+    std::size_t m_retainedBytes = 0;
+    std::vector<std::vector<detail::PayloadBlock*>> m_freeBlocks;
+    mutable std::mutex m_mutex;
+    std::atomic<std::uint64_t> m_allocations{0};
+    std::atomic<std::uint64_t> m_reuses{0};
+    std::atomic<std::uint64_t> m_copiedBytes{0};
+};
+
+// Неизменяемые данные с разделяемым владением: копирование буфера
+// увеличивает счётчик ссылок, байты не копируются.
+class PayloadBuffer {
+public:
+    PayloadBuffer() = default;
+    PayloadBuffer(const char* text);
+    PayloadBuffer(std::string_view data);
+    PayloadBuffer(const std::string& data) : PayloadBuffer(std::string_view(data)) {}
+    PayloadBuffer(const PayloadBuffer& other);
+    PayloadBuffer(PayloadBuffer&& other) noexcept;
+    PayloadBuffer& operator=(const PayloadBuffer& other);
+    PayloadBuffer& operator=(PayloadBuffer&& other) noexcept;
+    ~PayloadBuffer();
+
+    const char* data() const { return m_block ? m_block->storage.get() : nullptr; }
+    std::size_t size() const { return m_block ? m_block->size : 0; }
+    bool empty() const { return size() == 0; }
+    std::string_view view() const { return std::string_view(data(), size()); }
+    operator std::string_view() const { return view(); }
+    std::string toString() const { return std::string(view()); }
+    long useCount() const { return m_block ? m_block->references.load() : 0; }
+
+private:
+    friend class PayloadWriter;
+    explicit PayloadBuffer(detail::PayloadBlock* block);
+
+    detail::PayloadBlock* m_block = nullptr;
+};
+
+inline bool operator==(const PayloadBuffer& lhs, std::string_view rhs) { return lhs.view() == rhs; }
+inline bool operator==(std::string_view lhs, const PayloadBuffer& rhs) { return lhs == rhs.view(); }
+inline bool operator!=(const PayloadBuffer& lhs, std::string_view rhs) { return !(lhs == rhs); }
+inline bool operator!=(std::string_view lhs, const PayloadBuffer& rhs) { return !(lhs == rhs); }
+
+inline std::ostream& operator<<(std::ostream& stream, const PayloadBuffer& buffer) {
+    return stream << buffer.view();
+}
+
+// Заполняет блок из пула и запечатывает его в PayloadBuffer. При известном
+// размере (sizeHint) блок выделяется один раз и не перекладывается.
+class PayloadWriter {
+public:
+    explicit PayloadWriter(std::size_t sizeHint = 0);
+    PayloadWriter(PayloadWriter&& other) noexcept;
+    PayloadWriter& operator=(PayloadWriter&& other) noexcept;
+    PayloadWriter(const PayloadWriter&) = delete;
+    PayloadWriter& operator=(const PayloadWriter&) = delete;
+    ~PayloadWriter();
+
+    // Свободное место под прямое чтение из сокета; после чтения - commit()
+    char* prepare(std::size_t size);
+    void commit(std::size_t size);
+    void append(const char* data, std::size_t size);
+    std::size_t size() const { return m_block ? m_block->size : 0; }
+    std::size_t capacity() const { return m_block ? m_block->capacity : 0; }
+    PayloadBuffer finish();
+
+private:
+    void reserve(std::size_t capacity);
+
+    detail::PayloadBlock* m_block = nullptr;
+};
+
+} // namespace hmi3
+
+#endif // HMI3_PAYLOAD_BUFFER_HPP
\ No newline at end of file
@@ -0,0 +1,133 @@
+#ifndef HMI3_PROFILER_HPP
+#define HMI3_PROFILER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace hmi3 {
+
+// Профилировщик кадра. Каждый поток пишет интервалы в свой кольцевой буфер
+// (старые записи затираются), сводка и трасса строятся по тому, что в
+// буферах осталось. Контейнер размечает update, handleEvent и отрисовку
+// через HMI3_PROFILE_SCOPE; без HMI3_ENABLE_PROFILER макросы пустые и
+// аргументы не вычисляются.
+class Profiler {
+public:
+    // Последние кадры для перцентилей
+    static constexpr std::size_t frameWindow = 1024;
+    // Интервалов на поток
+    static constexpr std::size_t eventsPerThread = 1 << 15;
+
+    struct FrameStats {
+        std::size_t frames = 0;
+        double p50Ms = 0.0;
+        double p95Ms = 0.0;
+        double p99Ms = 0.0;
+        double maxMs = 0.0;
+    };
+
+    // Суммарное время и число вызовов по категории и имени
+    struct Entry {
+        std::string category;
+        std::string name;
+        std::size_t calls = 0;
+        double totalMs = 0.0;
+        double maxMs = 0.0;
+    };
+
+    static Profiler& instance();
+
+    // Время в наносекундах от запуска профилировщика
+    static std::int64_t now();
+
+    // category - строковый литерал, name обрезается до длины записи
+    void record(const char* category, std::string_view name, std::int64_t start, std::int64_t end);
+    // Отметка конца кадра: время от предыдущей отметки идёт в гистограмму
+    void markFrame();
+    void recordFrame(double milliseconds);
+
+    FrameStats getFrameStats() const;
+    // По убыванию суммарного времени
+    std::vector<Entry> getSummary() const;
+    // JSON формата Chrome trace events (chrome://tracing, Perfetto)
+    void writeChromeTrace(std::ostream& out) const;
+    bool writeChromeTrace(const std::string& path) const;
+    void reset();
+
+private:
+    struct Event {
+        std::int64_t start;
+        std::int64_t duration;
+        const char* category;
+        char name[40];
+    };
+
+    struct ThreadBuffer {
+        explicit ThreadBuffer(std::uint32_t threadId) : id(threadId), events(eventsPerThread) {}
+
+        // Писатель один, замок нужен только против чтения сводки и трассы
+        mutable std::mutex mutex;
+        std::uint32_t id;
+        std::vector<Event> events;
+        std::uint64_t written = 0;
+    };
+
+    Profiler() = default;
+    ThreadBuffer& threadBuffer();
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers() const;
+
+    mutable std::mutex m_mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> m_buffers;
+    double m_frames[frameWindow] = {};
+    std::size_t m_frameCount = 0;
+    std::int64_t m_lastFrame = -1;
+};
+
+// Интервал от конструктора до деструктора; неактивный ничего не пишет.
+// Имя копируется сразу: компонент может удалить себя, пока интервал открыт
+class ProfileScope {
+public:
+    ProfileScope(const char* category, std::string_view name, bool active = true)
+        : m_category(category)
+        , m_length(active ? name.copy(m_name, sizeof(m_name)) : 0)
+        , m_start(active ? Profiler::now() : -1) {}
+    ~ProfileScope() {
+        if (m_start >= 0) {
+            Profiler::instance().record(m_category, std::string_view(m_name, m_length), m_start, Profiler::now());
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* m_category;
+    char m_name[40];
+    std::size_t m_length;
+    std::int64_t m_start;
+};
+
+} // namespace hmi3
+
+#define HMI3_PROFILE_CONCAT_INNER(a, b) a##b
+#define HMI3_PROFILE_CONCAT(a, b) HMI3_PROFILE_CONCAT_INNER(a, b)
+
+#ifdef HMI3_ENABLE_PROFILER
+#define HMI3_PROFILE_SCOPE(category, name) \
+    ::hmi3::ProfileScope HMI3_PROFILE_CONCAT(hmi3ProfileScope, __LINE__)(category, name)
+#define HMI3_PROFILE_SCOPE_IF(active, category, name) \
+    ::hmi3::ProfileScope HMI3_PROFILE_CONCAT(hmi3ProfileScope, __LINE__)(category, name, active)
+#define HMI3_PROFILE_FRAME() ::hmi3::Profiler::instance().markFrame()
+#else
+#define HMI3_PROFILE_SCOPE(category, name) ((void)0)
+#define HMI3_PROFILE_SCOPE_IF(active, category, name) ((void)0)
+#define HMI3_PROFILE_FRAME() ((void)0)
+#endif
+
+#endif // HMI3_PROFILER_HPP
\ No newline at end of file
@@ -0,0 +1,44 @@
+#ifndef HMI3_PROJECT_DESCRIPTION_HPP
+#define HMI3_PROJECT_DESCRIPTION_HPP
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace hmi3 {
+
+using PropertyList = std::vector<std::pair<std::string, std::string>>;
+
+// Описание одного компонента проекта
+struct ComponentSpec {
+    std::string type;
+    std::string id;
+    // Пусто - корневой контейнер
+    std::string parent;
+    // В порядке файла; parent сюда не входит
+    PropertyList properties;
+
+    const std::string* findProperty(const std::string& name) const;
+};
+
+// Текстовый формат проекта - по компоненту на строку, порядок строк задаёт
+// порядок отрисовки внутри родителя, родитель объявляется раньше детей:
+//
+//   # комментарий
+//   root background=40,40,80
+//   container panel position=40,510 size=690,44 cache=1
+//   rectangle lamp1 parent=panel position=50,520 size=24,24 fill=0,255,0
+//
+// Значения с пробелами берутся в кавычки: text="Насос 1"
+struct ProjectDescription {
+    PropertyList rootProperties;
+    std::vector<ComponentSpec> components;
+};
+
+// false и текст ошибки с номером строки, если описание некорректно
+bool parseProject(std::string_view text, ProjectDescription& description, std::string& error);
+
+} // namespace hmi3
+
+#endif // HMI3_PROJECT_DESCRIPTION_HPP
\ No newline at end of file
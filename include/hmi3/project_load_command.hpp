@@ -0,0 +1,26 @@
+#ifndef HMI3_PROJECT_LOAD_COMMAND_HPP
+#define HMI3_PROJECT_LOAD_COMMAND_HPP
+
+#include "compression.hpp"
+#include "payload_buffer.hpp"
+#include <cstdint>
+#include <string>
+
+namespace hmi3 {
+
+struct ProjectLoadCommand {
+    std::string projectName;
+    PayloadBuffer projectData;
+    std::string checksum;
+    uint32_t version;
+    bool forceLoad;
+    // Отправитель сжимает нагрузку этим способом; у принятой команды -
+    // способ, которым она пришла, projectData уже распакованы
+    PayloadCompression compression;
+
+    ProjectLoadCommand() : version(1), forceLoad(false), compression(PayloadCompression::None) {}
+};
+
+} // namespace hmi3
+
+#endif // HMI3_PROJECT_LOAD_COMMAND_HPP
\ No newline at end of file
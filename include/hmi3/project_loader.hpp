@@ -0,0 +1,85 @@
+#ifndef HMI3_PROJECT_LOADER_HPP
+#define HMI3_PROJECT_LOADER_HPP
+
+#include "compiled_project.hpp"
+#include "component_factory.hpp"
+#include "container.hpp"
+#include "project_description.hpp"
+#include "project_load_command.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace hmi3 {
+
+// Применяет проект к живому дереву контейнеров. Повторная загрузка той же
+// версии сравнивается с предыдущим описанием по id компонентов: создаются,
+// удаляются, переносятся и получают новые свойства только изменившиеся
+// компоненты, остальные сохраняют объект и состояние. forceLoad или новая
+// версия проекта - полная пересборка. Компоненты, добавленные в корень
+// не через загрузчик, не трогаются.
+//
+// Скомпилированный проект (CompiledProject) всегда строится заново, прямо
+// из отображения файла; следующая текстовая загрузка после него - тоже
+// полная пересборка.
+class ProjectLoader {
+public:
+    struct Result {
+        bool success = false;
+        bool fullRebuild = false;
+        std::size_t created = 0;
+        std::size_t removed = 0;
+        std::size_t moved = 0;
+        std::size_t updated = 0;
+        std::string error;
+        // Неизвестные свойства и неверные значения не прерывают загрузку
+        std::vector<std::string> warnings;
+    };
+
+    explicit ProjectLoader(ComponentFactory factory = ComponentFactory::withBuiltins());
+
+    // Команда может нести как текст, так и скомпилированный проект
+    Result apply(Container& root, const ProjectLoadCommand& command);
+    Result apply(Container& root, ProjectDescription description, std::uint32_t version, bool forceLoad);
+    Result apply(Container& root, const CompiledProject& project);
+
+    ComponentFactory& getFactory() { return m_factory; }
+    // Компонент, созданный загрузчиком, по id
+    std::shared_ptr<Component> findComponent(const std::string& id) const;
+
+private:
+    struct Node {
+        ComponentSpec spec;
+        std::weak_ptr<Component> component;
+        // Место в описании - для проверки, не сменился ли порядок
+        std::size_t order = 0;
+        std::uint64_t generation = 0;
+    };
+
+    struct PlanEntry {
+        ComponentSpec* spec;
+        std::shared_ptr<Component> component;
+        Container* parent;
+        Node* previous;
+    };
+
+    static void applyProperties(Component& component, const ComponentSpec& spec, const Node* previous,
+                                Result& result);
+    // Снимает с дерева компоненты узлов другого поколения, возвращает их число
+    std::size_t removeStaleNodes(std::uint64_t generation);
+    void arrangeChildren(Container& parent, const std::vector<const PlanEntry*>& children, Result& result);
+
+    ComponentFactory m_factory;
+    std::unordered_map<std::string, Node> m_nodes;
+    PropertyList m_rootProperties;
+    Container* m_root = nullptr;
+    std::uint32_t m_version = 0;
+    std::uint64_t m_generation = 0;
+};
+
+} // namespace hmi3
+
+#endif // HMI3_PROJECT_LOADER_HPP
\ No newline at end of file
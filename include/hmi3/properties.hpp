@@ -0,0 +1,22 @@
+#ifndef HMI3_PROPERTIES_HPP
+#define HMI3_PROPERTIES_HPP
+
+#include <SFML/Graphics.hpp>
+#include <string_view>
+
+namespace hmi3 {
+namespace properties {
+
+// Текстовые значения свойств из файлов проекта.
+// При ошибке возвращают false и не трогают результат
+bool parseFloat(std::string_view text, float& value);
+bool parseBool(std::string_view text, bool& value);
+// "x,y"
+bool parseVector(std::string_view text, sf::Vector2f& value);
+// "r,g,b" или "r,g,b,a", 0..255
+bool parseColor(std::string_view text, sf::Color& value);
+
+} // namespace properties
+} // namespace hmi3
+
+#endif // HMI3_PROPERTIES_HPP
\ No newline at end of file
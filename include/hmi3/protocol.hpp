@@ -0,0 +1,143 @@
+#ifndef HMI3_PROTOCOL_HPP
+#define HMI3_PROTOCOL_HPP
+
+#include "compression.hpp"
+#include "payload_buffer.hpp"
+#include "project_load_command.hpp"
+#include <SFML/Network.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace hmi3 {
+
+// Кадр команды (все числа little-endian):
+//   0  4  магия "HMI3"
+//   4  1  версия протокола
+//   5  1  флаги (FrameFlags)
+//   6  2  длина имени проекта
+//   8  4  версия проекта
+//  12  4  CRC-32 полезной нагрузки
+//  16  8  длина полезной нагрузки
+//  24     имя проекта, затем полезная нагрузка
+// Длина и CRC-32 относятся к байтам в сети, то есть к сжатой нагрузке.
+// Сжатие появилось во второй версии; кадр без сжатия по-прежнему
+// помечается первой, чтобы его принимали и старые панели.
+namespace protocol {
+
+constexpr char kMagic[4] = {'H', 'M', 'I', '3'};
+constexpr std::uint8_t kVersion = 2;
+constexpr std::uint8_t kMinVersion = 1;
+constexpr std::size_t kHeaderSize = 24;
+constexpr std::size_t kMaxNameLength = 1024;
+constexpr std::uint64_t kDefaultMaxPayloadSize = 256ull * 1024 * 1024;
+
+enum FrameFlags : std::uint8_t {
+    FlagForceLoad = 1 << 0,
+    // Биты 1-2 - PayloadCompression
+    FlagCompressionMask = 3 << 1
+};
+
+constexpr int kCompressionShift = 1;
+
+} // namespace protocol
+
+std::uint32_t crc32(const void* data, std::size_t size, std::uint32_t crc = 0);
+
+// Нагрузка в том виде, в каком она уходит в сеть: сжатая способом
+// command.compression или сами projectData без копирования.
+// false - сжать не удалось, кадр отправлять нельзя
+bool encodeFramePayload(const ProjectLoadCommand& command, PayloadBuffer& payload, std::string& error);
+std::string encodeFrameHeader(const ProjectLoadCommand& command, std::string_view payload);
+// Пустая строка - нагрузку не удалось сжать
+std::string encodeFrameHeader(const ProjectLoadCommand& command);
+std::string encodeFrame(const ProjectLoadCommand& command);
+// Status::Error без отправки, если нагрузку не удалось сжать
+sf::Socket::Status sendFrame(sf::TcpSocket& socket, const ProjectLoadCommand& command);
+
+// Инкрементальный разбор потока кадров: байты можно подавать любыми порциями,
+// feed() останавливается на границе кадра, чтобы вызывающий забрал команду.
+//
+// Сжатая нагрузка распаковывается по мере прихода: окно под чтение из сокета
+// тогда - небольшой промежуточный буфер, а распакованное сразу ложится в блок
+// команды. Повреждённый сжатый поток или неизвестный способ сжатия
+// отбрасывают только этот кадр.
+class FrameParser {
+public:
+    enum class Result {
+        NeedMoreData,
+        FrameReady,
+        FrameRejected,
+        ProtocolError
+    };
+
+    // Сведения о последнем принятом кадре
+    struct FrameStats {
+        PayloadCompression compression = PayloadCompression::None;
+        std::uint64_t wireBytes = 0;
+        std::uint64_t payloadBytes = 0;
+        // Время внутри распаковщика
+        double decodeSeconds = 0.0;
+        // Наибольший объём памяти под кадр: блок результата, промежуточный
+        // буфер и буферы распаковщика
+        std::size_t peakMemory = 0;
+    };
+
+    // Промежуточный буфер под сжатые байты при прямом чтении из сокета
+    static constexpr std::size_t kStagingSize = 64 * 1024;
+    // Сколько памяти под нагрузку выделяется по одному заголовку; дальше
+    // блок растёт по мере прихода байт
+    static constexpr std::size_t kMaxPresize = 1024 * 1024;
+
+    // Предел действует и на распакованный размер
+    explicit FrameParser(std::uint64_t maxPayloadSize = protocol::kDefaultMaxPayloadSize);
+
+    Result feed(const char* data, std::size_t size, std::size_t& consumed);
+
+    // Окно под прямое чтение нагрузки из сокета, минуя промежуточный буфер.
+    // Пока разбирается заголовок, окно пустое.
+    char* payloadWindow(std::size_t& size);
+    Result commitPayload(std::size_t size);
+    ProjectLoadCommand takeCommand();
+    const std::string& getError() const { return m_error; }
+    const FrameStats& getFrameStats() const { return m_stats; }
+    bool isIdle() const { return m_state == State::Header && m_headerSize == 0; }
+    void reset();
+
+private:
+    enum class State {
+        Header,
+        Name,
+        Payload,
+        Error
+    };
+
+    Result parseHeader();
+    void consumePayload(const char* data, std::size_t size);
+    Result finishFrame();
+
+    std::uint64_t m_maxPayloadSize;
+    State m_state;
+    char m_header[protocol::kHeaderSize];
+    std::size_t m_headerSize;
+    std::size_t m_nameLength;
+    std::uint64_t m_payloadLength;
+    // Байт нагрузки, пришедших из сети
+    std::uint64_t m_received;
+    std::uint32_t m_expectedChecksum;
+    std::uint32_t m_checksum;
+    PayloadWriter m_payload;
+    std::unique_ptr<StreamDecompressor> m_decoder;
+    std::vector<char> m_staging;
+    // Причина, по которой кадр дочитывается без распаковки и отбрасывается
+    std::string m_discardReason;
+    ProjectLoadCommand m_command;
+    FrameStats m_stats;
+    std::string m_error;
+};
+
+} // namespace hmi3
+
+#endif // HMI3_PROTOCOL_HPP
\ No newline at end of file
@@ -0,0 +1,82 @@
+#ifndef HMI3_RENDER_BATCH_HPP
+#define HMI3_RENDER_BATCH_HPP
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+namespace hmi3 {
+
+// Список отрисовки кадра. Геометрия подряд идущих компонентов с одинаковой
+// текстурой и режимом смешивания сливается в один VertexArray (треугольники),
+// остальные компоненты рисуются своим draw() на своём месте в порядке.
+// Слои (pushLayer) задают преобразование и отсечение ножницами для всего,
+// что добавлено внутри них; пакеты разных слоёв не сливаются.
+class RenderBatch {
+public:
+    // Массивы вершин переиспользуются между кадрами
+    void clear();
+
+    // Треугольники текущего пакета; новый пакет - только при смене состояния
+    sf::VertexArray& geometry(const sf::Texture* texture = nullptr,
+                              const sf::BlendMode& blendMode = sf::BlendAlpha);
+    void appendRect(const sf::FloatRect& rect, const sf::Color& color);
+    void appendDrawable(const sf::Drawable& drawable);
+
+    // Геометрия до popLayer() рисуется с transform поверх внешних слоёв.
+    // clip задаётся в координатах до transform и пересекается с отсечением
+    // внешних слоёв
+    void pushLayer(const sf::Transform& transform, const std::optional<sf::FloatRect>& clip);
+    void popLayer();
+    // Видимая область цели в координатах корня; без неё ничего не отсекается
+    void setVisibleArea(const sf::FloatRect& area);
+    // Видимая область в координатах текущего слоя с учётом его отсечения -
+    // компоненты вне её можно не добавлять
+    const std::optional<sf::FloatRect>& getVisibleArea() const { return m_layers[m_layer].visible; }
+
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const;
+
+    std::size_t getDrawCallCount() const { return m_entries.size(); }
+    std::size_t getBatchCount() const { return m_usedBatches; }
+    std::size_t getVertexCount() const;
+    std::size_t getLayerCount() const { return m_layers.size(); }
+
+private:
+    struct Batch {
+        const sf::Texture* texture = nullptr;
+        sf::BlendMode blendMode;
+        std::size_t layer = 0;
+        sf::VertexArray vertices{sf::PrimitiveType::Triangles};
+    };
+
+    // drawable == nullptr - пакет с индексом batch
+    struct Entry {
+        const sf::Drawable* drawable;
+        std::size_t batch;
+        std::size_t layer;
+    };
+
+    // Преобразование и отсечение - уже сведённые с внешними слоями, в
+    // координатах корня; видимая область - в координатах слоя
+    struct Layer {
+        sf::Transform transform;
+        std::optional<sf::FloatRect> clip;
+        std::optional<sf::FloatRect> visible;
+        std::size_t parent = 0;
+    };
+
+    void applyClip(sf::RenderTarget& target, const sf::View& view, const sf::Transform& transform,
+                   const std::optional<sf::FloatRect>& clip) const;
+
+    std::vector<Batch> m_batches;
+    std::size_t m_usedBatches = 0;
+    std::vector<Entry> m_entries;
+    // Нулевой слой - корень без преобразования и отсечения
+    std::vector<Layer> m_layers{Layer{}};
+    std::size_t m_layer = 0;
+};
+
+} // namespace hmi3
+
+#endif // HMI3_RENDER_BATCH_HPP
\ No newline at end of file
@@ -0,0 +1,93 @@
+#ifndef HMI3_SCENE_STAGER_HPP
+#define HMI3_SCENE_STAGER_HPP
+
+#include "component_factory.hpp"
+#include "container.hpp"
+#include "project_load_command.hpp"
+#include "project_loader.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace hmi3 {
+
+// Сборка проекта вне потока отрисовки. Фоновый поток строит из команды
+// новое дерево целиком - с компонентами, шрифтами и текстурами - и
+// публикует готовую сцену одной атомарной заменой указателя. Поток
+// отрисовки забирает её через acquire() между кадрами и подменяет своё
+// поддерево (Container::replaceComponent), а прежнее отдаёт в retire():
+// его деструкторы тоже выполняются в фоновом потоке.
+//
+// Каждая сборка - полная: состояние компонентов прежней сцены не
+// переносится. Пока сборка идёт, новая команда заменяет ещё не начатую,
+// а сцена, которую так и не забрали, уступает более свежей.
+class SceneStager {
+public:
+    struct Scene {
+        // Без родителя; поток отрисовки вставляет его в своё дерево
+        std::shared_ptr<Container> root;
+        // Загрузчик, построивший root: годится для последующих частичных
+        // перезагрузок уже в потоке отрисовки
+        std::unique_ptr<ProjectLoader> loader;
+        ProjectLoadCommand command;
+        ProjectLoader::Result result;
+        double buildSeconds = 0.0;
+    };
+
+    struct Stats {
+        std::uint64_t submitted = 0;
+        std::uint64_t built = 0;
+        std::uint64_t failed = 0;
+        // Заменены новой командой до начала сборки или новой сценой до acquire()
+        std::uint64_t superseded = 0;
+        std::uint64_t retired = 0;
+    };
+
+    explicit SceneStager(ComponentFactory factory = ComponentFactory::withBuiltins(), std::string rootId = "project");
+    // Несобранные команды отбрасываются, отданное в retire() освобождается
+    ~SceneStager();
+
+    SceneStager(const SceneStager&) = delete;
+    SceneStager& operator=(const SceneStager&) = delete;
+
+    // Из любого потока
+    void submit(ProjectLoadCommand command);
+    // Готовая сцена или nullptr; не ждёт фоновый поток. Неудачная сборка
+    // тоже публикуется - с root == nullptr и ошибкой в result
+    std::shared_ptr<Scene> acquire();
+    // Освобождает объект в фоновом потоке
+    void retire(std::shared_ptr<void> garbage);
+    // Ждёт, пока не останется команд, сборок и мусора; для тестов и выхода
+    void waitIdle();
+
+    Stats getStats() const;
+
+private:
+    void workerLoop();
+    std::shared_ptr<Scene> build(ProjectLoadCommand command);
+
+    ComponentFactory m_factory;
+    std::string m_rootId;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_idle;
+    std::optional<ProjectLoadCommand> m_request;
+    std::vector<std::shared_ptr<void>> m_garbage;
+    bool m_busy = false;
+    bool m_stopping = false;
+    Stats m_stats;
+
+    // Читается потоком отрисовки только через std::atomic_exchange
+    std::shared_ptr<Scene> m_ready;
+    std::thread m_worker;
+};
+
+} // namespace hmi3
+
+#endif // HMI3_SCENE_STAGER_HPP
\ No newline at end of file
@@ -0,0 +1,116 @@
+#ifndef HMI3_SESSION_RECORDER_HPP
+#define HMI3_SESSION_RECORDER_HPP
+
+#include "project_load_command.hpp"
+#include <SFML/Window.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace hmi3 {
+
+// Запись сеанса панели для воспроизведения (session_replayer.hpp): события,
+// переданные корневому контейнеру, dt его update() и команды, вышедшие из
+// приёмника, с отметками времени. Файл (little-endian):
+//   0  4  магия "HMS1"
+//   4     записи: тип (1), время от начала записи в нс (8), длина тела (4),
+//         тело
+// Тела:
+//   Event    источник (1): 0 - ввод, дальше encodeInputEvent; 1 - окно,
+//            дальше вид (1), ширина (4), высота (4)
+//   Update   dt (float, 4)
+//   Command  версия (4), forceLoad (1), сжатие (1), длина имени (2), имя,
+//            данные проекта
+//   Scene    как Command: команда, чья сцена подменена в этом кадре
+// Недописанная последняя запись (запись оборвалась) при чтении отбрасывается.
+//
+// Контейнер и приёмник пишут сами, если им задан рекордер
+// (Container::setSessionRecorder, AbstractCommandReceiver::setSessionRecorder).
+// Приложение, которое собирает проект вне потока отрисовки (SceneStager),
+// само пишет recordScene() в кадре, где подменяет сцену: команда приходит
+// раньше, и без этой записи воспроизведение не знает, когда её применить.
+// Запись идёт под замком через буфер stdio; потоки отрисовки и приёмника
+// могут писать одновременно. Ошибка записи (диск заполнен) останавливает
+// запись: файл закрывается, hasWriteFailed() возвращает true, а в журнал
+// уходит сообщение об ошибке. Записанное до ошибки читается как оборванный хвост.
+class SessionRecorder {
+public:
+    SessionRecorder();
+    ~SessionRecorder();
+
+    SessionRecorder(const SessionRecorder&) = delete;
+    SessionRecorder& operator=(const SessionRecorder&) = delete;
+
+    // Файл перезаписывается; отсчёт времени идёт от open()
+    bool open(const std::string& path, std::string& error);
+    void close();
+    bool isOpen() const;
+    // Запись остановлена ошибкой; сбрасывается при open()
+    bool hasWriteFailed() const;
+
+    // Закрытие окна, джойстики, касания и сырые движения мыши не пишутся
+    void recordEvent(const sf::Event& event);
+    void recordUpdate(float dt);
+    void recordCommand(const ProjectLoadCommand& command);
+    void recordScene(const ProjectLoadCommand& command);
+
+    std::uint64_t getRecordCount() const;
+
+private:
+    void append(std::uint8_t type, std::string_view body);
+    // Под замком: закрывает файл после ошибки записи
+    void fail();
+
+    mutable std::mutex m_mutex;
+    std::FILE* m_file;
+    std::chrono::steady_clock::time_point m_start;
+    std::string m_record;
+    std::uint64_t m_records;
+    bool m_writeFailed;
+};
+
+struct SessionRecord {
+    enum class Type : std::uint8_t {
+        Event = 1,
+        Update = 2,
+        Command = 3,
+        Scene = 4
+    };
+
+    Type type = Type::Update;
+    // От начала записи
+    std::int64_t timeNs = 0;
+    std::optional<sf::Event> event;
+    float dt = 0.0f;
+    // Command и Scene
+    ProjectLoadCommand command;
+};
+
+// Прочитанный сеанс
+class SessionRecording {
+public:
+    bool load(const std::string& path, std::string& error);
+    bool parse(std::string_view data, std::string& error);
+
+    const std::vector<SessionRecord>& getRecords() const { return m_records; }
+    // Кадр - записи до очередного Update включительно
+    std::size_t getFrameCount() const { return m_frameCount; }
+    double getDurationSeconds() const;
+    // Сколько байт оборванного хвоста отброшено
+    std::size_t getSkippedBytes() const { return m_skippedBytes; }
+
+private:
+    std::vector<SessionRecord> m_records;
+    std::size_t m_frameCount = 0;
+    std::size_t m_skippedBytes = 0;
+};
+
+} // namespace hmi3
+
+#endif // HMI3_SESSION_RECORDER_HPP
\ No newline at end of file
@@ -0,0 +1,99 @@
+#ifndef HMI3_SESSION_REPLAYER_HPP
+#define HMI3_SESSION_REPLAYER_HPP
+
+#include "command_receiver.hpp"
+#include "session_recorder.hpp"
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace hmi3 {
+
+class Container;
+
+// Подставной приёмник для воспроизведения: команды сеанса поступают через
+// inject() и доставляются обработчику по тем же правилам, что и из сети
+class ReplayCommandReceiver : public AbstractCommandReceiver {
+public:
+    explicit ReplayCommandReceiver(std::size_t queueCapacity = kDefaultQueueCapacity)
+        : AbstractCommandReceiver(queueCapacity) {}
+
+    bool start() override {
+        m_running = true;
+        return true;
+    }
+    void stop() override { m_running = false; }
+    bool isRunning() const override { return m_running; }
+
+    // false - очередь заполнена
+    bool inject(ProjectLoadCommand command) { return enqueueCommand(std::move(command)); }
+
+private:
+    bool m_running = false;
+};
+
+// Воспроизводит записанный сеанс без окна: события идут в handleEvent()
+// корня, команды - через приёмник (в режиме Pump доставляются сразу же
+// вызовом pump()), dt - в update(). Подмена сцены (SessionRecorder::
+// recordScene) отдаётся обработчику сцен - тому же коду, которым её делает
+// приложение. Кадр сеанса заканчивается update();
+// время кадра - от первой его записи до конца update() и обратного вызова
+// кадра. В темпе записи перед кадром выдерживается записанное время,
+// без него кадры идут подряд - сеанс становится повторяемым замером.
+class SessionReplayer {
+public:
+    enum class Pace {
+        Recorded,
+        Unthrottled
+    };
+
+    struct Frame {
+        // От начала записи, с
+        double recordedTime = 0.0;
+        float dt = 0.0f;
+        std::size_t events = 0;
+        std::size_t commands = 0;
+        std::size_t scenes = 0;
+        double milliseconds = 0.0;
+    };
+
+    struct Report {
+        std::vector<Frame> frames;
+        std::size_t events = 0;
+        std::size_t commands = 0;
+        std::size_t scenes = 0;
+        double recordedSeconds = 0.0;
+        double wallSeconds = 0.0;
+        double p50Ms = 0.0;
+        double p95Ms = 0.0;
+        double p99Ms = 0.0;
+        double maxMs = 0.0;
+        // Номер самого долгого кадра
+        std::size_t slowestFrame = 0;
+    };
+
+    explicit SessionReplayer(const SessionRecording& recording);
+
+    // После update() каждого кадра, входит в его время - например,
+    // отрисовка в RenderTexture
+    void setFrameCallback(std::function<void(Container&)> callback) { m_frameCallback = std::move(callback); }
+    // Подмена сцены в записанном кадре, входит в его время. Без обработчика
+    // записи сцен пропускаются
+    void setSceneCallback(std::function<void(Container&, const ProjectLoadCommand&)> callback) {
+        m_sceneCallback = std::move(callback);
+    }
+
+    Report run(Container& root, ReplayCommandReceiver& receiver, Pace pace = Pace::Unthrottled);
+
+    static std::string formatReport(const Report& report);
+
+private:
+    const SessionRecording& m_recording;
+    std::function<void(Container&)> m_frameCallback;
+    std::function<void(Container&, const ProjectLoadCommand&)> m_sceneCallback;
+};
+
+} // namespace hmi3
+
+#endif // HMI3_SESSION_REPLAYER_HPP
\ No newline at end of file
@@ -0,0 +1,240 @@
+#ifndef HMI3_SLOT_MAP_HPP
+#define HMI3_SLOT_MAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace hmi3 {
+
+// Устойчивая ссылка на элемент SlotMap. После удаления элемента
+// поколение слота растёт, и старый дескриптор перестаёт разрешаться.
+struct SlotHandle {
+    static constexpr std::uint32_t kInvalidIndex = 0xFFFFFFFFu;
+
+    std::uint32_t index = kInvalidIndex;
+    std::uint32_t generation = 0;
+
+    bool isValid() const { return index != kInvalidIndex; }
+};
+
+inline bool operator==(const SlotHandle& lhs, const SlotHandle& rhs) {
+    return lhs.index == rhs.index && lhs.generation == rhs.generation;
+}
+inline bool operator!=(const SlotHandle& lhs, const SlotHandle& rhs) { return !(lhs == rhs); }
+
+// Хранилище со вставкой и удалением за O(1) и плотным массивом значений
+// в порядке вставки. Удаление оставляет в плотном массиве пропуск, пропуски
+// убираются при вставке, когда их становится больше живых элементов;
+// относительный порядок при этом сохраняется. Во время обхода (forEach)
+// уплотнение откладывается, поэтому обработчик может добавлять и удалять:
+// значения, удалённые за проход, освобождаются по его окончании (элемент,
+// удаливший сам себя, доживает до возврата из обработчика), а добавленные
+// за проход элементы обходятся со следующего прохода. Ссылка на значение,
+// переданная обработчику, действительна до вставки в тот же SlotMap.
+template <typename T>
+class SlotMap {
+public:
+    SlotHandle insert(T value) {
+        maybeCompact();
+
+        std::uint32_t index;
+        if (m_freeSlots.empty()) {
+            index = static_cast<std::uint32_t>(m_slots.size());
+            m_slots.push_back(Slot());
+        } else {
+            index = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        }
+
+        Slot& slot = m_slots[index];
+        slot.dense = static_cast<std::uint32_t>(m_values.size());
+        m_values.push_back(std::move(value));
+        m_denseToSlot.push_back(index);
+        return SlotHandle{index, slot.generation};
+    }
+
+    bool erase(SlotHandle handle) {
+        if (!contains(handle)) return false;
+
+        Slot& slot = m_slots[handle.index];
+        release(slot.dense);
+        m_denseToSlot[slot.dense] = kHole;
+        slot.dense = kHole;
+        ++slot.generation;
+        m_freeSlots.push_back(handle.index);
+        ++m_holes;
+        return true;
+    }
+
+    // Переносит элемент в конец порядка обхода, дескриптор не меняется
+    bool moveToBack(SlotHandle handle) {
+        if (!contains(handle)) return false;
+        maybeCompact();
+
+        Slot& slot = m_slots[handle.index];
+        if (slot.dense + 1 == m_values.size()) return true;
+
+        // Во время обхода старое место может ещё читать обработчик:
+        // значение копируется, а прежнее освобождается после прохода
+        T value = m_iterating == 0 ? std::move(m_values[slot.dense]) : m_values[slot.dense];
+        release(slot.dense);
+        m_denseToSlot[slot.dense] = kHole;
+        ++m_holes;
+        slot.dense = static_cast<std::uint32_t>(m_values.size());
+        m_values.push_back(std::move(value));
+        m_denseToSlot.push_back(handle.index);
+        return true;
+    }
+
+    bool contains(SlotHandle handle) const {
+        return handle.index < m_slots.size() &&
+               m_slots[handle.index].generation == handle.generation &&
+               m_slots[handle.index].dense != kHole;
+    }
+
+    T* get(SlotHandle handle) {
+        return contains(handle) ? &m_values[m_slots[handle.index].dense] : nullptr;
+    }
+
+    const T* get(SlotHandle handle) const {
+        return contains(handle) ? &m_values[m_slots[handle.index].dense] : nullptr;
+    }
+
+    // Обход живых элементов в порядке вставки; f(handle, value)
+    template <typename F>
+    void forEach(F&& f) const {
+        IterationGuard guard(*this);
+        // Граница берётся до обхода: добавленное за проход не обходится
+        const std::size_t end = m_values.size();
+        for (std::size_t i = 0; i < end; ++i) {
+            std::uint32_t index = m_denseToSlot[i];
+            if (index != kHole) {
+                f(SlotHandle{index, m_slots[index].generation}, m_values[i]);
+            }
+        }
+    }
+
+    template <typename F>
+    void forEachReverse(F&& f) const {
+        IterationGuard guard(*this);
+        for (std::size_t i = m_values.size(); i-- > 0;) {
+            std::uint32_t index = m_denseToSlot[i];
+            if (index != kHole) {
+                f(SlotHandle{index, m_slots[index].generation}, m_values[i]);
+            }
+        }
+    }
+
+    void clear() {
+        for (std::size_t i = 0; i < m_denseToSlot.size(); ++i) {
+            std::uint32_t index = m_denseToSlot[i];
+            if (index != kHole) {
+                m_slots[index].dense = kHole;
+                ++m_slots[index].generation;
+                m_freeSlots.push_back(index);
+            }
+        }
+        // Во время обхода оставляем пропуски, индексы обхода должны остаться верными
+        if (m_iterating == 0) {
+            m_values.clear();
+            m_denseToSlot.clear();
+            m_holes = 0;
+        } else {
+            for (std::size_t i = 0; i < m_values.size(); ++i) {
+                if (m_denseToSlot[i] != kHole) {
+                    release(static_cast<std::uint32_t>(i));
+                }
+                m_denseToSlot[i] = kHole;
+            }
+            m_holes = m_values.size();
+        }
+    }
+
+    std::size_t size() const { return m_values.size() - m_holes; }
+    bool empty() const { return size() == 0; }
+    // Длина плотного массива вместе с пропусками
+    std::size_t denseSize() const { return m_values.size(); }
+
+private:
+    static constexpr std::uint32_t kHole = 0xFFFFFFFFu;
+    static constexpr std::size_t kMinHolesToCompact = 32;
+
+    struct Slot {
+        std::uint32_t dense = kHole;
+        std::uint32_t generation = 0;
+    };
+
+    class IterationGuard {
+    public:
+        explicit IterationGuard(const SlotMap& map) : m_map(map) { ++m_map.m_iterating; }
+        ~IterationGuard() {
+            if (--m_map.m_iterating == 0 && !m_map.m_pendingRelease.empty()) {
+                // Удалять можно только из неконстантного SlotMap, так что
+                // при отложенных удалениях сам объект не константен
+                const_cast<SlotMap&>(m_map).releasePending();
+            }
+        }
+
+    private:
+        const SlotMap& m_map;
+    };
+
+    // Значение освобождается сразу, а во время обхода - после него:
+    // обработчик может ещё держать ссылку на него
+    void release(std::uint32_t dense) {
+        if (m_iterating == 0) {
+            m_values[dense] = T();
+        } else {
+            m_pendingRelease.push_back(dense);
+        }
+    }
+
+    void releasePending() {
+        // Деструкторы значений могут снова обратиться к SlotMap
+        std::vector<std::uint32_t> pending;
+        pending.swap(m_pendingRelease);
+        for (std::uint32_t dense : pending) {
+            if (dense < m_values.size() && m_denseToSlot[dense] == kHole) {
+                m_values[dense] = T();
+            }
+        }
+    }
+
+    void maybeCompact() {
+        if (m_iterating == 0 && m_holes > kMinHolesToCompact && m_holes > size()) {
+            compact();
+        }
+    }
+
+    void compact() {
+        std::size_t write = 0;
+        for (std::size_t read = 0; read < m_values.size(); ++read) {
+            std::uint32_t index = m_denseToSlot[read];
+            if (index == kHole) continue;
+            if (write != read) {
+                m_values[write] = std::move(m_values[read]);
+                m_denseToSlot[write] = index;
+            }
+            m_slots[index].dense = static_cast<std::uint32_t>(write);
+            ++write;
+        }
+        m_values.resize(write);
+        m_denseToSlot.resize(write);
+        m_holes = 0;
+    }
+
+    std::vector<T> m_values;
+    std::vector<std::uint32_t> m_denseToSlot;
+    std::vector<Slot> m_slots;
+    std::vector<std::uint32_t> m_freeSlots;
+    std::size_t m_holes = 0;
+    mutable std::size_t m_iterating = 0;
+    // Места в m_values, освобождаемые по окончании обхода
+    std::vector<std::uint32_t> m_pendingRelease;
+};
+
+} // namespace hmi3
+
+#endif // HMI3_SLOT_MAP_HPP
\ No newline at end of file
@@ -0,0 +1,64 @@
+#ifndef HMI3_SPATIAL_GRID_HPP
+#define HMI3_SPATIAL_GRID_HPP
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace hmi3 {
+
+class Component;
+
+// Равномерная сетка для поиска компонентов по точке или области.
+// Компонент регистрируется во всех ячейках, которые задевают его границы;
+// слишком крупные компоненты хранятся отдельным списком и проверяются всегда.
+class SpatialGrid {
+public:
+    explicit SpatialGrid(float cellSize = 64.0f, std::size_t maxCellsPerItem = 256);
+
+    void insert(Component* component, const sf::FloatRect& bounds);
+    void update(Component* component, const sf::FloatRect& bounds);
+    bool remove(Component* component);
+    void clear();
+
+    // Результаты без повторов и без учёта порядка отрисовки
+    void query(const sf::Vector2f& point, std::vector<Component*>& result) const;
+    void query(const sf::FloatRect& area, std::vector<Component*>& result) const;
+    // Сколько ячеек просмотрит query(area): если больше, чем компонентов,
+    // дешевле перебрать их все
+    std::size_t cellCount(const sf::FloatRect& area) const;
+
+    bool contains(Component* component) const { return m_entries.count(component) != 0; }
+    std::size_t size() const { return m_entries.size(); }
+    float getCellSize() const { return m_cellSize; }
+
+private:
+    struct CellRange {
+        int left;
+        int top;
+        int right;
+        int bottom;
+    };
+
+    struct Entry {
+        sf::FloatRect bounds;
+        CellRange cells;
+        bool oversized;
+    };
+
+    CellRange cellRange(const sf::FloatRect& bounds) const;
+    static std::uint64_t cellKey(int x, int y);
+    void link(Component* component, const Entry& entry);
+    void unlink(Component* component, const Entry& entry);
+
+    float m_cellSize;
+    std::size_t m_maxCellsPerItem;
+    std::unordered_map<std::uint64_t, std::vector<Component*>> m_cells;
+    std::unordered_map<Component*, Entry> m_entries;
+    std::vector<Component*> m_oversized;
+};
+
+} // namespace hmi3
+
+#endif // HMI3_SPATIAL_GRID_HPP
\ No newline at end of file
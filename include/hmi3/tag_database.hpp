@@ -0,0 +1,135 @@
+#ifndef HMI3_TAG_DATABASE_HPP
+#define HMI3_TAG_DATABASE_HPP
+
+#include "mpsc_queue.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace hmi3 {
+
+using TagId = std::uint32_t;
+using TagValue = std::variant<double, bool, std::string>;
+
+class TagDatabase;
+
+// Подписка на тег; при разрушении отписывается сама. Может пережить базу:
+// после разрушения базы подписка просто становится неактивной
+class TagSubscription {
+public:
+    TagSubscription() = default;
+    TagSubscription(TagSubscription&& other) noexcept;
+    TagSubscription& operator=(TagSubscription&& other) noexcept;
+    TagSubscription(const TagSubscription&) = delete;
+    TagSubscription& operator=(const TagSubscription&) = delete;
+    ~TagSubscription();
+
+    void reset();
+    bool isActive() const { return !m_database.expired(); }
+
+private:
+    friend class TagDatabase;
+    TagSubscription(std::weak_ptr<TagDatabase*> database, TagId tag, std::uint64_t id)
+        : m_database(std::move(database)), m_tag(tag), m_id(id) {}
+
+    std::weak_ptr<TagDatabase*> m_database;
+    TagId m_tag = 0;
+    std::uint64_t m_id = 0;
+};
+
+// База тегов процесса. Производители публикуют значения из любых потоков,
+// поток интерфейса раз в кадр вызывает dispatch(): каждый изменившийся тег
+// уведомляет подписчиков один раз последним значением. Стоимость dispatch()
+// зависит от числа изменившихся тегов, а не от числа подписок.
+// Теги регистрируются заранее; тип тега задаётся начальным значением.
+// Память под теги выделяется блоками по мере регистрации, maxTags - только
+// предел.
+class TagDatabase {
+public:
+    using Callback = std::function<void(TagId, const TagValue&)>;
+
+    static constexpr TagId kInvalidTag = 0xFFFFFFFFu;
+
+    explicit TagDatabase(std::size_t maxTags = 65536);
+    ~TagDatabase();
+
+    TagDatabase(const TagDatabase&) = delete;
+    TagDatabase& operator=(const TagDatabase&) = delete;
+
+    // kInvalidTag, если имя занято или база заполнена
+    TagId addTag(const std::string& name, TagValue initialValue = 0.0);
+    TagId findTag(const std::string& name) const;
+    const std::string& getTagName(TagId tag) const;
+    std::size_t getTagCount() const { return m_tagCount.load(std::memory_order_acquire); }
+
+    // Из любого потока. false - нет такого тега или другой тип значения
+    bool publish(TagId tag, TagValue value);
+    bool publish(TagId tag, const char* value) { return publish(tag, TagValue(std::string(value))); }
+
+    // Дальше - только поток интерфейса
+    [[nodiscard]] TagSubscription subscribe(TagId tag, Callback callback);
+    // Значение на момент последнего dispatch()
+    const TagValue& getValue(TagId tag) const;
+    // Возвращает число тегов, о которых разосланы уведомления
+    std::size_t dispatch();
+
+private:
+    friend class TagSubscription;
+
+    struct Subscriber {
+        std::uint64_t id;
+        Callback callback;
+        // Отписан во время рассылки; callback может ещё выполняться и
+        // уничтожается после неё
+        bool active = true;
+    };
+
+    struct Tag {
+        std::string name;
+        std::size_t type = 0;
+        // Последнее опубликованное значение под спин-блокировкой
+        std::atomic_flag lock = ATOMIC_FLAG_INIT;
+        TagValue latest;
+        std::atomic<bool> pending{false};
+        // Только поток интерфейса
+        TagValue current;
+        std::vector<Subscriber> subscribers;
+    };
+
+    struct DeferredSubscription {
+        TagId tag;
+        Subscriber subscriber;
+    };
+
+    static constexpr std::size_t kBlockSize = 1024;
+
+    Tag& tagAt(TagId tag) const { return m_blocks[tag / kBlockSize][tag % kBlockSize]; }
+    void unsubscribe(TagId tag, std::uint64_t id);
+
+    const std::size_t m_maxTags;
+    // Блок создаётся до публикации m_tagCount и больше не перемещается
+    std::unique_ptr<std::unique_ptr<Tag[]>[]> m_blocks;
+    std::atomic<std::size_t> m_tagCount{0};
+    mutable std::mutex m_namesMutex;
+    std::unordered_map<std::string, TagId> m_names;
+    // Каждый тег стоит в очереди не больше одного раза
+    BoundedMpscQueue<TagId> m_changed;
+    std::uint64_t m_nextSubscription = 1;
+    bool m_dispatching = false;
+    // Изменения подписок из обработчиков применяются после рассылки
+    std::vector<TagId> m_deferredRemovals;
+    std::vector<DeferredSubscription> m_deferredSubscriptions;
+    // Подписки проверяют через него, жива ли база
+    std::shared_ptr<TagDatabase*> m_self;
+};
+
+} // namespace hmi3
+
+#endif // HMI3_TAG_DATABASE_HPP
\ No newline at end of file
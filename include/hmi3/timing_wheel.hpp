@@ -0,0 +1,98 @@
+#ifndef HMI3_TIMING_WHEEL_HPP
+#define HMI3_TIMING_WHEEL_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace hmi3 {
+
+// Хэшированное колесо таймеров. Время делится на тики длиной resolution,
+// тик попадает в слот по модулю числа слотов; срок дальше одного оборота
+// ждёт в своём слоте следующих оборотов. Постановка - O(1), продвижение -
+// по числу пройденных слотов и записей в них. Отмены нет: владелец сам
+// отбрасывает устаревшие записи при срабатывании.
+template <typename T>
+class TimingWheel {
+public:
+    explicit TimingWheel(double resolution = 0.004, std::size_t slotCount = 256)
+        : m_resolution(resolution)
+        , m_slots(std::max<std::size_t>(slotCount, 1)) {}
+
+    // Срабатывает при первом advance() с now >= deadline, но не раньше
+    // следующего тика: уже прошедший срок не теряется. Бесконечный и
+    // сверхдальний срок ждёт последнего тика, то есть на деле не наступает
+    void schedule(double deadline, T value) {
+        std::uint64_t tick = m_tick + 1;
+        double ticks = std::ceil(deadline / m_resolution);
+        if (ticks > static_cast<double>(tick)) {
+            tick = toTick(ticks);
+        }
+        m_slots[tick % m_slots.size()].push_back(Entry{tick, std::move(value)});
+        ++m_size;
+    }
+
+    // Переносит сработавшие записи в expired; порядок внутри тика не задан
+    void advance(double now, std::vector<T>& expired) {
+        double ticks = std::floor(now / m_resolution);
+        // Так отбрасывается и NaN
+        if (!(ticks > static_cast<double>(m_tick))) return;
+        std::uint64_t target = toTick(ticks);
+
+        // Больше оборота за раз - каждый слот просматривается один раз
+        std::uint64_t steps = std::min<std::uint64_t>(target - m_tick, m_slots.size());
+        for (std::uint64_t step = 1; step <= steps; ++step) {
+            std::uint64_t tick = steps == m_slots.size() ? target - m_slots.size() + step : m_tick + step;
+            auto& slot = m_slots[tick % m_slots.size()];
+            for (std::size_t i = 0; i < slot.size();) {
+                if (slot[i].tick <= target) {
+                    expired.push_back(std::move(slot[i].value));
+                    slot[i] = std::move(slot.back());
+                    slot.pop_back();
+                    --m_size;
+                } else {
+                    ++i;
+                }
+            }
+        }
+        m_tick = target;
+    }
+
+    void clear() {
+        for (auto& slot : m_slots) {
+            slot.clear();
+        }
+        m_size = 0;
+    }
+
+    std::size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    double getResolution() const { return m_resolution; }
+
+private:
+    // Потолок номера тика, точно представимый в double: приведение
+    // большего значения к uint64_t - неопределённое поведение
+    static constexpr double kMaxTick = 9007199254740992.0; // 2^53
+
+    static std::uint64_t toTick(double ticks) {
+        return static_cast<std::uint64_t>(std::min(ticks, kMaxTick));
+    }
+
+    struct Entry {
+        std::uint64_t tick;
+        T value;
+    };
+
+    double m_resolution;
+    std::vector<std::vector<Entry>> m_slots;
+    // Последний пройденный тик
+    std::uint64_t m_tick = 0;
+    std::size_t m_size = 0;
+};
+
+} // namespace hmi3
+
+#endif // HMI3_TIMING_WHEEL_HPP
\ No newline at end of file
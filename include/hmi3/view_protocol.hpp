@@ -0,0 +1,108 @@
+#ifndef HMI3_VIEW_PROTOCOL_HPP
+#define HMI3_VIEW_PROTOCOL_HPP
+
+#include <SFML/Window.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace hmi3 {
+
+// Поток удалённого просмотра (все числа little-endian). Сообщение - тип (1),
+// длина тела (4), тело. Сервер -> зритель:
+//   Hello       магия "HMV1", версия (1)
+//   FrameBegin  номер кадра (4), ширина (2), высота (2), размер плитки (2),
+//               число плиток в кадре (4)
+//   Tile        столбец (2), строка (2), кодировка (1), пиксели RGBA плитки
+//   FrameEnd    -
+// Зритель -> сервер:
+//   Input       событие ввода (encodeInputEvent)
+// Кадр несёт только плитки, изменившиеся с прошлого кадра этого зрителя.
+namespace view {
+
+constexpr char kMagic[4] = {'H', 'M', 'V', '1'};
+constexpr std::uint8_t kVersion = 1;
+constexpr std::size_t kMessageHeaderSize = 5;
+constexpr std::uint32_t kMaxMessageSize = 64u * 1024 * 1024;
+constexpr unsigned kDefaultTileSize = 64;
+// Ширина, высота и плитка передаются 16 битами
+constexpr unsigned kMaxFrameSize = 0xFFFF;
+
+enum MessageType : std::uint8_t {
+    Hello = 1,
+    FrameBegin = 2,
+    Tile = 3,
+    FrameEnd = 4,
+    Input = 16
+};
+
+enum TileEncoding : std::uint8_t {
+    Raw = 0,
+    // Повторы пикселя: (число 1..255, RGBA)
+    Rle = 1
+};
+
+} // namespace view
+
+// Область кадра RGBA шириной stride пикселей
+struct PixelRect {
+    const std::uint8_t* pixels;
+    unsigned stride;
+    unsigned x;
+    unsigned y;
+    unsigned width;
+    unsigned height;
+};
+
+std::uint64_t hashPixels(const PixelRect& rect);
+void appendViewMessage(std::string& out, view::MessageType type, const std::string& body);
+// Плитка сжимается RLE, если так короче, иначе идёт как есть
+void appendTileMessage(std::string& out, unsigned column, unsigned row, const PixelRect& rect);
+std::string encodeInputEvent(const sf::Event& event);
+// nullopt - событие не пересылается или тело повреждено
+std::optional<sf::Event> decodeInputEvent(const char* data, std::size_t size);
+
+// Разбор потока сервера на стороне зрителя: собирает кадр в буфере RGBA.
+// feed() останавливается после FrameEnd, чтобы вызывающий забрал кадр.
+class ViewDecoder {
+public:
+    enum class Result {
+        NeedMoreData,
+        FrameReady,
+        ProtocolError
+    };
+
+    Result feed(const char* data, std::size_t size, std::size_t& consumed);
+
+    const std::vector<std::uint8_t>& getPixels() const { return m_pixels; }
+    unsigned getWidth() const { return m_width; }
+    unsigned getHeight() const { return m_height; }
+    std::uint32_t getFrameId() const { return m_frameId; }
+    // Плиток в последнем собранном кадре
+    std::size_t getTileCount() const { return m_tileCount; }
+    const std::string& getError() const { return m_error; }
+
+private:
+    Result fail(const std::string& error);
+    Result handleMessage();
+    bool decodeTile(const char* data, std::size_t size);
+
+    char m_header[view::kMessageHeaderSize];
+    std::size_t m_headerSize = 0;
+    std::string m_body;
+    std::size_t m_bodyExpected = 0;
+    bool m_helloSeen = false;
+    std::vector<std::uint8_t> m_pixels;
+    unsigned m_width = 0;
+    unsigned m_height = 0;
+    unsigned m_tileSize = view::kDefaultTileSize;
+    std::uint32_t m_frameId = 0;
+    std::size_t m_tileCount = 0;
+    std::string m_error;
+};
+
+} // namespace hmi3
+
+#endif // HMI3_VIEW_PROTOCOL_HPP
\ No newline at end of file
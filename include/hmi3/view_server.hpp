@@ -0,0 +1,130 @@
+#ifndef HMI3_VIEW_SERVER_HPP
+#define HMI3_VIEW_SERVER_HPP
+
+#include "mpsc_queue.hpp"
+#include "view_protocol.hpp"
+#include <SFML/Graphics.hpp>
+#include <SFML/Network.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace hmi3 {
+
+class Container;
+
+// Удалённый просмотр панели: кадр режется на плитки, каждому зрителю
+// уходят только плитки, изменившиеся с его прошлого кадра (view_protocol.hpp).
+// Поток отрисовки лишь копирует кадр; хэши плиток, кодирование и отправка
+// идут в потоке зрителя. Медленный зритель пропускает промежуточные кадры
+// и никогда не задерживает цикл отрисовки.
+//
+// Аутентификации нет, поэтому по умолчанию сервер слушает только 127.0.0.1
+// и только показывает панель. Ввод зрителей принимается после
+// setInputEnabled(true): он копится в очереди и доставляется в потоке
+// отрисовки через pumpInput().
+class ViewServer {
+public:
+    struct Stats {
+        std::uint64_t framesPublished = 0;
+        std::uint64_t framesSent = 0;
+        std::uint64_t tilesSent = 0;
+        std::uint64_t bytesSent = 0;
+        // Ввод, отброшенный при выключенном setInputEnabled
+        std::uint64_t inputIgnored = 0;
+    };
+
+    explicit ViewServer(unsigned short port = 8081, unsigned tileSize = view::kDefaultTileSize);
+    ~ViewServer();
+
+    ViewServer(const ViewServer&) = delete;
+    ViewServer& operator=(const ViewServer&) = delete;
+
+    bool start();
+    void stop();
+    bool isRunning() const { return m_running; }
+    unsigned short getLocalPort() const { return m_localPort; }
+    std::size_t getViewerCount() const { return m_viewerCount; }
+
+    // Адрес, на котором слушает сервер; задаётся до start().
+    // sf::IpAddress::Any открывает панель всей сети
+    void setBindAddress(const sf::IpAddress& address) { m_bindAddress = address; }
+    const sf::IpAddress& getBindAddress() const { return m_bindAddress; }
+    // Ввод зрителей доходит до панели; без этого он читается и отбрасывается
+    void setInputEnabled(bool enabled) { m_inputEnabled = enabled; }
+    bool isInputEnabled() const { return m_inputEnabled; }
+
+    // Частота кадров, которую получает зритель; 0 - без ограничения
+    void setMaxFrameRate(unsigned framesPerSecond) { m_maxFrameRate = framesPerSecond; }
+    void setMaxViewers(std::size_t count) { m_maxViewers = count; }
+
+    // Рисует root во внеэкранную текстуру и публикует кадр. Без зрителей
+    // и чаще заданной частоты ничего не делает; true - кадр опубликован.
+    // Текстура читается с видеокарты при следующем захвате, а не сразу
+    // после отрисовки: к тому времени видеокарта её давно дорисовала, и
+    // чтение не ждёт конвейер. Зритель видит кадр с опозданием на один
+    // интервал захвата
+    bool capture(const Container& root);
+    // Кадр RGBA width x height копируется, вызывающий сохраняет буфер.
+    // Стороны больше view::kMaxFrameSize не передаются - кадр отвергается
+    bool publishFrame(const std::uint8_t* pixels, unsigned width, unsigned height);
+
+    // Вызывается из потока отрисовки; возвращает число доставленных событий
+    std::size_t pumpInput(Container& root);
+
+    Stats getStats() const;
+
+private:
+    struct Frame;
+    struct Viewer;
+
+    bool isFrameDue();
+    void acceptLoop();
+    void viewerLoop(Viewer& viewer);
+    bool readInput(Viewer& viewer);
+    bool sendFrame(Viewer& viewer, const Frame& frame);
+    bool sendAll(Viewer& viewer, const std::string& data);
+    void reapViewers(bool all);
+
+    unsigned short m_port;
+    unsigned short m_localPort;
+    sf::IpAddress m_bindAddress;
+    std::atomic<bool> m_inputEnabled;
+    unsigned m_tileSize;
+    unsigned m_maxFrameRate;
+    std::size_t m_maxViewers;
+    std::atomic<bool> m_running;
+    std::atomic<std::size_t> m_viewerCount;
+    sf::TcpListener m_listener;
+    std::thread m_acceptThread;
+
+    std::mutex m_viewersMutex;
+    std::vector<std::unique_ptr<Viewer>> m_viewers;
+
+    // Последний опубликованный кадр; зрители берут его под мьютексом
+    std::mutex m_frameMutex;
+    std::condition_variable m_frameChanged;
+    std::shared_ptr<const Frame> m_frame;
+    std::uint32_t m_nextFrameId;
+    sf::Clock m_publishClock;
+
+    sf::RenderTexture m_texture;
+    // В текстуре кадр, ещё не прочитанный с видеокарты
+    bool m_readbackPending;
+    BoundedMpscQueue<std::optional<sf::Event>> m_input;
+
+    std::atomic<std::uint64_t> m_framesPublished;
+    std::atomic<std::uint64_t> m_framesSent;
+    std::atomic<std::uint64_t> m_tilesSent;
+    std::atomic<std::uint64_t> m_bytesSent;
+    std::atomic<std::uint64_t> m_inputIgnored;
+};
+
+} // namespace hmi3
+
+#endif // HMI3_VIEW_SERVER_HPP
\ No newline at end of file
@@ -0,0 +1,61 @@
+#ifndef HMI3_WORKER_POOL_HPP
+#define HMI3_WORKER_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hmi3 {
+
+// Пул потоков для параллельных циклов кадра. Диапазон режется на куски,
+// свободные потоки забирают следующий кусок сами, поэтому тяжёлые
+// элементы не задерживают остальных. Вызывающий поток тоже работает.
+class WorkerPool {
+public:
+    using RangeFunction = std::function<void(std::size_t begin, std::size_t end)>;
+
+    // 0 - по числу ядер минус вызывающий поток
+    explicit WorkerPool(std::size_t threadCount = 0);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Возвращается, когда обработан весь диапазон. Первое исключение из
+    // body пробрасывается вызывающему. Вызов изнутри body выполняется
+    // последовательно в том же потоке
+    void parallelFor(std::size_t count, const RangeFunction& body, std::size_t grain = 0);
+
+    std::size_t getThreadCount() const { return m_threads.size(); }
+
+private:
+    void workerLoop();
+    void runChunks();
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_submitMutex;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_finished;
+    std::uint64_t m_generation = 0;
+    std::size_t m_busyWorkers = 0;
+    bool m_stopping = false;
+
+    const RangeFunction* m_body = nullptr;
+    std::size_t m_count = 0;
+    std::size_t m_grain = 1;
+    std::atomic<std::size_t> m_next{0};
+    std::exception_ptr m_error;
+    std::mutex m_errorMutex;
+};
+
+} // namespace hmi3
+
+#endif // HMI3_WORKER_POOL_HPP
\ No newline at end of file
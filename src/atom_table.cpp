@@ -0,0 +1,114 @@
+#include "hmi3/atom_table.hpp"
+#include <mutex>
+#include <sstream>
+
+namespace hmi3 {
+
+AtomTable& AtomTable::global() {
+    static AtomTable table;
+    return table;
+}
+
+Atom AtomTable::intern(std::string_view name) {
+    {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        auto it = m_atoms.find(name);
+        if (it != m_atoms.end() && m_entries[it->second].refs == kPinned) {
+            return it->second;
+        }
+    }
+    return insert(name, true);
+}
+
+Atom AtomTable::acquire(std::string_view name) {
+    return insert(name, false);
+}
+
+Atom AtomTable::insert(std::string_view name, bool pin) {
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    // Другой поток мог добавить строку, пока блокировка была снята
+    auto it = m_atoms.find(name);
+    if (it != m_atoms.end()) {
+        Entry& entry = m_entries[it->second];
+        if (pin && entry.refs != kPinned) {
+            entry.refs = kPinned;
+            ++m_pinned;
+        } else if (entry.refs != kPinned) {
+            ++entry.refs;
+        }
+        return it->second;
+    }
+
+    Atom atom;
+    if (!m_free.empty()) {
+        atom = m_free.back();
+        m_free.pop_back();
+    } else {
+        atom = static_cast<Atom>(m_entries.size());
+        m_entries.emplace_back();
+    }
+    Entry& entry = m_entries[atom];
+    entry.name.assign(name);
+    entry.refs = pin ? kPinned : 1;
+    m_pinned += pin ? 1 : 0;
+    m_atoms.emplace(entry.name, atom);
+    return atom;
+}
+
+void AtomTable::release(Atom atom) {
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    if (atom >= m_entries.size()) {
+        return;
+    }
+    Entry& entry = m_entries[atom];
+    if (entry.refs == kPinned || entry.refs == 0 || --entry.refs > 0) {
+        return;
+    }
+    m_atoms.erase(entry.name);
+    // Память строки возвращается: номер может долго оставаться свободным
+    std::string().swap(entry.name);
+    m_free.push_back(atom);
+    ++m_released;
+}
+
+Atom AtomTable::find(std::string_view name) const {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    auto it = m_atoms.find(name);
+    return it != m_atoms.end() ? it->second : kInvalidAtom;
+}
+
+const std::string& AtomTable::name(Atom atom) const {
+    static const std::string empty;
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    return atom < m_entries.size() ? m_entries[atom].name : empty;
+}
+
+std::size_t AtomTable::size() const {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    return m_atoms.size();
+}
+
+AtomTable::Stats AtomTable::getStats() const {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    Stats stats;
+    stats.live = m_atoms.size();
+    stats.pinned = m_pinned;
+    stats.slots = m_entries.size();
+    stats.released = m_released;
+    return stats;
+}
+
+std::string AtomTable::formatStats(const Stats& stats) {
+    std::ostringstream out;
+    out << "# TYPE hmi3_atoms_live gauge\n"
+        << "hmi3_atoms_live " << stats.live << '\n'
+        << "# TYPE hmi3_atoms_pinned gauge\n"
+        << "hmi3_atoms_pinned " << stats.pinned << '\n'
+        << "# TYPE hmi3_atoms_slots gauge\n"
+        << "hmi3_atoms_slots " << stats.slots << '\n'
+        << "# TYPE hmi3_atoms_released_total counter\n"
+        << "hmi3_atoms_released_total " << stats.released << '\n';
+    return out.str();
+}
+
+} // namespace hmi3
\ No newline at end of file
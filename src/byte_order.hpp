@@ -0,0 +1,39 @@
+#ifndef HMI3_BYTE_ORDER_HPP
+#define HMI3_BYTE_ORDER_HPP
+
+// Внутренний заголовок библиотеки: все форматы hmi3 (кадры протокола,
+// журнал команд, запись сеанса, протокол зрителя) хранят целые в
+// little-endian независимо от платформы
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace hmi3 {
+
+template <typename T>
+void writeLE(char* out, T value) {
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        out[i] = static_cast<char>((static_cast<std::uint64_t>(value) >> (8 * i)) & 0xFF);
+    }
+}
+
+template <typename T>
+T readLE(const char* in) {
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        value |= static_cast<std::uint64_t>(static_cast<unsigned char>(in[i])) << (8 * i);
+    }
+    return static_cast<T>(value);
+}
+
+template <typename T>
+void appendLE(std::string& out, T value) {
+    char bytes[sizeof(T)];
+    writeLE(bytes, value);
+    out.append(bytes, sizeof(T));
+}
+
+} // namespace hmi3
+
+#endif // HMI3_BYTE_ORDER_HPP
\ No newline at end of file
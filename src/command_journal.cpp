@@ -0,0 +1,428 @@
+#include "hmi3/command_journal.hpp"
+#include "hmi3/logger.hpp"
+#include "hmi3/project_description.hpp"
+#include "hmi3/project_loader.hpp"
+#include "hmi3/protocol.hpp"
+#include "byte_order.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <string_view>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace hmi3 {
+
+namespace {
+
+constexpr char kRecordMagic[4] = {'H', 'M', 'J', '1'};
+constexpr std::size_t kRecordHeaderSize = 12;
+// номер (8), версия (4), forceLoad (1), длина имени (2)
+constexpr std::size_t kBodyHeaderSize = 15;
+// Хвост снимка: магия и номер записи журнала, из которой снимок сделан.
+// CompiledProject лишние байты после своих таблиц не читает
+constexpr char kSnapshotMagic[4] = {'H', 'M', 'J', 'S'};
+constexpr std::size_t kSnapshotTrailerSize = 12;
+
+void appendRecord(std::string& out, std::uint64_t sequence, const ProjectLoadCommand& command) {
+    std::size_t nameLength = std::min<std::size_t>(command.projectName.size(), 0xFFFF);
+    std::size_t bodySize = kBodyHeaderSize + nameLength + command.projectData.size();
+
+    out.reserve(out.size() + kRecordHeaderSize + bodySize);
+    out.append(kRecordMagic, sizeof(kRecordMagic));
+    appendLE<std::uint32_t>(out, static_cast<std::uint32_t>(bodySize));
+    std::size_t crcOffset = out.size();
+    appendLE<std::uint32_t>(out, 0);
+
+    std::size_t bodyOffset = out.size();
+    appendLE<std::uint64_t>(out, sequence);
+    appendLE<std::uint32_t>(out, command.version);
+    appendLE<std::uint8_t>(out, command.forceLoad ? 1 : 0);
+    appendLE<std::uint16_t>(out, static_cast<std::uint16_t>(nameLength));
+    out.append(command.projectName.data(), nameLength);
+    out.append(command.projectData.data(), command.projectData.size());
+
+    std::uint32_t crc = crc32(out.data() + bodyOffset, bodySize);
+    for (std::size_t i = 0; i < 4; ++i) {
+        out[crcOffset + i] = static_cast<char>((crc >> (8 * i)) & 0xFF);
+    }
+}
+
+struct ScanResult {
+    std::size_t records = 0;
+    // Конец последней целой записи
+    std::size_t validSize = 0;
+    std::uint64_t lastSequence = 0;
+};
+
+// Обходит целые записи; останавливается на первой битой
+ScanResult scanRecords(const std::string& data,
+                       const std::function<void(std::uint64_t, const ProjectLoadCommand&)>& callback) {
+    ScanResult result;
+    std::size_t offset = 0;
+    while (data.size() - offset >= kRecordHeaderSize) {
+        const char* header = data.data() + offset;
+        if (std::memcmp(header, kRecordMagic, sizeof(kRecordMagic)) != 0) break;
+        std::size_t bodySize = readLE<std::uint32_t>(header + 4);
+        if (bodySize < kBodyHeaderSize || bodySize > data.size() - offset - kRecordHeaderSize) break;
+
+        const char* body = header + kRecordHeaderSize;
+        if (crc32(body, bodySize) != readLE<std::uint32_t>(header + 8)) break;
+        std::size_t nameLength = readLE<std::uint16_t>(body + 13);
+        if (kBodyHeaderSize + nameLength > bodySize) break;
+
+        std::uint64_t sequence = readLE<std::uint64_t>(body);
+        if (callback) {
+            ProjectLoadCommand command;
+            command.version = readLE<std::uint32_t>(body + 8);
+            command.forceLoad = body[12] != 0;
+            command.projectName.assign(body + kBodyHeaderSize, nameLength);
+            command.projectData = std::string_view(body + kBodyHeaderSize + nameLength,
+                                                   bodySize - kBodyHeaderSize - nameLength);
+            callback(sequence, command);
+        }
+
+        ++result.records;
+        result.lastSequence = sequence;
+        offset += kRecordHeaderSize + bodySize;
+        result.validSize = offset;
+    }
+    return result;
+}
+
+bool readFile(const std::string& path, std::string& data) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+bool syncFile(std::FILE* file) {
+    if (std::fflush(file) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+// Переименование в каталоге становится надёжным только после его fsync
+void syncDirectory(const std::string& directory) {
+#ifndef _WIN32
+    int fd = ::open(directory.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        fsync(fd);
+        ::close(fd);
+    }
+#else
+    (void)directory;
+#endif
+}
+
+// Новый файл пишется рядом и заменяет старый переименованием: после сбоя
+// на диске остаётся либо старая, либо новая версия целиком
+bool replaceFile(const std::string& directory, const std::string& path, std::string_view data,
+                 std::string_view trailer = std::string_view()) {
+    std::string temporary = path + ".tmp";
+    std::FILE* file = std::fopen(temporary.c_str(), "wb");
+    if (!file) return false;
+    bool written = std::fwrite(data.data(), 1, data.size(), file) == data.size() &&
+                   std::fwrite(trailer.data(), 1, trailer.size(), file) == trailer.size() && syncFile(file);
+    written = std::fclose(file) == 0 && written;
+
+    std::error_code ec;
+    if (!written || (std::filesystem::rename(temporary, path, ec), ec)) {
+        std::filesystem::remove(temporary, ec);
+        return false;
+    }
+    syncDirectory(directory);
+    return true;
+}
+
+// Номер записи журнала, из которой сделан снимок; 0 - хвоста нет
+std::uint64_t readSnapshotSequence(const std::string& path) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in || in.tellg() < static_cast<std::streamoff>(kSnapshotTrailerSize)) return 0;
+    char trailer[kSnapshotTrailerSize];
+    in.seekg(-static_cast<std::streamoff>(kSnapshotTrailerSize), std::ios::end);
+    if (!in.read(trailer, sizeof(trailer)) ||
+        std::memcmp(trailer, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0) {
+        return 0;
+    }
+    return readLE<std::uint64_t>(trailer + 4);
+}
+
+} // namespace
+
+CommandJournal::CommandJournal(std::string directory)
+    : m_directory(std::move(directory))
+    , m_journalPath((std::filesystem::path(m_directory) / "journal.hmj").string())
+    , m_snapshotPath((std::filesystem::path(m_directory) / "snapshot.hmi3c").string())
+    , m_maxJournalSize(kDefaultMaxJournalSize)
+    , m_skippedBytes(0)
+    , m_file(nullptr)
+    , m_fileSize(0)
+    , m_nextSequence(1)
+    , m_durableSequence(0)
+    , m_failed(false)
+    , m_stopping(true) {
+}
+
+CommandJournal::~CommandJournal() {
+    close();
+}
+
+bool CommandJournal::open(std::string& error) {
+    if (isOpen()) return true;
+
+    std::error_code ec;
+    std::filesystem::create_directories(m_directory, ec);
+    if (ec) {
+        error = "cannot create " + m_directory + ": " + ec.message();
+        return false;
+    }
+
+    std::string data;
+    ScanResult scan;
+    if (readFile(m_journalPath, data)) {
+        scan = scanRecords(data, nullptr);
+        m_skippedBytes = data.size() - scan.validSize;
+        if (m_skippedBytes > 0) {
+            // Оборванная при сбое запись не должна оказаться посреди журнала
+            HMI3_LOG_WARNING("Journal: dropping " << m_skippedBytes << " bytes of corrupt tail after "
+                             << scan.records << " records");
+            std::filesystem::resize_file(m_journalPath, scan.validSize, ec);
+            if (ec) {
+                error = "cannot truncate " + m_journalPath + ": " + ec.message();
+                return false;
+            }
+        }
+    }
+
+    m_file = std::fopen(m_journalPath.c_str(), "ab");
+    if (!m_file) {
+        error = "cannot open " + m_journalPath + ": " + std::strerror(errno);
+        return false;
+    }
+    m_fileSize = scan.validSize;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_nextSequence = scan.lastSequence + 1;
+        m_durableSequence = scan.lastSequence;
+        m_failed = false;
+        m_stopping = false;
+    }
+    m_writer = std::thread(&CommandJournal::writerLoop, this);
+    return true;
+}
+
+void CommandJournal::close() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_pendingChanged.notify_all();
+    if (m_writer.joinable()) {
+        m_writer.join();
+    }
+    if (m_file) {
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+}
+
+void CommandJournal::record(const ProjectLoadCommand& command) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping) return;
+        // Данные проекта не копируются: PayloadBuffer разделяет блок
+        m_pending.push_back(Pending{m_nextSequence++, command});
+    }
+    m_pendingChanged.notify_one();
+}
+
+bool CommandJournal::flush() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    std::uint64_t target = m_nextSequence - 1;
+    m_durableChanged.wait(lock, [this, target] {
+        return m_durableSequence >= target || m_failed || m_stopping;
+    });
+    return m_durableSequence >= target && !m_failed;
+}
+
+CommandJournal::Stats CommandJournal::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void CommandJournal::writerLoop() {
+    std::vector<Pending> batch;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_pendingChanged.wait(lock, [this] { return m_stopping || !m_pending.empty(); });
+            if (m_pending.empty()) {
+                return;
+            }
+            batch.swap(m_pending);
+        }
+
+        // Снимок - только новейшая команда группы: промежуточные устарели
+        bool written = commit(batch);
+        if (written) {
+            if (!writeSnapshot(batch.back())) {
+                HMI3_LOG_ERROR("Journal: cannot write snapshot " << m_snapshotPath);
+            }
+            if (m_fileSize > m_maxJournalSize && !compact(batch.back())) {
+                HMI3_LOG_ERROR("Journal: cannot compact " << m_journalPath);
+            }
+        } else {
+            HMI3_LOG_ERROR("Journal: cannot write " << m_journalPath);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (written) {
+                m_durableSequence = batch.back().sequence;
+            } else {
+                m_failed = true;
+            }
+        }
+        m_durableChanged.notify_all();
+        batch.clear();
+    }
+}
+
+bool CommandJournal::commit(const std::vector<Pending>& batch) {
+    std::string data;
+    for (const auto& pending : batch) {
+        appendRecord(data, pending.sequence, pending.command);
+    }
+
+    // Вся группа - одна запись в файл и один fsync
+    if (std::fwrite(data.data(), 1, data.size(), m_file) != data.size() || !syncFile(m_file)) {
+        return false;
+    }
+    m_fileSize += data.size();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.records += batch.size();
+    m_stats.commits += 1;
+    m_stats.bytes += data.size();
+    return true;
+}
+
+bool CommandJournal::writeSnapshot(const Pending& pending) {
+    const ProjectLoadCommand& command = pending.command;
+    std::string_view data = command.projectData.view();
+    std::vector<char> compiled;
+    if (!CompiledProject::isCompiled(data)) {
+        ProjectDescription description;
+        std::string error;
+        if (!parseProject(data, description, error) ||
+            !compileProject(description, command.version, compiled, error)) {
+            return false;
+        }
+        data = std::string_view(compiled.data(), compiled.size());
+    }
+
+    std::string trailer(kSnapshotMagic, sizeof(kSnapshotMagic));
+    appendLE<std::uint64_t>(trailer, pending.sequence);
+    if (!replaceFile(m_directory, m_snapshotPath, data, trailer)) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_stats.snapshots;
+    return true;
+}
+
+bool CommandJournal::compact(const Pending& last) {
+    std::string data;
+    appendRecord(data, last.sequence, last.command);
+
+    std::fclose(m_file);
+    m_file = nullptr;
+    bool replaced = replaceFile(m_directory, m_journalPath, data);
+    m_file = std::fopen(m_journalPath.c_str(), "ab");
+    if (!m_file) {
+        return false;
+    }
+    if (replaced) {
+        m_fileSize = data.size();
+    }
+    return replaced;
+}
+
+bool CommandJournal::loadSnapshot(CompiledProject& project, std::string& error) const {
+    return project.open(m_snapshotPath, error);
+}
+
+bool CommandJournal::restore(ProjectLoader& loader, Container& root, std::string& error) const {
+    std::optional<ProjectLoadCommand> last;
+    std::uint64_t lastSequence = 0;
+    std::string data;
+    if (readFile(m_journalPath, data)) {
+        scanRecords(data, [&](std::uint64_t sequence, const ProjectLoadCommand& command) {
+            last = command;
+            lastSequence = sequence;
+        });
+    }
+
+    CompiledProject snapshot;
+    std::string snapshotError;
+    bool haveSnapshot = loadSnapshot(snapshot, snapshotError);
+
+    // Снимок пишется после журнала: сбой между ними или неудачная запись
+    // снимка оставляют в журнале запись новее снимка - тогда она первая
+    bool journalFirst = last && (!haveSnapshot || lastSequence > readSnapshotSequence(m_snapshotPath));
+    std::string journalError;
+    auto applyJournal = [&]() {
+        auto result = loader.apply(root, *last);
+        journalError = result.error;
+        return result.success;
+    };
+
+    if (journalFirst && applyJournal()) return true;
+    if (haveSnapshot) {
+        auto result = loader.apply(root, snapshot);
+        if (result.success) return true;
+        snapshotError = result.error;
+    }
+    // Снимок испорчен - последняя целая команда журнала
+    if (last && !journalFirst && applyJournal()) return true;
+
+    if (!last) {
+        error = "no snapshot (" + snapshotError + ") and no journal records";
+    } else {
+        error = journalError.empty() ? snapshotError : journalError;
+    }
+    return false;
+}
+
+CommandJournal::ReplayResult CommandJournal::replay(
+    const std::function<void(const ProjectLoadCommand&)>& callback) const {
+    ReplayResult result;
+    std::string data;
+    if (!readFile(m_journalPath, data)) {
+        return result;
+    }
+    auto scan = scanRecords(data, [&callback](std::uint64_t, const ProjectLoadCommand& command) {
+        if (callback) callback(command);
+    });
+    result.records = scan.records;
+    result.skippedBytes = data.size() - scan.validSize;
+    return result;
+}
+
+} // namespace hmi3
\ No newline at end of file
@@ -1,104 +1,572 @@
-#include "hmi3/command_receiver.hpp"
-#include <SFML/Network.hpp>
-#include <thread>
-#include <iostream>
-#include <cmath>
-
-namespace hmi3 {
-
-NetworkCommandReceiver::NetworkCommandReceiver(unsigned short port) 
-    : m_port(port)
-    , m_receiveTimeout(5000)
-    , m_running(false) {
-}
-
-NetworkCommandReceiver::~NetworkCommandReceiver() {
-    stop();
-}
-
-bool NetworkCommandReceiver::start() {
-    if (m_running) return true;
-
-    m_running = true;
-    m_receiveThread = std::thread(&NetworkCommandReceiver::receiveLoop, this);
-    return true;
-}
-
-void NetworkCommandReceiver::stop() {
-    m_running = false;
-    if (m_receiveThread.joinable()) {
-        m_receiveThread.join();
-    }
-}
-
-bool NetworkCommandReceiver::isRunning() const {
-    return m_running;
-}
-
-std::vector<ProjectLoadCommand> NetworkCommandReceiver::getCommands() {
-    std::lock_guard<std::mutex> lock(m_commandsMutex);
-    auto commands = std::move(m_commands);
-    m_commands.clear();
-    return commands;
-}
-
-void NetworkCommandReceiver::receiveLoop() {
-    sf::TcpListener listener;
-    
-    if (listener.listen(m_port) != sf::Socket::Status::Done) {
-        std::cerr << "Failed to bind to port " << m_port << std::endl;
-        m_running = false;
-        return;
-    }
-
-    std::cout << "Command receiver listening on port " << m_port << std::endl;
-
-    while (m_running) {
-        sf::TcpSocket socket;
-        if (listener.accept(socket) == sf::Socket::Status::Done) {
-            auto remoteAddr = socket.getRemoteAddress();
-            if (remoteAddr.has_value()) {
-                std::cout << "Client connected from " << remoteAddr.value().toString() << std::endl;
-            } else {
-                std::cout << "Client connected from unknown address" << std::endl;
-            }
-
-            char buffer[1024];
-            std::size_t received;
-            std::string data;
-
-            // Получаем данные
-            while (socket.receive(buffer, sizeof(buffer), received) == sf::Socket::Status::Done) {
-                data.append(buffer, received);
-            }
-
-            if (!data.empty()) {
-                ProjectLoadCommand command;
-                command.projectName = "ReceivedProject";
-                command.projectData = std::move(data);
-                command.version = 1;
-                command.forceLoad = false;
-
-                {
-                    std::lock_guard<std::mutex> lock(m_commandsMutex);
-                    m_commands.push_back(command);
-                }
-
-                if (m_commandCallback) {
-                    m_commandCallback(command);
-                }
-
-                std::cout << "Received project load command, data size: " 
-                          << command.projectData.size() << " bytes" << std::endl;
-            }
-
-            socket.disconnect();
-        }
-
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
-    }
-
-    listener.close();
-}
-
+#include "hmi3/command_receiver.hpp"
+#include "hmi3/atom_table.hpp"
+#include "hmi3/logger.hpp"
+#include "hmi3/protocol.hpp"
+#include "hmi3/session_recorder.hpp"
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <sstream>
+
+namespace hmi3 {
+
+namespace {
+
+// Верхняя граница ожидания селектора: за это время цикл проверяет
+// таймауты простоя соединений, даже если сеть молчит.
+const sf::Time kSelectorTimeout = sf::milliseconds(100);
+
+// Предел одного прямого чтения нагрузки, чтобы большой кадр
+// не занимал цикл надолго в ущерб остальным соединениям
+const std::size_t kMaxDirectRead = 1024 * 1024;
+
+// Пока очередь заполнена, селектор ждёт недолго и повторяет доставку
+const sf::Time kStalledRetryTimeout = sf::milliseconds(5);
+
+// Клиент сводки, не закрывший соединение сам, закрывается по истечении срока
+const sf::Time kMetricsClientTimeout = sf::seconds(1);
+
+void writeCounter(std::ostringstream& out, const char* name, std::uint64_t value) {
+    out << "# TYPE hmi3_receiver_" << name << " counter\n"
+        << "hmi3_receiver_" << name << ' ' << value << '\n';
+}
+
+void writeGauge(std::ostringstream& out, const char* name, std::uint64_t value) {
+    out << "# TYPE hmi3_receiver_" << name << " gauge\n"
+        << "hmi3_receiver_" << name << ' ' << value << '\n';
+}
+
+void writeSummary(std::ostringstream& out, const char* name, const HistogramSnapshot& histogram) {
+    out << "# TYPE hmi3_receiver_" << name << " summary\n";
+    for (double quantile : {0.5, 0.9, 0.99}) {
+        out << "hmi3_receiver_" << name << "{quantile=\"" << quantile << "\"} " << histogram.percentile(quantile)
+            << '\n';
+    }
+    out << "hmi3_receiver_" << name << "_max " << histogram.max << '\n'
+        << "hmi3_receiver_" << name << "_sum " << histogram.sum << '\n'
+        << "hmi3_receiver_" << name << "_count " << histogram.count << '\n';
+}
+
+} // namespace
+
+struct NetworkCommandReceiver::Connection {
+    enum class Mode {
+        Detect,
+        Framed,
+        Raw
+    };
+
+    sf::TcpSocket socket;
+    Mode mode = Mode::Detect;
+    FrameParser parser;
+    std::string pending;
+    PayloadWriter raw;
+    sf::Clock idleClock;
+
+    // Команды, не поместившиеся в очередь. Пока список не пуст, сокет
+    // снят с селектора и не читается - давление передаётся отправителю
+    std::deque<QueuedCommand> backlog;
+    bool stalled = false;
+    bool closing = false;
+
+    // Постоянное соединение между кадрами простаивает законно, но не вечно
+    bool isBetweenFrames() const { return mode == Mode::Framed && parser.isIdle(); }
+};
+
+// Сводка отправляется сразу после подключения; соединение закрывается,
+// когда клиент дочитал (прислал запрос или закрыл своё) - так закрытие не
+// обрывает ответ сбросом из-за непрочитанного запроса
+struct NetworkCommandReceiver::MetricsClient {
+    sf::TcpSocket socket;
+    sf::Clock clock;
+};
+
+std::vector<ProjectLoadCommand> AbstractCommandReceiver::getCommands() {
+    std::vector<ProjectLoadCommand> commands;
+    QueuedCommand queued;
+    while (m_queue.tryPop(queued)) {
+        if (!queued.dispatched) {
+            recordDispatch(queued);
+        }
+        commands.push_back(std::move(queued.command));
+    }
+    return commands;
+}
+
+std::size_t AbstractCommandReceiver::pump(std::size_t maxCommands) {
+    if (!m_commandCallback) {
+        return 0;
+    }
+
+    std::size_t dispatched = 0;
+    QueuedCommand queued;
+    while (dispatched < maxCommands && m_queue.tryPop(queued)) {
+        recordDispatch(queued);
+        m_commandCallback(queued.command);
+        ++dispatched;
+    }
+    return dispatched;
+}
+
+bool AbstractCommandReceiver::enqueueCommand(ProjectLoadCommand&& command) {
+    QueuedCommand queued{std::move(command), Clock::now()};
+    if (enqueueCommand(std::move(queued))) {
+        return true;
+    }
+    command = std::move(queued.command);
+    return false;
+}
+
+bool AbstractCommandReceiver::enqueueCommand(QueuedCommand&& queued) {
+    std::size_t payloadBytes = queued.command.projectData.size();
+    if (m_dispatchMode == DispatchMode::ReceiverThread && m_commandCallback) {
+        // Копия делит буфер нагрузки; кладётся до вызова обработчика, чтобы
+        // getCommands() после обработчика уже видел команду
+        QueuedCommand copy = queued;
+        copy.dispatched = true;
+        if (!m_queue.tryPush(std::move(copy))) {
+            m_counters.queueFull.fetch_add(1, std::memory_order_relaxed);
+        }
+        recordDispatch(queued);
+        m_commandCallback(queued.command);
+    } else if (!m_queue.tryPush(std::move(queued))) {
+        m_counters.queueFull.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    m_counters.commandsAccepted.fetch_add(1, std::memory_order_relaxed);
+    m_counters.payloadBytes.record(payloadBytes);
+    return true;
+}
+
+void AbstractCommandReceiver::recordDispatch(const QueuedCommand& queued) {
+    auto latency = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - queued.receivedAt);
+    m_counters.dispatchLatencyUs.record(static_cast<std::uint64_t>(std::max<std::int64_t>(latency.count(), 0)));
+    m_counters.commandsDispatched.fetch_add(1, std::memory_order_relaxed);
+    if (m_sessionRecorder) {
+        m_sessionRecorder->recordCommand(queued.command);
+    }
+}
+
+AbstractCommandReceiver::Stats AbstractCommandReceiver::getStats() const {
+    Stats stats;
+    stats.connectionsAccepted = m_counters.connectionsAccepted.load(std::memory_order_relaxed);
+    stats.connectionsRejected = m_counters.connectionsRejected.load(std::memory_order_relaxed);
+    std::uint64_t closed = m_counters.connectionsClosed.load(std::memory_order_relaxed);
+    stats.connectionsActive = stats.connectionsAccepted > closed ? stats.connectionsAccepted - closed : 0;
+    stats.bytesReceived = m_counters.bytesReceived.load(std::memory_order_relaxed);
+    stats.commandsAccepted = m_counters.commandsAccepted.load(std::memory_order_relaxed);
+    stats.commandsRejected = m_counters.commandsRejected.load(std::memory_order_relaxed);
+    stats.commandsDispatched = m_counters.commandsDispatched.load(std::memory_order_relaxed);
+    stats.queueFull = m_counters.queueFull.load(std::memory_order_relaxed);
+    stats.queueDepth = m_queue.size();
+    stats.queueCapacity = m_queue.capacity();
+    stats.dispatchLatencyUs = m_counters.dispatchLatencyUs.snapshot();
+    stats.payloadBytes = m_counters.payloadBytes.snapshot();
+    return stats;
+}
+
+std::string AbstractCommandReceiver::formatStats(const Stats& stats) {
+    std::ostringstream out;
+    writeCounter(out, "connections_accepted_total", stats.connectionsAccepted);
+    writeCounter(out, "connections_rejected_total", stats.connectionsRejected);
+    writeGauge(out, "connections_active", stats.connectionsActive);
+    writeCounter(out, "bytes_received_total", stats.bytesReceived);
+    writeCounter(out, "commands_accepted_total", stats.commandsAccepted);
+    writeCounter(out, "commands_rejected_total", stats.commandsRejected);
+    writeCounter(out, "commands_dispatched_total", stats.commandsDispatched);
+    writeCounter(out, "queue_full_total", stats.queueFull);
+    writeGauge(out, "queue_depth", stats.queueDepth);
+    writeGauge(out, "queue_capacity", stats.queueCapacity);
+    writeSummary(out, "dispatch_latency_us", stats.dispatchLatencyUs);
+    writeSummary(out, "payload_bytes", stats.payloadBytes);
+    return out.str();
+}
+
+NetworkCommandReceiver::NetworkCommandReceiver(unsigned short port, std::size_t queueCapacity)
+    : AbstractCommandReceiver(queueCapacity)
+    , m_port(port)
+    , m_localPort(0)
+    , m_receiveTimeout(5000)
+    , m_keepAliveTimeout(60000)
+    , m_maxConnections(64)
+    , m_metricsEnabled(false)
+    , m_metricsPort(0)
+    , m_localMetricsPort(0)
+    , m_running(false)
+    , m_connectionCount(0)
+    , m_buffer(64 * 1024) {
+}
+
+NetworkCommandReceiver::~NetworkCommandReceiver() {
+    stop();
+}
+
+bool NetworkCommandReceiver::start() {
+    if (m_running) return true;
+
+    // Слушаем в вызывающем потоке, чтобы ошибка привязки вернулась из start()
+    if (m_listener.listen(m_port) != sf::Socket::Status::Done) {
+        HMI3_LOG_ERROR("Failed to bind to port " << m_port);
+        return false;
+    }
+    m_localPort = m_listener.getLocalPort();
+
+    if (m_metricsEnabled) {
+        if (m_metricsListener.listen(m_metricsPort, sf::IpAddress::LocalHost) != sf::Socket::Status::Done) {
+            HMI3_LOG_ERROR("Failed to bind metrics endpoint to port " << m_metricsPort);
+            m_listener.close();
+            return false;
+        }
+        m_localMetricsPort = m_metricsListener.getLocalPort();
+        HMI3_LOG_INFO("Receiver metrics on http://127.0.0.1:" << m_localMetricsPort << "/metrics");
+    }
+
+    HMI3_LOG_INFO("Command receiver listening on port " << m_localPort);
+
+    m_running = true;
+    m_receiveThread = std::thread(&NetworkCommandReceiver::receiveLoop, this);
+    return true;
+}
+
+void NetworkCommandReceiver::stop() {
+    if (m_running.exchange(false)) {
+        wakeUp();
+    }
+    if (m_receiveThread.joinable()) {
+        m_receiveThread.join();
+    }
+}
+
+bool NetworkCommandReceiver::isRunning() const {
+    return m_running;
+}
+
+void NetworkCommandReceiver::setMetricsPort(unsigned short port) {
+    m_metricsEnabled = true;
+    m_metricsPort = port;
+}
+
+void NetworkCommandReceiver::receiveLoop() {
+    m_selector.add(m_listener);
+    if (m_metricsEnabled) {
+        m_selector.add(m_metricsListener);
+    }
+
+    while (m_running) {
+        bool stalled = flushStalledConnections();
+
+        if (m_selector.wait(stalled ? kStalledRetryTimeout : kSelectorTimeout)) {
+            if (m_selector.isReady(m_listener)) {
+                acceptConnection();
+            }
+            if (m_metricsEnabled && m_selector.isReady(m_metricsListener)) {
+                acceptMetricsClient();
+            }
+
+            for (std::size_t i = 0; i < m_connections.size();) {
+                Connection& connection = *m_connections[i];
+                if (!connection.stalled && m_selector.isReady(connection.socket) &&
+                    !readConnection(connection)) {
+                    closeConnection(i);
+                    continue;
+                }
+                ++i;
+            }
+        }
+
+        // Зависший или молчащий клиент не должен вечно занимать слот
+        // соединения; ждёт только соединение, которое ждём мы сами
+        int receiveTimeout = m_receiveTimeout;
+        int keepAliveTimeout = m_keepAliveTimeout;
+        for (std::size_t i = 0; i < m_connections.size();) {
+            const Connection& connection = *m_connections[i];
+            bool betweenFrames = connection.isBetweenFrames();
+            int timeout = betweenFrames ? keepAliveTimeout : receiveTimeout;
+            if (!connection.stalled && timeout > 0 &&
+                connection.idleClock.getElapsedTime().asMilliseconds() > timeout) {
+                if (betweenFrames) {
+                    HMI3_LOG_DEBUG("Closing idle persistent connection");
+                } else {
+                    HMI3_LOG_WARNING("Client timed out, dropping " << connection.raw.size() << " bytes");
+                }
+                closeConnection(i);
+                continue;
+            }
+            ++i;
+        }
+        serviceMetricsClients();
+    }
+
+    while (!m_connections.empty()) {
+        closeConnection(m_connections.size() - 1);
+    }
+    m_metricsClients.clear();
+    m_selector.clear();
+    m_listener.close();
+    m_metricsListener.close();
+}
+
+void NetworkCommandReceiver::acceptConnection() {
+    auto connection = std::make_unique<Connection>();
+    if (m_listener.accept(connection->socket) != sf::Socket::Status::Done) {
+        return;
+    }
+
+    // Соединение от wakeUp() или клиента, пришедшего во время остановки
+    if (!m_running) {
+        return;
+    }
+
+    if (m_connections.size() >= m_maxConnections) {
+        m_counters.connectionsRejected.fetch_add(1, std::memory_order_relaxed);
+        HMI3_LOG_WARNING("Connection limit reached, rejecting client");
+        return;
+    }
+
+    if (Logger::instance().isEnabled(LogLevel::Debug)) {
+        auto remoteAddr = connection->socket.getRemoteAddress();
+        HMI3_LOG_DEBUG("Client connected from " << (remoteAddr ? remoteAddr->toString() : std::string("unknown address")));
+    }
+
+    m_counters.connectionsAccepted.fetch_add(1, std::memory_order_relaxed);
+    m_selector.add(connection->socket);
+    m_connections.push_back(std::move(connection));
+    m_connectionCount = m_connections.size();
+}
+
+void NetworkCommandReceiver::acceptMetricsClient() {
+    auto client = std::make_unique<MetricsClient>();
+    if (m_metricsListener.accept(client->socket) != sf::Socket::Status::Done || !m_running) {
+        return;
+    }
+
+    // Сводка в несколько килобайт помещается в буфер сокета, отправка не ждёт
+    std::string body = formatStats(getStats()) + AtomTable::formatStats(AtomTable::global().getStats());
+    std::string response = "HTTP/1.0 200 OK\r\n"
+                           "Content-Type: text/plain; version=0.0.4\r\n"
+                           "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                           "Connection: close\r\n"
+                           "\r\n" + body;
+    if (client->socket.send(response.data(), response.size()) != sf::Socket::Status::Done) {
+        return;
+    }
+    client->socket.setBlocking(false);
+    m_selector.add(client->socket);
+    m_metricsClients.push_back(std::move(client));
+}
+
+void NetworkCommandReceiver::serviceMetricsClients() {
+    for (std::size_t i = 0; i < m_metricsClients.size();) {
+        MetricsClient& client = *m_metricsClients[i];
+        bool done = client.clock.getElapsedTime() > kMetricsClientTimeout;
+        if (!done && m_selector.isReady(client.socket)) {
+            // Запрос не разбирается: ответ один на любой путь
+            std::size_t received = 0;
+            while (client.socket.receive(m_buffer.data(), m_buffer.size(), received) == sf::Socket::Status::Done) {
+            }
+            done = true;
+        }
+        if (!done) {
+            ++i;
+            continue;
+        }
+        m_selector.remove(client.socket);
+        client.socket.disconnect();
+        std::swap(m_metricsClients[i], m_metricsClients.back());
+        m_metricsClients.pop_back();
+    }
+}
+
+bool NetworkCommandReceiver::readConnection(Connection& connection) {
+    // Одно чтение за пробуждение: быстрый клиент не может заморить остальных
+    std::size_t received = 0;
+    std::size_t windowSize = 0;
+    char* window = connection.mode == Connection::Mode::Framed
+        ? connection.parser.payloadWindow(windowSize)
+        : nullptr;
+
+    sf::Socket::Status status;
+    if (window) {
+        // Нагрузка читается сразу в блок из пула, без промежуточной копии
+        status = connection.socket.receive(window, std::min(windowSize, kMaxDirectRead), received);
+        if (status == sf::Socket::Status::Done) {
+            m_counters.bytesReceived.fetch_add(received, std::memory_order_relaxed);
+            connection.idleClock.restart();
+            return handleFrameResult(connection, connection.parser.commitPayload(received));
+        }
+    } else {
+        status = connection.socket.receive(m_buffer.data(), m_buffer.size(), received);
+        if (status == sf::Socket::Status::Done) {
+            m_counters.bytesReceived.fetch_add(received, std::memory_order_relaxed);
+            connection.idleClock.restart();
+            return consumeData(connection, m_buffer.data(), received);
+        }
+    }
+
+    if (status == sf::Socket::Status::NotReady || status == sf::Socket::Status::Partial) {
+        return true;
+    }
+
+    if (status == sf::Socket::Status::Disconnected) {
+        if (connection.mode == Connection::Mode::Framed && !connection.parser.isIdle()) {
+            m_counters.commandsRejected.fetch_add(1, std::memory_order_relaxed);
+            HMI3_LOG_WARNING("Client disconnected in the middle of a frame");
+        } else if (connection.mode != Connection::Mode::Framed) {
+            // Старый клиент закрыл соединение - всё полученное считается одной командой
+            connection.raw.append(connection.pending.data(), connection.pending.size());
+            ProjectLoadCommand command;
+            command.projectName = "ReceivedProject";
+            command.projectData = connection.raw.finish();
+            command.version = 1;
+            command.forceLoad = false;
+            if (!command.projectData.empty()) {
+                dispatchCommand(connection, std::move(command));
+            }
+        }
+    }
+
+    // Соединение с недоставленными командами закроется после их доставки
+    if (connection.stalled) {
+        connection.closing = true;
+        return true;
+    }
+    return false;
+}
+
+bool NetworkCommandReceiver::consumeData(Connection& connection, const char* data, std::size_t size) {
+    if (connection.mode == Connection::Mode::Framed) {
+        return consumeFrames(connection, data, size);
+    }
+    if (connection.mode == Connection::Mode::Raw) {
+        connection.raw.append(data, size);
+        return true;
+    }
+
+    // Режим определяется по первым байтам: магия кадра или сырой поток
+    connection.pending.append(data, size);
+    std::size_t prefix = std::min(connection.pending.size(), sizeof(protocol::kMagic));
+    if (std::memcmp(connection.pending.data(), protocol::kMagic, prefix) != 0) {
+        connection.mode = Connection::Mode::Raw;
+        connection.raw.append(connection.pending.data(), connection.pending.size());
+        connection.pending.clear();
+    } else if (prefix == sizeof(protocol::kMagic)) {
+        connection.mode = Connection::Mode::Framed;
+        std::string pending = std::move(connection.pending);
+        connection.pending.clear();
+        return consumeFrames(connection, pending.data(), pending.size());
+    }
+    return true;
+}
+
+bool NetworkCommandReceiver::consumeFrames(Connection& connection, const char* data, std::size_t size) {
+    std::size_t offset = 0;
+    while (offset < size) {
+        std::size_t consumed = 0;
+        auto result = connection.parser.feed(data + offset, size - offset, consumed);
+        offset += consumed;
+        if (!handleFrameResult(connection, result)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool NetworkCommandReceiver::handleFrameResult(Connection& connection, FrameParser::Result result) {
+    switch (result) {
+    case FrameParser::Result::FrameReady: {
+        const auto& stats = connection.parser.getFrameStats();
+        if (stats.compression != PayloadCompression::None) {
+            double seconds = std::max(stats.decodeSeconds, 1e-9);
+            HMI3_LOG_DEBUG("Decompressed " << compressionName(stats.compression) << " payload: "
+                           << stats.wireBytes << " -> " << stats.payloadBytes << " bytes, "
+                           << stats.payloadBytes / seconds / (1024.0 * 1024.0) << " MB/s, peak memory "
+                           << stats.peakMemory / 1024 << " KB");
+        }
+        dispatchCommand(connection, connection.parser.takeCommand());
+        break;
+    }
+    case FrameParser::Result::FrameRejected:
+        m_counters.commandsRejected.fetch_add(1, std::memory_order_relaxed);
+        HMI3_LOG_WARNING("Rejected frame: " << connection.parser.getError());
+        break;
+    case FrameParser::Result::ProtocolError:
+        m_counters.commandsRejected.fetch_add(1, std::memory_order_relaxed);
+        HMI3_LOG_WARNING("Protocol error: " << connection.parser.getError());
+        return false;
+    case FrameParser::Result::NeedMoreData:
+        break;
+    }
+    return true;
+}
+
+void NetworkCommandReceiver::dispatchCommand(Connection& connection, ProjectLoadCommand&& command) {
+    HMI3_LOG_DEBUG("Received project load command, data size: " << command.projectData.size() << " bytes");
+
+    // Порядок команд одного соединения сохраняется: новая встаёт за отложенными
+    QueuedCommand queued{std::move(command), Clock::now()};
+    if (connection.backlog.empty() && enqueueCommand(std::move(queued))) {
+        return;
+    }
+
+    connection.backlog.push_back(std::move(queued));
+    if (!connection.stalled) {
+        m_selector.remove(connection.socket);
+        connection.stalled = true;
+    }
+}
+
+bool NetworkCommandReceiver::flushStalledConnections() {
+    bool stalled = false;
+    for (std::size_t i = 0; i < m_connections.size();) {
+        Connection& connection = *m_connections[i];
+        if (!connection.stalled) {
+            ++i;
+            continue;
+        }
+
+        while (!connection.backlog.empty() && enqueueCommand(std::move(connection.backlog.front()))) {
+            connection.backlog.pop_front();
+        }
+
+        if (!connection.backlog.empty()) {
+            stalled = true;
+            ++i;
+            continue;
+        }
+
+        connection.stalled = false;
+        if (connection.closing) {
+            closeConnection(i);
+            continue;
+        }
+        m_selector.add(connection.socket);
+        connection.idleClock.restart();
+        ++i;
+    }
+    return stalled;
+}
+
+void NetworkCommandReceiver::closeConnection(std::size_t index) {
+    auto& connection = m_connections[index];
+    if (!connection->stalled) {
+        m_selector.remove(connection->socket);
+    }
+    connection->socket.disconnect();
+
+    // Порядок соединений не важен - удаляем обменом с последним
+    std::swap(connection, m_connections.back());
+    m_connections.pop_back();
+    m_connectionCount = m_connections.size();
+    m_counters.connectionsClosed.fetch_add(1, std::memory_order_relaxed);
+}
+
+void NetworkCommandReceiver::wakeUp() {
+    // Пробуждаем селектор подключением к собственному порту,
+    // чтобы не ждать истечения kSelectorTimeout
+    sf::TcpSocket socket;
+    if (socket.connect(sf::IpAddress::LocalHost, m_localPort, sf::milliseconds(100)) == sf::Socket::Status::Done) {
+        socket.disconnect();
+    }
+}
+
 } // namespace hmi3
\ No newline at end of file
@@ -0,0 +1,416 @@
+#include "hmi3/compiled_project.hpp"
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace hmi3 {
+
+namespace {
+
+constexpr char kMagic[8] = {'H', 'M', 'I', '3', 'P', 'R', 'J', '\0'};
+constexpr std::uint32_t kFormatVersion = 1;
+
+// Смещения полей заголовка
+enum HeaderField : std::size_t {
+    FormatVersion = 8,
+    ProjectVersion = 12,
+    ComponentCount = 16,
+    PropertyCount = 20,
+    StringCount = 24,
+    RootFirstProperty = 28,
+    RootPropertyCount = 32,
+    ComponentsOffset = 36,
+    PropertiesOffset = 40,
+    StringsOffset = 44,
+    StringDataOffset = 48,
+    StringDataSize = 52,
+    HeaderSize = 56
+};
+
+// Размеры записей: компонент - type, id, parent, firstProperty, propertyCount;
+// свойство - name, value; строка - offset, length
+constexpr std::size_t kComponentSize = 5 * sizeof(std::uint32_t);
+constexpr std::size_t kPropertySize = 2 * sizeof(std::uint32_t);
+constexpr std::size_t kStringSize = 2 * sizeof(std::uint32_t);
+
+void put(std::vector<char>& output, std::size_t offset, std::uint32_t value) {
+    std::memcpy(output.data() + offset, &value, sizeof(value));
+}
+
+} // namespace
+
+struct CompiledProject::ComponentRecord {
+    std::uint32_t type;
+    std::uint32_t id;
+    std::uint32_t parent;
+    std::uint32_t firstProperty;
+    std::uint32_t propertyCount;
+};
+
+CompiledProject::~CompiledProject() {
+    close();
+}
+
+CompiledProject::CompiledProject(CompiledProject&& other) noexcept {
+    *this = std::move(other);
+}
+
+CompiledProject& CompiledProject::operator=(CompiledProject&& other) noexcept {
+    if (this != &other) {
+        close();
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+        std::swap(m_mapping, other.m_mapping);
+        std::swap(m_mappingSize, other.m_mappingSize);
+#ifdef _WIN32
+        std::swap(m_file, other.m_file);
+        std::swap(m_mappingHandle, other.m_mappingHandle);
+#endif
+    }
+    return *this;
+}
+
+bool CompiledProject::open(const std::string& path, std::string& error) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        error = "cannot open " + path;
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        error = "cannot map empty file " + path;
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        error = "cannot map " + path;
+        return false;
+    }
+    m_file = file;
+    m_mappingHandle = mapping;
+    m_mapping = view;
+    m_mappingSize = static_cast<std::size_t>(size.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "cannot open " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        ::close(fd);
+        error = "cannot map empty file " + path;
+        return false;
+    }
+    std::size_t size = static_cast<std::size_t>(info.st_size);
+    void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // Отображение держит файл само
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        error = "cannot map " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    m_mapping = view;
+    m_mappingSize = size;
+#endif
+
+    m_data = static_cast<const unsigned char*>(m_mapping);
+    m_size = m_mappingSize;
+    if (!validate(error)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool CompiledProject::openMemory(const void* data, std::size_t size, std::string& error) {
+    close();
+    m_data = static_cast<const unsigned char*>(data);
+    m_size = size;
+    if (!m_data || !validate(error)) {
+        m_data = nullptr;
+        m_size = 0;
+        if (error.empty()) error = "no data";
+        return false;
+    }
+    return true;
+}
+
+void CompiledProject::close() {
+    if (m_mapping) {
+#ifdef _WIN32
+        UnmapViewOfFile(m_mapping);
+        CloseHandle(m_mappingHandle);
+        CloseHandle(m_file);
+        m_mappingHandle = nullptr;
+        m_file = nullptr;
+#else
+        munmap(m_mapping, m_mappingSize);
+#endif
+        m_mapping = nullptr;
+        m_mappingSize = 0;
+    }
+    m_data = nullptr;
+    m_size = 0;
+}
+
+bool CompiledProject::isCompiled(std::string_view data) {
+    return data.size() >= sizeof(kMagic) && std::memcmp(data.data(), kMagic, sizeof(kMagic)) == 0;
+}
+
+bool CompiledProject::validate(std::string& error) {
+    if (m_size < HeaderSize || std::memcmp(m_data, kMagic, sizeof(kMagic)) != 0) {
+        error = "not a compiled project";
+        return false;
+    }
+    if (field(FormatVersion) != kFormatVersion) {
+        error = "unsupported compiled project format " + std::to_string(field(FormatVersion));
+        return false;
+    }
+
+    // Таблицы должны целиком лежать в файле; дальше записи читаются без проверок
+    auto fits = [this](std::uint64_t offset, std::uint64_t count, std::uint64_t recordSize) {
+        return offset + count * recordSize <= m_size;
+    };
+    std::uint32_t componentCount = field(ComponentCount);
+    std::uint32_t propertyCount = field(PropertyCount);
+    std::uint32_t stringCount = field(StringCount);
+    std::uint32_t stringDataSize = field(StringDataSize);
+    if (!fits(field(ComponentsOffset), componentCount, kComponentSize) ||
+        !fits(field(PropertiesOffset), propertyCount, kPropertySize) ||
+        !fits(field(StringsOffset), stringCount, kStringSize) || !fits(field(StringDataOffset), stringDataSize, 1)) {
+        error = "compiled project is truncated";
+        return false;
+    }
+
+    std::size_t strings = field(StringsOffset);
+    for (std::uint32_t i = 0; i < stringCount; ++i) {
+        std::uint64_t offset = field(strings + i * kStringSize);
+        std::uint64_t length = field(strings + i * kStringSize + 4);
+        if (offset + length > stringDataSize) {
+            error = "string " + std::to_string(i) + " is out of range";
+            return false;
+        }
+    }
+    std::size_t properties = field(PropertiesOffset);
+    for (std::uint32_t i = 0; i < propertyCount; ++i) {
+        if (field(properties + i * kPropertySize) >= stringCount ||
+            field(properties + i * kPropertySize + 4) >= stringCount) {
+            error = "property " + std::to_string(i) + " refers to a missing string";
+            return false;
+        }
+    }
+    if (static_cast<std::uint64_t>(field(RootFirstProperty)) + field(RootPropertyCount) > propertyCount) {
+        error = "root properties are out of range";
+        return false;
+    }
+    // id уникальны во всём проекте, как и в текстовом описании
+    std::unordered_set<std::string_view> ids;
+    ids.reserve(componentCount);
+    for (std::uint32_t i = 0; i < componentCount; ++i) {
+        ComponentRecord record = component(i);
+        // Родитель раньше ребёнка - дерево строится за один проход
+        if (record.type >= stringCount || record.id >= stringCount ||
+            (record.parent != noParent && record.parent >= i) ||
+            static_cast<std::uint64_t>(record.firstProperty) + record.propertyCount > propertyCount) {
+            error = "component " + std::to_string(i) + " is malformed";
+            return false;
+        }
+        if (!ids.insert(string(record.id)).second) {
+            error = "duplicate component id '" + std::string(string(record.id)) + "'";
+            return false;
+        }
+    }
+    return true;
+}
+
+std::uint32_t CompiledProject::field(std::size_t offset) const {
+    // Буфер из сети может быть не выровнен
+    std::uint32_t value;
+    std::memcpy(&value, m_data + offset, sizeof(value));
+    return value;
+}
+
+CompiledProject::ComponentRecord CompiledProject::component(std::size_t index) const {
+    std::size_t offset = field(ComponentsOffset) + index * kComponentSize;
+    return ComponentRecord{field(offset), field(offset + 4), field(offset + 8), field(offset + 12),
+                           field(offset + 16)};
+}
+
+CompiledProperty CompiledProject::property(std::size_t index) const {
+    std::size_t offset = field(PropertiesOffset) + index * kPropertySize;
+    return CompiledProperty{string(field(offset)), string(field(offset + 4))};
+}
+
+std::string_view CompiledProject::string(std::uint32_t index) const {
+    std::size_t offset = field(StringsOffset) + static_cast<std::size_t>(index) * kStringSize;
+    const char* data = reinterpret_cast<const char*>(m_data) + field(StringDataOffset) + field(offset);
+    return std::string_view(data, field(offset + 4));
+}
+
+std::uint32_t CompiledProject::getVersion() const {
+    return field(ProjectVersion);
+}
+
+std::size_t CompiledProject::getComponentCount() const {
+    return field(ComponentCount);
+}
+
+std::string_view CompiledProject::getType(std::size_t component) const {
+    return string(this->component(component).type);
+}
+
+std::string_view CompiledProject::getId(std::size_t component) const {
+    return string(this->component(component).id);
+}
+
+std::uint32_t CompiledProject::getParent(std::size_t component) const {
+    return this->component(component).parent;
+}
+
+std::size_t CompiledProject::getPropertyCount(std::size_t component) const {
+    return this->component(component).propertyCount;
+}
+
+CompiledProperty CompiledProject::getProperty(std::size_t component, std::size_t property) const {
+    return this->property(this->component(component).firstProperty + property);
+}
+
+std::size_t CompiledProject::getRootPropertyCount() const {
+    return field(RootPropertyCount);
+}
+
+CompiledProperty CompiledProject::getRootProperty(std::size_t property) const {
+    return this->property(field(RootFirstProperty) + property);
+}
+
+std::size_t CompiledProject::getStringCount() const {
+    return field(StringCount);
+}
+
+bool compileProject(const ProjectDescription& description, std::uint32_t version, std::vector<char>& output,
+                    std::string& error) {
+    // Пул строк: типы, id, имена и значения свойств встречаются многократно
+    std::vector<std::string_view> strings;
+    std::unordered_map<std::string_view, std::uint32_t> stringIndex;
+    std::uint64_t stringDataSize = 0;
+    auto intern = [&](std::string_view text) {
+        auto it = stringIndex.emplace(text, static_cast<std::uint32_t>(strings.size()));
+        if (it.second) {
+            strings.push_back(text);
+            stringDataSize += text.size();
+        }
+        return it.first->second;
+    };
+
+    std::unordered_map<std::string_view, std::uint32_t> componentIndex;
+    componentIndex.reserve(description.components.size());
+    std::uint64_t propertyCount = description.rootProperties.size();
+    for (std::size_t i = 0; i < description.components.size(); ++i) {
+        const ComponentSpec& spec = description.components[i];
+        if (!spec.parent.empty() && !componentIndex.count(spec.parent)) {
+            error = "parent '" + spec.parent + "' of '" + spec.id + "' is not declared before it";
+            return false;
+        }
+        if (!componentIndex.emplace(spec.id, static_cast<std::uint32_t>(i)).second) {
+            error = "duplicate component id '" + spec.id + "'";
+            return false;
+        }
+        propertyCount += spec.properties.size();
+    }
+
+    std::vector<std::uint32_t> propertyStrings;
+    propertyStrings.reserve(propertyCount * 2);
+    std::vector<std::uint32_t> componentStrings;
+    componentStrings.reserve(description.components.size() * 2);
+    for (const auto& property : description.rootProperties) {
+        propertyStrings.push_back(intern(property.first));
+        propertyStrings.push_back(intern(property.second));
+    }
+    for (const ComponentSpec& spec : description.components) {
+        componentStrings.push_back(intern(spec.type));
+        componentStrings.push_back(intern(spec.id));
+        for (const auto& property : spec.properties) {
+            propertyStrings.push_back(intern(property.first));
+            propertyStrings.push_back(intern(property.second));
+        }
+    }
+
+    std::uint64_t componentsOffset = HeaderSize;
+    std::uint64_t propertiesOffset = componentsOffset + description.components.size() * kComponentSize;
+    std::uint64_t stringsOffset = propertiesOffset + propertyCount * kPropertySize;
+    std::uint64_t stringDataOffset = stringsOffset + strings.size() * kStringSize;
+    std::uint64_t total = stringDataOffset + stringDataSize;
+    if (total > std::numeric_limits<std::uint32_t>::max()) {
+        error = "project is too large for the compiled format";
+        return false;
+    }
+
+    output.assign(static_cast<std::size_t>(total), 0);
+    std::memcpy(output.data(), kMagic, sizeof(kMagic));
+    put(output, FormatVersion, kFormatVersion);
+    put(output, ProjectVersion, version);
+    put(output, ComponentCount, static_cast<std::uint32_t>(description.components.size()));
+    put(output, PropertyCount, static_cast<std::uint32_t>(propertyCount));
+    put(output, StringCount, static_cast<std::uint32_t>(strings.size()));
+    put(output, RootFirstProperty, 0);
+    put(output, RootPropertyCount, static_cast<std::uint32_t>(description.rootProperties.size()));
+    put(output, ComponentsOffset, static_cast<std::uint32_t>(componentsOffset));
+    put(output, PropertiesOffset, static_cast<std::uint32_t>(propertiesOffset));
+    put(output, StringsOffset, static_cast<std::uint32_t>(stringsOffset));
+    put(output, StringDataOffset, static_cast<std::uint32_t>(stringDataOffset));
+    put(output, StringDataSize, static_cast<std::uint32_t>(stringDataSize));
+
+    std::uint32_t firstProperty = static_cast<std::uint32_t>(description.rootProperties.size());
+    for (std::size_t i = 0; i < description.components.size(); ++i) {
+        const ComponentSpec& spec = description.components[i];
+        std::size_t offset = static_cast<std::size_t>(componentsOffset + i * kComponentSize);
+        put(output, offset, componentStrings[i * 2]);
+        put(output, offset + 4, componentStrings[i * 2 + 1]);
+        put(output, offset + 8, spec.parent.empty() ? CompiledProject::noParent : componentIndex.at(spec.parent));
+        put(output, offset + 12, firstProperty);
+        put(output, offset + 16, static_cast<std::uint32_t>(spec.properties.size()));
+        firstProperty += static_cast<std::uint32_t>(spec.properties.size());
+    }
+    for (std::size_t i = 0; i < propertyStrings.size(); ++i) {
+        put(output, static_cast<std::size_t>(propertiesOffset + i * 4), propertyStrings[i]);
+    }
+
+    std::uint32_t dataOffset = 0;
+    for (std::size_t i = 0; i < strings.size(); ++i) {
+        std::size_t offset = static_cast<std::size_t>(stringsOffset + i * kStringSize);
+        put(output, offset, dataOffset);
+        put(output, offset + 4, static_cast<std::uint32_t>(strings[i].size()));
+        std::memcpy(output.data() + stringDataOffset + dataOffset, strings[i].data(), strings[i].size());
+        dataOffset += static_cast<std::uint32_t>(strings[i].size());
+    }
+    return true;
+}
+
+} // namespace hmi3
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include "hmi3/components/component.hpp"
+#include "hmi3/container.hpp"
+#include "hmi3/properties.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace hmi3 {
+
+Component::~Component() {
+    AtomTable::global().release(m_atom);
+}
+
+void Component::setPosition(const sf::Vector2f& position) {
+    if (m_position == position) return;
+    m_position = position;
+    markDirty();
+    notifyBoundsChanged();
+}
+
+void Component::setVisible(bool visible) {
+    if (m_visible == visible) return;
+    m_visible = visible;
+    markDirty();
+    notifyBoundsChanged();
+}
+
+void Component::setSize(const sf::Vector2f& size) {
+    if (m_size == size) return;
+    m_size = size;
+    markDirty();
+    notifyBoundsChanged();
+}
+
+void Component::sleep() {
+    m_sleeping = true;
+    reschedule(-1.0);
+}
+
+void Component::sleepFor(float seconds) {
+    // Бесконечный срок - сон до пробуждения
+    if (!std::isfinite(seconds)) {
+        sleep();
+        return;
+    }
+    m_sleeping = true;
+    reschedule(std::max(seconds, 0.0f));
+}
+
+void Component::wake() {
+    if (!m_sleeping) return;
+    m_sleeping = false;
+    // С интервалом - первый тик в ближайшем кадре
+    reschedule(0.0);
+}
+
+void Component::setUpdateInterval(float seconds) {
+    seconds = std::max(seconds, 0.0f);
+    if (m_updateInterval == seconds) return;
+    m_updateInterval = seconds;
+    if (!m_sleeping) {
+        reschedule(seconds);
+    }
+}
+
+void Component::reschedule(double delay) {
+    ++m_scheduleTicket;
+    if (m_parent) {
+        m_parent->scheduleChild(*this, delay);
+    }
+}
+
+void Component::markDirty() {
+    // Новые данные или вид - повод обновиться
+    wake();
+    // Чистый узел означает чистое поддерево, поэтому подъём можно
+    // прекратить на первом уже помеченном предке
+    for (Component* node = this; node && !node->m_dirty; node = node->m_parent) {
+        node->m_dirty = true;
+    }
+}
+
+bool Component::applyProperty(std::string_view name, std::string_view value) {
+    if (name == "position") {
+        sf::Vector2f position;
+        if (!properties::parseVector(value, position)) return false;
+        setPosition(position);
+        return true;
+    }
+    if (name == "size") {
+        sf::Vector2f size;
+        if (!properties::parseVector(value, size)) return false;
+        setSize(size);
+        return true;
+    }
+    if (name == "visible") {
+        bool visible = true;
+        if (!properties::parseBool(value, visible)) return false;
+        setVisible(visible);
+        return true;
+    }
+    return false;
+}
+
+bool Component::hasBounds() const {
+    sf::FloatRect bounds = getBounds();
+    return bounds.size.x > 0.0f && bounds.size.y > 0.0f;
+}
+
+void Component::notifyBoundsChanged() {
+    if (m_parent) {
+        m_parent->onChildChanged(*this);
+    }
+}
+
+} // namespace hmi3
\ No newline at end of file
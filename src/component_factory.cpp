@@ -0,0 +1,35 @@
+#include "hmi3/component_factory.hpp"
+#include "hmi3/components/rectangle_component.hpp"
+#include "hmi3/components/trend_component.hpp"
+#include "hmi3/components/value_display_component.hpp"
+#include "hmi3/container.hpp"
+
+namespace hmi3 {
+
+ComponentFactory ComponentFactory::withBuiltins() {
+    ComponentFactory factory;
+    factory.registerType("container", [](const std::string& id) {
+        return std::make_shared<Container>(id);
+    });
+    factory.registerType("rectangle", [](const std::string& id) {
+        return std::make_shared<RectangleComponent>(id, sf::Vector2f(), sf::Color::White);
+    });
+    factory.registerType("trend", [](const std::string& id) {
+        return std::make_shared<TrendComponent>(id);
+    });
+    factory.registerType("value", [](const std::string& id) {
+        return std::make_shared<ValueDisplayComponent>(id);
+    });
+    return factory;
+}
+
+void ComponentFactory::registerType(const std::string& type, Creator creator) {
+    m_creators[type] = std::move(creator);
+}
+
+std::shared_ptr<Component> ComponentFactory::create(const std::string& type, const std::string& id) const {
+    auto it = m_creators.find(type);
+    return it != m_creators.end() ? it->second(id) : nullptr;
+}
+
+} // namespace hmi3
\ No newline at end of file
@@ -0,0 +1,223 @@
+#include "hmi3/compression.hpp"
+#include <lz4frame.h>
+#include <algorithm>
+
+namespace hmi3 {
+
+namespace {
+
+// Шаг роста результата, когда исходный размер в заголовке не указан
+const std::size_t kOutputChunk = 64 * 1024;
+// Словарь связанных блоков LZ4F держит 128 КБ уже распакованных данных
+const std::size_t kLz4DictionarySize = 128 * 1024;
+// Размер из заголовка LZ4 не проверен: заранее выделяем не больше этой
+// кратности сжатых байт. Текст проектов сжимается в 5-15 раз, так что
+// обычный кадр по-прежнему укладывается в один блок, а крошечный кадр
+// с огромным заявленным размером не занимает память впустую
+const std::uint64_t kMaxPresizeRatio = 16;
+
+std::size_t lz4BlockSize(LZ4F_blockSizeID_t id) {
+    switch (id) {
+    case LZ4F_max256KB:
+        return 256 * 1024;
+    case LZ4F_max1MB:
+        return 1024 * 1024;
+    case LZ4F_max4MB:
+        return 4 * 1024 * 1024;
+    default:
+        return 64 * 1024;
+    }
+}
+
+} // namespace
+
+struct StreamDecompressor::Context {
+    LZ4F_dctx* lz4 = nullptr;
+
+    ~Context() {
+        if (lz4) {
+            LZ4F_freeDecompressionContext(lz4);
+        }
+    }
+};
+
+const char* compressionName(PayloadCompression compression) {
+    switch (compression) {
+    case PayloadCompression::None:
+        return "none";
+    case PayloadCompression::Lz4:
+        return "lz4";
+    }
+    return "unknown";
+}
+
+bool compressPayload(PayloadCompression compression, std::string_view data, PayloadBuffer& out,
+                     std::string& error) {
+    if (compression == PayloadCompression::None) {
+        out = PayloadBuffer(data);
+        return true;
+    }
+    if (compression != PayloadCompression::Lz4) {
+        error = std::string("unsupported payload compression '") + compressionName(compression) + "'";
+        return false;
+    }
+
+    // Исходный размер пишется в заголовок - приёмник выделит память один раз
+    LZ4F_preferences_t preferences{};
+    preferences.frameInfo.contentSize = data.size();
+    preferences.frameInfo.contentChecksumFlag = LZ4F_contentChecksumEnabled;
+
+    std::size_t bound = LZ4F_compressFrameBound(data.size(), &preferences);
+    PayloadWriter writer(bound);
+    std::size_t size = LZ4F_compressFrame(writer.prepare(bound), bound, data.data(), data.size(), &preferences);
+    if (LZ4F_isError(size)) {
+        error = std::string("payload compression failed: ") + LZ4F_getErrorName(size);
+        return false;
+    }
+    writer.commit(size);
+    out = writer.finish();
+    return true;
+}
+
+StreamDecompressor::StreamDecompressor(PayloadCompression compression)
+    : m_compression(compression),
+      m_context(std::make_unique<Context>()),
+      m_infoKnown(false),
+      m_contentSizeKnown(false),
+      m_contentSize(0),
+      m_inputSize(0),
+      m_blockSize(0),
+      m_complete(false) {
+    if (m_compression == PayloadCompression::Lz4 &&
+        LZ4F_isError(LZ4F_createDecompressionContext(&m_context->lz4, LZ4F_VERSION))) {
+        m_context->lz4 = nullptr;
+    }
+}
+
+StreamDecompressor::~StreamDecompressor() = default;
+
+void StreamDecompressor::reset(std::uint64_t inputSize) {
+    if (m_context->lz4) {
+        LZ4F_resetDecompressionContext(m_context->lz4);
+    }
+    m_infoKnown = false;
+    m_contentSizeKnown = false;
+    m_contentSize = 0;
+    m_inputSize = inputSize;
+    m_blockSize = 0;
+    m_complete = false;
+    m_error.clear();
+}
+
+std::size_t StreamDecompressor::getWorkingMemory() const {
+    // Вход блока и выход блока вместе со словарём
+    return m_blockSize > 0 ? 2 * m_blockSize + kLz4DictionarySize : 0;
+}
+
+bool StreamDecompressor::readFrameInfo(const char*& data, std::size_t& size, PayloadWriter& out,
+                                       std::uint64_t limit) {
+    // Заголовок может прийти не целиком - тогда его накопит сам LZ4F,
+    // а размер узнаем после первой распаковки
+    LZ4F_frameInfo_t info{};
+    std::size_t consumed = size;
+    std::size_t hint = LZ4F_getFrameInfo(m_context->lz4, &info, data, &consumed);
+    if (LZ4F_isError(hint)) {
+        return true;
+    }
+    data += consumed;
+    size -= consumed;
+    return applyFrameInfo(info.blockSizeID, info.contentSize, out, limit);
+}
+
+bool StreamDecompressor::applyFrameInfo(int blockSizeId, std::uint64_t contentSize, PayloadWriter& out,
+                                        std::uint64_t limit) {
+    m_infoKnown = true;
+    m_blockSize = lz4BlockSize(static_cast<LZ4F_blockSizeID_t>(blockSizeId));
+
+    if (contentSize > 0) {
+        if (contentSize > limit) {
+            m_error = "decompressed payload too large";
+            return false;
+        }
+        m_contentSizeKnown = true;
+        m_contentSize = contentSize;
+        std::uint64_t presize = std::min<std::uint64_t>(
+            contentSize, std::max<std::uint64_t>(kOutputChunk, m_inputSize * kMaxPresizeRatio));
+        if (out.capacity() < presize) {
+            out.prepare(static_cast<std::size_t>(presize - out.size()));
+        }
+    }
+    return true;
+}
+
+bool StreamDecompressor::feed(const char* data, std::size_t size, PayloadWriter& out, std::uint64_t limit) {
+    if (!m_error.empty()) {
+        return false;
+    }
+    if (!m_context->lz4) {
+        m_error = std::string("unsupported payload compression '") + compressionName(m_compression) + "'";
+        return false;
+    }
+    if (!m_infoKnown && size > 0 && !readFrameInfo(data, size, out, limit)) {
+        return false;
+    }
+
+    char spill[4096];
+    bool outputFull = false;
+    while (size > 0 || outputFull) {
+        if (m_complete) {
+            if (size == 0) {
+                break;
+            }
+            m_error = "data after the end of the compressed stream";
+            return false;
+        }
+
+        // Пишем прямо в блок результата; место кончилось - растём шагом,
+        // а сверх известного размера остаток (конец потока) идёт через spill
+        std::size_t space = out.capacity() - out.size();
+        if (space == 0 && (!m_contentSizeKnown || out.size() < m_contentSize)) {
+            out.prepare(kOutputChunk);
+            space = out.capacity() - out.size();
+        }
+        char* dst = space > 0 ? out.prepare(space) : spill;
+        std::size_t dstSize = space > 0 ? space : sizeof(spill);
+        std::size_t offered = dstSize;
+        std::size_t srcSize = size;
+
+        std::size_t hint = LZ4F_decompress(m_context->lz4, dst, &dstSize, data, &srcSize, nullptr);
+        if (LZ4F_isError(hint)) {
+            m_error = std::string("corrupt compressed payload: ") + LZ4F_getErrorName(hint);
+            return false;
+        }
+        if (dst == spill) {
+            out.append(spill, dstSize);
+        } else {
+            out.commit(dstSize);
+        }
+        data += srcSize;
+        size -= srcSize;
+
+        if (out.size() > limit) {
+            m_error = "decompressed payload too large";
+            return false;
+        }
+        if (!m_infoKnown) {
+            // Заголовок собран внутри LZ4F - теперь размер блока известен
+            LZ4F_frameInfo_t info{};
+            std::size_t none = 0;
+            if (!LZ4F_isError(LZ4F_getFrameInfo(m_context->lz4, &info, nullptr, &none)) &&
+                !applyFrameInfo(info.blockSizeID, info.contentSize, out, limit)) {
+                return false;
+            }
+        }
+        m_complete = hint == 0;
+        outputFull = dstSize == offered;
+        if (srcSize == 0 && dstSize == 0) {
+            break;
+        }
+    }
+    return true;
+}
+
+} // namespace hmi3
\ No newline at end of file
@@ -1,77 +1,950 @@
-#include "hmi3/container.hpp"
-#include <algorithm>
-
-namespace hmi3 {
-
-Container::Container(std::string id) 
-    : Component(std::move(id))
-    , m_size(800.0f, 600.0f)
-    , m_backgroundColor(sf::Color::Transparent) {
-}
-
-void Container::update(float dt) {
-    for (auto& component : m_components) {
-        if (component->isVisible()) {
-            component->update(dt);
-        }
-    }
-}
-
-void Container::handleEvent(const sf::Event& event) {
-    for (auto it = m_components.rbegin(); it != m_components.rend(); ++it) {
-        if ((*it)->isVisible()) {
-            (*it)->handleEvent(event);
-        }
-    }
-}
-
-void Container::draw(sf::RenderTarget& target, sf::RenderStates states) const {
-    if (m_backgroundColor != sf::Color::Transparent) {
-        sf::RectangleShape background(m_size);
-        background.setFillColor(m_backgroundColor);
-        target.draw(background, states);
-    }
-
-    for (const auto& component : m_components) {
-        if (component->isVisible()) {
-            // Компоненты должны сами наследоваться
-            target.draw(*component, states);
-        }
-    }
-}
-
-void Container::addComponent(std::shared_ptr<Component> component) {
-    if (!component) return;
-    
-    auto it = m_componentMap.find(component->getId());
-    if (it == m_componentMap.end()) {
-        m_components.push_back(component);
-        m_componentMap[component->getId()] = component;
-    }
-}
-
-bool Container::removeComponent(const std::string& id) {
-    auto it = m_componentMap.find(id);
-    if (it != m_componentMap.end()) {
-        auto component = it->second;
-        m_components.erase(
-            std::remove(m_components.begin(), m_components.end(), component),
-            m_components.end()
-        );
-        m_componentMap.erase(it);
-        return true;
-    }
-    return false;
-}
-
-std::shared_ptr<Component> Container::getComponent(const std::string& id) const {
-    auto it = m_componentMap.find(id);
-    return it != m_componentMap.end() ? it->second : nullptr;
-}
-
-void Container::clear() {
-    m_components.clear();
-    m_componentMap.clear();
-}
-
+#include "hmi3/container.hpp"
+#include "hmi3/profiler.hpp"
+#include "hmi3/properties.hpp"
+#include "hmi3/session_recorder.hpp"
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <typeinfo>
+
+namespace hmi3 {
+
+namespace {
+
+// Координаты для событий, которые адресуются точке на экране
+std::optional<sf::Vector2f> pointerPosition(const sf::Event& event) {
+    if (auto* e = event.getIf<sf::Event::MouseButtonPressed>()) return sf::Vector2f(e->position);
+    if (auto* e = event.getIf<sf::Event::MouseButtonReleased>()) return sf::Vector2f(e->position);
+    if (auto* e = event.getIf<sf::Event::MouseMoved>()) return sf::Vector2f(e->position);
+    if (auto* e = event.getIf<sf::Event::MouseWheelScrolled>()) return sf::Vector2f(e->position);
+    if (auto* e = event.getIf<sf::Event::TouchBegan>()) return sf::Vector2f(e->position);
+    if (auto* e = event.getIf<sf::Event::TouchMoved>()) return sf::Vector2f(e->position);
+    if (auto* e = event.getIf<sf::Event::TouchEnded>()) return sf::Vector2f(e->position);
+    return std::nullopt;
+}
+
+// Событие указателя с координатами, пересчитанными через transform
+sf::Event mapPointer(const sf::Event& event, const sf::Transform& transform) {
+    sf::Event mapped = event;
+    auto map = [&transform](sf::Vector2i& position) {
+        sf::Vector2f point = transform.transformPoint(sf::Vector2f(position));
+        position = sf::Vector2i(static_cast<int>(std::floor(point.x)), static_cast<int>(std::floor(point.y)));
+    };
+    if (auto* e = mapped.getIf<sf::Event::MouseButtonPressed>()) map(e->position);
+    if (auto* e = mapped.getIf<sf::Event::MouseButtonReleased>()) map(e->position);
+    if (auto* e = mapped.getIf<sf::Event::MouseMoved>()) map(e->position);
+    if (auto* e = mapped.getIf<sf::Event::MouseWheelScrolled>()) map(e->position);
+    if (auto* e = mapped.getIf<sf::Event::TouchBegan>()) map(e->position);
+    if (auto* e = mapped.getIf<sf::Event::TouchMoved>()) map(e->position);
+    if (auto* e = mapped.getIf<sf::Event::TouchEnded>()) map(e->position);
+    return mapped;
+}
+
+bool overlaps(const sf::FloatRect& a, const sf::FloatRect& b) {
+    return a.position.x < b.position.x + b.size.x && b.position.x < a.position.x + a.size.x &&
+           a.position.y < b.position.y + b.size.y && b.position.y < a.position.y + a.size.y;
+}
+
+bool isKeyboardEvent(const sf::Event& event) {
+    return event.is<sf::Event::KeyPressed>() || event.is<sf::Event::KeyReleased>() ||
+           event.is<sf::Event::TextEntered>();
+}
+
+} // namespace
+
+Container::Container(std::string id)
+    : Component(std::move(id))
+    , m_backgroundColor(sf::Color::Transparent) {
+    m_size = sf::Vector2f(800.0f, 600.0f);
+}
+
+Container::~Container() {
+    forEachComponent([](Component& component) {
+        component.m_parent = nullptr;
+        component.m_handle = ComponentHandle();
+        if (auto* container = dynamic_cast<Container*>(&component)) {
+            container->m_pathIndexStale = true;
+        }
+    });
+}
+
+void Container::update(float dt) {
+    // Вложенный контейнер уже размечен родителем
+    HMI3_PROFILE_SCOPE_IF(!getParent(), "update", m_id);
+    if (m_sessionRecorder) {
+        m_sessionRecorder->recordUpdate(dt);
+    }
+    flushPendingMotion();
+    m_time += dt;
+
+    // Кто обновляется в этом кадре: бодрствующие и те, чей таймер истёк.
+    // Спящие сюда не попадают вовсе
+    m_dueUpdates.clear();
+    m_periodicUpdates.clear();
+    auto addDue = [this](Component& component, float elapsed) {
+        component.m_pendingDt = elapsed;
+        m_dueUpdates.push_back(DueUpdate{&component, component.m_handle});
+    };
+    auto isAwake = [](const Component& component) {
+        return !component.m_sleeping && component.m_updateInterval <= 0.0f;
+    };
+
+    m_expiredTimers.clear();
+    m_timers.advance(m_time, m_expiredTimers);
+    for (const ScheduledWake& timer : m_expiredTimers) {
+        Component* component = getComponent(timer.handle);
+        // Удалён или расписание сменилось после постановки
+        if (!component || component->m_scheduleTicket != timer.ticket) continue;
+        float elapsed = static_cast<float>(m_time - component->m_lastUpdate);
+        if (component->m_sleeping) {
+            // Истёк sleepFor(): просыпается и обновляется в этом же кадре
+            component->m_sleeping = false;
+            ++component->m_scheduleTicket;
+            elapsed = dt;
+            if (component->m_updateInterval <= 0.0f) {
+                m_awake.emplace(component->m_order, component);
+                continue;
+            }
+        }
+        m_periodicUpdates.push_back(ScheduledWake{timer.handle, component->m_scheduleTicket});
+        addDue(*component, elapsed);
+    }
+
+    // Если бодрствует большинство, плотный обход компонентов дешевле прохода
+    // по дереву m_awake, а без сработавших таймеров и список не нужен:
+    // спящие отсеиваются прямо при обходе
+    bool dense = m_awake.size() * 2 > m_components.size();
+    bool direct = dense && m_dueUpdates.empty();
+    if (!direct) {
+        bool timersFired = !m_dueUpdates.empty();
+        if (dense) {
+            forEachComponent([&addDue, &isAwake, dt](Component& component) {
+                if (isAwake(component)) addDue(component, dt);
+            });
+        } else {
+            for (const auto& entry : m_awake) {
+                addDue(*entry.second, dt);
+            }
+        }
+        if (timersFired) {
+            std::sort(m_dueUpdates.begin(), m_dueUpdates.end(), [](const DueUpdate& a, const DueUpdate& b) {
+                return a.component->m_order < b.component->m_order;
+            });
+        }
+    }
+
+    // Фаза 1: потокобезопасные компоненты, в пуле, если он есть
+    m_parallelUpdates.clear();
+    auto addParallel = [this](Component& component) {
+        if (component.isVisible() && component.isUpdateThreadSafe()) {
+            m_parallelUpdates.push_back(&component);
+        }
+    };
+    if (direct) {
+        forEachComponent([&addParallel, &isAwake, dt](Component& component) {
+            if (!isAwake(component)) return;
+            component.m_pendingDt = dt;
+            addParallel(component);
+        });
+    } else {
+        for (const DueUpdate& due : m_dueUpdates) {
+            addParallel(*due.component);
+        }
+    }
+
+    WorkerPool* pool = getWorkerPool();
+    auto updateRange = [this](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            HMI3_PROFILE_SCOPE("update", m_parallelUpdates[i]->getId());
+            m_parallelUpdates[i]->update(m_parallelUpdates[i]->m_pendingDt);
+        }
+    };
+    if (pool) {
+        pool->parallelFor(m_parallelUpdates.size(), updateRange);
+    } else {
+        updateRange(0, m_parallelUpdates.size());
+    }
+
+    // Фаза 2: фиксация результатов в порядке отрисовки, до того как
+    // последовательные обработчики успеют изменить состав контейнера
+    for (Component* component : m_parallelUpdates) {
+        component->m_lastUpdate = m_time;
+        component->commitUpdate();
+    }
+
+    // Фаза 3: остальные компоненты. Усыплённые соседом в этом кадре
+    // пропускаются
+    auto updateSerial = [this](Component& component, float elapsed) {
+        if (component.m_sleeping || !component.isVisible() || component.isUpdateThreadSafe()) return;
+        HMI3_PROFILE_SCOPE("update", component.getId());
+        component.update(elapsed);
+        component.m_lastUpdate = m_time;
+    };
+    if (direct) {
+        forEachComponent([&updateSerial, &isAwake, dt](Component& component) {
+            if (isAwake(component)) updateSerial(component, dt);
+        });
+    } else {
+        // Пока никого не удалили, указатели действительны; после удаления
+        // дескрипторы разрешаются заново
+        std::uint64_t removals = m_removalCount;
+        for (const DueUpdate& due : m_dueUpdates) {
+            Component* component = removals == m_removalCount ? due.component : getComponent(due.handle);
+            if (component) {
+                updateSerial(*component, component->m_pendingDt);
+            }
+        }
+    }
+
+    // Компоненты с интервалом встают в колесо на следующий тик, если за
+    // кадр их расписание не сменилось
+    for (const ScheduledWake& periodic : m_periodicUpdates) {
+        Component* component = getComponent(periodic.handle);
+        if (!component || component->m_scheduleTicket != periodic.ticket) continue;
+        double next = component->m_lastUpdate + component->m_updateInterval;
+        if (next <= m_time) {
+            // Скрытый компонент пропустил тик
+            next = m_time + component->m_updateInterval;
+        }
+        m_timers.schedule(next, periodic);
+    }
+}
+
+void Container::scheduleChild(Component& child, double delay) {
+    m_awake.erase(child.m_order);
+    if (!child.m_sleeping && child.m_updateInterval <= 0.0f) {
+        m_awake.emplace(child.m_order, &child);
+        return;
+    }
+    if (!child.m_sleeping) {
+        // Первый тик по интервалу получит dt от этого момента
+        child.m_lastUpdate = m_time;
+    }
+    if (delay >= 0.0) {
+        m_timers.schedule(m_time + delay, ScheduledWake{child.m_handle, child.m_scheduleTicket});
+    }
+}
+
+WorkerPool* Container::getWorkerPool() const {
+    for (const Container* node = this; node; node = node->getParent()) {
+        if (node->m_workerPool) {
+            return node->m_workerPool;
+        }
+    }
+    return nullptr;
+}
+
+void Container::handleEvent(const sf::Event& event) {
+    HMI3_PROFILE_SCOPE_IF(!getParent(), "event", m_id);
+    if (m_sessionRecorder) {
+        m_sessionRecorder->recordEvent(event);
+    }
+    if (auto* moved = event.getIf<sf::Event::MouseMoved>(); moved && m_coalesceMotion) {
+        m_pendingMotion = moved->position;
+        return;
+    }
+    // Отложенное движение идёт первым, чтобы порядок событий сохранился
+    flushPendingMotion();
+    dispatchEvent(event);
+}
+
+void Container::flushPendingMotion() {
+    if (!m_pendingMotion) {
+        return;
+    }
+    sf::Event moved(sf::Event::MouseMoved{*m_pendingMotion});
+    m_pendingMotion.reset();
+    dispatchEvent(moved);
+}
+
+void Container::setMotionCoalescing(bool enabled) {
+    if (!enabled) {
+        flushPendingMotion();
+    }
+    m_coalesceMotion = enabled;
+}
+
+void Container::dispatchEvent(const sf::Event& original) {
+    auto position = pointerPosition(original);
+    // Указатель за обрезанными границами не задевает компоненты
+    bool clipped = position && m_clipEnabled && !sf::FloatRect(m_position, m_size).contains(*position);
+    // Компоненты получают координаты своего содержимого
+    std::optional<sf::Event> mapped;
+    if (position && hasContentLayer()) {
+        sf::Transform toContent = getContentTransform().getInverse();
+        mapped = mapPointer(original, toContent);
+        position = toContent.transformPoint(*position);
+    }
+    const sf::Event& event = mapped ? *mapped : original;
+
+    if (!position) {
+        if (event.is<sf::Event::MouseLeft>()) {
+            setHovered(nullptr);
+        } else if (event.is<sf::Event::FocusLost>()) {
+            // Отпускание кнопки вне окна не придёт
+            m_capture = ComponentHandle();
+        }
+
+        if (isKeyboardEvent(event)) {
+            Component* focus = getFocus();
+            if (focus && !focus->isVisible()) {
+                setFocus(ComponentHandle());
+                focus = nullptr;
+            }
+            if (focus) {
+                HMI3_PROFILE_SCOPE("event", focus->getId());
+                focus->wake();
+                focus->handleEvent(event);
+                return;
+            }
+        }
+
+        m_components.forEachReverse([&event](ComponentHandle, const std::shared_ptr<Component>& component) {
+            if (component->isVisible()) {
+                HMI3_PROFILE_SCOPE("event", component->getId());
+                component->handleEvent(event);
+            }
+        });
+        return;
+    }
+
+    Component* target = clipped ? nullptr : hitTest(*position);
+    if (event.is<sf::Event::MouseMoved>()) {
+        setHovered(target);
+    }
+
+    Component* capture = getPointerCapture();
+    bool releasesCapture = false;
+    if (auto* pressed = event.getIf<sf::Event::MouseButtonPressed>()) {
+        if (!capture) {
+            m_capture = target ? target->m_handle : ComponentHandle();
+            m_captureButton = pressed->button;
+            setFocus(target ? target->m_handle : ComponentHandle());
+        }
+    } else if (auto* released = event.getIf<sf::Event::MouseButtonReleased>()) {
+        if (capture) {
+            target = capture;
+            releasesCapture = released->button == m_captureButton;
+        }
+    } else if (capture && event.is<sf::Event::MouseMoved>()) {
+        target = capture;
+    }
+
+    // Компоненты без границ проверяют попадание сами, поэтому получают событие
+    // как раньше; из размеченных - только целевой
+    for (auto it = m_unbounded.rbegin(); it != m_unbounded.rend(); ++it) {
+        if (target && target->m_order > it->first) {
+            HMI3_PROFILE_SCOPE("event", target->getId());
+            target->wake();
+            target->handleEvent(event);
+            target = nullptr;
+        }
+        HMI3_PROFILE_SCOPE("event", it->second->getId());
+        it->second->handleEvent(event);
+    }
+    if (target) {
+        HMI3_PROFILE_SCOPE("event", target->getId());
+        target->wake();
+        target->handleEvent(event);
+    }
+    if (releasesCapture) {
+        m_capture = ComponentHandle();
+    }
+}
+
+void Container::onHoverChanged(bool hovered) {
+    // Уход указателя с контейнера - уход и с его компонентов
+    if (!hovered) {
+        setHovered(nullptr);
+    }
+}
+
+void Container::onFocusChanged(bool focused) {
+    if (!focused) {
+        setFocus(ComponentHandle());
+    }
+}
+
+bool Container::setFocus(ComponentHandle handle) {
+    Component* component = getComponent(handle);
+    if (handle.isValid() && !component) {
+        return false;
+    }
+    if (handle == m_focus) {
+        return true;
+    }
+    if (Component* previous = getFocus()) {
+        m_focus = ComponentHandle();
+        previous->onFocusChanged(false);
+    }
+    m_focus = handle;
+    if (component) {
+        component->onFocusChanged(true);
+    }
+    return true;
+}
+
+void Container::setHovered(Component* component) {
+    ComponentHandle handle = component ? component->m_handle : ComponentHandle();
+    if (handle == m_hovered) {
+        return;
+    }
+    if (Component* previous = getHovered()) {
+        m_hovered = ComponentHandle();
+        previous->onHoverChanged(false);
+    }
+    m_hovered = handle;
+    if (component) {
+        component->onHoverChanged(true);
+    }
+}
+
+// Удаляемый компонент теряет наведение и фокус, захват снимается
+void Container::releaseChild(Component& child) {
+    if (child.m_handle == m_hovered) {
+        m_hovered = ComponentHandle();
+        child.onHoverChanged(false);
+    }
+    if (child.m_handle == m_focus) {
+        m_focus = ComponentHandle();
+        child.onFocusChanged(false);
+    }
+    if (child.m_handle == m_capture) {
+        m_capture = ComponentHandle();
+    }
+}
+
+Component* Container::hitTest(const sf::Vector2f& point) const {
+    m_hits.clear();
+    m_spatialIndex.query(point, m_hits);
+
+    Component* top = nullptr;
+    for (Component* component : m_hits) {
+        if (!top || component->m_order > top->m_order) {
+            top = component;
+        }
+    }
+
+    // Необрезающий вложенный контейнер рисует детей и за своими границами
+    // (см. appendChildren), поэтому попадание в такого ребёнка - попадание
+    // в контейнер, даже если точка вне его прямоугольника
+    for (auto it = m_unclipped.rbegin(); it != m_unclipped.rend() && (!top || it->first > top->m_order); ++it) {
+        auto* nested = static_cast<const Container*>(it->second);
+        sf::Vector2f inner =
+            nested->hasContentLayer() ? nested->getContentTransform().getInverse().transformPoint(point) : point;
+        if (nested->hitTest(inner)) {
+            return it->second;
+        }
+    }
+    return top;
+}
+
+void Container::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    HMI3_PROFILE_SCOPE("draw", m_id);
+    m_renderBatch.clear();
+    // Вид цели в координатах контейнера, с учётом поворота - описанный прямоугольник
+    sf::FloatRect view = target.getView().getInverseTransform().transformRect(sf::FloatRect({-1.0f, -1.0f}, {2.0f, 2.0f}));
+    m_renderBatch.setVisibleArea(states.transform.getInverse().transformRect(view));
+    appendSelf(m_renderBatch);
+    HMI3_PROFILE_SCOPE("submit", m_id);
+    m_renderBatch.draw(target, states);
+}
+
+bool Container::appendGeometry(RenderBatch& batch) const {
+    if (!isFlattenable()) {
+        return false;
+    }
+    appendSelf(batch);
+    return true;
+}
+
+bool Container::isFlattenable() const {
+    return typeid(*this) == typeid(Container);
+}
+
+void Container::appendSelf(RenderBatch& batch) const {
+    if (m_cacheEnabled && refreshCache()) {
+        sf::FloatRect bounds(m_position, m_size);
+        sf::Vector2f textureSize(m_cache->getSize());
+        sf::Vector2f topRight(bounds.position.x + bounds.size.x, bounds.position.y);
+        sf::Vector2f bottomLeft(bounds.position.x, bounds.position.y + bounds.size.y);
+        sf::Vector2f bottomRight = bounds.position + bounds.size;
+
+        sf::VertexArray& vertices = batch.geometry(&m_cache->getTexture());
+        vertices.append(sf::Vertex{bounds.position, sf::Color::White, {0.0f, 0.0f}});
+        vertices.append(sf::Vertex{topRight, sf::Color::White, {textureSize.x, 0.0f}});
+        vertices.append(sf::Vertex{bottomLeft, sf::Color::White, {0.0f, textureSize.y}});
+        vertices.append(sf::Vertex{bottomLeft, sf::Color::White, {0.0f, textureSize.y}});
+        vertices.append(sf::Vertex{topRight, sf::Color::White, {textureSize.x, 0.0f}});
+        vertices.append(sf::Vertex{bottomRight, sf::Color::White, textureSize});
+        return;
+    }
+
+    appendContents(batch);
+}
+
+void Container::appendContents(RenderBatch& batch) const {
+    sf::FloatRect bounds(m_position, m_size);
+    batch.appendRect(bounds, m_backgroundColor);
+
+    if (!hasContentLayer() && !m_clipEnabled) {
+        appendChildren(batch);
+        return;
+    }
+    std::optional<sf::FloatRect> clip;
+    if (m_clipEnabled) {
+        clip = bounds;
+    }
+    batch.pushLayer(getContentTransform(), clip);
+    appendChildren(batch);
+    batch.popLayer();
+}
+
+void Container::appendChildren(RenderBatch& batch) const {
+    auto append = [&batch](const Component& component) {
+        HMI3_PROFILE_SCOPE("draw", component.getId());
+        if (!component.appendGeometry(batch)) {
+            // Компоненты должны сами наследоваться
+            batch.appendDrawable(component);
+        }
+    };
+
+    const std::optional<sf::FloatRect>& visible = batch.getVisibleArea();
+    if (!visible || m_spatialIndex.cellCount(*visible) >= m_spatialIndex.size()) {
+        // Видно почти всё - проверка границ дешевле запроса к индексу
+        forEachComponent([this, &append, &visible](const Component& component) {
+            if (!component.isVisible()) return;
+            if (visible && component.hasBounds() && !overlaps(component.getBounds(), *visible) &&
+                !m_unclipped.count(component.m_order)) {
+                return;
+            }
+            append(component);
+        });
+        return;
+    }
+
+    // Малая часть: видимые из индекса в порядке отрисовки вперемешку с
+    // компонентами без границ, которые не отсекаются
+    m_drawList.clear();
+    m_spatialIndex.query(*visible, m_drawList);
+    for (const auto& entry : m_unclipped) {
+        m_drawList.push_back(entry.second);
+    }
+    std::sort(m_drawList.begin(), m_drawList.end(),
+              [](const Component* a, const Component* b) { return a->m_order < b->m_order; });
+    m_drawList.erase(std::unique(m_drawList.begin(), m_drawList.end()), m_drawList.end());
+    auto unbounded = m_unbounded.begin();
+    for (const Component* component : m_drawList) {
+        for (; unbounded != m_unbounded.end() && unbounded->first < component->m_order; ++unbounded) {
+            append(*unbounded->second);
+        }
+        append(*component);
+    }
+    for (; unbounded != m_unbounded.end(); ++unbounded) {
+        append(*unbounded->second);
+    }
+}
+
+bool Container::applyProperty(std::string_view name, std::string_view value) {
+    if (name == "background") {
+        sf::Color color;
+        if (!properties::parseColor(value, color)) return false;
+        setBackgroundColor(color);
+        return true;
+    }
+    if (name == "cache" || name == "clip") {
+        bool enabled = false;
+        if (!properties::parseBool(value, enabled)) return false;
+        if (name == "cache") {
+            setCacheEnabled(enabled);
+        } else {
+            setClipEnabled(enabled);
+        }
+        return true;
+    }
+    if (name == "scroll") {
+        sf::Vector2f scroll;
+        if (!properties::parseVector(value, scroll)) return false;
+        setScroll(scroll);
+        return true;
+    }
+    if (name == "zoom") {
+        float zoom = 0.0f;
+        if (!properties::parseFloat(value, zoom) || zoom <= 0.0f) return false;
+        setZoom(zoom);
+        return true;
+    }
+    return Component::applyProperty(name, value);
+}
+
+void Container::setBackgroundColor(const sf::Color& color) {
+    if (m_backgroundColor == color) return;
+    m_backgroundColor = color;
+    markDirty();
+}
+
+void Container::setScroll(const sf::Vector2f& scroll) {
+    if (m_scroll == scroll) return;
+    m_scroll = scroll;
+    markDirty();
+}
+
+void Container::setZoom(float zoom) {
+    if (zoom <= 0.0f || m_zoom == zoom) return;
+    m_zoom = zoom;
+    markDirty();
+}
+
+void Container::setClipEnabled(bool enabled) {
+    if (m_clipEnabled == enabled) return;
+    m_clipEnabled = enabled;
+    markDirty();
+    // Родитель отсекает по границам только контейнер с отсечением
+    if (m_parent) {
+        m_parent->onChildChanged(*this);
+    }
+}
+
+sf::Transform Container::getContentTransform() const {
+    // Масштаб - относительно левого верхнего угла контейнера
+    sf::Transform transform;
+    transform.translate(m_position);
+    transform.scale({m_zoom, m_zoom});
+    transform.translate(-m_position - m_scroll);
+    return transform;
+}
+
+bool Container::hasContentLayer() const {
+    return m_zoom != 1.0f || m_scroll != sf::Vector2f();
+}
+
+void Container::setCacheEnabled(bool enabled) {
+    m_cacheEnabled = enabled;
+    if (!enabled) {
+        m_cache.reset();
+    }
+    markDirty();
+}
+
+bool Container::refreshCache() const {
+    sf::Vector2u size(static_cast<unsigned int>(std::ceil(m_size.x)),
+                      static_cast<unsigned int>(std::ceil(m_size.y)));
+    if (size.x == 0 || size.y == 0) {
+        return false;
+    }
+
+    if (!m_cache || m_cache->getSize() != size) {
+        auto cache = std::make_unique<sf::RenderTexture>();
+        if (!cache->resize(size)) {
+            // Нет контекста или памяти - рисуем поддерево как обычно
+            return false;
+        }
+        m_cache = std::move(cache);
+        m_dirty = true;
+    }
+    if (!m_dirty) {
+        return true;
+    }
+    HMI3_PROFILE_SCOPE("cache", m_id);
+
+    m_cache->setView(sf::View(sf::FloatRect(m_position, m_size)));
+    m_cache->clear(sf::Color::Transparent);
+
+    // Вложенные кэширующие контейнеры попадают в кэш своей текстурой
+    m_cacheBatch.clear();
+    m_cacheBatch.setVisibleArea(sf::FloatRect(m_position, m_size));
+    appendContents(m_cacheBatch);
+    m_cacheBatch.draw(*m_cache, sf::RenderStates::Default);
+    m_cache->display();
+
+    ++m_cacheRenderCount;
+    clearDirty();
+    return true;
+}
+
+void Container::clearDirty() const {
+    m_dirty = false;
+    forEachComponent([](const Component& component) {
+        component.clearDirty();
+    });
+}
+
+ComponentHandle Container::addComponent(std::shared_ptr<Component> component) {
+    if (!component || m_componentMap.count(component->getAtom())) {
+        return ComponentHandle();
+    }
+
+    // Компонент может принадлежать только одному контейнеру
+    if (component->m_parent) {
+        component->m_parent->removeComponent(component->m_handle);
+    }
+
+    Component& child = *component;
+    child.m_parent = this;
+    child.m_order = m_nextOrder++;
+    child.m_handle = m_components.insert(std::move(component));
+    m_componentMap.emplace(child.m_atom, child.m_handle);
+    child.reschedule(child.m_sleeping ? -1.0 : child.m_updateInterval);
+    indexSubtree(getRootContainer(), child);
+    onChildChanged(child);
+    markDirty();
+    return child.m_handle;
+}
+
+bool Container::removeComponent(ComponentHandle handle) {
+    const std::shared_ptr<Component>* slot = m_components.get(handle);
+    if (!slot) {
+        return false;
+    }
+
+    // Держим компонент до конца удаления: слот освобождает свою ссылку
+    std::shared_ptr<Component> component = *slot;
+    detachChild(*component);
+    m_components.erase(handle);
+    markDirty();
+    return true;
+}
+
+std::shared_ptr<Component> Container::replaceComponent(ComponentHandle handle,
+                                                       std::shared_ptr<Component> component) {
+    std::shared_ptr<Component>* slot = m_components.get(handle);
+    if (!slot || !component || *slot == component) {
+        return nullptr;
+    }
+    auto existing = m_componentMap.find(component->getAtom());
+    if (existing != m_componentMap.end() && existing->second != handle) {
+        return nullptr;
+    }
+    if (component->m_parent) {
+        component->m_parent->removeComponent(component->m_handle);
+        // Удаление могло сдвинуть плотный массив, но не слот
+        slot = m_components.get(handle);
+    }
+
+    std::shared_ptr<Component> previous = std::move(*slot);
+    std::uint64_t order = previous->m_order;
+    std::uint32_t ticket = previous->m_scheduleTicket;
+    // Заменяют обычно целые сцены: вместо обхода обоих поддеревьев индекс
+    // путей корня перестроится при следующем findByPath(), а прежний
+    // освободится вместе со старым поддеревом
+    Container& root = getRootContainer();
+    if (!root.m_pathIndexStale) {
+        root.m_pathIndexStale = true;
+        if (auto* container = dynamic_cast<Container*>(previous.get())) {
+            container->m_pathIndex.swap(root.m_pathIndex);
+        }
+    }
+    detachChild(*previous);
+
+    // Слот, дескриптор и место в порядке отрисовки переходят новому компоненту
+    Component& child = *component;
+    child.m_parent = this;
+    child.m_order = order;
+    child.m_handle = handle;
+    *slot = std::move(component);
+    m_componentMap.emplace(child.m_atom, handle);
+    // Таймеры прежнего компонента остаются в колесе с тем же дескриптором:
+    // билет новому берётся дальше, чтобы они не сработали на нём
+    child.m_scheduleTicket = std::max(child.m_scheduleTicket, ticket);
+    child.reschedule(child.m_sleeping ? -1.0 : child.m_updateInterval);
+    onChildChanged(child);
+    markDirty();
+    return previous;
+}
+
+void Container::detachChild(Component& child) {
+    releaseChild(child);
+    unindexSubtree(getRootContainer(), child);
+    if (!m_spatialIndex.remove(&child)) {
+        m_unbounded.erase(child.m_order);
+    }
+    m_unclipped.erase(child.m_order);
+    m_awake.erase(child.m_order);
+    ++m_removalCount;
+    m_componentMap.erase(child.m_atom);
+    child.m_parent = nullptr;
+    child.m_handle = ComponentHandle();
+    // Отсоединённый контейнер сам становится корнем
+    if (auto* container = dynamic_cast<Container*>(&child)) {
+        container->m_pathIndexStale = true;
+    }
+}
+
+bool Container::removeComponent(const std::string& id) {
+    return removeComponent(getHandle(id));
+}
+
+Component* Container::getComponent(ComponentHandle handle) const {
+    const std::shared_ptr<Component>* slot = m_components.get(handle);
+    return slot ? slot->get() : nullptr;
+}
+
+std::shared_ptr<Component> Container::getComponent(const std::string& id) const {
+    const std::shared_ptr<Component>* slot = m_components.get(getHandle(id));
+    return slot ? *slot : nullptr;
+}
+
+ComponentHandle Container::getHandle(const std::string& id) const {
+    // Поиск не интернирует: незнакомой строки нет ни в одном контейнере
+    return getHandle(findAtom(id));
+}
+
+ComponentHandle Container::getHandle(Atom id) const {
+    auto it = m_componentMap.find(id);
+    return it != m_componentMap.end() ? it->second : ComponentHandle();
+}
+
+Component* Container::findByPath(std::string_view path) const {
+    if (!m_parent) {
+        if (m_pathIndexStale) {
+            rebuildPathIndex();
+        }
+        auto it = m_pathIndex.find(path);
+        return it != m_pathIndex.end() ? it->second : nullptr;
+    }
+
+    const Container* node = this;
+    for (;;) {
+        std::size_t slash = path.find('/');
+        Component* child = node->getComponent(node->getHandle(findAtom(path.substr(0, slash))));
+        if (!child || slash == std::string_view::npos) {
+            return child;
+        }
+        node = dynamic_cast<const Container*>(child);
+        if (!node) {
+            return nullptr;
+        }
+        path.remove_prefix(slash + 1);
+    }
+}
+
+Container& Container::getRootContainer() {
+    Container* root = this;
+    while (root->m_parent) {
+        root = root->m_parent;
+    }
+    return *root;
+}
+
+void Container::indexSubtree(const Container& root, Component& component) const {
+    // Пути пересчитает rebuildPathIndex()
+    if (root.m_pathIndexStale) {
+        return;
+    }
+    component.m_path.clear();
+    if (m_parent) {
+        component.m_path = m_path;
+        component.m_path += '/';
+    }
+    component.m_path += component.m_id;
+    root.m_pathIndex.emplace(component.m_path, &component);
+
+    if (auto* container = dynamic_cast<Container*>(&component)) {
+        // Бывший корень: его индекс теперь часть индекса root
+        container->m_pathIndex.clear();
+        container->m_pathIndexStale = false;
+        container->forEachComponent([&root, container](Component& child) {
+            container->indexSubtree(root, child);
+        });
+    }
+}
+
+void Container::unindexSubtree(const Container& root, Component& component) const {
+    if (root.m_pathIndexStale) {
+        return;
+    }
+    auto it = root.m_pathIndex.find(component.m_path);
+    if (it != root.m_pathIndex.end() && it->second == &component) {
+        root.m_pathIndex.erase(it);
+    }
+    if (auto* container = dynamic_cast<Container*>(&component)) {
+        container->forEachComponent([&root, container](Component& child) {
+            container->unindexSubtree(root, child);
+        });
+    }
+}
+
+void Container::rebuildPathIndex() const {
+    m_pathIndex.clear();
+    m_pathIndexStale = false;
+    forEachComponent([this](Component& child) {
+        indexSubtree(*this, child);
+    });
+}
+
+bool Container::bringToFront(ComponentHandle handle) {
+    Component* component = getComponent(handle);
+    if (!component) {
+        return false;
+    }
+
+    bool unbounded = m_unbounded.erase(component->m_order) > 0;
+    bool unclipped = m_unclipped.erase(component->m_order) > 0;
+    bool awake = m_awake.erase(component->m_order) > 0;
+    m_components.moveToBack(handle);
+    component->m_order = m_nextOrder++;
+    if (unbounded) {
+        m_unbounded.emplace(component->m_order, component);
+    }
+    if (unclipped) {
+        m_unclipped.emplace(component->m_order, component);
+    }
+    if (awake) {
+        m_awake.emplace(component->m_order, component);
+    }
+    markDirty();
+    return true;
+}
+
+void Container::clear() {
+    Container& root = getRootContainer();
+    forEachComponent([this, &root](Component& component) {
+        releaseChild(component);
+        unindexSubtree(root, component);
+        component.m_parent = nullptr;
+        component.m_handle = ComponentHandle();
+        if (auto* container = dynamic_cast<Container*>(&component)) {
+            container->m_pathIndexStale = true;
+        }
+    });
+    m_components.clear();
+    m_componentMap.clear();
+    m_spatialIndex.clear();
+    m_unbounded.clear();
+    m_unclipped.clear();
+    m_awake.clear();
+    m_timers.clear();
+    ++m_removalCount;
+    markDirty();
+}
+
+void Container::onChildChanged(Component& child) {
+    bool indexed = m_spatialIndex.contains(&child);
+    if (child.isVisible() && child.hasBounds()) {
+        if (!indexed) {
+            m_unbounded.erase(child.m_order);
+        }
+        m_spatialIndex.update(&child, child.getBounds());
+        // Границы остаются для событий указателя, но не для отсечения
+        auto* container = dynamic_cast<const Container*>(&child);
+        if (container && !container->m_clipEnabled) {
+            m_unclipped.emplace(child.m_order, &child);
+        } else {
+            m_unclipped.erase(child.m_order);
+        }
+        return;
+    }
+
+    m_unclipped.erase(child.m_order);
+
+    if (indexed) {
+        m_spatialIndex.remove(&child);
+    } else {
+        m_unbounded.erase(child.m_order);
+    }
+    if (child.isVisible()) {
+        m_unbounded.emplace(child.m_order, &child);
+    }
+}
+
 } // namespace hmi3
\ No newline at end of file
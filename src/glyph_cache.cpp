@@ -0,0 +1,82 @@
+#include "hmi3/glyph_cache.hpp"
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace hmi3 {
+
+namespace {
+
+// Записи освобождённых объектов убираются при вставке новой, иначе карта
+// растёт с каждым шрифтом и размером, встреченным за время работы
+template <typename Map>
+void eraseExpired(Map& map) {
+    for (auto it = map.begin(); it != map.end();) {
+        it = it->second.expired() ? map.erase(it) : std::next(it);
+    }
+}
+
+} // namespace
+
+std::shared_ptr<const GlyphCache> GlyphCache::get(std::shared_ptr<const sf::Font> font, unsigned int characterSize) {
+    if (!font) return nullptr;
+
+    static std::mutex mutex;
+    static std::map<std::pair<const sf::Font*, unsigned int>, std::weak_ptr<const GlyphCache>> caches;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::pair<const sf::Font*, unsigned int> key(font.get(), characterSize);
+    auto it = caches.find(key);
+    if (it != caches.end()) {
+        if (auto cache = it->second.lock()) {
+            return cache;
+        }
+    }
+    eraseExpired(caches);
+    auto cache = std::make_shared<const GlyphCache>(std::move(font), characterSize);
+    caches[key] = cache;
+    return cache;
+}
+
+std::shared_ptr<const sf::Font> GlyphCache::loadFont(const std::string& path) {
+    static std::mutex mutex;
+    static std::map<std::string, std::weak_ptr<const sf::Font>> fonts;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = fonts.find(path);
+    if (it != fonts.end()) {
+        if (auto font = it->second.lock()) {
+            return font;
+        }
+    }
+    eraseExpired(fonts);
+    auto font = std::make_shared<sf::Font>();
+    if (!font->openFromFile(path)) {
+        return nullptr;
+    }
+    fonts[path] = font;
+    return font;
+}
+
+GlyphCache::GlyphCache(std::shared_ptr<const sf::Font> font, unsigned int characterSize)
+    : m_font(std::move(font))
+    , m_characterSize(characterSize)
+    , m_lineSpacing(m_font->getLineSpacing(characterSize)) {
+    for (char c = kFirstChar; c <= kLastChar; ++c) {
+        const sf::Glyph& glyph = m_font->getGlyph(static_cast<char32_t>(c), characterSize, false);
+        Quad& quad = m_quads[static_cast<std::size_t>(c - kFirstChar)];
+        quad.bounds = glyph.bounds;
+        quad.textureRect = sf::FloatRect(sf::Vector2f(glyph.textureRect.position), sf::Vector2f(glyph.textureRect.size));
+        quad.advance = glyph.advance;
+    }
+}
+
+const GlyphCache::Quad& GlyphCache::glyph(char c) const {
+    if (c < kFirstChar || c > kLastChar) {
+        c = '?';
+    }
+    return m_quads[static_cast<std::size_t>(c - kFirstChar)];
+}
+
+} // namespace hmi3
\ No newline at end of file
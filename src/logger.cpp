@@ -0,0 +1,105 @@
+#include "hmi3/logger.hpp"
+#include <chrono>
+#include <iostream>
+
+namespace hmi3 {
+
+namespace {
+
+// Запасной срок ожидания писателя: уведомление без замка может разминуться
+// с засыпанием потока
+const auto kWriterPoll = std::chrono::milliseconds(50);
+
+void writeDefault(LogLevel level, const std::string& message) {
+    std::ostream& out = level >= LogLevel::Warning ? std::cerr : std::cout;
+    out << message << '\n';
+}
+
+} // namespace
+
+const char* logLevelName(LogLevel level) {
+    switch (level) {
+    case LogLevel::Debug:
+        return "debug";
+    case LogLevel::Info:
+        return "info";
+    case LogLevel::Warning:
+        return "warning";
+    case LogLevel::Error:
+        return "error";
+    case LogLevel::Off:
+        return "off";
+    }
+    return "unknown";
+}
+
+Logger& Logger::instance() {
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger()
+    : m_queue(kQueueCapacity) {
+    m_writer = std::thread(&Logger::writerLoop, this);
+}
+
+Logger::~Logger() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    m_writer.join();
+}
+
+void Logger::log(LogLevel level, std::string message) {
+    if (!isEnabled(level)) return;
+    Record record;
+    record.level = level;
+    record.message = std::move(message);
+    if (!m_queue.tryPush(std::move(record))) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    m_pushed.fetch_add(1, std::memory_order_release);
+    m_wake.notify_one();
+}
+
+void Logger::flush() {
+    std::uint64_t target = m_pushed.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_wake.notify_one();
+    m_flushed.wait(lock, [&] { return m_written.load(std::memory_order_relaxed) >= target; });
+}
+
+void Logger::setSink(Sink sink) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_sink = std::move(sink);
+}
+
+void Logger::writerLoop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    Record record;
+    for (;;) {
+        m_wake.wait_for(lock, kWriterPoll, [this] { return m_stopping || m_queue.size() > 0; });
+
+        // Замок держится на время вывода: setSink() не меняет sink посреди записи
+        bool wrote = false;
+        while (m_queue.tryPop(record)) {
+            if (m_sink) {
+                m_sink(record.level, record.message);
+            } else {
+                writeDefault(record.level, record.message);
+            }
+            m_written.fetch_add(1, std::memory_order_relaxed);
+            wrote = true;
+        }
+        if (wrote) {
+            std::cout.flush();
+            m_flushed.notify_all();
+        }
+        if (m_stopping) return;
+    }
+}
+
+} // namespace hmi3
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include "hmi3/metrics.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace hmi3 {
+
+namespace {
+
+int highestBit(std::uint64_t value) {
+    int bit = 0;
+    while (value >>= 1) {
+        ++bit;
+    }
+    return bit;
+}
+
+} // namespace
+
+std::uint64_t HistogramSnapshot::percentile(double fraction) const {
+    if (count == 0) return 0;
+    fraction = std::clamp(fraction, 0.0, 1.0);
+    auto rank = static_cast<std::uint64_t>(std::ceil(fraction * static_cast<double>(count)));
+    rank = std::max<std::uint64_t>(rank, 1);
+
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return std::min(Histogram::bucketUpperBound(i), max);
+        }
+    }
+    return max;
+}
+
+std::size_t Histogram::bucketIndex(std::uint64_t value) {
+    if (value < kLinearBuckets) {
+        return static_cast<std::size_t>(value);
+    }
+    // Старший бит задаёт октаву, три следующих - корзину в ней
+    int bit = highestBit(value);
+    auto sub = static_cast<std::size_t>((value >> (bit - 3)) & (kSubBuckets - 1));
+    return kLinearBuckets + static_cast<std::size_t>(bit - 4) * kSubBuckets + sub;
+}
+
+std::uint64_t Histogram::bucketUpperBound(std::size_t index) {
+    if (index < kLinearBuckets) {
+        return index;
+    }
+    std::size_t octave = (index - kLinearBuckets) / kSubBuckets;
+    std::size_t sub = (index - kLinearBuckets) % kSubBuckets;
+    int bit = static_cast<int>(octave) + 4;
+    std::uint64_t width = std::uint64_t(1) << (bit - 3);
+    std::uint64_t lower = (std::uint64_t(1) << bit) + sub * width;
+    if (bit == 63 && sub == kSubBuckets - 1) {
+        return std::numeric_limits<std::uint64_t>::max();
+    }
+    return lower + width - 1;
+}
+
+void Histogram::record(std::uint64_t value) {
+    m_buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+    std::uint64_t max = m_max.load(std::memory_order_relaxed);
+    while (value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+    }
+}
+
+HistogramSnapshot Histogram::snapshot() const {
+    HistogramSnapshot snapshot;
+    snapshot.buckets.resize(kBucketCount);
+    for (std::size_t i = 0; i < kBucketCount; ++i) {
+        snapshot.buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+        snapshot.count += snapshot.buckets[i];
+    }
+    snapshot.sum = m_sum.load(std::memory_order_relaxed);
+    snapshot.max = m_max.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+void Histogram::reset() {
+    for (auto& bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_sum.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+} // namespace hmi3
\ No newline at end of file
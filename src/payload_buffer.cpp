@@ -0,0 +1,217 @@
+#include "hmi3/payload_buffer.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace hmi3 {
+
+namespace {
+
+// Наименьший класс - 4 КБ, чтобы мелкие команды не дробили пул
+const std::size_t kMinClassShift = 12;
+
+} // namespace
+
+PayloadPool& PayloadPool::instance() {
+    // Пул намеренно не разрушается: буферы могут пережить статические объекты
+    static PayloadPool* pool = new PayloadPool();
+    return *pool;
+}
+
+std::size_t PayloadPool::sizeClass(std::size_t capacity) {
+    std::size_t shift = kMinClassShift;
+    while ((std::size_t(1) << shift) < capacity) {
+        ++shift;
+    }
+    return shift - kMinClassShift;
+}
+
+detail::PayloadBlock* PayloadPool::acquire(std::size_t capacity) {
+    std::size_t cls = sizeClass(capacity);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (cls < m_freeBlocks.size() && !m_freeBlocks[cls].empty()) {
+            detail::PayloadBlock* block = m_freeBlocks[cls].back();
+            m_freeBlocks[cls].pop_back();
+            m_retainedBytes -= block->capacity;
+            ++m_reuses;
+            return block;
+        }
+    }
+
+    auto block = new detail::PayloadBlock();
+    block->capacity = std::size_t(1) << (cls + kMinClassShift);
+    block->storage.reset(new char[block->capacity]);
+    ++m_allocations;
+    return block;
+}
+
+void PayloadPool::release(detail::PayloadBlock* block) {
+    block->size = 0;
+    block->references = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_retainedBytes + block->capacity <= m_retainLimit) {
+            std::size_t cls = sizeClass(block->capacity);
+            if (cls >= m_freeBlocks.size()) {
+                m_freeBlocks.resize(cls + 1);
+            }
+            m_freeBlocks[cls].push_back(block);
+            m_retainedBytes += block->capacity;
+            return;
+        }
+    }
+    delete block;
+}
+
+PayloadPool::Stats PayloadPool::getStats() const {
+    Stats stats;
+    stats.allocations = m_allocations;
+    stats.reuses = m_reuses;
+    stats.copiedBytes = m_copiedBytes;
+    return stats;
+}
+
+void PayloadPool::setRetainLimit(std::size_t bytes) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_retainLimit = bytes;
+        if (m_retainedBytes <= m_retainLimit) {
+            return;
+        }
+    }
+    trim();
+}
+
+void PayloadPool::trim() {
+    std::vector<std::vector<detail::PayloadBlock*>> freeBlocks;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        freeBlocks.swap(m_freeBlocks);
+        m_retainedBytes = 0;
+    }
+    for (auto& blocks : freeBlocks) {
+        for (auto block : blocks) {
+            delete block;
+        }
+    }
+}
+
+PayloadBuffer::PayloadBuffer(const char* text)
+    : PayloadBuffer(std::string_view(text)) {
+}
+
+PayloadBuffer::PayloadBuffer(std::string_view data) {
+    if (!data.empty()) {
+        PayloadWriter writer(data.size());
+        writer.append(data.data(), data.size());
+        *this = writer.finish();
+    }
+}
+
+PayloadBuffer::PayloadBuffer(detail::PayloadBlock* block)
+    : m_block(block) {
+    m_block->references = 1;
+}
+
+PayloadBuffer::PayloadBuffer(const PayloadBuffer& other)
+    : m_block(other.m_block) {
+    if (m_block) {
+        m_block->references.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+PayloadBuffer::PayloadBuffer(PayloadBuffer&& other) noexcept
+    : m_block(other.m_block) {
+    other.m_block = nullptr;
+}
+
+PayloadBuffer& PayloadBuffer::operator=(const PayloadBuffer& other) {
+    if (this != &other) {
+        PayloadBuffer copy(other);
+        std::swap(m_block, copy.m_block);
+    }
+    return *this;
+}
+
+PayloadBuffer& PayloadBuffer::operator=(PayloadBuffer&& other) noexcept {
+    std::swap(m_block, other.m_block);
+    return *this;
+}
+
+PayloadBuffer::~PayloadBuffer() {
+    if (m_block && m_block->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        PayloadPool::instance().release(m_block);
+    }
+}
+
+PayloadWriter::PayloadWriter(std::size_t sizeHint) {
+    if (sizeHint > 0) {
+        reserve(sizeHint);
+    }
+}
+
+PayloadWriter::PayloadWriter(PayloadWriter&& other) noexcept
+    : m_block(other.m_block) {
+    other.m_block = nullptr;
+}
+
+PayloadWriter& PayloadWriter::operator=(PayloadWriter&& other) noexcept {
+    std::swap(m_block, other.m_block);
+    return *this;
+}
+
+PayloadWriter::~PayloadWriter() {
+    if (m_block) {
+        PayloadPool::instance().release(m_block);
+    }
+}
+
+void PayloadWriter::reserve(std::size_t capacity) {
+    auto& pool = PayloadPool::instance();
+    if (!m_block) {
+        m_block = pool.acquire(capacity);
+        return;
+    }
+    if (capacity <= m_block->capacity) {
+        return;
+    }
+
+    // Размер не был известен заранее - перекладываем с удвоением
+    detail::PayloadBlock* grown = pool.acquire(std::max(capacity, m_block->capacity * 2));
+    std::memcpy(grown->storage.get(), m_block->storage.get(), m_block->size);
+    grown->size = m_block->size;
+    pool.recordCopy(m_block->size);
+    pool.release(m_block);
+    m_block = grown;
+}
+
+char* PayloadWriter::prepare(std::size_t size) {
+    reserve(this->size() + size);
+    return m_block->storage.get() + m_block->size;
+}
+
+void PayloadWriter::commit(std::size_t size) {
+    m_block->size += size;
+}
+
+void PayloadWriter::append(const char* data, std::size_t size) {
+    if (size == 0) return;
+    std::memcpy(prepare(size), data, size);
+    commit(size);
+    PayloadPool::instance().recordCopy(size);
+}
+
+PayloadBuffer PayloadWriter::finish() {
+    detail::PayloadBlock* block = m_block;
+    m_block = nullptr;
+    if (!block) {
+        return PayloadBuffer();
+    }
+    if (block->size == 0) {
+        PayloadPool::instance().release(block);
+        return PayloadBuffer();
+    }
+    return PayloadBuffer(block);
+}
+
+} // namespace hmi3
\ No newline at end of file
@@ -0,0 +1,183 @@
+#include "hmi3/profiler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <utility>
+
+namespace hmi3 {
+
+namespace {
+
+const auto kEpoch = std::chrono::steady_clock::now();
+
+double percentile(std::vector<double>& sorted, double fraction) {
+    std::size_t index = static_cast<std::size_t>(fraction * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+void writeJsonString(std::ostream& out, std::string_view text) {
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+            out << escaped;
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+} // namespace
+
+Profiler& Profiler::instance() {
+    static Profiler profiler;
+    return profiler;
+}
+
+std::int64_t Profiler::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - kEpoch).count();
+}
+
+Profiler::ThreadBuffer& Profiler::threadBuffer() {
+    // Буфер переживает поток: его интервалы ещё попадут в трассу
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    if (!buffer) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        buffer = std::make_shared<ThreadBuffer>(static_cast<std::uint32_t>(m_buffers.size() + 1));
+        m_buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+std::vector<std::shared_ptr<Profiler::ThreadBuffer>> Profiler::buffers() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_buffers;
+}
+
+void Profiler::record(const char* category, std::string_view name, std::int64_t start, std::int64_t end) {
+    ThreadBuffer& buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    Event& event = buffer.events[buffer.written++ % eventsPerThread];
+    event.start = start;
+    event.duration = end - start;
+    event.category = category;
+    std::size_t length = name.copy(event.name, sizeof(event.name) - 1);
+    event.name[length] = '\0';
+}
+
+void Profiler::markFrame() {
+    std::int64_t time = now();
+    std::int64_t last;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        last = m_lastFrame;
+        m_lastFrame = time;
+    }
+    if (last >= 0) {
+        recordFrame(static_cast<double>(time - last) / 1e6);
+    }
+}
+
+void Profiler::recordFrame(double milliseconds) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_frames[m_frameCount++ % frameWindow] = milliseconds;
+}
+
+Profiler::FrameStats Profiler::getFrameStats() const {
+    std::vector<double> frames;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        frames.assign(m_frames, m_frames + std::min(m_frameCount, frameWindow));
+    }
+
+    FrameStats stats;
+    stats.frames = frames.size();
+    if (frames.empty()) {
+        return stats;
+    }
+    std::sort(frames.begin(), frames.end());
+    stats.p50Ms = percentile(frames, 0.50);
+    stats.p95Ms = percentile(frames, 0.95);
+    stats.p99Ms = percentile(frames, 0.99);
+    stats.maxMs = frames.back();
+    return stats;
+}
+
+std::vector<Profiler::Entry> Profiler::getSummary() const {
+    std::map<std::pair<std::string, std::string>, Entry> entries;
+    for (const auto& buffer : buffers()) {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        std::size_t count = static_cast<std::size_t>(std::min<std::uint64_t>(buffer->written, eventsPerThread));
+        for (std::size_t i = 0; i < count; ++i) {
+            const Event& event = buffer->events[i];
+            Entry& entry = entries[{event.category, event.name}];
+            double ms = static_cast<double>(event.duration) / 1e6;
+            ++entry.calls;
+            entry.totalMs += ms;
+            entry.maxMs = std::max(entry.maxMs, ms);
+        }
+    }
+
+    std::vector<Entry> result;
+    result.reserve(entries.size());
+    for (auto& item : entries) {
+        item.second.category = item.first.first;
+        item.second.name = item.first.second;
+        result.push_back(std::move(item.second));
+    }
+    std::sort(result.begin(), result.end(), [](const Entry& a, const Entry& b) { return a.totalMs > b.totalMs; });
+    return result;
+}
+
+void Profiler::writeChromeTrace(std::ostream& out) const {
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+    bool first = true;
+    for (const auto& buffer : buffers()) {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        // Самые старые записи - сразу за последней записанной
+        std::uint64_t count = std::min<std::uint64_t>(buffer->written, eventsPerThread);
+        for (std::uint64_t i = buffer->written - count; i < buffer->written; ++i) {
+            const Event& event = buffer->events[i % eventsPerThread];
+            out << (first ? "\n" : ",\n") << "{\"name\":";
+            writeJsonString(out, event.name);
+            out << ",\"cat\":";
+            writeJsonString(out, event.category);
+            // Время в trace events - микросекунды
+            out << ",\"ph\":\"X\",\"ts\":" << static_cast<double>(event.start) / 1e3
+                << ",\"dur\":" << static_cast<double>(event.duration) / 1e3 << ",\"pid\":1,\"tid\":" << buffer->id
+                << "}";
+            first = false;
+        }
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    out.flags(flags);
+    out.precision(precision);
+}
+
+bool Profiler::writeChromeTrace(const std::string& path) const {
+    std::ofstream out(path, std::ios::trunc);
+    writeChromeTrace(out);
+    return static_cast<bool>(out);
+}
+
+void Profiler::reset() {
+    for (const auto& buffer : buffers()) {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        buffer->written = 0;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_frameCount = 0;
+    m_lastFrame = -1;
+}
+
+} // namespace hmi3
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "hmi3/project_description.hpp"
+#include <unordered_set>
+
+namespace hmi3 {
+
+namespace {
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Следующее слово строки; кавычки снимаются, \" и \\ раскрываются
+bool nextToken(std::string_view& line, std::string& token, std::string& error) {
+    while (!line.empty() && isSpace(line.front())) line.remove_prefix(1);
+    token.clear();
+    if (line.empty()) return false;
+
+    bool quoted = false;
+    while (!line.empty()) {
+        char c = line.front();
+        if (!quoted && isSpace(c)) break;
+        line.remove_prefix(1);
+        if (c == '"') {
+            quoted = !quoted;
+        } else if (c == '\\' && quoted && !line.empty()) {
+            token += line.front();
+            line.remove_prefix(1);
+        } else {
+            token += c;
+        }
+    }
+    if (quoted) {
+        error = "unterminated quote";
+    }
+    return true;
+}
+
+} // namespace
+
+const std::string* ComponentSpec::findProperty(const std::string& name) const {
+    for (const auto& property : properties) {
+        if (property.first == name) return &property.second;
+    }
+    return nullptr;
+}
+
+bool parseProject(std::string_view text, ProjectDescription& description, std::string& error) {
+    description = ProjectDescription();
+    std::unordered_set<std::string> ids;
+    std::size_t lineNumber = 0;
+    std::string token;
+
+    while (!text.empty()) {
+        ++lineNumber;
+        std::size_t end = text.find('\n');
+        std::string_view line = text.substr(0, end);
+        text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+
+        auto fail = [&](const std::string& message) {
+            error = "line " + std::to_string(lineNumber) + ": " + message;
+            return false;
+        };
+
+        std::string lineError;
+        if (!nextToken(line, token, lineError) || (!token.empty() && token.front() == '#')) {
+            continue;
+        }
+        if (!lineError.empty() || token.empty()) return fail("component type expected");
+
+        ComponentSpec spec;
+        PropertyList* properties = &spec.properties;
+        spec.type = token;
+        bool isRoot = spec.type == "root";
+        if (isRoot) {
+            properties = &description.rootProperties;
+        } else if (!nextToken(line, spec.id, lineError) || spec.id.find('=') != std::string::npos) {
+            return fail("component id expected after '" + spec.type + "'");
+        }
+
+        while (nextToken(line, token, lineError)) {
+            if (!lineError.empty()) return fail(lineError);
+            std::size_t equals = token.find('=');
+            if (equals == std::string::npos || equals == 0) {
+                return fail("expected name=value, got '" + token + "'");
+            }
+            std::string name = token.substr(0, equals);
+            std::string value = token.substr(equals + 1);
+            if (name == "parent" && !isRoot) {
+                spec.parent = std::move(value);
+            } else {
+                properties->emplace_back(std::move(name), std::move(value));
+            }
+        }
+        if (!lineError.empty()) return fail(lineError);
+
+        if (isRoot) continue;
+        if (!ids.insert(spec.id).second) {
+            return fail("duplicate component id '" + spec.id + "'");
+        }
+        if (!spec.parent.empty() && (spec.parent == spec.id || !ids.count(spec.parent))) {
+            return fail("parent '" + spec.parent + "' must be declared before '" + spec.id + "'");
+        }
+        description.components.push_back(std::move(spec));
+    }
+    return true;
+}
+
+} // namespace hmi3
\ No newline at end of file
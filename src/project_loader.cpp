@@ -0,0 +1,331 @@
+#include "hmi3/project_loader.hpp"
+#include <algorithm>
+#include <string_view>
+#include <unordered_set>
+
+namespace hmi3 {
+
+namespace {
+
+bool hasSameKeys(const ComponentSpec& previous, const ComponentSpec& next) {
+    // Снятое свойство нельзя вернуть к значению по умолчанию - компонент пересоздаётся
+    for (const auto& property : previous.properties) {
+        if (!next.findProperty(property.first)) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+ProjectLoader::ProjectLoader(ComponentFactory factory)
+    : m_factory(std::move(factory)) {
+}
+
+ProjectLoader::Result ProjectLoader::apply(Container& root, const ProjectLoadCommand& command) {
+    if (CompiledProject::isCompiled(command.projectData.view())) {
+        CompiledProject project;
+        Result result;
+        if (!project.openMemory(command.projectData.data(), command.projectData.size(), result.error)) {
+            return result;
+        }
+        return apply(root, project);
+    }
+
+    ProjectDescription description;
+    Result result;
+    if (!parseProject(command.projectData.view(), description, result.error)) {
+        return result;
+    }
+    return apply(root, std::move(description), command.version, command.forceLoad);
+}
+
+ProjectLoader::Result ProjectLoader::apply(Container& root, ProjectDescription description,
+                                           std::uint32_t version, bool forceLoad) {
+    Result result;
+    result.fullRebuild = forceLoad || m_root != &root || version != m_version;
+    // Узлы, переиспользованные этой загрузкой, получают новое поколение
+    std::uint64_t generation = ++m_generation;
+
+    // План строится без изменений живого дерева: при ошибке всё остаётся как было
+    std::vector<PlanEntry> plan;
+    plan.reserve(description.components.size());
+    std::unordered_map<std::string_view, Container*> containers;
+
+    for (auto& spec : description.components) {
+        PlanEntry entry{&spec, nullptr, &root, nullptr};
+
+        if (!spec.parent.empty()) {
+            auto parent = containers.find(spec.parent);
+            if (parent == containers.end()) {
+                result.error = "parent '" + spec.parent + "' of '" + spec.id + "' is not a container";
+                return result;
+            }
+            entry.parent = parent->second;
+        }
+
+        auto previous = m_nodes.find(spec.id);
+        if (!result.fullRebuild && previous != m_nodes.end() && previous->second.spec.type == spec.type &&
+            hasSameKeys(previous->second.spec, spec)) {
+            entry.component = previous->second.component.lock();
+            if (entry.component) {
+                entry.previous = &previous->second;
+                entry.previous->generation = generation;
+            }
+        }
+        if (!entry.component) {
+            entry.component = m_factory.create(spec.type, spec.id);
+            if (!entry.component) {
+                result.error = "unknown component type '" + spec.type + "' for '" + spec.id + "'";
+                return result;
+            }
+        }
+
+        if (auto container = dynamic_cast<Container*>(entry.component.get())) {
+            containers.emplace(spec.id, container);
+        }
+        plan.push_back(std::move(entry));
+    }
+
+    // Удаление всего, что не переиспользуется
+    result.removed = removeStaleNodes(generation);
+
+    // Свойства корня
+    for (const auto& property : description.rootProperties) {
+        bool changed = true;
+        if (!result.fullRebuild) {
+            auto previous = std::find(m_rootProperties.begin(), m_rootProperties.end(), property);
+            changed = previous == m_rootProperties.end();
+        }
+        if (changed && !root.applyProperty(property.first, property.second)) {
+            result.warnings.push_back("root: cannot apply " + property.first + "=" + property.second);
+        }
+    }
+
+    // Новые компоненты, переносы и изменённые свойства. Родители в плане
+    // всегда раньше детей, поэтому контейнер готов к моменту вставки
+    struct Siblings {
+        std::vector<const PlanEntry*> entries;
+        bool reordered = false;
+        const Node* lastKept = nullptr;
+    };
+    std::unordered_map<Container*, Siblings> siblings;
+    std::vector<Container*> parentsToArrange;
+
+    for (const auto& entry : plan) {
+        Component& component = *entry.component;
+        applyProperties(component, *entry.spec, entry.previous, result);
+
+        Siblings& group = siblings[entry.parent];
+        bool reordered = false;
+        if (!entry.previous || component.getParent() != entry.parent) {
+            if (!entry.parent->addComponent(entry.component).isValid()) {
+                result.warnings.push_back(entry.spec->id + ": id is already used in its parent");
+                continue;
+            }
+            ++(entry.previous ? result.moved : result.created);
+            // Новые встают в конец - если дальше идут старые соседи, нужен порядок
+            reordered = group.reordered || group.entries.size() + 1 != entry.parent->getComponentCount();
+        } else {
+            // Старые соседи должны идти в прежнем относительном порядке
+            reordered = group.lastKept && group.lastKept->order > entry.previous->order;
+            group.lastKept = entry.previous;
+        }
+
+        group.entries.push_back(&entry);
+        if (reordered && !group.reordered) {
+            group.reordered = true;
+            parentsToArrange.push_back(entry.parent);
+        }
+    }
+
+    for (Container* parent : parentsToArrange) {
+        arrangeChildren(*parent, siblings[parent].entries, result);
+    }
+
+    // Запоминаем применённое описание для следующего сравнения
+    for (std::size_t i = 0; i < plan.size(); ++i) {
+        Node* node = plan[i].previous;
+        if (!node) {
+            node = &m_nodes[plan[i].spec->id];
+            node->component = plan[i].component;
+            node->generation = generation;
+        }
+        node->spec = std::move(*plan[i].spec);
+        node->order = i;
+    }
+    for (auto it = m_nodes.begin(); it != m_nodes.end();) {
+        it = it->second.generation == generation ? std::next(it) : m_nodes.erase(it);
+    }
+    m_rootProperties = std::move(description.rootProperties);
+    m_root = &root;
+    m_version = version;
+
+    result.success = true;
+    return result;
+}
+
+ProjectLoader::Result ProjectLoader::apply(Container& root, const CompiledProject& project) {
+    Result result;
+    result.fullRebuild = true;
+    std::uint64_t generation = ++m_generation;
+
+    // Сначала все компоненты - при ошибке живое дерево не тронуто
+    std::size_t count = project.getComponentCount();
+    std::vector<std::shared_ptr<Component>> components(count);
+    std::vector<Container*> parents(count, &root);
+    std::string type;
+    std::string id;
+    for (std::size_t i = 0; i < count; ++i) {
+        type.assign(project.getType(i));
+        id.assign(project.getId(i));
+        components[i] = m_factory.create(type, id);
+        if (!components[i]) {
+            result.error = "unknown component type '" + type + "' for '" + id + "'";
+            return result;
+        }
+        std::uint32_t parent = project.getParent(i);
+        if (parent != CompiledProject::noParent) {
+            parents[i] = dynamic_cast<Container*>(components[parent].get());
+            if (!parents[i]) {
+                result.error = "parent '" + std::string(project.getId(parent)) + "' of '" + id +
+                               "' is not a container";
+                return result;
+            }
+        }
+    }
+
+    result.removed = removeStaleNodes(generation);
+    m_nodes.clear();
+    m_nodes.reserve(count);
+
+    auto warn = [&result](std::string_view owner, const CompiledProperty& property) {
+        result.warnings.push_back(std::string(owner) + ": cannot apply " + std::string(property.name) + "=" +
+                                  std::string(property.value));
+    };
+    for (std::size_t i = 0; i < project.getRootPropertyCount(); ++i) {
+        CompiledProperty property = project.getRootProperty(i);
+        if (!root.applyProperty(property.name, property.value)) {
+            warn("root", property);
+        }
+    }
+
+    // Поддерево компонента, не попавшего в дерево, не применяется
+    std::vector<bool> skipped(count, false);
+    for (std::size_t i = 0; i < count; ++i) {
+        Component& component = *components[i];
+        std::uint32_t parent = project.getParent(i);
+        if (parent != CompiledProject::noParent && skipped[parent]) {
+            skipped[i] = true;
+            result.warnings.push_back(component.getId() + ": skipped, parent '" + components[parent]->getId() +
+                                      "' was not added");
+            continue;
+        }
+        for (std::size_t j = 0; j < project.getPropertyCount(i); ++j) {
+            CompiledProperty property = project.getProperty(i, j);
+            if (!component.applyProperty(property.name, property.value)) {
+                warn(component.getId(), property);
+            }
+        }
+        if (!parents[i]->addComponent(components[i]).isValid()) {
+            skipped[i] = true;
+            result.warnings.push_back(component.getId() + ": id is already used in its parent");
+            continue;
+        }
+        ++result.created;
+
+        // Свойства остаются в отображении; узел нужен только для учёта компонентов
+        Node& node = m_nodes[component.getId()];
+        node.spec.type.assign(project.getType(i));
+        node.spec.id = component.getId();
+        if (parents[i] != &root) {
+            node.spec.parent = parents[i]->getId();
+        }
+        node.component = components[i];
+        node.order = i;
+        node.generation = generation;
+    }
+
+    // Сравнивать следующую загрузку не с чем
+    m_rootProperties.clear();
+    m_root = nullptr;
+    m_version = project.getVersion();
+
+    result.success = true;
+    return result;
+}
+
+std::size_t ProjectLoader::removeStaleNodes(std::uint64_t generation) {
+    // Дети удаляемого контейнера уходят вместе с ним, по одному их не вынимаем
+    std::unordered_set<const Component*> removed;
+    for (auto& node : m_nodes) {
+        if (node.second.generation == generation) continue;
+        if (auto component = node.second.component.lock()) {
+            removed.insert(component.get());
+        }
+    }
+    for (const Component* component : removed) {
+        Container* parent = component->getParent();
+        if (parent && !removed.count(parent)) {
+            parent->removeComponent(component->getHandle());
+        }
+    }
+    return removed.size();
+}
+
+void ProjectLoader::applyProperties(Component& component, const ComponentSpec& spec, const Node* previous,
+                                    Result& result) {
+    bool changed = false;
+    for (const auto& property : spec.properties) {
+        if (previous) {
+            const std::string* old = previous->spec.findProperty(property.first);
+            if (old && *old == property.second) continue;
+        }
+        changed = true;
+        if (!component.applyProperty(property.first, property.second)) {
+            result.warnings.push_back(spec.id + ": cannot apply " + property.first + "=" + property.second);
+        }
+    }
+    if (previous && changed) {
+        ++result.updated;
+    }
+}
+
+void ProjectLoader::arrangeChildren(Container& parent, const std::vector<const PlanEntry*>& children,
+                                    Result& result) {
+    // Текущие места управляемых компонентов в порядке отрисовки родителя
+    std::unordered_map<const Component*, std::size_t> position;
+    position.reserve(children.size());
+    for (const PlanEntry* entry : children) {
+        position.emplace(entry->component.get(), 0);
+    }
+    std::size_t index = 0;
+    parent.forEachComponent([&](Component& component) {
+        auto it = position.find(&component);
+        if (it != position.end()) {
+            it->second = index++;
+        }
+    });
+
+    // Начало нужного порядка, которое уже стоит как надо, не трогаем;
+    // остальные переносятся наверх по порядку. Обычно это хвост из новых
+    std::size_t keep = 0;
+    while (keep < children.size() &&
+           (keep == 0 || position[children[keep]->component.get()] > position[children[keep - 1]->component.get()])) {
+        ++keep;
+    }
+    for (std::size_t i = keep; i < children.size(); ++i) {
+        Component& component = *children[i]->component;
+        parent.bringToFront(component.getHandle());
+        // Только что созданные уже посчитаны
+        if (children[i]->previous && component.getParent() == &parent) {
+            ++result.moved;
+        }
+    }
+}
+
+std::shared_ptr<Component> ProjectLoader::findComponent(const std::string& id) const {
+    auto it = m_nodes.find(id);
+    return it != m_nodes.end() ? it->second.component.lock() : nullptr;
+}
+
+} // namespace hmi3
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include "hmi3/properties.hpp"
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+namespace hmi3 {
+namespace properties {
+
+namespace {
+
+// Делит "a,b,c" на части; false, если частей больше max
+template <std::size_t max>
+bool split(std::string_view text, std::string_view (&parts)[max], std::size_t& count) {
+    count = 0;
+    while (true) {
+        if (count == max) return false;
+        std::size_t comma = text.find(',');
+        parts[count++] = text.substr(0, comma);
+        if (comma == std::string_view::npos) return true;
+        text.remove_prefix(comma + 1);
+    }
+}
+
+bool parseByte(std::string_view text, std::uint8_t& value) {
+    unsigned int number = 0;
+    auto result = std::from_chars(text.data(), text.data() + text.size(), number);
+    if (result.ec != std::errc() || result.ptr != text.data() + text.size() || number > 255) {
+        return false;
+    }
+    value = static_cast<std::uint8_t>(number);
+    return true;
+}
+
+} // namespace
+
+bool parseFloat(std::string_view text, float& value) {
+    if (text.empty()) return false;
+    // from_chars для float есть не во всех стандартных библиотеках C++17
+    std::string copy(text);
+    char* end = nullptr;
+    float number = std::strtof(copy.c_str(), &end);
+    if (end != copy.c_str() + copy.size()) return false;
+    value = number;
+    return true;
+}
+
+bool parseBool(std::string_view text, bool& value) {
+    if (text == "1" || text == "true" || text == "yes") {
+        value = true;
+        return true;
+    }
+    if (text == "0" || text == "false" || text == "no") {
+        value = false;
+        return true;
+    }
+    return false;
+}
+
+bool parseVector(std::string_view text, sf::Vector2f& value) {
+    std::string_view parts[2];
+    std::size_t count = 0;
+    sf::Vector2f result;
+    if (!split(text, parts, count) || count != 2 ||
+        !parseFloat(parts[0], result.x) || !parseFloat(parts[1], result.y)) {
+        return false;
+    }
+    value = result;
+    return true;
+}
+
+bool parseColor(std::string_view text, sf::Color& value) {
+    std::string_view parts[4];
+    std::size_t count = 0;
+    sf::Color result;
+    if (!split(text, parts, count) || count < 3 ||
+        !parseByte(parts[0], result.r) || !parseByte(parts[1], result.g) || !parseByte(parts[2], result.b) ||
+        (count == 4 && !parseByte(parts[3], result.a))) {
+        return false;
+    }
+    value = result;
+    return true;
+}
+
+} // namespace properties
+} // namespace hmi3
\ No newline at end of file
@@ -0,0 +1,342 @@
+#include "hmi3/protocol.hpp"
+#include "byte_order.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+
+namespace hmi3 {
+
+namespace {
+
+std::array<std::uint32_t, 256> makeCrcTable() {
+    std::array<std::uint32_t, 256> table{};
+    for (std::uint32_t i = 0; i < 256; ++i) {
+        std::uint32_t value = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            value = (value & 1) ? (0xEDB88320u ^ (value >> 1)) : (value >> 1);
+        }
+        table[i] = value;
+    }
+    return table;
+}
+
+std::string checksumToString(std::uint32_t checksum) {
+    char text[9];
+    std::snprintf(text, sizeof(text), "%08x", checksum);
+    return text;
+}
+
+} // namespace
+
+std::uint32_t crc32(const void* data, std::size_t size, std::uint32_t crc) {
+    static const auto table = makeCrcTable();
+    auto bytes = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+    for (std::size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+bool encodeFramePayload(const ProjectLoadCommand& command, PayloadBuffer& payload, std::string& error) {
+    if (command.compression == PayloadCompression::None) {
+        payload = command.projectData;
+        return true;
+    }
+    return compressPayload(command.compression, command.projectData, payload, error);
+}
+
+std::string encodeFrameHeader(const ProjectLoadCommand& command, std::string_view payload) {
+    std::size_t nameLength = std::min(command.projectName.size(), protocol::kMaxNameLength);
+    bool compressed = command.compression != PayloadCompression::None;
+    std::uint8_t flags = static_cast<std::uint8_t>(
+        (command.forceLoad ? protocol::FlagForceLoad : 0) |
+        ((static_cast<std::uint8_t>(command.compression) << protocol::kCompressionShift) &
+         protocol::FlagCompressionMask));
+
+    std::string header(protocol::kHeaderSize, '\0');
+    std::memcpy(&header[0], protocol::kMagic, sizeof(protocol::kMagic));
+    header[4] = static_cast<char>(compressed ? protocol::kVersion : protocol::kMinVersion);
+    header[5] = static_cast<char>(flags);
+    writeLE<std::uint16_t>(&header[6], static_cast<std::uint16_t>(nameLength));
+    writeLE<std::uint32_t>(&header[8], command.version);
+    writeLE<std::uint32_t>(&header[12], crc32(payload.data(), payload.size()));
+    writeLE<std::uint64_t>(&header[16], payload.size());
+    header.append(command.projectName, 0, nameLength);
+    return header;
+}
+
+std::string encodeFrameHeader(const ProjectLoadCommand& command) {
+    PayloadBuffer payload;
+    std::string error;
+    if (!encodeFramePayload(command, payload, error)) {
+        return std::string();
+    }
+    return encodeFrameHeader(command, payload);
+}
+
+std::string encodeFrame(const ProjectLoadCommand& command) {
+    PayloadBuffer payload;
+    std::string error;
+    if (!encodeFramePayload(command, payload, error)) {
+        return std::string();
+    }
+    std::string frame = encodeFrameHeader(command, payload);
+    frame.append(payload.data(), payload.size());
+    return frame;
+}
+
+sf::Socket::Status sendFrame(sf::TcpSocket& socket, const ProjectLoadCommand& command) {
+    // Заголовок и нагрузка уходят двумя вызовами - без склейки в один буфер.
+    // Несжавшаяся нагрузка не уходит вовсе: флаг сжатия соврал бы приёмнику
+    PayloadBuffer payload;
+    std::string error;
+    if (!encodeFramePayload(command, payload, error)) {
+        return sf::Socket::Status::Error;
+    }
+    std::string header = encodeFrameHeader(command, payload);
+    auto status = socket.send(header.data(), header.size());
+    if (status != sf::Socket::Status::Done || payload.empty()) {
+        return status;
+    }
+    return socket.send(payload.data(), payload.size());
+}
+
+FrameParser::FrameParser(std::uint64_t maxPayloadSize)
+    : m_maxPayloadSize(maxPayloadSize) {
+    reset();
+}
+
+void FrameParser::reset() {
+    m_state = State::Header;
+    m_headerSize = 0;
+    m_nameLength = 0;
+    m_payloadLength = 0;
+    m_received = 0;
+    m_expectedChecksum = 0;
+    m_checksum = 0;
+    m_payload = PayloadWriter();
+    m_discardReason.clear();
+    m_command = ProjectLoadCommand();
+    m_stats = FrameStats();
+    m_error.clear();
+}
+
+FrameParser::Result FrameParser::feed(const char* data, std::size_t size, std::size_t& consumed) {
+    consumed = 0;
+
+    while (consumed < size || m_state == State::Payload) {
+        switch (m_state) {
+        case State::Header: {
+            std::size_t count = std::min(size - consumed, protocol::kHeaderSize - m_headerSize);
+            std::memcpy(m_header + m_headerSize, data + consumed, count);
+            m_headerSize += count;
+            consumed += count;
+            if (m_headerSize < protocol::kHeaderSize) {
+                return Result::NeedMoreData;
+            }
+            Result result = parseHeader();
+            if (result != Result::NeedMoreData) {
+                return result;
+            }
+            break;
+        }
+        case State::Name: {
+            std::size_t count = std::min(size - consumed, m_nameLength - m_command.projectName.size());
+            m_command.projectName.append(data + consumed, count);
+            consumed += count;
+            if (m_command.projectName.size() < m_nameLength) {
+                return Result::NeedMoreData;
+            }
+            m_state = State::Payload;
+            break;
+        }
+        case State::Payload: {
+            std::uint64_t remaining = m_payloadLength - m_received;
+            std::size_t count = static_cast<std::size_t>(std::min<std::uint64_t>(size - consumed, remaining));
+            consumePayload(data + consumed, count);
+            consumed += count;
+            if (m_received < m_payloadLength) {
+                return Result::NeedMoreData;
+            }
+            return finishFrame();
+        }
+        case State::Error:
+            return Result::ProtocolError;
+        }
+    }
+    return Result::NeedMoreData;
+}
+
+char* FrameParser::payloadWindow(std::size_t& size) {
+    size = 0;
+    if (m_state != State::Payload) {
+        return nullptr;
+    }
+    size = static_cast<std::size_t>(m_payloadLength - m_received);
+    if (size == 0) {
+        return nullptr;
+    }
+    if (m_stats.compression == PayloadCompression::None && m_discardReason.empty()) {
+        // Окно - только уже выделенная часть блока; блок растёт удвоением
+        // по мере прихода байт, а не по длине из заголовка
+        std::size_t space = m_payload.capacity() - m_payload.size();
+        if (space == 0) {
+            m_payload.prepare(std::min(size, kMaxPresize));
+            space = m_payload.capacity() - m_payload.size();
+        }
+        size = std::min(size, space);
+        return m_payload.prepare(size);
+    }
+
+    // Сжатые байты живут в буфере только до распаковки
+    if (m_staging.empty()) {
+        m_staging.resize(kStagingSize);
+    }
+    size = std::min(size, m_staging.size());
+    return m_staging.data();
+}
+
+FrameParser::Result FrameParser::commitPayload(std::size_t size) {
+    std::size_t window = 0;
+    char* data = payloadWindow(window);
+    size = std::min(size, window);
+
+    if (data != m_staging.data()) {
+        m_checksum = crc32(data, size, m_checksum);
+        m_payload.commit(size);
+        m_received += size;
+    } else {
+        consumePayload(data, size);
+    }
+    if (m_received < m_payloadLength) {
+        return Result::NeedMoreData;
+    }
+    return finishFrame();
+}
+
+ProjectLoadCommand FrameParser::takeCommand() {
+    ProjectLoadCommand command = std::move(m_command);
+    m_command = ProjectLoadCommand();
+    return command;
+}
+
+FrameParser::Result FrameParser::parseHeader() {
+    m_error.clear();
+    std::uint8_t version = static_cast<std::uint8_t>(m_header[4]);
+    std::uint8_t flags = static_cast<std::uint8_t>(m_header[5]);
+    if (std::memcmp(m_header, protocol::kMagic, sizeof(protocol::kMagic)) != 0) {
+        m_error = "bad frame magic";
+    } else if (version < protocol::kMinVersion || version > protocol::kVersion) {
+        m_error = "unsupported protocol version " + std::to_string(version);
+    } else if (version < 2 && (flags & protocol::FlagCompressionMask) != 0) {
+        m_error = "compressed payload in a version 1 frame";
+    } else if (readLE<std::uint16_t>(m_header + 6) > protocol::kMaxNameLength) {
+        m_error = "project name too long";
+    } else if (readLE<std::uint64_t>(m_header + 16) > m_maxPayloadSize) {
+        m_error = "payload too large";
+    }
+
+    if (!m_error.empty()) {
+        m_state = State::Error;
+        return Result::ProtocolError;
+    }
+
+    auto compression = static_cast<PayloadCompression>((flags & protocol::FlagCompressionMask) >>
+                                                       protocol::kCompressionShift);
+    m_nameLength = readLE<std::uint16_t>(m_header + 6);
+    m_expectedChecksum = readLE<std::uint32_t>(m_header + 12);
+    m_payloadLength = readLE<std::uint64_t>(m_header + 16);
+    m_received = 0;
+    m_checksum = 0;
+    m_discardReason.clear();
+    m_stats = FrameStats();
+    m_stats.compression = compression;
+    m_stats.wireBytes = m_payloadLength;
+
+    m_command = ProjectLoadCommand();
+    m_command.version = readLE<std::uint32_t>(m_header + 8);
+    m_command.forceLoad = (flags & protocol::FlagForceLoad) != 0;
+    m_command.checksum = checksumToString(m_expectedChecksum);
+    m_command.compression = compression;
+    m_command.projectName.reserve(m_nameLength);
+
+    if (compression == PayloadCompression::None) {
+        // Длина из заголовка ещё ничем не подтверждена: заранее берём из пула
+        // не больше kMaxPresize, иначе 24 байта заголовка занимали бы 256 МБ
+        m_payload = PayloadWriter(static_cast<std::size_t>(std::min<std::uint64_t>(m_payloadLength, kMaxPresize)));
+    } else if (compression == PayloadCompression::Lz4) {
+        // Распакованный размер узнаем из заголовка LZ4
+        m_payload = PayloadWriter();
+        if (!m_decoder || m_decoder->getCompression() != compression) {
+            m_decoder = std::make_unique<StreamDecompressor>(compression);
+        }
+        m_decoder->reset(m_payloadLength);
+    } else {
+        m_payload = PayloadWriter();
+        m_discardReason = "unsupported payload compression " +
+                          std::to_string(static_cast<unsigned>(compression));
+    }
+
+    m_state = m_nameLength > 0 ? State::Name : State::Payload;
+    return Result::NeedMoreData;
+}
+
+void FrameParser::consumePayload(const char* data, std::size_t size) {
+    m_checksum = crc32(data, size, m_checksum);
+    m_received += size;
+    if (!m_discardReason.empty()) {
+        return;
+    }
+    if (m_stats.compression == PayloadCompression::None) {
+        m_payload.append(data, size);
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    bool decoded = m_decoder->feed(data, size, m_payload, m_maxPayloadSize);
+    m_stats.decodeSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (!decoded) {
+        // Остаток кадра дочитывается ради синхронизации потока
+        m_discardReason = m_decoder->getError();
+        m_payload = PayloadWriter();
+    }
+}
+
+FrameParser::Result FrameParser::finishFrame() {
+    m_state = State::Header;
+    m_headerSize = 0;
+
+    // Длина известна, поэтому поток остаётся синхронизированным:
+    // отбрасываем только повреждённый кадр, соединение продолжает работать
+    if (m_checksum != m_expectedChecksum) {
+        m_error = "checksum mismatch in frame '" + m_command.projectName + "'";
+        m_payload = PayloadWriter();
+        m_command = ProjectLoadCommand();
+        return Result::FrameRejected;
+    }
+
+    bool compressed = m_stats.compression != PayloadCompression::None;
+    if (m_discardReason.empty() && compressed && !m_decoder->isComplete()) {
+        m_discardReason = "truncated compressed payload";
+    }
+    if (!m_discardReason.empty()) {
+        m_error = m_discardReason + " in frame '" + m_command.projectName + "'";
+        m_discardReason.clear();
+        m_payload = PayloadWriter();
+        m_command = ProjectLoadCommand();
+        return Result::FrameRejected;
+    }
+
+    m_stats.payloadBytes = m_payload.size();
+    m_stats.peakMemory = m_payload.capacity();
+    if (compressed) {
+        m_stats.peakMemory += m_staging.capacity() + m_decoder->getWorkingMemory();
+    }
+    m_command.projectData = m_payload.finish();
+    return Result::FrameReady;
+}
+
+} // namespace hmi3
\ No newline at end of file
@@ -0,0 +1,73 @@
+#include "hmi3/components/rectangle_component.hpp"
+#include "hmi3/properties.hpp"
+#include "hmi3/render_batch.hpp"
+#include <algorithm>
+
+namespace hmi3 {
+
+RectangleComponent::RectangleComponent(std::string id, const sf::Vector2f& size, const sf::Color& fillColor)
+    : Component(std::move(id))
+    , m_fillColor(fillColor) {
+    m_size = size;
+}
+
+void RectangleComponent::setFillColor(const sf::Color& color) {
+    if (m_fillColor == color) return;
+    m_fillColor = color;
+    markDirty();
+}
+
+void RectangleComponent::setOutlineColor(const sf::Color& color) {
+    if (m_outlineColor == color) return;
+    m_outlineColor = color;
+    markDirty();
+}
+
+void RectangleComponent::setOutlineThickness(float thickness) {
+    if (m_outlineThickness == thickness) return;
+    m_outlineThickness = thickness;
+    markDirty();
+}
+
+bool RectangleComponent::applyProperty(std::string_view name, std::string_view value) {
+    if (name == "fill" || name == "outline") {
+        sf::Color color;
+        if (!properties::parseColor(value, color)) return false;
+        name == "fill" ? setFillColor(color) : setOutlineColor(color);
+        return true;
+    }
+    if (name == "outlineThickness") {
+        float thickness = 0.0f;
+        if (!properties::parseFloat(value, thickness)) return false;
+        setOutlineThickness(thickness);
+        return true;
+    }
+    return Component::applyProperty(name, value);
+}
+
+void RectangleComponent::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    // Вне контейнера - отдельный пакет из одного компонента
+    RenderBatch batch;
+    appendGeometry(batch);
+    batch.draw(target, states);
+}
+
+bool RectangleComponent::appendGeometry(RenderBatch& batch) const {
+    float outline = std::min({m_outlineThickness, m_size.x / 2.0f, m_size.y / 2.0f});
+    if (outline <= 0.0f || m_outlineColor.a == 0) {
+        batch.appendRect(sf::FloatRect(m_position, m_size), m_fillColor);
+        return true;
+    }
+
+    sf::Vector2f inner(m_size.x - 2.0f * outline, m_size.y - 2.0f * outline);
+    batch.appendRect(sf::FloatRect(m_position + sf::Vector2f(outline, outline), inner), m_fillColor);
+
+    // Рамка - четыре полосы без перекрытия
+    batch.appendRect(sf::FloatRect(m_position, {m_size.x, outline}), m_outlineColor);
+    batch.appendRect(sf::FloatRect({m_position.x, m_position.y + m_size.y - outline}, {m_size.x, outline}), m_outlineColor);
+    batch.appendRect(sf::FloatRect({m_position.x, m_position.y + outline}, {outline, inner.y}), m_outlineColor);
+    batch.appendRect(sf::FloatRect({m_position.x + m_size.x - outline, m_position.y + outline}, {outline, inner.y}), m_outlineColor);
+    return true;
+}
+
+} // namespace hmi3
\ No newline at end of file
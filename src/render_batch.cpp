@@ -0,0 +1,157 @@
+#include "hmi3/render_batch.hpp"
+#include <algorithm>
+
+namespace hmi3 {
+
+namespace {
+
+// Пустое пересечение - прямоугольник нулевого размера: всё отсекается
+sf::FloatRect intersect(const sf::FloatRect& a, const sf::FloatRect& b) {
+    return a.findIntersection(b).value_or(sf::FloatRect(a.position, {0.0f, 0.0f}));
+}
+
+} // namespace
+
+void RenderBatch::clear() {
+    for (std::size_t i = 0; i < m_usedBatches; ++i) {
+        m_batches[i].vertices.clear();
+    }
+    m_usedBatches = 0;
+    m_entries.clear();
+    m_layers.resize(1);
+    m_layers[0] = Layer{};
+    m_layer = 0;
+}
+
+sf::VertexArray& RenderBatch::geometry(const sf::Texture* texture, const sf::BlendMode& blendMode) {
+    if (!m_entries.empty() && !m_entries.back().drawable) {
+        Batch& last = m_batches[m_entries.back().batch];
+        if (last.texture == texture && last.blendMode == blendMode && last.layer == m_layer) {
+            return last.vertices;
+        }
+    }
+
+    if (m_usedBatches == m_batches.size()) {
+        m_batches.emplace_back();
+    }
+    Batch& batch = m_batches[m_usedBatches];
+    batch.texture = texture;
+    batch.blendMode = blendMode;
+    batch.layer = m_layer;
+    m_entries.push_back({nullptr, m_usedBatches, m_layer});
+    ++m_usedBatches;
+    return batch.vertices;
+}
+
+void RenderBatch::appendRect(const sf::FloatRect& rect, const sf::Color& color) {
+    if (color.a == 0 || rect.size.x <= 0.0f || rect.size.y <= 0.0f) return;
+
+    sf::Vector2f topLeft = rect.position;
+    sf::Vector2f topRight(rect.position.x + rect.size.x, rect.position.y);
+    sf::Vector2f bottomLeft(rect.position.x, rect.position.y + rect.size.y);
+    sf::Vector2f bottomRight = rect.position + rect.size;
+
+    sf::VertexArray& vertices = geometry();
+    vertices.append(sf::Vertex{topLeft, color, {}});
+    vertices.append(sf::Vertex{topRight, color, {}});
+    vertices.append(sf::Vertex{bottomLeft, color, {}});
+    vertices.append(sf::Vertex{bottomLeft, color, {}});
+    vertices.append(sf::Vertex{topRight, color, {}});
+    vertices.append(sf::Vertex{bottomRight, color, {}});
+}
+
+void RenderBatch::appendDrawable(const sf::Drawable& drawable) {
+    m_entries.push_back({&drawable, 0, m_layer});
+}
+
+void RenderBatch::pushLayer(const sf::Transform& transform, const std::optional<sf::FloatRect>& clip) {
+    const Layer& parent = m_layers[m_layer];
+    Layer layer;
+    layer.parent = m_layer;
+    layer.transform = parent.transform * transform;
+    layer.clip = parent.clip;
+    if (clip) {
+        sf::FloatRect rootClip = parent.transform.transformRect(*clip);
+        layer.clip = layer.clip ? intersect(*layer.clip, rootClip) : rootClip;
+    }
+
+    std::optional<sf::FloatRect> visible = parent.visible;
+    if (clip) {
+        visible = visible ? intersect(*visible, *clip) : *clip;
+    }
+    if (visible) {
+        layer.visible = transform.getInverse().transformRect(*visible);
+    }
+
+    m_layers.push_back(layer);
+    m_layer = m_layers.size() - 1;
+}
+
+void RenderBatch::popLayer() {
+    m_layer = m_layers[m_layer].parent;
+}
+
+void RenderBatch::setVisibleArea(const sf::FloatRect& area) {
+    m_layers[0].visible = area;
+}
+
+void RenderBatch::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    // Ножницы ставятся через вид цели; после отрисовки вид возвращается
+    const sf::View view = target.getView();
+    std::size_t applied = 0;
+    for (const auto& entry : m_entries) {
+        const Layer& layer = m_layers[entry.layer];
+        if (entry.layer != applied) {
+            applyClip(target, view, states.transform, layer.clip);
+            applied = entry.layer;
+        }
+        sf::RenderStates layerStates = states;
+        layerStates.transform *= layer.transform;
+
+        if (entry.drawable) {
+            target.draw(*entry.drawable, layerStates);
+            continue;
+        }
+        const Batch& batch = m_batches[entry.batch];
+        if (batch.vertices.getVertexCount() == 0) continue;
+
+        layerStates.texture = batch.texture;
+        layerStates.blendMode = batch.blendMode;
+        target.draw(batch.vertices, layerStates);
+    }
+    if (applied != 0) {
+        target.setView(view);
+    }
+}
+
+void RenderBatch::applyClip(sf::RenderTarget& target, const sf::View& view, const sf::Transform& transform,
+                            const std::optional<sf::FloatRect>& clip) const {
+    if (!clip) {
+        target.setView(view);
+        return;
+    }
+
+    // Ножницы вида задаются долями цели
+    sf::FloatRect area = transform.transformRect(*clip);
+    sf::Vector2i topLeft = target.mapCoordsToPixel(area.position, view);
+    sf::Vector2i bottomRight = target.mapCoordsToPixel(area.position + area.size, view);
+    sf::Vector2f size(target.getSize());
+    sf::Vector2f left(static_cast<float>(std::min(topLeft.x, bottomRight.x)) / size.x,
+                      static_cast<float>(std::min(topLeft.y, bottomRight.y)) / size.y);
+    sf::Vector2f right(static_cast<float>(std::max(topLeft.x, bottomRight.x)) / size.x,
+                       static_cast<float>(std::max(topLeft.y, bottomRight.y)) / size.y);
+
+    sf::View clipped = view;
+    clipped.setScissor(intersect(view.getScissor(), sf::FloatRect(left, right - left)));
+    target.setView(clipped);
+}
+
+std::size_t RenderBatch::getVertexCount() const {
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < m_usedBatches; ++i) {
+        count += m_batches[i].vertices.getVertexCount();
+    }
+    return count;
+}
+
+} // namespace hmi3
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "hmi3/scene_stager.hpp"
+#include "hmi3/profiler.hpp"
+#include <chrono>
+
+namespace hmi3 {
+
+SceneStager::SceneStager(ComponentFactory factory, std::string rootId)
+    : m_factory(std::move(factory))
+    , m_rootId(std::move(rootId)) {
+    m_worker = std::thread(&SceneStager::workerLoop, this);
+}
+
+SceneStager::~SceneStager() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    m_worker.join();
+}
+
+void SceneStager::submit(ProjectLoadCommand command) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_request) {
+            ++m_stats.superseded;
+        }
+        m_request = std::move(command);
+        ++m_stats.submitted;
+    }
+    m_wake.notify_one();
+}
+
+std::shared_ptr<SceneStager::Scene> SceneStager::acquire() {
+    return std::atomic_exchange(&m_ready, std::shared_ptr<Scene>());
+}
+
+void SceneStager::retire(std::shared_ptr<void> garbage) {
+    if (!garbage) return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_garbage.push_back(std::move(garbage));
+    }
+    m_wake.notify_one();
+}
+
+void SceneStager::waitIdle() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this] { return !m_request && m_garbage.empty() && !m_busy; });
+}
+
+SceneStager::Stats SceneStager::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void SceneStager::workerLoop() {
+    for (;;) {
+        std::optional<ProjectLoadCommand> request;
+        std::vector<std::shared_ptr<void>> garbage;
+        bool stopping;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this] { return m_stopping || m_request || !m_garbage.empty(); });
+            stopping = m_stopping;
+            garbage.swap(m_garbage);
+            if (!stopping) {
+                request = std::move(m_request);
+                m_request.reset();
+            }
+            m_busy = true;
+        }
+
+        // Сначала мусор: прежняя сцена освобождает память до сборки новой
+        std::size_t retired = garbage.size();
+        garbage.clear();
+        if (stopping) return;
+
+        std::shared_ptr<Scene> stale;
+        bool success = false;
+        if (request) {
+            std::shared_ptr<Scene> scene = build(std::move(*request));
+            success = scene->result.success;
+            stale = std::atomic_exchange(&m_ready, std::move(scene));
+        }
+
+        // Сцена, которую так и не забрали, уходит здесь же
+        bool superseded = stale != nullptr;
+        stale.reset();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stats.retired += retired;
+            if (request) {
+                ++(success ? m_stats.built : m_stats.failed);
+            }
+            if (superseded) {
+                ++m_stats.superseded;
+            }
+            m_busy = false;
+        }
+        m_idle.notify_all();
+    }
+}
+
+std::shared_ptr<SceneStager::Scene> SceneStager::build(ProjectLoadCommand command) {
+    HMI3_PROFILE_SCOPE("stage", command.projectName);
+    auto start = std::chrono::steady_clock::now();
+
+    auto scene = std::make_shared<Scene>();
+    scene->loader = std::make_unique<ProjectLoader>(m_factory);
+    auto root = std::make_shared<Container>(m_rootId);
+    scene->result = scene->loader->apply(*root, command);
+    if (scene->result.success) {
+        // Первый update() новых компонентов (большинство после него
+        // засыпает) тоже проходит здесь, а не в кадре после подмены
+        root->update(0.0f);
+        scene->root = std::move(root);
+    } else {
+        // Загрузчик помнит корень, который сейчас будет удалён
+        scene->loader.reset();
+    }
+    scene->command = std::move(command);
+
+    scene->buildSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return scene;
+}
+
+} // namespace hmi3
\ No newline at end of file
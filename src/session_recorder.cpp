@@ -0,0 +1,285 @@
+#include "hmi3/session_recorder.hpp"
+#include "hmi3/logger.hpp"
+#include "hmi3/view_protocol.hpp"
+#include "byte_order.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace hmi3 {
+
+namespace {
+
+constexpr char kSessionMagic[4] = {'H', 'M', 'S', '1'};
+// тип (1), время (8), длина тела (4)
+constexpr std::size_t kRecordHeaderSize = 13;
+// версия (4), forceLoad (1), сжатие (1), длина имени (2)
+constexpr std::size_t kCommandHeaderSize = 8;
+
+enum EventSource : std::uint8_t {
+    SourceInput = 0,
+    SourceWindow = 1
+};
+
+enum WindowEventKind : std::uint8_t {
+    WindowResized = 1,
+    WindowFocusLost = 2,
+    WindowFocusGained = 3,
+    WindowMouseEntered = 4,
+    WindowMouseLeft = 5
+};
+
+std::string encodeWindowEvent(WindowEventKind kind, sf::Vector2u size = {}) {
+    std::string body;
+    appendLE<std::uint8_t>(body, SourceWindow);
+    appendLE<std::uint8_t>(body, kind);
+    appendLE<std::uint32_t>(body, size.x);
+    appendLE<std::uint32_t>(body, size.y);
+    return body;
+}
+
+std::optional<sf::Event> decodeEvent(const char* data, std::size_t size) {
+    if (size < 1) {
+        return std::nullopt;
+    }
+    if (data[0] == SourceInput) {
+        return decodeInputEvent(data + 1, size - 1);
+    }
+    if (data[0] != SourceWindow || size != 10) {
+        return std::nullopt;
+    }
+    sf::Vector2u windowSize(readLE<std::uint32_t>(data + 2), readLE<std::uint32_t>(data + 6));
+    switch (static_cast<std::uint8_t>(data[1])) {
+    case WindowResized:
+        return sf::Event(sf::Event::Resized{windowSize});
+    case WindowFocusLost:
+        return sf::Event(sf::Event::FocusLost{});
+    case WindowFocusGained:
+        return sf::Event(sf::Event::FocusGained{});
+    case WindowMouseEntered:
+        return sf::Event(sf::Event::MouseEntered{});
+    case WindowMouseLeft:
+        return sf::Event(sf::Event::MouseLeft{});
+    default:
+        return std::nullopt;
+    }
+}
+
+std::string encodeCommand(const ProjectLoadCommand& command) {
+    std::size_t nameLength = std::min<std::size_t>(command.projectName.size(), 0xFFFF);
+    std::string body;
+    body.reserve(kCommandHeaderSize + nameLength + command.projectData.size());
+    appendLE<std::uint32_t>(body, command.version);
+    appendLE<std::uint8_t>(body, command.forceLoad ? 1 : 0);
+    appendLE<std::uint8_t>(body, static_cast<std::uint8_t>(command.compression));
+    appendLE<std::uint16_t>(body, static_cast<std::uint16_t>(nameLength));
+    body.append(command.projectName.data(), nameLength);
+    body.append(command.projectData.data(), command.projectData.size());
+    return body;
+}
+
+} // namespace
+
+SessionRecorder::SessionRecorder()
+    : m_file(nullptr)
+    , m_records(0)
+    , m_writeFailed(false) {
+}
+
+SessionRecorder::~SessionRecorder() {
+    close();
+}
+
+bool SessionRecorder::open(const std::string& path, std::string& error) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_file) {
+        std::fclose(m_file);
+    }
+    m_file = std::fopen(path.c_str(), "wb");
+    if (!m_file) {
+        error = "cannot create " + path;
+        return false;
+    }
+    m_start = std::chrono::steady_clock::now();
+    m_records = 0;
+    m_writeFailed = false;
+    if (std::fwrite(kSessionMagic, 1, sizeof(kSessionMagic), m_file) != sizeof(kSessionMagic)) {
+        fail();
+        error = "cannot write " + path;
+        return false;
+    }
+    return true;
+}
+
+void SessionRecorder::close() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_file) {
+        // Остаток буфера stdio уходит на диск здесь
+        if (std::fclose(m_file) != 0) {
+            m_writeFailed = true;
+            HMI3_LOG_ERROR("Session recording: cannot flush the last records, the file is truncated");
+        }
+        m_file = nullptr;
+    }
+}
+
+void SessionRecorder::fail() {
+    std::fclose(m_file);
+    m_file = nullptr;
+    m_writeFailed = true;
+    HMI3_LOG_ERROR("Session recording stopped after " << m_records << " records: write failed");
+}
+
+bool SessionRecorder::hasWriteFailed() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_writeFailed;
+}
+
+bool SessionRecorder::isOpen() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_file != nullptr;
+}
+
+std::uint64_t SessionRecorder::getRecordCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_records;
+}
+
+void SessionRecorder::recordEvent(const sf::Event& event) {
+    // Записыватель подключён постоянно: без файла тело записи не собираем
+    if (!isOpen()) return;
+    std::string input = encodeInputEvent(event);
+    if (!input.empty()) {
+        input.insert(input.begin(), static_cast<char>(SourceInput));
+        append(static_cast<std::uint8_t>(SessionRecord::Type::Event), input);
+    } else if (auto* resized = event.getIf<sf::Event::Resized>()) {
+        append(static_cast<std::uint8_t>(SessionRecord::Type::Event), encodeWindowEvent(WindowResized, resized->size));
+    } else if (event.is<sf::Event::FocusLost>()) {
+        append(static_cast<std::uint8_t>(SessionRecord::Type::Event), encodeWindowEvent(WindowFocusLost));
+    } else if (event.is<sf::Event::FocusGained>()) {
+        append(static_cast<std::uint8_t>(SessionRecord::Type::Event), encodeWindowEvent(WindowFocusGained));
+    } else if (event.is<sf::Event::MouseEntered>()) {
+        append(static_cast<std::uint8_t>(SessionRecord::Type::Event), encodeWindowEvent(WindowMouseEntered));
+    } else if (event.is<sf::Event::MouseLeft>()) {
+        append(static_cast<std::uint8_t>(SessionRecord::Type::Event), encodeWindowEvent(WindowMouseLeft));
+    }
+}
+
+void SessionRecorder::recordUpdate(float dt) {
+    if (!isOpen()) return;
+    std::uint32_t bits;
+    std::memcpy(&bits, &dt, sizeof(bits));
+    std::string body;
+    appendLE<std::uint32_t>(body, bits);
+    append(static_cast<std::uint8_t>(SessionRecord::Type::Update), body);
+}
+
+void SessionRecorder::recordCommand(const ProjectLoadCommand& command) {
+    if (isOpen()) {
+        append(static_cast<std::uint8_t>(SessionRecord::Type::Command), encodeCommand(command));
+    }
+}
+
+void SessionRecorder::recordScene(const ProjectLoadCommand& command) {
+    if (isOpen()) {
+        append(static_cast<std::uint8_t>(SessionRecord::Type::Scene), encodeCommand(command));
+    }
+}
+
+void SessionRecorder::append(std::uint8_t type, std::string_view body) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_file) return;
+
+    auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start);
+    m_record.clear();
+    appendLE<std::uint8_t>(m_record, type);
+    appendLE<std::int64_t>(m_record, time.count());
+    appendLE<std::uint32_t>(m_record, static_cast<std::uint32_t>(body.size()));
+    if (std::fwrite(m_record.data(), 1, m_record.size(), m_file) != m_record.size() ||
+        std::fwrite(body.data(), 1, body.size(), m_file) != body.size()) {
+        fail();
+        return;
+    }
+    ++m_records;
+}
+
+bool SessionRecording::load(const std::string& path, std::string& error) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        error = "cannot read " + path;
+        return false;
+    }
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return parse(data, error);
+}
+
+bool SessionRecording::parse(std::string_view data, std::string& error) {
+    m_records.clear();
+    m_frameCount = 0;
+    m_skippedBytes = 0;
+    if (data.size() < sizeof(kSessionMagic) || std::memcmp(data.data(), kSessionMagic, sizeof(kSessionMagic)) != 0) {
+        error = "not a session recording";
+        return false;
+    }
+
+    std::size_t offset = sizeof(kSessionMagic);
+    while (data.size() - offset >= kRecordHeaderSize) {
+        const char* header = data.data() + offset;
+        std::size_t bodySize = readLE<std::uint32_t>(header + 9);
+        if (bodySize > data.size() - offset - kRecordHeaderSize) break;
+        const char* body = header + kRecordHeaderSize;
+
+        SessionRecord record;
+        record.type = static_cast<SessionRecord::Type>(readLE<std::uint8_t>(header));
+        record.timeNs = readLE<std::int64_t>(header + 1);
+        switch (record.type) {
+        case SessionRecord::Type::Event:
+            record.event = decodeEvent(body, bodySize);
+            if (!record.event) {
+                error = "bad event at offset " + std::to_string(offset);
+                return false;
+            }
+            break;
+        case SessionRecord::Type::Update: {
+            if (bodySize != 4) {
+                error = "bad update at offset " + std::to_string(offset);
+                return false;
+            }
+            std::uint32_t bits = readLE<std::uint32_t>(body);
+            std::memcpy(&record.dt, &bits, sizeof(bits));
+            ++m_frameCount;
+            break;
+        }
+        case SessionRecord::Type::Command:
+        case SessionRecord::Type::Scene: {
+            std::size_t nameLength = bodySize >= kCommandHeaderSize ? readLE<std::uint16_t>(body + 6) : 0;
+            if (bodySize < kCommandHeaderSize || kCommandHeaderSize + nameLength > bodySize) {
+                error = "bad command at offset " + std::to_string(offset);
+                return false;
+            }
+            record.command.version = readLE<std::uint32_t>(body);
+            record.command.forceLoad = body[4] != 0;
+            record.command.compression = static_cast<PayloadCompression>(readLE<std::uint8_t>(body + 5));
+            record.command.projectName.assign(body + kCommandHeaderSize, nameLength);
+            record.command.projectData = std::string_view(body + kCommandHeaderSize + nameLength,
+                                                          bodySize - kCommandHeaderSize - nameLength);
+            break;
+        }
+        default:
+            error = "unknown record type at offset " + std::to_string(offset);
+            return false;
+        }
+
+        m_records.push_back(std::move(record));
+        offset += kRecordHeaderSize + bodySize;
+    }
+    m_skippedBytes = data.size() - offset;
+    return true;
+}
+
+double SessionRecording::getDurationSeconds() const {
+    return m_records.empty() ? 0.0 : static_cast<double>(m_records.back().timeNs) * 1e-9;
+}
+
+} // namespace hmi3
\ No newline at end of file
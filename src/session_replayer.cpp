@@ -0,0 +1,115 @@
+#include "hmi3/session_replayer.hpp"
+#include "hmi3/container.hpp"
+#include "hmi3/profiler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <sstream>
+#include <thread>
+
+namespace hmi3 {
+
+namespace {
+
+double percentile(const std::vector<double>& sorted, double fraction) {
+    if (sorted.empty()) return 0.0;
+    auto rank = static_cast<std::size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+    return sorted[std::min(std::max<std::size_t>(rank, 1), sorted.size()) - 1];
+}
+
+} // namespace
+
+SessionReplayer::SessionReplayer(const SessionRecording& recording)
+    : m_recording(recording) {
+}
+
+SessionReplayer::Report SessionReplayer::run(Container& root, ReplayCommandReceiver& receiver, Pace pace) {
+    using Clock = std::chrono::steady_clock;
+
+    Report report;
+    report.recordedSeconds = m_recording.getDurationSeconds();
+    const auto& records = m_recording.getRecords();
+    auto wallStart = Clock::now();
+
+    std::size_t next = 0;
+    while (next < records.size()) {
+        std::size_t end = next;
+        while (end < records.size() && records[end].type != SessionRecord::Type::Update) {
+            ++end;
+        }
+        // Хвост без update() - тоже кадр, только без обновления
+        bool hasUpdate = end < records.size();
+        const SessionRecord& last = records[hasUpdate ? end : end - 1];
+
+        Frame frame;
+        frame.recordedTime = static_cast<double>(last.timeNs) * 1e-9;
+        if (pace == Pace::Recorded) {
+            std::this_thread::sleep_until(wallStart + std::chrono::nanoseconds(last.timeNs));
+        }
+
+        auto start = Clock::now();
+        for (; next < end; ++next) {
+            const SessionRecord& record = records[next];
+            if (record.type == SessionRecord::Type::Event) {
+                root.handleEvent(*record.event);
+                ++frame.events;
+            } else if (record.type == SessionRecord::Type::Scene) {
+                if (m_sceneCallback) {
+                    m_sceneCallback(root, record.command);
+                }
+                ++frame.scenes;
+            } else {
+                receiver.inject(record.command);
+                receiver.pump();
+                ++frame.commands;
+            }
+        }
+        if (hasUpdate) {
+            frame.dt = records[end].dt;
+            root.update(frame.dt);
+            ++next;
+        }
+        if (m_frameCallback) {
+            m_frameCallback(root);
+        }
+        frame.milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        HMI3_PROFILE_FRAME();
+
+        report.events += frame.events;
+        report.commands += frame.commands;
+        report.scenes += frame.scenes;
+        report.frames.push_back(frame);
+    }
+    report.wallSeconds = std::chrono::duration<double>(Clock::now() - wallStart).count();
+
+    std::vector<double> sorted;
+    sorted.reserve(report.frames.size());
+    for (std::size_t i = 0; i < report.frames.size(); ++i) {
+        sorted.push_back(report.frames[i].milliseconds);
+        if (report.frames[i].milliseconds > report.frames[report.slowestFrame].milliseconds) {
+            report.slowestFrame = i;
+        }
+    }
+    std::sort(sorted.begin(), sorted.end());
+    report.p50Ms = percentile(sorted, 0.50);
+    report.p95Ms = percentile(sorted, 0.95);
+    report.p99Ms = percentile(sorted, 0.99);
+    report.maxMs = sorted.empty() ? 0.0 : sorted.back();
+    return report;
+}
+
+std::string SessionReplayer::formatReport(const Report& report) {
+    std::ostringstream out;
+    out << report.frames.size() << " frames, " << report.events << " events, " << report.commands
+        << " commands, " << report.scenes << " scenes; frame p50 " << report.p50Ms << " ms, p95 " << report.p95Ms << " ms, p99 " << report.p99Ms
+        << " ms, max " << report.maxMs << " ms";
+    if (!report.frames.empty()) {
+        const Frame& slowest = report.frames[report.slowestFrame];
+        out << " (frame " << report.slowestFrame << " at " << slowest.recordedTime << " s, " << slowest.events
+            << " events, " << slowest.commands << " commands)";
+    }
+    out << "; replayed in " << report.wallSeconds << " s, recorded " << report.recordedSeconds << " s";
+    return out.str();
+}
+
+} // namespace hmi3
\ No newline at end of file
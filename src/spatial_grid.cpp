@@ -0,0 +1,197 @@
+#include "hmi3/spatial_grid.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace hmi3 {
+
+namespace {
+
+void eraseValue(std::vector<Component*>& items, Component* component) {
+    auto it = std::find(items.begin(), items.end(), component);
+    if (it != items.end()) {
+        // Порядок внутри ячейки не важен
+        *it = items.back();
+        items.pop_back();
+    }
+}
+
+// Запас в единицу: обход ячеек до right включительно не переполняет int
+const double kCellLimit = static_cast<double>(std::numeric_limits<int>::max() - 1);
+
+// floor считается в double и зажимается в диапазон int: огромные и
+// бесконечные координаты дают крайнюю ячейку, NaN - нулевую
+int cellIndex(double coordinate, float cellSize) {
+    double cell = std::floor(coordinate / cellSize);
+    if (std::isnan(cell)) return 0;
+    return static_cast<int>(std::clamp(cell, -kCellLimit, kCellLimit));
+}
+
+bool overlaps(const sf::FloatRect& a, const sf::FloatRect& b) {
+    return a.position.x < b.position.x + b.size.x && b.position.x < a.position.x + a.size.x &&
+           a.position.y < b.position.y + b.size.y && b.position.y < a.position.y + a.size.y;
+}
+
+} // namespace
+
+SpatialGrid::SpatialGrid(float cellSize, std::size_t maxCellsPerItem)
+    : m_cellSize(cellSize > 0.0f ? cellSize : 64.0f)
+    , m_maxCellsPerItem(maxCellsPerItem) {
+}
+
+std::uint64_t SpatialGrid::cellKey(int x, int y) {
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32) |
+           static_cast<std::uint32_t>(y);
+}
+
+SpatialGrid::CellRange SpatialGrid::cellRange(const sf::FloatRect& bounds) const {
+    CellRange range;
+    range.left = cellIndex(bounds.position.x, m_cellSize);
+    range.top = cellIndex(bounds.position.y, m_cellSize);
+    range.right = cellIndex(static_cast<double>(bounds.position.x) + bounds.size.x, m_cellSize);
+    range.bottom = cellIndex(static_cast<double>(bounds.position.y) + bounds.size.y, m_cellSize);
+    return range;
+}
+
+void SpatialGrid::insert(Component* component, const sf::FloatRect& bounds) {
+    if (contains(component)) {
+        update(component, bounds);
+        return;
+    }
+
+    Entry entry;
+    entry.bounds = bounds;
+    entry.cells = cellRange(bounds);
+    // Произведение в double: ширина диапазона доходит до 2^32 ячеек
+    double cellCount = (static_cast<double>(entry.cells.right) - entry.cells.left + 1) *
+                       (static_cast<double>(entry.cells.bottom) - entry.cells.top + 1);
+    entry.oversized = cellCount > static_cast<double>(m_maxCellsPerItem);
+
+    link(component, entry);
+    m_entries.emplace(component, entry);
+}
+
+void SpatialGrid::update(Component* component, const sf::FloatRect& bounds) {
+    auto it = m_entries.find(component);
+    if (it == m_entries.end()) {
+        insert(component, bounds);
+        return;
+    }
+
+    CellRange cells = cellRange(bounds);
+    Entry& entry = it->second;
+    // Сдвиг внутри тех же ячеек не трогает сетку
+    if (!entry.oversized && cells.left == entry.cells.left && cells.top == entry.cells.top &&
+        cells.right == entry.cells.right && cells.bottom == entry.cells.bottom) {
+        entry.bounds = bounds;
+        return;
+    }
+
+    unlink(component, entry);
+    m_entries.erase(it);
+    insert(component, bounds);
+}
+
+bool SpatialGrid::remove(Component* component) {
+    auto it = m_entries.find(component);
+    if (it == m_entries.end()) {
+        return false;
+    }
+    unlink(component, it->second);
+    m_entries.erase(it);
+    return true;
+}
+
+void SpatialGrid::clear() {
+    m_cells.clear();
+    m_entries.clear();
+    m_oversized.clear();
+}
+
+void SpatialGrid::link(Component* component, const Entry& entry) {
+    if (entry.oversized) {
+        m_oversized.push_back(component);
+        return;
+    }
+    for (int y = entry.cells.top; y <= entry.cells.bottom; ++y) {
+        for (int x = entry.cells.left; x <= entry.cells.right; ++x) {
+            m_cells[cellKey(x, y)].push_back(component);
+        }
+    }
+}
+
+void SpatialGrid::unlink(Component* component, const Entry& entry) {
+    if (entry.oversized) {
+        eraseValue(m_oversized, component);
+        return;
+    }
+    for (int y = entry.cells.top; y <= entry.cells.bottom; ++y) {
+        for (int x = entry.cells.left; x <= entry.cells.right; ++x) {
+            auto cell = m_cells.find(cellKey(x, y));
+            if (cell != m_cells.end()) {
+                eraseValue(cell->second, component);
+                if (cell->second.empty()) {
+                    m_cells.erase(cell);
+                }
+            }
+        }
+    }
+}
+
+void SpatialGrid::query(const sf::Vector2f& point, std::vector<Component*>& result) const {
+    // Точка лежит ровно в одной ячейке, поэтому повторов не бывает
+    // Та же ячейка, что при вставке, в том числе для зажатых координат
+    int x = cellIndex(point.x, m_cellSize);
+    int y = cellIndex(point.y, m_cellSize);
+
+    auto cell = m_cells.find(cellKey(x, y));
+    if (cell != m_cells.end()) {
+        for (Component* component : cell->second) {
+            if (m_entries.at(component).bounds.contains(point)) {
+                result.push_back(component);
+            }
+        }
+    }
+    for (Component* component : m_oversized) {
+        if (m_entries.at(component).bounds.contains(point)) {
+            result.push_back(component);
+        }
+    }
+}
+
+std::size_t SpatialGrid::cellCount(const sf::FloatRect& area) const {
+    // Огромная область не должна переполнить произведение
+    double columns = std::floor((area.position.x + area.size.x) / m_cellSize) - std::floor(area.position.x / m_cellSize) + 1;
+    double rows = std::floor((area.position.y + area.size.y) / m_cellSize) - std::floor(area.position.y / m_cellSize) + 1;
+    double cells = columns * rows;
+    return cells < 1e18 ? static_cast<std::size_t>(cells) : static_cast<std::size_t>(1e18);
+}
+
+void SpatialGrid::query(const sf::FloatRect& area, std::vector<Component*>& result) const {
+    std::size_t first = result.size();
+    CellRange cells = cellRange(area);
+
+    for (int y = cells.top; y <= cells.bottom; ++y) {
+        for (int x = cells.left; x <= cells.right; ++x) {
+            auto cell = m_cells.find(cellKey(x, y));
+            if (cell == m_cells.end()) continue;
+            for (Component* component : cell->second) {
+                if (overlaps(m_entries.at(component).bounds, area)) {
+                    result.push_back(component);
+                }
+            }
+        }
+    }
+
+    // Компонент на нескольких ячейках попадает в выборку несколько раз
+    std::sort(result.begin() + first, result.end());
+    result.erase(std::unique(result.begin() + first, result.end()), result.end());
+
+    for (Component* component : m_oversized) {
+        if (overlaps(m_entries.at(component).bounds, area)) {
+            result.push_back(component);
+        }
+    }
+}
+
+} // namespace hmi3
\ No newline at end of file
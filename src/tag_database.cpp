@@ -0,0 +1,203 @@
+#include "hmi3/tag_database.hpp"
+#include <algorithm>
+
+namespace hmi3 {
+
+namespace {
+
+// Критическая секция - присваивание значения, спин дешевле мьютекса
+class SpinLock {
+public:
+    explicit SpinLock(std::atomic_flag& flag) : m_flag(flag) {
+        while (m_flag.test_and_set(std::memory_order_acquire)) {
+        }
+    }
+    ~SpinLock() { m_flag.clear(std::memory_order_release); }
+
+private:
+    std::atomic_flag& m_flag;
+};
+
+const std::string kEmptyName;
+
+} // namespace
+
+TagSubscription::TagSubscription(TagSubscription&& other) noexcept
+    : m_database(std::move(other.m_database))
+    , m_tag(other.m_tag)
+    , m_id(other.m_id) {
+    other.m_database.reset();
+}
+
+TagSubscription& TagSubscription::operator=(TagSubscription&& other) noexcept {
+    if (this != &other) {
+        reset();
+        m_database = std::move(other.m_database);
+        m_tag = other.m_tag;
+        m_id = other.m_id;
+        other.m_database.reset();
+    }
+    return *this;
+}
+
+TagSubscription::~TagSubscription() {
+    reset();
+}
+
+void TagSubscription::reset() {
+    // База живёт в потоке интерфейса, как и подписки: между lock() и
+    // unsubscribe() она не разрушится
+    if (auto database = m_database.lock()) {
+        (*database)->unsubscribe(m_tag, m_id);
+    }
+    m_database.reset();
+}
+
+TagDatabase::TagDatabase(std::size_t maxTags)
+    : m_maxTags(maxTags)
+    , m_blocks(new std::unique_ptr<Tag[]>[(maxTags + kBlockSize - 1) / kBlockSize])
+    , m_changed(maxTags)
+    , m_self(std::make_shared<TagDatabase*>(this)) {
+}
+
+TagDatabase::~TagDatabase() = default;
+
+TagId TagDatabase::addTag(const std::string& name, TagValue initialValue) {
+    std::lock_guard<std::mutex> lock(m_namesMutex);
+    std::size_t count = m_tagCount.load(std::memory_order_relaxed);
+    if (count >= m_maxTags || m_names.count(name)) {
+        return kInvalidTag;
+    }
+
+    auto& block = m_blocks[count / kBlockSize];
+    if (!block) {
+        block.reset(new Tag[kBlockSize]);
+    }
+    Tag& tag = block[count % kBlockSize];
+    tag.name = name;
+    tag.type = initialValue.index();
+    tag.latest = initialValue;
+    tag.current = std::move(initialValue);
+
+    auto id = static_cast<TagId>(count);
+    m_names.emplace(name, id);
+    // Публикация видит тег только после инициализации
+    m_tagCount.store(count + 1, std::memory_order_release);
+    return id;
+}
+
+TagId TagDatabase::findTag(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(m_namesMutex);
+    auto it = m_names.find(name);
+    return it != m_names.end() ? it->second : kInvalidTag;
+}
+
+const std::string& TagDatabase::getTagName(TagId tag) const {
+    return tag < getTagCount() ? tagAt(tag).name : kEmptyName;
+}
+
+bool TagDatabase::publish(TagId id, TagValue value) {
+    if (id >= getTagCount()) {
+        return false;
+    }
+    Tag& tag = tagAt(id);
+    if (value.index() != tag.type) {
+        return false;
+    }
+
+    {
+        SpinLock lock(tag.lock);
+        tag.latest = std::move(value);
+    }
+    // Уже в очереди - dispatch() заберёт новое значение
+    if (!tag.pending.exchange(true, std::memory_order_acq_rel)) {
+        m_changed.tryPush(TagId(id));
+    }
+    return true;
+}
+
+TagSubscription TagDatabase::subscribe(TagId tag, Callback callback) {
+    if (tag >= getTagCount() || !callback) {
+        return TagSubscription();
+    }
+    std::uint64_t id = m_nextSubscription++;
+    if (m_dispatching) {
+        // Список подписчиков может сейчас обходиться
+        m_deferredSubscriptions.push_back({tag, {id, std::move(callback)}});
+    } else {
+        tagAt(tag).subscribers.push_back({id, std::move(callback)});
+    }
+    return TagSubscription(m_self, tag, id);
+}
+
+void TagDatabase::unsubscribe(TagId tag, std::uint64_t id) {
+    auto deferred = std::find_if(m_deferredSubscriptions.begin(), m_deferredSubscriptions.end(),
+        [id](const DeferredSubscription& entry) { return entry.subscriber.id == id; });
+    if (deferred != m_deferredSubscriptions.end()) {
+        m_deferredSubscriptions.erase(deferred);
+        return;
+    }
+
+    auto& subscribers = tagAt(tag).subscribers;
+    auto it = std::find_if(subscribers.begin(), subscribers.end(),
+        [id](const Subscriber& subscriber) { return subscriber.id == id; });
+    if (it == subscribers.end()) {
+        return;
+    }
+    if (m_dispatching) {
+        // Идёт рассылка - удалим после неё
+        it->active = false;
+        m_deferredRemovals.push_back(tag);
+    } else {
+        subscribers.erase(it);
+    }
+}
+
+const TagValue& TagDatabase::getValue(TagId tag) const {
+    static const TagValue empty;
+    return tag < getTagCount() ? tagAt(tag).current : empty;
+}
+
+std::size_t TagDatabase::dispatch() {
+    // Только то, что накопилось к началу кадра: частый производитель
+    // не должен растягивать кадр
+    std::size_t budget = m_changed.size();
+    std::size_t notified = 0;
+    m_dispatching = true;
+
+    TagId id;
+    while (budget-- > 0 && m_changed.tryPop(id)) {
+        Tag& tag = tagAt(id);
+        // Сбрасываем до чтения: публикация после этой точки снова поставит тег в очередь
+        tag.pending.store(false, std::memory_order_seq_cst);
+        {
+            SpinLock lock(tag.lock);
+            tag.current = tag.latest;
+        }
+
+        for (const auto& subscriber : tag.subscribers) {
+            if (subscriber.active) {
+                subscriber.callback(id, tag.current);
+            }
+        }
+        ++notified;
+    }
+
+    m_dispatching = false;
+
+    for (TagId tag : m_deferredRemovals) {
+        auto& subscribers = tagAt(tag).subscribers;
+        subscribers.erase(
+            std::remove_if(subscribers.begin(), subscribers.end(),
+                           [](const Subscriber& subscriber) { return !subscriber.active; }),
+            subscribers.end());
+    }
+    m_deferredRemovals.clear();
+    for (auto& entry : m_deferredSubscriptions) {
+        tagAt(entry.tag).subscribers.push_back(std::move(entry.subscriber));
+    }
+    m_deferredSubscriptions.clear();
+    return notified;
+}
+
+} // namespace hmi3
\ No newline at end of file
@@ -0,0 +1,292 @@
+#include "hmi3/components/trend_component.hpp"
+#include "hmi3/properties.hpp"
+#include "hmi3/render_batch.hpp"
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HMI3_TREND_SSE2 1
+#endif
+
+namespace hmi3 {
+
+void findMinMax(const float* data, std::size_t count, float& min, float& max) {
+    if (count == 0) return;
+
+    std::size_t i = 0;
+    float lo = data[0];
+    float hi = data[0];
+#ifdef HMI3_TREND_SSE2
+    if (count >= 16) {
+        // Четыре пары аккумуляторов скрывают задержку minps/maxps
+        __m128 lo0 = _mm_loadu_ps(data), lo1 = lo0, lo2 = lo0, lo3 = lo0;
+        __m128 hi0 = lo0, hi1 = lo0, hi2 = lo0, hi3 = lo0;
+        for (; i + 16 <= count; i += 16) {
+            __m128 a = _mm_loadu_ps(data + i);
+            __m128 b = _mm_loadu_ps(data + i + 4);
+            __m128 c = _mm_loadu_ps(data + i + 8);
+            __m128 d = _mm_loadu_ps(data + i + 12);
+            lo0 = _mm_min_ps(lo0, a);
+            hi0 = _mm_max_ps(hi0, a);
+            lo1 = _mm_min_ps(lo1, b);
+            hi1 = _mm_max_ps(hi1, b);
+            lo2 = _mm_min_ps(lo2, c);
+            hi2 = _mm_max_ps(hi2, c);
+            lo3 = _mm_min_ps(lo3, d);
+            hi3 = _mm_max_ps(hi3, d);
+        }
+        __m128 loAll = _mm_min_ps(_mm_min_ps(lo0, lo1), _mm_min_ps(lo2, lo3));
+        __m128 hiAll = _mm_max_ps(_mm_max_ps(hi0, hi1), _mm_max_ps(hi2, hi3));
+        alignas(16) float lanes[8];
+        _mm_store_ps(lanes, loAll);
+        _mm_store_ps(lanes + 4, hiAll);
+        lo = std::min({lanes[0], lanes[1], lanes[2], lanes[3]});
+        hi = std::max({lanes[4], lanes[5], lanes[6], lanes[7]});
+    }
+#endif
+    for (; i < count; ++i) {
+        lo = std::min(lo, data[i]);
+        hi = std::max(hi, data[i]);
+    }
+    min = lo;
+    max = hi;
+}
+
+TrendComponent::TrendComponent(std::string id, std::size_t capacity)
+    : Component(std::move(id))
+    , m_capacity(std::max<std::size_t>(capacity, 1)) {
+}
+
+std::size_t TrendComponent::addPen(const sf::Color& color) {
+    Pen pen;
+    pen.color = color;
+    pen.samples.resize(m_capacity);
+    m_pens.push_back(std::move(pen));
+    markDirty();
+    return m_pens.size() - 1;
+}
+
+void TrendComponent::addSamples(std::size_t pen, const float* values, std::size_t count) {
+    if (pen >= m_pens.size() || count == 0) return;
+    Pen& target = m_pens[pen];
+
+    // Больше ёмкости за раз - остаются только последние
+    if (count > m_capacity) {
+        target.total += count - m_capacity;
+        values += count - m_capacity;
+        count = m_capacity;
+    }
+    std::size_t slot = static_cast<std::size_t>(target.total % m_capacity);
+    std::size_t first = std::min(count, m_capacity - slot);
+    std::copy(values, values + first, target.samples.begin() + slot);
+    std::copy(values + first, values + count, target.samples.begin());
+    target.total += count;
+    markDirty();
+}
+
+std::size_t TrendComponent::getSampleCount(std::size_t pen) const {
+    if (pen >= m_pens.size()) return 0;
+    return static_cast<std::size_t>(std::min<std::uint64_t>(m_pens[pen].total, m_capacity));
+}
+
+void TrendComponent::setVisibleSamples(std::size_t count) {
+    if (m_visibleSamples == count) return;
+    m_visibleSamples = count;
+    markDirty();
+}
+
+void TrendComponent::setRange(float min, float max) {
+    if (m_rangeMin == min && m_rangeMax == max) return;
+    m_rangeMin = min;
+    m_rangeMax = max;
+    markDirty();
+}
+
+void TrendComponent::setBackground(const sf::Color& color) {
+    if (m_background == color) return;
+    m_background = color;
+    markDirty();
+}
+
+bool TrendComponent::applyProperty(std::string_view name, std::string_view value) {
+    if (name == "range") {
+        sf::Vector2f range;
+        if (!properties::parseVector(value, range) || range.x >= range.y) return false;
+        setRange(range.x, range.y);
+        return true;
+    }
+    if (name == "visibleSamples") {
+        float count = 0.0f;
+        if (!properties::parseFloat(value, count) || count < 0.0f) return false;
+        setVisibleSamples(static_cast<std::size_t>(count));
+        return true;
+    }
+    if (name == "background") {
+        sf::Color color;
+        if (!properties::parseColor(value, color)) return false;
+        setBackground(color);
+        return true;
+    }
+    return Component::applyProperty(name, value);
+}
+
+std::uint64_t TrendComponent::historyStart(const Pen& pen) const {
+    return pen.total > m_capacity ? pen.total - m_capacity : 0;
+}
+
+TrendComponent::Bucket TrendComponent::scan(const Pen& pen, std::uint64_t begin, std::uint64_t end) const {
+    std::size_t count = static_cast<std::size_t>(end - begin);
+    std::size_t slot = static_cast<std::size_t>(begin % m_capacity);
+    std::size_t first = std::min(count, m_capacity - slot);
+
+    Bucket bucket{0.0f, 0.0f};
+    findMinMax(pen.samples.data() + slot, first, bucket.min, bucket.max);
+    if (first < count) {
+        // Корзина через конец кольца
+        Bucket tail{0.0f, 0.0f};
+        findMinMax(pen.samples.data(), count - first, tail.min, tail.max);
+        bucket.min = std::min(bucket.min, tail.min);
+        bucket.max = std::max(bucket.max, tail.max);
+    }
+    m_stats.scannedSamples += count;
+    return bucket;
+}
+
+void TrendComponent::catchUp(const Pen& pen, Level& level) const {
+    std::uint64_t start = historyStart(pen);
+    std::uint64_t size = level.bucketSize;
+
+    // Корзины, целиком ушедшие из кольца
+    while (!level.buckets.empty() && (level.firstBucket + 1) * size <= start) {
+        level.buckets.pop_front();
+        ++level.firstBucket;
+    }
+    // Корзина на границе окна помнит min/max выборок, уже перезаписанных
+    // в кольце: пересчитывается по оставшимся, не больше bucketSize выборок
+    if (!level.buckets.empty() && level.firstBucket * size < start && level.clippedAt != start) {
+        std::uint64_t end = std::min(level.covered, (level.firstBucket + 1) * size);
+        if (end > start) {
+            level.buckets.front() = scan(pen, start, end);
+        } else {
+            level.buckets.clear();
+        }
+        level.clippedAt = start;
+    }
+
+    std::uint64_t from = std::max(level.covered, start);
+    if (level.buckets.empty()) {
+        level.firstBucket = from / size;
+    }
+    while (from < pen.total) {
+        std::uint64_t index = from / size;
+        std::uint64_t end = std::min(pen.total, (index + 1) * size);
+        Bucket bucket = scan(pen, from, end);
+        if (index < level.firstBucket + level.buckets.size()) {
+            // Недописанная последняя корзина: min/max просто сливаются
+            Bucket& last = level.buckets.back();
+            last.min = std::min(last.min, bucket.min);
+            last.max = std::max(last.max, bucket.max);
+        } else {
+            level.buckets.push_back(bucket);
+        }
+        from = end;
+    }
+    level.covered = pen.total;
+}
+
+TrendComponent::Level& TrendComponent::level(Pen& pen, std::size_t bucketSize) const {
+    auto& levels = pen.levels;
+    auto it = std::find_if(levels.begin(), levels.end(),
+                           [bucketSize](const Level& level) { return level.bucketSize == bucketSize; });
+    if (it == levels.end()) {
+        if (levels.size() >= kMaxCachedLevels) {
+            // Вытесняется масштаб, который дольше всех не рисовался
+            it = std::min_element(levels.begin(), levels.end(),
+                                  [](const Level& a, const Level& b) { return a.lastUse < b.lastUse; });
+            *it = Level();
+        } else {
+            it = levels.emplace(levels.end());
+        }
+        it->bucketSize = bucketSize;
+        ++m_stats.levelBuilds;
+    }
+    it->lastUse = ++m_useCounter;
+    catchUp(pen, *it);
+    return *it;
+}
+
+const std::deque<TrendComponent::Bucket>& TrendComponent::getBuckets(std::size_t pen, std::size_t bucketSize) const {
+    return level(m_pens.at(pen), std::max<std::size_t>(bucketSize, 1)).buckets;
+}
+
+void TrendComponent::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    RenderBatch batch;
+    appendGeometry(batch);
+    batch.draw(target, states);
+}
+
+bool TrendComponent::appendGeometry(RenderBatch& batch) const {
+    batch.appendRect(sf::FloatRect(m_position, m_size), m_background);
+    if (m_size.x < 1.0f || m_size.y <= 0.0f || m_rangeMax <= m_rangeMin) return true;
+
+    std::uint64_t visible = m_visibleSamples > 0 ? m_visibleSamples : m_capacity;
+    std::uint64_t columns = static_cast<std::uint64_t>(m_size.x);
+    std::size_t bucketSize = 1;
+    while (bucketSize * 2 <= visible / columns) {
+        bucketSize *= 2;
+    }
+    float scaleX = m_size.x / static_cast<float>(visible);
+    float scaleY = m_size.y / (m_rangeMax - m_rangeMin);
+    float bottom = m_position.y + m_size.y;
+    auto toY = [&](float value) {
+        return std::clamp(bottom - (value - m_rangeMin) * scaleY, m_position.y, bottom);
+    };
+
+    for (Pen& pen : m_pens) {
+        if (pen.total == 0) continue;
+        // Окно - последние visible выборок; номера считаются от его левого края
+        std::int64_t viewStart = static_cast<std::int64_t>(pen.total) - static_cast<std::int64_t>(visible);
+        std::int64_t from = std::max<std::int64_t>(viewStart, static_cast<std::int64_t>(historyStart(pen)));
+
+        Bucket previous{0.0f, 0.0f};
+        bool first = true;
+        auto column = [&](std::int64_t sample, Bucket bucket) {
+            // Соседние столбцы перекрываются по значению, чтобы линия была сплошной
+            Bucket joined = bucket;
+            if (!first) {
+                joined.min = std::min(bucket.min, previous.max);
+                joined.max = std::max(bucket.max, previous.min);
+            }
+            previous = bucket;
+            first = false;
+
+            float left = std::max(m_position.x + static_cast<float>(sample - viewStart) * scaleX, m_position.x);
+            float right = std::min(m_position.x + static_cast<float>(sample - viewStart + static_cast<std::int64_t>(bucketSize)) * scaleX,
+                                   m_position.x + m_size.x);
+            float top = toY(joined.max);
+            float height = std::max(toY(joined.min) - top, 1.0f);
+            batch.appendRect(sf::FloatRect({left, std::min(top, bottom - 1.0f)},
+                                           {std::max(right - left, 1.0f), height}),
+                             pen.color);
+        };
+
+        if (bucketSize == 1) {
+            // Выборок меньше, чем пикселей - рисуем их как есть
+            for (std::int64_t n = from; n < static_cast<std::int64_t>(pen.total); ++n) {
+                float value = pen.samples[static_cast<std::size_t>(n % static_cast<std::int64_t>(m_capacity))];
+                column(n, Bucket{value, value});
+            }
+            continue;
+        }
+
+        const Level& cached = level(pen, bucketSize);
+        std::int64_t size = static_cast<std::int64_t>(bucketSize);
+        std::int64_t firstIndex = std::max<std::int64_t>(from / size - static_cast<std::int64_t>(cached.firstBucket), 0);
+        for (std::size_t i = static_cast<std::size_t>(firstIndex); i < cached.buckets.size(); ++i) {
+            column(static_cast<std::int64_t>(cached.firstBucket + i) * size, cached.buckets[i]);
+        }
+    }
+    return true;
+}
+
+} // namespace hmi3
\ No newline at end of file
@@ -0,0 +1,195 @@
+#include "hmi3/components/value_display_component.hpp"
+#include "hmi3/properties.hpp"
+#include "hmi3/render_batch.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+namespace hmi3 {
+
+ValueDisplayComponent::ValueDisplayComponent(std::string id)
+    : Component(std::move(id)) {
+    format();
+}
+
+void ValueDisplayComponent::setFont(std::shared_ptr<const sf::Font> font, unsigned int characterSize) {
+    m_font = std::move(font);
+    m_characterSize = characterSize;
+    m_glyphs = GlyphCache::get(m_font, m_characterSize);
+    // Другие глифы - переписываются все квады
+    m_laidOutLength = 0;
+    layout();
+    markDirty();
+}
+
+void ValueDisplayComponent::setValue(double value) {
+    if (value == m_value) return;
+    m_value = value;
+    std::size_t length = m_length;
+    std::array<char, kMaxChars> text = m_text;
+    format();
+    if (m_length == length && std::memcmp(text.data(), m_text.data(), length) == 0) return;
+    layout();
+    markDirty();
+}
+
+void ValueDisplayComponent::setPrecision(int precision) {
+    precision = std::clamp(precision, 0, 9);
+    if (m_precision == precision) return;
+    m_precision = precision;
+    format();
+    layout();
+    markDirty();
+}
+
+void ValueDisplayComponent::setUnit(std::string_view unit) {
+    m_unitLength = std::min(unit.size(), kMaxChars);
+    std::memcpy(m_unit.data(), unit.data(), m_unitLength);
+    format();
+    layout();
+    markDirty();
+}
+
+void ValueDisplayComponent::setColor(const sf::Color& color) {
+    if (m_color == color) return;
+    m_color = color;
+    for (std::size_t i = 0; i < m_laidOutLength * 6; ++i) {
+        m_vertices[i].color = color;
+    }
+    markDirty();
+}
+
+void ValueDisplayComponent::setAlignment(Alignment alignment) {
+    if (m_alignment == alignment) return;
+    m_alignment = alignment;
+    layout();
+    markDirty();
+}
+
+bool ValueDisplayComponent::applyProperty(std::string_view name, std::string_view value) {
+    if (name == "value" || name == "precision" || name == "characterSize") {
+        float number = 0.0f;
+        if (!properties::parseFloat(value, number)) return false;
+        if (name == "value") {
+            setValue(number);
+        } else if (name == "precision") {
+            setPrecision(static_cast<int>(number));
+        } else {
+            if (number < 1.0f) return false;
+            setFont(m_font, static_cast<unsigned int>(number));
+        }
+        return true;
+    }
+    if (name == "unit") {
+        setUnit(value);
+        return true;
+    }
+    if (name == "color") {
+        sf::Color color;
+        if (!properties::parseColor(value, color)) return false;
+        setColor(color);
+        return true;
+    }
+    if (name == "align") {
+        if (value != "left" && value != "right") return false;
+        setAlignment(value == "left" ? Alignment::Left : Alignment::Right);
+        return true;
+    }
+    if (name == "font") {
+        auto font = GlyphCache::loadFont(std::string(value));
+        if (!font) return false;
+        setFont(std::move(font), m_characterSize);
+        return true;
+    }
+    return Component::applyProperty(name, value);
+}
+
+void ValueDisplayComponent::format() {
+    // Без кучи: число и единица собираются прямо в m_text
+    char* begin = m_text.data();
+    char* end = begin + kMaxChars;
+    auto result = std::to_chars(begin, end, m_value, std::chars_format::fixed, m_precision);
+    std::size_t length = 0;
+    if (result.ec == std::errc()) {
+        length = static_cast<std::size_t>(result.ptr - begin);
+    } else {
+        std::memcpy(begin, "####", 4);
+        length = 4;
+    }
+    std::size_t unit = std::min(m_unitLength, kMaxChars - length);
+    std::memcpy(begin + length, m_unit.data(), unit);
+    m_length = length + unit;
+}
+
+void ValueDisplayComponent::writeQuad(std::size_t index, char c, float pen) {
+    const GlyphCache::Quad& quad = m_glyphs->glyph(c);
+    // Базовая линия на высоте размера шрифта от верха, как у sf::Text
+    float baseline = static_cast<float>(m_glyphs->getCharacterSize());
+    float left = pen + quad.bounds.position.x;
+    float top = baseline + quad.bounds.position.y;
+    float right = left + quad.bounds.size.x;
+    float bottom = top + quad.bounds.size.y;
+
+    float u0 = quad.textureRect.position.x;
+    float v0 = quad.textureRect.position.y;
+    float u1 = u0 + quad.textureRect.size.x;
+    float v1 = v0 + quad.textureRect.size.y;
+
+    sf::Vertex* v = &m_vertices[index * 6];
+    v[0] = sf::Vertex{{left, top}, m_color, {u0, v0}};
+    v[1] = sf::Vertex{{right, top}, m_color, {u1, v0}};
+    v[2] = sf::Vertex{{left, bottom}, m_color, {u0, v1}};
+    v[3] = sf::Vertex{{left, bottom}, m_color, {u0, v1}};
+    v[4] = sf::Vertex{{right, top}, m_color, {u1, v0}};
+    v[5] = sf::Vertex{{right, bottom}, m_color, {u1, v1}};
+
+    m_laidOut[index] = c;
+    m_pen[index] = pen;
+    ++m_glyphWrites;
+}
+
+void ValueDisplayComponent::layout() {
+    if (!m_glyphs) {
+        m_laidOutLength = 0;
+        return;
+    }
+
+    float pen = 0.0f;
+    if (m_alignment == Alignment::Right) {
+        for (std::size_t i = 0; i < m_length; ++i) {
+            pen -= m_glyphs->glyph(m_text[i]).advance;
+        }
+    }
+    for (std::size_t i = 0; i < m_length; ++i) {
+        char c = m_text[i];
+        if (i >= m_laidOutLength || m_laidOut[i] != c || m_pen[i] != pen) {
+            writeQuad(i, c, pen);
+        }
+        pen += m_glyphs->glyph(c).advance;
+    }
+    m_laidOutLength = m_length;
+}
+
+void ValueDisplayComponent::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    RenderBatch batch;
+    appendGeometry(batch);
+    batch.draw(target, states);
+}
+
+bool ValueDisplayComponent::appendGeometry(RenderBatch& batch) const {
+    if (!m_glyphs || m_laidOutLength == 0) return true;
+
+    sf::Vector2f anchor = m_position;
+    if (m_alignment == Alignment::Right) {
+        anchor.x += m_size.x;
+    }
+    sf::VertexArray& vertices = batch.geometry(&m_glyphs->getTexture());
+    for (std::size_t i = 0; i < m_laidOutLength * 6; ++i) {
+        sf::Vertex vertex = m_vertices[i];
+        vertex.position += anchor;
+        vertices.append(vertex);
+    }
+    return true;
+}
+
+} // namespace hmi3
\ No newline at end of file
@@ -0,0 +1,336 @@
+#include "hmi3/view_protocol.hpp"
+#include "byte_order.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace hmi3 {
+
+namespace {
+
+// Вид события в сообщении Input
+enum InputKind : std::uint8_t {
+    InputMouseMoved = 1,
+    InputMousePressed = 2,
+    InputMouseReleased = 3,
+    InputMouseWheel = 4,
+    InputKeyPressed = 5,
+    InputKeyReleased = 6,
+    InputText = 7
+};
+
+enum InputFlags : std::uint8_t {
+    FlagAlt = 1 << 0,
+    FlagControl = 1 << 1,
+    FlagShift = 1 << 2,
+    FlagSystem = 1 << 3
+};
+
+// вид (1), флаги (1), x (4), y (4), код (4), доп. код (4), прокрутка (4, float)
+constexpr std::size_t kInputSize = 22;
+// столбец (2), строка (2), кодировка (1)
+constexpr std::size_t kTileHeaderSize = 5;
+
+std::uint32_t pixelAt(const PixelRect& rect, unsigned x, unsigned y) {
+    std::uint32_t pixel;
+    std::memcpy(&pixel, rect.pixels + (static_cast<std::size_t>(rect.y + y) * rect.stride + rect.x + x) * 4, 4);
+    return pixel;
+}
+
+std::string encodeInput(InputKind kind, std::uint8_t flags, sf::Vector2i position, std::int32_t code,
+                        std::int32_t extra, float delta) {
+    std::string body;
+    body.reserve(kInputSize);
+    appendLE<std::uint8_t>(body, kind);
+    appendLE<std::uint8_t>(body, flags);
+    appendLE<std::uint32_t>(body, static_cast<std::uint32_t>(position.x));
+    appendLE<std::uint32_t>(body, static_cast<std::uint32_t>(position.y));
+    appendLE<std::uint32_t>(body, static_cast<std::uint32_t>(code));
+    appendLE<std::uint32_t>(body, static_cast<std::uint32_t>(extra));
+    std::uint32_t bits;
+    std::memcpy(&bits, &delta, sizeof(bits));
+    appendLE<std::uint32_t>(body, bits);
+    return body;
+}
+
+template <typename KeyEvent>
+std::string encodeKey(InputKind kind, const KeyEvent& key) {
+    std::uint8_t flags = (key.alt ? FlagAlt : 0) | (key.control ? FlagControl : 0) | (key.shift ? FlagShift : 0) |
+                         (key.system ? FlagSystem : 0);
+    return encodeInput(kind, flags, {}, static_cast<std::int32_t>(key.code), static_cast<std::int32_t>(key.scancode),
+                       0.0f);
+}
+
+template <typename KeyEvent>
+KeyEvent decodeKey(std::uint8_t flags, std::int32_t code, std::int32_t extra) {
+    KeyEvent key;
+    key.code = static_cast<sf::Keyboard::Key>(code);
+    key.scancode = static_cast<sf::Keyboard::Scancode>(extra);
+    key.alt = (flags & FlagAlt) != 0;
+    key.control = (flags & FlagControl) != 0;
+    key.shift = (flags & FlagShift) != 0;
+    key.system = (flags & FlagSystem) != 0;
+    return key;
+}
+
+} // namespace
+
+std::uint64_t hashPixels(const PixelRect& rect) {
+    // FNV-1a по 32-битным пикселям: плитка 64x64 - 4096 шагов
+    std::uint64_t hash = 14695981039346656037ull;
+    for (unsigned y = 0; y < rect.height; ++y) {
+        for (unsigned x = 0; x < rect.width; ++x) {
+            hash = (hash ^ pixelAt(rect, x, y)) * 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+void appendViewMessage(std::string& out, view::MessageType type, const std::string& body) {
+    appendLE<std::uint8_t>(out, type);
+    appendLE<std::uint32_t>(out, static_cast<std::uint32_t>(body.size()));
+    out += body;
+}
+
+void appendTileMessage(std::string& out, unsigned column, unsigned row, const PixelRect& rect) {
+    std::size_t start = out.size();
+    appendLE<std::uint8_t>(out, view::Tile);
+    appendLE<std::uint32_t>(out, 0);
+    appendLE<std::uint16_t>(out, static_cast<std::uint16_t>(column));
+    appendLE<std::uint16_t>(out, static_cast<std::uint16_t>(row));
+    std::size_t encodingOffset = out.size();
+    appendLE<std::uint8_t>(out, view::Rle);
+
+    // Панели HMI - в основном заливки, RLE сжимает их в разы
+    std::size_t rawSize = static_cast<std::size_t>(rect.width) * rect.height * 4;
+    std::size_t pixelsStart = out.size();
+    bool rle = true;
+    for (unsigned y = 0; y < rect.height && rle; ++y) {
+        unsigned x = 0;
+        while (x < rect.width) {
+            std::uint32_t pixel = pixelAt(rect, x, y);
+            unsigned run = 1;
+            while (x + run < rect.width && run < 255 && pixelAt(rect, x + run, y) == pixel) {
+                ++run;
+            }
+            appendLE<std::uint8_t>(out, static_cast<std::uint8_t>(run));
+            out.append(reinterpret_cast<const char*>(&pixel), 4);
+            x += run;
+        }
+        if (out.size() - pixelsStart >= rawSize) {
+            rle = false;
+        }
+    }
+    if (!rle) {
+        out.resize(pixelsStart);
+        out[encodingOffset] = static_cast<char>(view::Raw);
+        for (unsigned y = 0; y < rect.height; ++y) {
+            const std::uint8_t* line = rect.pixels + (static_cast<std::size_t>(rect.y + y) * rect.stride + rect.x) * 4;
+            out.append(reinterpret_cast<const char*>(line), static_cast<std::size_t>(rect.width) * 4);
+        }
+    }
+    writeLE<std::uint32_t>(&out[start + 1], static_cast<std::uint32_t>(out.size() - start - view::kMessageHeaderSize));
+}
+
+std::string encodeInputEvent(const sf::Event& event) {
+    if (auto* e = event.getIf<sf::Event::MouseMoved>()) {
+        return encodeInput(InputMouseMoved, 0, e->position, 0, 0, 0.0f);
+    }
+    if (auto* e = event.getIf<sf::Event::MouseButtonPressed>()) {
+        return encodeInput(InputMousePressed, 0, e->position, static_cast<std::int32_t>(e->button), 0, 0.0f);
+    }
+    if (auto* e = event.getIf<sf::Event::MouseButtonReleased>()) {
+        return encodeInput(InputMouseReleased, 0, e->position, static_cast<std::int32_t>(e->button), 0, 0.0f);
+    }
+    if (auto* e = event.getIf<sf::Event::MouseWheelScrolled>()) {
+        return encodeInput(InputMouseWheel, 0, e->position, static_cast<std::int32_t>(e->wheel), 0, e->delta);
+    }
+    if (auto* e = event.getIf<sf::Event::KeyPressed>()) {
+        return encodeKey(InputKeyPressed, *e);
+    }
+    if (auto* e = event.getIf<sf::Event::KeyReleased>()) {
+        return encodeKey(InputKeyReleased, *e);
+    }
+    if (auto* e = event.getIf<sf::Event::TextEntered>()) {
+        return encodeInput(InputText, 0, {}, static_cast<std::int32_t>(e->unicode), 0, 0.0f);
+    }
+    return std::string();
+}
+
+std::optional<sf::Event> decodeInputEvent(const char* data, std::size_t size) {
+    if (size != kInputSize) {
+        return std::nullopt;
+    }
+    auto kind = readLE<std::uint8_t>(data);
+    auto flags = readLE<std::uint8_t>(data + 1);
+    sf::Vector2i position(static_cast<std::int32_t>(readLE<std::uint32_t>(data + 2)),
+                          static_cast<std::int32_t>(readLE<std::uint32_t>(data + 6)));
+    auto code = static_cast<std::int32_t>(readLE<std::uint32_t>(data + 10));
+    auto extra = static_cast<std::int32_t>(readLE<std::uint32_t>(data + 14));
+    std::uint32_t bits = readLE<std::uint32_t>(data + 18);
+    float delta;
+    std::memcpy(&delta, &bits, sizeof(delta));
+
+    switch (kind) {
+    case InputMouseMoved:
+        return sf::Event(sf::Event::MouseMoved{position});
+    case InputMousePressed:
+        return sf::Event(sf::Event::MouseButtonPressed{static_cast<sf::Mouse::Button>(code), position});
+    case InputMouseReleased:
+        return sf::Event(sf::Event::MouseButtonReleased{static_cast<sf::Mouse::Button>(code), position});
+    case InputMouseWheel:
+        return sf::Event(sf::Event::MouseWheelScrolled{static_cast<sf::Mouse::Wheel>(code), delta, position});
+    case InputKeyPressed:
+        return sf::Event(decodeKey<sf::Event::KeyPressed>(flags, code, extra));
+    case InputKeyReleased:
+        return sf::Event(decodeKey<sf::Event::KeyReleased>(flags, code, extra));
+    case InputText:
+        return sf::Event(sf::Event::TextEntered{static_cast<char32_t>(code)});
+    default:
+        return std::nullopt;
+    }
+}
+
+ViewDecoder::Result ViewDecoder::fail(const std::string& error) {
+    m_error = error;
+    return Result::ProtocolError;
+}
+
+ViewDecoder::Result ViewDecoder::feed(const char* data, std::size_t size, std::size_t& consumed) {
+    consumed = 0;
+    while (consumed < size) {
+        if (m_headerSize < view::kMessageHeaderSize) {
+            std::size_t take = std::min(view::kMessageHeaderSize - m_headerSize, size - consumed);
+            std::memcpy(m_header + m_headerSize, data + consumed, take);
+            m_headerSize += take;
+            consumed += take;
+            if (m_headerSize < view::kMessageHeaderSize) break;
+
+            m_bodyExpected = readLE<std::uint32_t>(m_header + 1);
+            if (m_bodyExpected > view::kMaxMessageSize) {
+                return fail("message is too large");
+            }
+            m_body.clear();
+        }
+
+        std::size_t take = std::min(m_bodyExpected - m_body.size(), size - consumed);
+        m_body.append(data + consumed, take);
+        consumed += take;
+        if (m_body.size() < m_bodyExpected) break;
+
+        m_headerSize = 0;
+        Result result = handleMessage();
+        if (result != Result::NeedMoreData) {
+            return result;
+        }
+    }
+    return Result::NeedMoreData;
+}
+
+ViewDecoder::Result ViewDecoder::handleMessage() {
+    auto type = static_cast<std::uint8_t>(m_header[0]);
+    const char* body = m_body.data();
+
+    if (!m_helloSeen) {
+        if (type != view::Hello || m_body.size() < 5 || std::memcmp(body, view::kMagic, 4) != 0) {
+            return fail("not a view stream");
+        }
+        if (static_cast<std::uint8_t>(body[4]) != view::kVersion) {
+            return fail("unsupported view protocol version");
+        }
+        m_helloSeen = true;
+        return Result::NeedMoreData;
+    }
+
+    switch (type) {
+    case view::FrameBegin: {
+        if (m_body.size() != 14) return fail("malformed frame header");
+        m_frameId = readLE<std::uint32_t>(body);
+        unsigned width = readLE<std::uint16_t>(body + 4);
+        unsigned height = readLE<std::uint16_t>(body + 6);
+        m_tileSize = readLE<std::uint16_t>(body + 8);
+        if (m_tileSize == 0) return fail("zero tile size");
+        if (width != m_width || height != m_height) {
+            m_width = width;
+            m_height = height;
+            m_pixels.assign(static_cast<std::size_t>(width) * height * 4, 0);
+        }
+        m_tileCount = 0;
+        return Result::NeedMoreData;
+    }
+    case view::Tile:
+        if (!decodeTile(body, m_body.size())) return Result::ProtocolError;
+        ++m_tileCount;
+        return Result::NeedMoreData;
+    case view::FrameEnd:
+        return Result::FrameReady;
+    default:
+        // Неизвестные сообщения пропускаются - место для расширений
+        return Result::NeedMoreData;
+    }
+}
+
+bool ViewDecoder::decodeTile(const char* data, std::size_t size) {
+    if (size < kTileHeaderSize) {
+        fail("malformed tile");
+        return false;
+    }
+    unsigned x0 = readLE<std::uint16_t>(data) * m_tileSize;
+    unsigned y0 = readLE<std::uint16_t>(data + 2) * m_tileSize;
+    auto encoding = static_cast<std::uint8_t>(data[4]);
+    if (x0 >= m_width || y0 >= m_height) {
+        fail("tile outside the frame");
+        return false;
+    }
+    unsigned width = std::min(m_tileSize, m_width - x0);
+    unsigned height = std::min(m_tileSize, m_height - y0);
+    data += kTileHeaderSize;
+    size -= kTileHeaderSize;
+
+    auto target = [&](unsigned x, unsigned y) {
+        return m_pixels.data() + (static_cast<std::size_t>(y0 + y) * m_width + x0 + x) * 4;
+    };
+
+    if (encoding == view::Raw) {
+        if (size != static_cast<std::size_t>(width) * height * 4) {
+            fail("raw tile size mismatch");
+            return false;
+        }
+        for (unsigned y = 0; y < height; ++y) {
+            std::memcpy(target(0, y), data + static_cast<std::size_t>(y) * width * 4, width * 4);
+        }
+        return true;
+    }
+    if (encoding != view::Rle) {
+        fail("unknown tile encoding");
+        return false;
+    }
+
+    // Серии не переходят через конец строки
+    std::size_t offset = 0;
+    for (unsigned y = 0; y < height; ++y) {
+        unsigned x = 0;
+        while (x < width) {
+            if (offset + 5 > size) {
+                fail("truncated RLE tile");
+                return false;
+            }
+            unsigned run = static_cast<unsigned char>(data[offset]);
+            if (run == 0 || x + run > width) {
+                fail("bad RLE run");
+                return false;
+            }
+            for (unsigned i = 0; i < run; ++i) {
+                std::memcpy(target(x + i, y), data + offset + 1, 4);
+            }
+            x += run;
+            offset += 5;
+        }
+    }
+    if (offset != size) {
+        fail("trailing bytes in RLE tile");
+        return false;
+    }
+    return true;
+}
+
+} // namespace hmi3
\ No newline at end of file
@@ -0,0 +1,399 @@
+#include "hmi3/view_server.hpp"
+#include "hmi3/container.hpp"
+#include "hmi3/logger.hpp"
+#include "byte_order.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace hmi3 {
+
+namespace {
+
+const sf::Time kSelectorTimeout = sf::milliseconds(100);
+
+// Поток зрителя просыпается так часто, чтобы читать ввод без задержки
+const auto kViewerPollInterval = std::chrono::milliseconds(10);
+
+// Пока сокет не принимает данные, отправка повторяется с этим шагом
+const auto kSendRetryInterval = std::chrono::milliseconds(1);
+
+// Сообщения зрителя короткие; больше - поток повреждён
+const std::uint32_t kMaxInputMessage = 1024;
+
+const std::size_t kInputQueueCapacity = 1024;
+
+} // namespace
+
+struct ViewServer::Frame {
+    std::uint32_t id = 0;
+    unsigned width = 0;
+    unsigned height = 0;
+    unsigned tileSize = 0;
+    std::vector<std::uint8_t> pixels;
+
+    unsigned columns() const { return (width + tileSize - 1) / tileSize; }
+    unsigned rows() const { return (height + tileSize - 1) / tileSize; }
+
+    PixelRect tile(unsigned column, unsigned row) const {
+        unsigned x = column * tileSize;
+        unsigned y = row * tileSize;
+        return PixelRect{pixels.data(), width, x, y, std::min(tileSize, width - x), std::min(tileSize, height - y)};
+    }
+
+    // Хэши считает первый зритель, которому они понадобились, а не поток отрисовки
+    const std::vector<std::uint64_t>& tileHashes() const {
+        std::call_once(m_hashOnce, [this] {
+            m_hashes.reserve(static_cast<std::size_t>(columns()) * rows());
+            for (unsigned row = 0; row < rows(); ++row) {
+                for (unsigned column = 0; column < columns(); ++column) {
+                    m_hashes.push_back(hashPixels(tile(column, row)));
+                }
+            }
+        });
+        return m_hashes;
+    }
+
+private:
+    mutable std::once_flag m_hashOnce;
+    mutable std::vector<std::uint64_t> m_hashes;
+};
+
+struct ViewServer::Viewer {
+    sf::TcpSocket socket;
+    std::thread thread;
+    std::atomic<bool> finished{false};
+    std::string inbox;
+
+    // Что видит зритель: хэши плиток последнего отправленного кадра
+    std::vector<std::uint64_t> sentHashes;
+    unsigned sentWidth = 0;
+    unsigned sentHeight = 0;
+    std::uint32_t lastFrameId = 0;
+};
+
+ViewServer::ViewServer(unsigned short port, unsigned tileSize)
+    : m_port(port)
+    , m_localPort(0)
+    , m_bindAddress(sf::IpAddress::LocalHost)
+    , m_inputEnabled(false)
+    , m_tileSize(tileSize > 0 && tileSize <= view::kMaxFrameSize ? tileSize : view::kDefaultTileSize)
+    , m_maxFrameRate(30)
+    , m_maxViewers(8)
+    , m_running(false)
+    , m_viewerCount(0)
+    , m_nextFrameId(1)
+    , m_readbackPending(false)
+    , m_input(kInputQueueCapacity)
+    , m_framesPublished(0)
+    , m_framesSent(0)
+    , m_tilesSent(0)
+    , m_bytesSent(0)
+    , m_inputIgnored(0) {
+}
+
+ViewServer::~ViewServer() {
+    stop();
+}
+
+bool ViewServer::start() {
+    if (m_running) return true;
+
+    if (m_listener.listen(m_port, m_bindAddress) != sf::Socket::Status::Done) {
+        HMI3_LOG_ERROR("View server failed to bind to " << m_bindAddress.toString() << ":" << m_port);
+        return false;
+    }
+    m_localPort = m_listener.getLocalPort();
+    if (m_bindAddress != sf::IpAddress::LocalHost) {
+        HMI3_LOG_WARNING("View server is reachable on " << m_bindAddress.toString() << ":" << m_localPort
+                         << " without authentication" << (m_inputEnabled ? ", viewer input enabled" : ""));
+    }
+
+    m_running = true;
+    m_acceptThread = std::thread(&ViewServer::acceptLoop, this);
+    return true;
+}
+
+void ViewServer::stop() {
+    if (!m_running.exchange(false)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_frameMutex);
+    }
+    m_frameChanged.notify_all();
+    if (m_acceptThread.joinable()) {
+        m_acceptThread.join();
+    }
+    reapViewers(true);
+    m_listener.close();
+
+    std::lock_guard<std::mutex> lock(m_frameMutex);
+    m_frame.reset();
+}
+
+bool ViewServer::isFrameDue() {
+    if (m_viewerCount == 0) {
+        return false;
+    }
+    if (m_maxFrameRate > 0 && m_framesPublished > 0 &&
+        m_publishClock.getElapsedTime() < sf::seconds(1.0f / static_cast<float>(m_maxFrameRate))) {
+        return false;
+    }
+    return true;
+}
+
+bool ViewServer::capture(const Container& root) {
+    if (!isFrameDue()) {
+        // Без зрителей отложенный кадр устаревает
+        m_readbackPending = m_readbackPending && m_viewerCount > 0;
+        return false;
+    }
+
+    bool published = false;
+    if (m_readbackPending) {
+        sf::Image image = m_texture.getTexture().copyToImage();
+        published = publishFrame(image.getPixelsPtr(), image.getSize().x, image.getSize().y);
+        m_readbackPending = false;
+    }
+
+    sf::Vector2u size(static_cast<unsigned>(root.getSize().x), static_cast<unsigned>(root.getSize().y));
+    if (size.x == 0 || size.y == 0 || size.x > view::kMaxFrameSize || size.y > view::kMaxFrameSize) {
+        return published;
+    }
+    if (m_texture.getSize() != size && !m_texture.resize(size)) {
+        return published;
+    }
+
+    m_texture.clear();
+    m_texture.draw(root);
+    m_texture.display();
+    m_readbackPending = true;
+    return published;
+}
+
+bool ViewServer::publishFrame(const std::uint8_t* pixels, unsigned width, unsigned height) {
+    if (!pixels || width == 0 || height == 0 || width > view::kMaxFrameSize || height > view::kMaxFrameSize ||
+        !isFrameDue()) {
+        return false;
+    }
+
+    auto frame = std::make_shared<Frame>();
+    frame->width = width;
+    frame->height = height;
+    frame->tileSize = m_tileSize;
+    frame->pixels.assign(pixels, pixels + static_cast<std::size_t>(width) * height * 4);
+    m_publishClock.restart();
+    ++m_framesPublished;
+
+    {
+        std::lock_guard<std::mutex> lock(m_frameMutex);
+        frame->id = m_nextFrameId++;
+        // Кадр, который никто не успел забрать, просто заменяется
+        m_frame = std::move(frame);
+    }
+    m_frameChanged.notify_all();
+    return true;
+}
+
+std::size_t ViewServer::pumpInput(Container& root) {
+    std::size_t delivered = 0;
+    std::optional<sf::Event> event;
+    while (m_input.tryPop(event)) {
+        if (event) {
+            root.handleEvent(*event);
+            ++delivered;
+        }
+    }
+    return delivered;
+}
+
+ViewServer::Stats ViewServer::getStats() const {
+    Stats stats;
+    stats.framesPublished = m_framesPublished;
+    stats.framesSent = m_framesSent;
+    stats.tilesSent = m_tilesSent;
+    stats.bytesSent = m_bytesSent;
+    stats.inputIgnored = m_inputIgnored;
+    return stats;
+}
+
+void ViewServer::acceptLoop() {
+    sf::SocketSelector selector;
+    selector.add(m_listener);
+
+    while (m_running) {
+        if (selector.wait(kSelectorTimeout) && selector.isReady(m_listener)) {
+            auto viewer = std::make_unique<Viewer>();
+            if (m_listener.accept(viewer->socket) == sf::Socket::Status::Done && m_running) {
+                std::lock_guard<std::mutex> lock(m_viewersMutex);
+                if (m_viewers.size() >= m_maxViewers) {
+                    HMI3_LOG_WARNING("Viewer limit reached, rejecting viewer");
+                } else {
+                    // Отправка без блокировок: зависший зритель не держит поток при остановке
+                    viewer->socket.setBlocking(false);
+                    Viewer& ref = *viewer;
+                    m_viewers.push_back(std::move(viewer));
+                    m_viewerCount = m_viewers.size();
+                    ref.thread = std::thread(&ViewServer::viewerLoop, this, std::ref(ref));
+                }
+            }
+        }
+        reapViewers(false);
+    }
+}
+
+void ViewServer::viewerLoop(Viewer& viewer) {
+    std::string hello;
+    std::string body(view::kMagic, sizeof(view::kMagic));
+    body.push_back(static_cast<char>(view::kVersion));
+    appendViewMessage(hello, view::Hello, body);
+
+    bool connected = sendAll(viewer, hello);
+    while (connected && m_running) {
+        std::shared_ptr<const Frame> frame;
+        {
+            std::unique_lock<std::mutex> lock(m_frameMutex);
+            m_frameChanged.wait_for(lock, kViewerPollInterval, [this, &viewer] {
+                return !m_running || (m_frame && m_frame->id != viewer.lastFrameId);
+            });
+            if (m_frame && m_frame->id != viewer.lastFrameId) {
+                frame = m_frame;
+            }
+        }
+
+        connected = readInput(viewer);
+        if (connected && frame && m_running) {
+            connected = sendFrame(viewer, *frame);
+        }
+    }
+
+    viewer.socket.disconnect();
+    viewer.finished = true;
+}
+
+bool ViewServer::readInput(Viewer& viewer) {
+    char buffer[4096];
+    for (;;) {
+        std::size_t received = 0;
+        auto status = viewer.socket.receive(buffer, sizeof(buffer), received);
+        if (status == sf::Socket::Status::NotReady) break;
+        if (status != sf::Socket::Status::Done && status != sf::Socket::Status::Partial) return false;
+        viewer.inbox.append(buffer, received);
+    }
+
+    std::size_t offset = 0;
+    while (viewer.inbox.size() - offset >= view::kMessageHeaderSize) {
+        const char* header = viewer.inbox.data() + offset;
+        std::uint32_t length = readLE<std::uint32_t>(header + 1);
+        if (length > kMaxInputMessage) {
+            HMI3_LOG_WARNING("Viewer sent an oversized message, disconnecting");
+            return false;
+        }
+        if (viewer.inbox.size() - offset < view::kMessageHeaderSize + length) break;
+
+        if (static_cast<std::uint8_t>(header[0]) == view::Input && !m_inputEnabled) {
+            ++m_inputIgnored;
+        } else if (static_cast<std::uint8_t>(header[0]) == view::Input) {
+            auto event = decodeInputEvent(header + view::kMessageHeaderSize, length);
+            // Переполненная очередь теряет ввод, но не задерживает зрителя
+            if (event) {
+                std::optional<sf::Event> item(std::move(event));
+                m_input.tryPush(std::move(item));
+            }
+        }
+        offset += view::kMessageHeaderSize + length;
+    }
+    viewer.inbox.erase(0, offset);
+    return true;
+}
+
+bool ViewServer::sendFrame(Viewer& viewer, const Frame& frame) {
+    const auto& hashes = frame.tileHashes();
+    bool resized = frame.width != viewer.sentWidth || frame.height != viewer.sentHeight;
+
+    std::string tiles;
+    std::uint32_t tileCount = 0;
+    unsigned columns = frame.columns();
+    for (std::size_t i = 0; i < hashes.size(); ++i) {
+        if (!resized && hashes[i] == viewer.sentHashes[i]) continue;
+        appendTileMessage(tiles, static_cast<unsigned>(i % columns), static_cast<unsigned>(i / columns),
+                          frame.tile(static_cast<unsigned>(i % columns), static_cast<unsigned>(i / columns)));
+        ++tileCount;
+    }
+    viewer.lastFrameId = frame.id;
+
+    // Неизменившийся кадр зрителю не нужен
+    if (tileCount == 0) {
+        return true;
+    }
+
+    std::string begin;
+    appendLE<std::uint32_t>(begin, frame.id);
+    appendLE<std::uint16_t>(begin, static_cast<std::uint16_t>(frame.width));
+    appendLE<std::uint16_t>(begin, static_cast<std::uint16_t>(frame.height));
+    appendLE<std::uint16_t>(begin, static_cast<std::uint16_t>(frame.tileSize));
+    appendLE<std::uint32_t>(begin, tileCount);
+
+    std::string message;
+    message.reserve(tiles.size() + 32);
+    appendViewMessage(message, view::FrameBegin, begin);
+    message += tiles;
+    appendViewMessage(message, view::FrameEnd, std::string());
+
+    if (!sendAll(viewer, message)) {
+        return false;
+    }
+    viewer.sentHashes = hashes;
+    viewer.sentWidth = frame.width;
+    viewer.sentHeight = frame.height;
+    ++m_framesSent;
+    m_tilesSent += tileCount;
+    m_bytesSent += message.size();
+    return true;
+}
+
+bool ViewServer::sendAll(Viewer& viewer, const std::string& data) {
+    std::size_t offset = 0;
+    while (offset < data.size()) {
+        std::size_t sent = 0;
+        auto status = viewer.socket.send(data.data() + offset, data.size() - offset, sent);
+        offset += sent;
+        if (status == sf::Socket::Status::Done) {
+            break;
+        }
+        if (status != sf::Socket::Status::Partial && status != sf::Socket::Status::NotReady) {
+            return false;
+        }
+        // Пока зритель не разгребёт сокет, его ввод продолжает читаться
+        if (!m_running || !readInput(viewer)) {
+            return false;
+        }
+        std::this_thread::sleep_for(kSendRetryInterval);
+    }
+    return true;
+}
+
+void ViewServer::reapViewers(bool all) {
+    std::vector<std::unique_ptr<Viewer>> finished;
+    {
+        std::lock_guard<std::mutex> lock(m_viewersMutex);
+        for (std::size_t i = 0; i < m_viewers.size();) {
+            if (all || m_viewers[i]->finished) {
+                std::swap(m_viewers[i], m_viewers.back());
+                finished.push_back(std::move(m_viewers.back()));
+                m_viewers.pop_back();
+                continue;
+            }
+            ++i;
+        }
+        m_viewerCount = m_viewers.size();
+    }
+    for (auto& viewer : finished) {
+        if (viewer->thread.joinable()) {
+            viewer->thread.join();
+        }
+    }
+}
+
+} // namespace hmi3
\ No newline at end of file
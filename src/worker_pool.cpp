@@ -0,0 +1,114 @@
+#include "hmi3/worker_pool.hpp"
+#include <algorithm>
+
+namespace hmi3 {
+
+namespace {
+
+thread_local bool t_insideParallelFor = false;
+
+} // namespace
+
+WorkerPool::WorkerPool(std::size_t threadCount) {
+    if (threadCount == 0) {
+        unsigned int cores = std::thread::hardware_concurrency();
+        threadCount = cores > 1 ? cores - 1 : 0;
+    }
+    m_threads.reserve(threadCount);
+    for (std::size_t i = 0; i < threadCount; ++i) {
+        m_threads.emplace_back(&WorkerPool::workerLoop, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+void WorkerPool::parallelFor(std::size_t count, const RangeFunction& body, std::size_t grain) {
+    if (count == 0) return;
+
+    if (grain == 0) {
+        // Несколько кусков на поток, чтобы было что забрать у медленных
+        grain = std::max<std::size_t>(1, count / ((m_threads.size() + 1) * 4));
+    }
+    if (m_threads.empty() || t_insideParallelFor || count <= grain) {
+        body(0, count);
+        return;
+    }
+
+    std::lock_guard<std::mutex> submit(m_submitMutex);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_body = &body;
+        m_count = count;
+        m_grain = grain;
+        m_next.store(0, std::memory_order_relaxed);
+        m_error = nullptr;
+        m_busyWorkers = m_threads.size();
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    runChunks();
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_finished.wait(lock, [this] { return m_busyWorkers == 0; });
+        m_body = nullptr;
+        error = m_error;
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void WorkerPool::workerLoop() {
+    std::uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stopping || m_generation != seen; });
+            if (m_stopping) return;
+            seen = m_generation;
+        }
+
+        runChunks();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_busyWorkers == 0) {
+                m_finished.notify_one();
+            }
+        }
+    }
+}
+
+void WorkerPool::runChunks() {
+    t_insideParallelFor = true;
+    for (;;) {
+        std::size_t begin = m_next.fetch_add(m_grain, std::memory_order_relaxed);
+        if (begin >= m_count) break;
+        std::size_t end = std::min(begin + m_grain, m_count);
+        try {
+            (*m_body)(begin, end);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(m_errorMutex);
+            if (!m_error) {
+                m_error = std::current_exception();
+            }
+            // Остаток диапазона не выполняем
+            m_next.store(m_count, std::memory_order_relaxed);
+        }
+    }
+    t_insideParallelFor = false;
+}
+
+} // namespace hmi3
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "hmi3/atom_table.hpp"
+#include "hmi3/components/rectangle_component.hpp"
+
+TEST(AtomTableTest, SameStringGetsSameAtom) {
+    hmi3::AtomTable table;
+    hmi3::Atom pump = table.intern("pump1");
+    hmi3::Atom valve = table.intern("valve1");
+    EXPECT_NE(pump, valve);
+    EXPECT_EQ(table.intern(std::string("pump") + "1"), pump);
+    EXPECT_EQ(table.name(pump), "pump1");
+    EXPECT_EQ(table.size(), 2u);
+}
+
+TEST(AtomTableTest, FindDoesNotGrowTable) {
+    hmi3::AtomTable table;
+    table.intern("tank");
+    EXPECT_EQ(table.find("tank"), table.intern("tank"));
+    EXPECT_EQ(table.find("missing"), hmi3::AtomTable::kInvalidAtom);
+    EXPECT_EQ(table.size(), 1u);
+    EXPECT_EQ(table.name(hmi3::AtomTable::kInvalidAtom), "");
+}
+
+TEST(AtomTableTest, ConcurrentInterningAgrees) {
+    hmi3::AtomTable table;
+    const int count = 2000;
+    std::vector<std::vector<hmi3::Atom>> results(4);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < results.size(); ++t) {
+        threads.emplace_back([&table, &results, t, count] {
+            for (int i = 0; i < count; ++i) {
+                results[t].push_back(table.intern("id" + std::to_string(i)));
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    EXPECT_EQ(table.size(), static_cast<std::size_t>(count));
+    for (std::size_t t = 1; t < results.size(); ++t) {
+        EXPECT_EQ(results[t], results[0]);
+    }
+    EXPECT_EQ(table.name(results[0][42]), "id42");
+}
+
+TEST(AtomTableTest, ReleasedAtomIsReused) {
+    hmi3::AtomTable table;
+    hmi3::Atom first = table.acquire("pump1");
+    EXPECT_EQ(table.acquire("pump1"), first);
+    table.release(first);
+    EXPECT_EQ(table.find("pump1"), first);
+    table.release(first);
+    EXPECT_EQ(table.find("pump1"), hmi3::AtomTable::kInvalidAtom);
+    EXPECT_EQ(table.size(), 0u);
+
+    // Номер достаётся следующей строке, таблица не растёт
+    EXPECT_EQ(table.acquire("valve1"), first);
+    EXPECT_EQ(table.name(first), "valve1");
+    auto stats = table.getStats();
+    EXPECT_EQ(stats.live, 1u);
+    EXPECT_EQ(stats.slots, 1u);
+    EXPECT_EQ(stats.released, 1u);
+}
+
+TEST(AtomTableTest, InternedAtomIsNeverReleased) {
+    hmi3::AtomTable table;
+    hmi3::Atom tank = table.acquire("tank");
+    EXPECT_EQ(table.intern("tank"), tank);
+    table.release(tank);
+    table.release(tank);
+    EXPECT_EQ(table.find("tank"), tank);
+    EXPECT_EQ(table.getStats().pinned, 1u);
+    EXPECT_NE(hmi3::AtomTable::formatStats(table.getStats()).find("hmi3_atoms_pinned 1"), std::string::npos);
+}
+
+TEST(AtomTableTest, ComponentIdsLeaveTableWithComponents) {
+    auto& table = hmi3::AtomTable::global();
+    std::size_t before = table.size();
+    auto make = [](const std::string& id) {
+        return std::make_unique<hmi3::RectangleComponent>(id, sf::Vector2f(10, 10), sf::Color::Red);
+    };
+    {
+        std::vector<std::unique_ptr<hmi3::RectangleComponent>> components;
+        for (int i = 0; i < 100; ++i) {
+            components.push_back(make("atom_test_" + std::to_string(i)));
+        }
+        // Одинаковый id - один атом
+        components.push_back(make("atom_test_0"));
+        EXPECT_EQ(components.back()->getAtom(), components.front()->getAtom());
+        EXPECT_EQ(table.size(), before + 100);
+        components.front().reset();
+        EXPECT_EQ(table.find("atom_test_0"), components.back()->getAtom());
+    }
+    EXPECT_EQ(table.size(), before);
+    EXPECT_EQ(table.find("atom_test_0"), hmi3::AtomTable::kInvalidAtom);
+}
\ No newline at end of file
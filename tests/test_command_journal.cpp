@@ -0,0 +1,196 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "hmi3/command_journal.hpp"
+#include "hmi3/container.hpp"
+#include "hmi3/project_loader.hpp"
+#include "test_helpers.hpp"
+
+namespace {
+
+const char* kProject =
+    "root background=40,40,80\n"
+    "container panel position=10,10 size=300,100\n"
+    "rectangle lamp1 parent=panel position=20,20 size=10,10 fill=0,255,0\n";
+
+using hmi3::test::makeCommand;
+
+// Временный каталог журнала, удаляется в конце теста
+struct TempDirectory : hmi3::test::TempPath {
+    TempDirectory() : TempPath("hmi3_journal") {}
+};
+
+std::vector<hmi3::ProjectLoadCommand> replayAll(const hmi3::CommandJournal& journal) {
+    std::vector<hmi3::ProjectLoadCommand> commands;
+    journal.replay([&commands](const hmi3::ProjectLoadCommand& command) { commands.push_back(command); });
+    return commands;
+}
+
+} // namespace
+
+TEST(CommandJournalTest, RecordsSurviveReopen) {
+    TempDirectory directory;
+    std::string error;
+    {
+        hmi3::CommandJournal journal(directory.path);
+        ASSERT_TRUE(journal.open(error)) << error;
+        journal.record(makeCommand("first", kProject, 1));
+        auto forced = makeCommand("second", kProject, 2);
+        forced.forceLoad = true;
+        journal.record(forced);
+        EXPECT_TRUE(journal.flush());
+    }
+
+    hmi3::CommandJournal journal(directory.path);
+    ASSERT_TRUE(journal.open(error)) << error;
+    EXPECT_EQ(journal.getSkippedBytes(), 0u);
+    auto commands = replayAll(journal);
+    ASSERT_EQ(commands.size(), 2u);
+    EXPECT_EQ(commands[0].projectName, "first");
+    EXPECT_EQ(commands[0].projectData.view(), kProject);
+    EXPECT_FALSE(commands[0].forceLoad);
+    EXPECT_EQ(commands[1].version, 2u);
+    EXPECT_TRUE(commands[1].forceLoad);
+
+    // Нумерация продолжается после перезапуска
+    journal.record(makeCommand("third", "root background=1,2,3\n"));
+    EXPECT_TRUE(journal.flush());
+    EXPECT_EQ(replayAll(journal).size(), 3u);
+}
+
+TEST(CommandJournalTest, GroupsRecordsIntoFewCommits) {
+    TempDirectory directory;
+    hmi3::CommandJournal journal(directory.path);
+    std::string error;
+    ASSERT_TRUE(journal.open(error)) << error;
+
+    const int count = 1000;
+    for (int i = 0; i < count; ++i) {
+        journal.record(makeCommand("p" + std::to_string(i), kProject));
+    }
+    EXPECT_TRUE(journal.flush());
+
+    auto stats = journal.getStats();
+    EXPECT_EQ(stats.records, static_cast<std::uint64_t>(count));
+    EXPECT_LT(stats.commits, stats.records);
+    // Снимок пишется раз на группу, а не на каждую команду
+    EXPECT_EQ(stats.snapshots, stats.commits);
+    EXPECT_EQ(replayAll(journal).size(), static_cast<std::size_t>(count));
+}
+
+TEST(CommandJournalTest, CorruptTailIsDroppedOnOpen) {
+    TempDirectory directory;
+    std::string error;
+    std::uintmax_t goodSize = 0;
+    {
+        hmi3::CommandJournal journal(directory.path);
+        ASSERT_TRUE(journal.open(error)) << error;
+        journal.record(makeCommand("first", kProject));
+        journal.record(makeCommand("second", kProject));
+        ASSERT_TRUE(journal.flush());
+        goodSize = std::filesystem::file_size(journal.getJournalPath());
+        journal.record(makeCommand("third", kProject));
+        ASSERT_TRUE(journal.flush());
+    }
+
+    // Сбой посреди записи: последняя запись оборвана и испорчена
+    hmi3::CommandJournal journal(directory.path);
+    std::uintmax_t fullSize = std::filesystem::file_size(journal.getJournalPath());
+    std::filesystem::resize_file(journal.getJournalPath(), fullSize - 5);
+    {
+        std::fstream file(journal.getJournalPath(), std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(static_cast<std::streamoff>(goodSize + 20));
+        file.put('X');
+    }
+    EXPECT_EQ(journal.replay(nullptr).skippedBytes, fullSize - 5 - goodSize);
+
+    ASSERT_TRUE(journal.open(error)) << error;
+    EXPECT_EQ(journal.getSkippedBytes(), fullSize - 5 - goodSize);
+    EXPECT_EQ(std::filesystem::file_size(journal.getJournalPath()), goodSize);
+
+    // Новые записи идут сразу за последней целой
+    journal.record(makeCommand("fourth", kProject));
+    ASSERT_TRUE(journal.flush());
+    auto commands = replayAll(journal);
+    ASSERT_EQ(commands.size(), 3u);
+    EXPECT_EQ(commands[1].projectName, "second");
+    EXPECT_EQ(commands[2].projectName, "fourth");
+    EXPECT_EQ(journal.replay(nullptr).skippedBytes, 0u);
+}
+
+TEST(CommandJournalTest, RestoreBuildsTreeFromSnapshot) {
+    TempDirectory directory;
+    std::string error;
+    {
+        hmi3::CommandJournal journal(directory.path);
+        ASSERT_TRUE(journal.open(error)) << error;
+        journal.record(makeCommand("old", "rectangle stale position=0,0 size=5,5\n"));
+        journal.record(makeCommand("current", kProject));
+        ASSERT_TRUE(journal.flush());
+    }
+
+    hmi3::CommandJournal journal(directory.path);
+    hmi3::CompiledProject snapshot;
+    ASSERT_TRUE(journal.loadSnapshot(snapshot, error)) << error;
+    EXPECT_EQ(snapshot.getComponentCount(), 2u);
+    snapshot.close();
+
+    hmi3::Container root("root");
+    hmi3::ProjectLoader loader;
+    ASSERT_TRUE(journal.restore(loader, root, error)) << error;
+    EXPECT_NE(root.findByPath("panel/lamp1"), nullptr);
+    EXPECT_EQ(root.getComponent("stale"), nullptr);
+
+    // Без снимка - последняя целая команда журнала
+    std::filesystem::remove(journal.getSnapshotPath());
+    hmi3::Container fallback("root");
+    hmi3::ProjectLoader fallbackLoader;
+    ASSERT_TRUE(journal.restore(fallbackLoader, fallback, error)) << error;
+    EXPECT_NE(fallback.findByPath("panel/lamp1"), nullptr);
+}
+
+// Снимок не записался, а запись журнала - да: restore() берёт запись,
+// а не устаревший снимок
+TEST(CommandJournalTest, RestorePrefersJournalRecordNewerThanSnapshot) {
+    TempDirectory directory;
+    std::string error;
+    {
+        hmi3::CommandJournal journal(directory.path);
+        ASSERT_TRUE(journal.open(error)) << error;
+        journal.record(makeCommand("old", "rectangle stale position=0,0 size=5,5\n"));
+        ASSERT_TRUE(journal.flush());
+
+        // Каталог на месте временного файла - снимок заменить не удастся
+        std::filesystem::create_directory(journal.getSnapshotPath() + ".tmp");
+        journal.record(makeCommand("current", kProject));
+        ASSERT_TRUE(journal.flush());
+        EXPECT_EQ(journal.getStats().snapshots, 1u);
+        std::filesystem::remove(journal.getSnapshotPath() + ".tmp");
+    }
+
+    hmi3::CommandJournal journal(directory.path);
+    hmi3::Container root("root");
+    hmi3::ProjectLoader loader;
+    ASSERT_TRUE(journal.restore(loader, root, error)) << error;
+    EXPECT_NE(root.findByPath("panel/lamp1"), nullptr);
+    EXPECT_EQ(root.getComponent("stale"), nullptr);
+}
+
+TEST(CommandJournalTest, CompactionKeepsLatestRecord) {
+    TempDirectory directory;
+    hmi3::CommandJournal journal(directory.path);
+    journal.setMaxJournalSize(1024);
+    std::string error;
+    ASSERT_TRUE(journal.open(error)) << error;
+
+    for (int i = 0; i < 50; ++i) {
+        journal.record(makeCommand("p" + std::to_string(i), kProject));
+        ASSERT_TRUE(journal.flush());
+    }
+    EXPECT_LE(std::filesystem::file_size(journal.getJournalPath()), 1024u + 256u);
+    auto commands = replayAll(journal);
+    ASSERT_FALSE(commands.empty());
+    EXPECT_EQ(commands.back().projectName, "p49");
+}
\ No newline at end of file
@@ -1,96 +1,570 @@
-#include <gtest/gtest.h>
-#include <thread>
-#include <chrono>
-#include <mutex>
-#include <functional>
-#include <vector>
-#include <string>
-#include "hmi3/command_receiver.hpp"
-
-// Mock command receiver для тестов
-class MockCommandReceiver : public hmi3::AbstractCommandReceiver {
-public:
-    bool start() override {
-        m_running = true;
-        return true;
-    }
-    
-    void stop() override {
-        m_running = false;
-    }
-    
-    bool isRunning() const override {
-        return m_running;
-    }
-    
-    std::vector<hmi3::ProjectLoadCommand> getCommands() override {
-        std::lock_guard<std::mutex> lock(m_commandsMutex);
-        std::vector<hmi3::ProjectLoadCommand> commands;
-        commands.swap(m_commands);
-        return commands;
-    }
-    
-    void simulateCommand(const hmi3::ProjectLoadCommand& command) {
-        std::lock_guard<std::mutex> lock(m_commandsMutex);
-        m_commands.push_back(command);
-        
-        if (m_commandCallback) {
-            m_commandCallback(command);
-        }
-    }
-
-private:
-    bool m_running = false;
-    std::vector<hmi3::ProjectLoadCommand> m_commands;
-    mutable std::mutex m_commandsMutex;
-};
-
-class CommandReceiverTest : public ::testing::Test {
-protected:
-    void SetUp() override {
-        receiver = std::make_unique<MockCommandReceiver>();
-    }
-
-    void TearDown() override {
-        if (receiver) {
-            receiver->stop();
-        }
-    }
-
-    std::unique_ptr<MockCommandReceiver> receiver;
-};
-
-TEST_F(CommandReceiverTest, StartStop) {
-    EXPECT_FALSE(receiver->isRunning());
-    
-    EXPECT_TRUE(receiver->start());
-    EXPECT_TRUE(receiver->isRunning());
-    
-    receiver->stop();
-    EXPECT_FALSE(receiver->isRunning());
-}
-
-TEST_F(CommandReceiverTest, SimulateCommand) {
-    receiver->start();
-    
-    hmi3::ProjectLoadCommand cmd;
-    cmd.projectName = "TestProject";
-    cmd.projectData = "TestData";
-    cmd.version = 1;
-    
-    bool callbackCalled = false;
-    receiver->setCommandCallback([&](const hmi3::ProjectLoadCommand& receivedCmd) {
-        callbackCalled = true;
-        EXPECT_EQ(receivedCmd.projectName, "TestProject");
-    });
-    
-    receiver->simulateCommand(cmd);
-    
-    EXPECT_TRUE(callbackCalled);
-    
-    auto commands = receiver->getCommands();
-    EXPECT_EQ(commands.size(), 1);
-    EXPECT_EQ(commands[0].projectName, "TestProject");
-    
-    receiver->stop();
+#include <gtest/gtest.h>
+#include <thread>
+#include <chrono>
+#include <mutex>
+#include <functional>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <condition_variable>
+#include <unordered_map>
+#include <SFML/Network.hpp>
+#include "hmi3/command_receiver.hpp"
+#include "hmi3/protocol.hpp"
+
+// Mock command receiver для тестов
+class MockCommandReceiver : public hmi3::AbstractCommandReceiver {
+public:
+    bool start() override {
+        m_running = true;
+        return true;
+    }
+    
+    void stop() override {
+        m_running = false;
+    }
+    
+    bool isRunning() const override {
+        return m_running;
+    }
+    
+    std::vector<hmi3::ProjectLoadCommand> getCommands() override {
+        std::lock_guard<std::mutex> lock(m_commandsMutex);
+        std::vector<hmi3::ProjectLoadCommand> commands;
+        commands.swap(m_commands);
+        return commands;
+    }
+    
+    void simulateCommand(const hmi3::ProjectLoadCommand& command) {
+        std::lock_guard<std::mutex> lock(m_commandsMutex);
+        m_commands.push_back(command);
+        
+        if (m_commandCallback) {
+            m_commandCallback(command);
+        }
+    }
+
+private:
+    bool m_running = false;
+    std::vector<hmi3::ProjectLoadCommand> m_commands;
+    mutable std::mutex m_commandsMutex;
+};
+
+class CommandReceiverTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        receiver = std::make_unique<MockCommandReceiver>();
+    }
+
+    void TearDown() override {
+        if (receiver) {
+            receiver->stop();
+        }
+    }
+
+    std::unique_ptr<MockCommandReceiver> receiver;
+};
+
+TEST_F(CommandReceiverTest, StartStop) {
+    EXPECT_FALSE(receiver->isRunning());
+    
+    EXPECT_TRUE(receiver->start());
+    EXPECT_TRUE(receiver->isRunning());
+    
+    receiver->stop();
+    EXPECT_FALSE(receiver->isRunning());
+}
+
+TEST_F(CommandReceiverTest, SimulateCommand) {
+    receiver->start();
+    
+    hmi3::ProjectLoadCommand cmd;
+    cmd.projectName = "TestProject";
+    cmd.projectData = "TestData";
+    cmd.version = 1;
+    
+    bool callbackCalled = false;
+    receiver->setCommandCallback([&](const hmi3::ProjectLoadCommand& receivedCmd) {
+        callbackCalled = true;
+        EXPECT_EQ(receivedCmd.projectName, "TestProject");
+    });
+    
+    receiver->simulateCommand(cmd);
+    
+    EXPECT_TRUE(callbackCalled);
+    
+    auto commands = receiver->getCommands();
+    EXPECT_EQ(commands.size(), 1);
+    EXPECT_EQ(commands[0].projectName, "TestProject");
+    
+    receiver->stop();
+}
+
+// Тесты сетевого приёмника на loopback-интерфейсе
+class NetworkCommandReceiverTest : public ::testing::Test {
+protected:
+    using Clock = std::chrono::steady_clock;
+
+    void SetUp() override {
+        // Порт 0 - система выбирает свободный порт. Очередь вмещает все
+        // команды нагрузочного теста: копии для getCommands() не теряются
+        receiver = std::make_unique<hmi3::NetworkCommandReceiver>(0, 1024);
+        receiver->setCommandCallback([this](const hmi3::ProjectLoadCommand& cmd) {
+            std::lock_guard<std::mutex> lock(mutex);
+            received.push_back(cmd.projectData.toString());
+            ++arrivals[cmd.projectData.toString()];
+            condition.notify_all();
+        });
+        ASSERT_TRUE(receiver->start());
+        ASSERT_NE(receiver->getLocalPort(), 0);
+    }
+
+    void TearDown() override {
+        receiver->stop();
+    }
+
+    bool waitForCommands(std::size_t count, std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return condition.wait_for(lock, timeout, [&] { return received.size() >= count; });
+    }
+
+    bool sendRaw(const std::string& data) {
+        sf::TcpSocket socket;
+        if (socket.connect(sf::IpAddress::LocalHost, receiver->getLocalPort()) != sf::Socket::Status::Done) {
+            return false;
+        }
+        return socket.send(data.data(), data.size()) == sf::Socket::Status::Done;
+    }
+
+    std::unique_ptr<hmi3::NetworkCommandReceiver> receiver;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<std::string> received;
+    std::unordered_map<std::string, int> arrivals;
+};
+
+TEST_F(NetworkCommandReceiverTest, StopWakesReceiverPromptly) {
+    auto begin = Clock::now();
+    receiver->stop();
+    auto elapsed = Clock::now() - begin;
+
+    EXPECT_FALSE(receiver->isRunning());
+    EXPECT_LT(elapsed, std::chrono::milliseconds(500));
+}
+
+TEST_F(NetworkCommandReceiverTest, ReceivesCommandOnDisconnect) {
+    ASSERT_TRUE(sendRaw("Hello HMI3!"));
+    ASSERT_TRUE(waitForCommands(1, std::chrono::seconds(2)));
+
+    auto commands = receiver->getCommands();
+    ASSERT_EQ(commands.size(), 1);
+    EXPECT_EQ(commands[0].projectData, "Hello HMI3!");
+}
+
+TEST_F(NetworkCommandReceiverTest, PersistentConnectionCarriesManyFrames) {
+    receiver->setReceiveTimeout(200);
+
+    sf::TcpSocket socket;
+    ASSERT_EQ(socket.connect(sf::IpAddress::LocalHost, receiver->getLocalPort()), sf::Socket::Status::Done);
+
+    for (int i = 0; i < 3; ++i) {
+        hmi3::ProjectLoadCommand command;
+        command.projectName = "Project" + std::to_string(i);
+        command.projectData = "data" + std::to_string(i);
+        command.version = 10 + i;
+        command.forceLoad = (i == 1);
+        ASSERT_EQ(hmi3::sendFrame(socket, command), sf::Socket::Status::Done);
+    }
+    ASSERT_TRUE(waitForCommands(3, std::chrono::seconds(2)));
+
+    auto commands = receiver->getCommands();
+    ASSERT_EQ(commands.size(), 3);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(commands[i].projectName, "Project" + std::to_string(i));
+        EXPECT_EQ(commands[i].projectData, "data" + std::to_string(i));
+        EXPECT_EQ(commands[i].version, 10 + i);
+        EXPECT_EQ(commands[i].forceLoad, i == 1);
+        EXPECT_EQ(commands[i].checksum.size(), 8);
+    }
+
+    // Соединение между кадрами не считается зависшим
+    std::this_thread::sleep_for(std::chrono::milliseconds(400));
+    EXPECT_EQ(receiver->getConnectionCount(), 1);
+}
+
+TEST_F(NetworkCommandReceiverTest, DecompressesLz4FramesWhileReceiving) {
+    std::string text;
+    for (int i = 0; i < 20000; ++i) {
+        text += "rectangle lamp" + std::to_string(i) + " position=20,20 size=10,10 fill=0,255,0\n";
+    }
+
+    sf::TcpSocket socket;
+    ASSERT_EQ(socket.connect(sf::IpAddress::LocalHost, receiver->getLocalPort()), sf::Socket::Status::Done);
+    hmi3::ProjectLoadCommand command;
+    command.projectName = "Compressed";
+    command.projectData = text;
+    command.compression = hmi3::PayloadCompression::Lz4;
+    ASSERT_EQ(hmi3::sendFrame(socket, command), sf::Socket::Status::Done);
+    command.projectName = "Plain";
+    command.compression = hmi3::PayloadCompression::None;
+    ASSERT_EQ(hmi3::sendFrame(socket, command), sf::Socket::Status::Done);
+    ASSERT_TRUE(waitForCommands(2, std::chrono::seconds(5)));
+
+    auto commands = receiver->getCommands();
+    ASSERT_EQ(commands.size(), 2);
+    EXPECT_EQ(commands[0].projectName, "Compressed");
+    EXPECT_EQ(commands[0].compression, hmi3::PayloadCompression::Lz4);
+    EXPECT_EQ(commands[0].projectData, text);
+    EXPECT_EQ(commands[1].compression, hmi3::PayloadCompression::None);
+    EXPECT_EQ(commands[1].projectData, text);
+}
+
+// Инвариант: байты читаются прямо в блок, копируется не больше одного
+// промежуточного чтения с заголовком и перекладок при росте блока.
+// Блок растёт удвоением от kMaxPresize, так что перекладки в сумме меньше
+// самой нагрузки
+TEST_F(NetworkCommandReceiverTest, LargePayloadIsReadWithoutCopies) {
+    const std::size_t payloadSize = 8 * 1024 * 1024;
+    const int frameCount = 2;
+
+    const char* sharedBytes = nullptr;
+    receiver->setCommandCallback([&](const hmi3::ProjectLoadCommand& cmd) {
+        std::lock_guard<std::mutex> lock(mutex);
+        sharedBytes = cmd.projectData.data();
+        received.push_back(cmd.projectName);
+        condition.notify_all();
+    });
+
+    auto before = hmi3::PayloadPool::instance().getStats();
+
+    sf::TcpSocket socket;
+    ASSERT_EQ(socket.connect(sf::IpAddress::LocalHost, receiver->getLocalPort()), sf::Socket::Status::Done);
+    hmi3::ProjectLoadCommand command;
+    command.projectName = "Large";
+    command.projectData = std::string(payloadSize, 'L');
+    for (int i = 0; i < frameCount; ++i) {
+        ASSERT_EQ(hmi3::sendFrame(socket, command), sf::Socket::Status::Done);
+    }
+    ASSERT_TRUE(waitForCommands(frameCount, std::chrono::seconds(10)));
+
+    auto after = hmi3::PayloadPool::instance().getStats();
+    double megabytes = static_cast<double>(payloadSize * frameCount) / (1024 * 1024);
+    double blocksPerMb = (after.allocations + after.reuses - before.allocations - before.reuses) / megabytes;
+    double copiedPerMb = (after.copiedBytes - before.copiedBytes) / megabytes;
+
+    // Клиентская нагрузка создана через PayloadBuffer(std::string) - вычитаем её
+    blocksPerMb -= 1.0 / megabytes;
+    copiedPerMb -= payloadSize / megabytes;
+
+    // 1, 2, 4 и 8 МБ на кадр
+    EXPECT_LE(blocksPerMb, frameCount * 4 / megabytes);
+    EXPECT_LE(copiedPerMb, frameCount * (payloadSize + 64.0 * 1024) / megabytes);
+
+    auto commands = receiver->getCommands();
+    ASSERT_EQ(commands.size(), frameCount);
+    EXPECT_EQ(commands.back().projectData.data(), sharedBytes);
+    EXPECT_EQ(commands[0].projectData, command.projectData.view());
+}
+
+TEST_F(NetworkCommandReceiverTest, StalledClientDoesNotBlockOthers) {
+    // Клиент, который начал передачу и завис
+    sf::TcpSocket stalled;
+    ASSERT_EQ(stalled.connect(sf::IpAddress::LocalHost, receiver->getLocalPort()), sf::Socket::Status::Done);
+    ASSERT_EQ(stalled.send("partial", 7), sf::Socket::Status::Done);
+
+    ASSERT_TRUE(sendRaw("from another station"));
+    ASSERT_TRUE(waitForCommands(1, std::chrono::seconds(1)));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        EXPECT_EQ(received[0], "from another station");
+    }
+
+    stalled.disconnect();
+    ASSERT_TRUE(waitForCommands(2, std::chrono::seconds(1)));
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(received[1], "partial");
+}
+
+TEST_F(NetworkCommandReceiverTest, IdleConnectionTimesOut) {
+    receiver->setReceiveTimeout(200);
+
+    sf::TcpSocket idle;
+    ASSERT_EQ(idle.connect(sf::IpAddress::LocalHost, receiver->getLocalPort()), sf::Socket::Status::Done);
+
+    auto deadline = Clock::now() + std::chrono::seconds(2);
+    while (receiver->getConnectionCount() == 0 && Clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    while (receiver->getConnectionCount() != 0 && Clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(receiver->getConnectionCount(), 0);
+}
+
+// Постоянное соединение переживает паузы между кадрами, но молчащий
+// дольше keep-alive клиент освобождает слот
+TEST_F(NetworkCommandReceiverTest, IdlePersistentConnectionExpiresAfterKeepAlive) {
+    receiver->setKeepAliveTimeout(200);
+
+    sf::TcpSocket socket;
+    ASSERT_EQ(socket.connect(sf::IpAddress::LocalHost, receiver->getLocalPort()), sf::Socket::Status::Done);
+    hmi3::ProjectLoadCommand command;
+    command.projectName = "once";
+    ASSERT_EQ(hmi3::sendFrame(socket, command), sf::Socket::Status::Done);
+    ASSERT_TRUE(waitForCommands(1, std::chrono::seconds(2)));
+
+    auto deadline = Clock::now() + std::chrono::seconds(2);
+    while (receiver->getConnectionCount() != 0 && Clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(receiver->getConnectionCount(), 0);
+}
+
+// Параллельные клиенты: каждая команда доходит ровно один раз.
+// Пропускную способность и задержку меряют BM_Receiver* в hmi3_bench
+TEST_F(NetworkCommandReceiverTest, LoopbackLoad) {
+    const int clientCount = 8;
+    const int commandsPerClient = 50;
+    const std::size_t total = clientCount * commandsPerClient;
+
+    std::atomic<int> failures{0};
+
+    std::vector<std::thread> clients;
+    for (int c = 0; c < clientCount; ++c) {
+        clients.emplace_back([&, c] {
+            for (int i = 0; i < commandsPerClient; ++i) {
+                std::string payload = "client-" + std::to_string(c) + "-" + std::to_string(i);
+                if (!sendRaw(payload)) {
+                    failures++;
+                }
+            }
+        });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+
+    ASSERT_EQ(failures, 0);
+    ASSERT_TRUE(waitForCommands(total, std::chrono::seconds(10)));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        EXPECT_EQ(arrivals.size(), total);
+        for (int c = 0; c < clientCount; ++c) {
+            for (int i = 0; i < commandsPerClient; ++i) {
+                EXPECT_EQ(arrivals["client-" + std::to_string(c) + "-" + std::to_string(i)], 1);
+            }
+        }
+    }
+
+    EXPECT_EQ(receiver->getCommands().size(), total);
+}
+
+// Режим Pump: обработчик вызывается в потоке, который зовёт pump()
+TEST_F(NetworkCommandReceiverTest, PumpDeliversOnConsumerThread) {
+    receiver->stop();
+    receiver = std::make_unique<hmi3::NetworkCommandReceiver>(0);
+    receiver->setDispatchMode(hmi3::DispatchMode::Pump);
+
+    std::vector<std::thread::id> threads;
+    std::vector<std::string> names;
+    receiver->setCommandCallback([&](const hmi3::ProjectLoadCommand& cmd) {
+        threads.push_back(std::this_thread::get_id());
+        names.push_back(cmd.projectName);
+    });
+    ASSERT_TRUE(receiver->start());
+
+    sf::TcpSocket socket;
+    ASSERT_EQ(socket.connect(sf::IpAddress::LocalHost, receiver->getLocalPort()), sf::Socket::Status::Done);
+    for (int i = 0; i < 3; ++i) {
+        hmi3::ProjectLoadCommand command;
+        command.projectName = "frame" + std::to_string(i);
+        ASSERT_EQ(hmi3::sendFrame(socket, command), sf::Socket::Status::Done);
+    }
+
+    // Имитация цикла отрисовки: один pump() на кадр
+    auto deadline = Clock::now() + std::chrono::seconds(2);
+    while (names.size() < 3 && Clock::now() < deadline) {
+        receiver->pump();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    ASSERT_EQ(names.size(), 3);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(names[i], "frame" + std::to_string(i));
+        EXPECT_EQ(threads[i], std::this_thread::get_id());
+    }
+}
+
+// Очередь не растёт сверх предела: приёмник перестаёт читать сокет,
+// а после разгрузки доставляет всё без потерь и в исходном порядке
+TEST_F(NetworkCommandReceiverTest, FullQueueAppliesBackpressure) {
+    receiver->stop();
+    receiver = std::make_unique<hmi3::NetworkCommandReceiver>(0, 2);
+    receiver->setDispatchMode(hmi3::DispatchMode::Pump);
+    ASSERT_TRUE(receiver->start());
+
+    const int frameCount = 10;
+    sf::TcpSocket socket;
+    ASSERT_EQ(socket.connect(sf::IpAddress::LocalHost, receiver->getLocalPort()), sf::Socket::Status::Done);
+    for (int i = 0; i < frameCount; ++i) {
+        hmi3::ProjectLoadCommand command;
+        command.projectName = std::to_string(i);
+        command.projectData = std::string(1000, 'b');
+        ASSERT_EQ(hmi3::sendFrame(socket, command), sf::Socket::Status::Done);
+    }
+
+    auto deadline = Clock::now() + std::chrono::seconds(2);
+    while (receiver->getQueueDepth() < 2 && Clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(receiver->getQueueDepth(), 2);
+    EXPECT_EQ(receiver->getQueueCapacity(), 2);
+
+    std::vector<std::string> names;
+    deadline = Clock::now() + std::chrono::seconds(2);
+    while (names.size() < frameCount && Clock::now() < deadline) {
+        for (auto& command : receiver->getCommands()) {
+            names.push_back(command.projectName);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    ASSERT_EQ(names.size(), frameCount);
+    for (int i = 0; i < frameCount; ++i) {
+        EXPECT_EQ(names[i], std::to_string(i));
+    }
+}
+
+// Режим ReceiverThread: обработчик получает всё, очередь для getCommands()
+// хранит копии, пока есть место, и не останавливает приём
+TEST_F(NetworkCommandReceiverTest, ReceiverThreadKeepsCopiesForGetCommands) {
+    receiver->stop();
+    receiver = std::make_unique<hmi3::NetworkCommandReceiver>(0, 2);
+    receiver->setCommandCallback([this](const hmi3::ProjectLoadCommand& cmd) {
+        std::lock_guard<std::mutex> lock(mutex);
+        received.push_back(cmd.projectName);
+        condition.notify_all();
+    });
+    ASSERT_TRUE(receiver->start());
+
+    const int frameCount = 5;
+    sf::TcpSocket socket;
+    ASSERT_EQ(socket.connect(sf::IpAddress::LocalHost, receiver->getLocalPort()), sf::Socket::Status::Done);
+    for (int i = 0; i < frameCount; ++i) {
+        hmi3::ProjectLoadCommand command;
+        command.projectName = std::to_string(i);
+        ASSERT_EQ(hmi3::sendFrame(socket, command), sf::Socket::Status::Done);
+    }
+    ASSERT_TRUE(waitForCommands(frameCount, std::chrono::seconds(2)));
+
+    auto commands = receiver->getCommands();
+    ASSERT_EQ(commands.size(), 2);
+    EXPECT_EQ(commands[0].projectName, "0");
+    EXPECT_EQ(commands[1].projectName, "1");
+
+    auto stats = receiver->getStats();
+    EXPECT_EQ(stats.commandsAccepted, frameCount);
+    EXPECT_EQ(stats.commandsDispatched, frameCount);
+    EXPECT_EQ(stats.queueFull, frameCount - 2);
+}
+
+TEST_F(NetworkCommandReceiverTest, StatsCountTrafficRejectionsAndLatency) {
+    receiver->stop();
+    receiver = std::make_unique<hmi3::NetworkCommandReceiver>(0);
+    receiver->setDispatchMode(hmi3::DispatchMode::Pump);
+    std::size_t dispatched = 0;
+    receiver->setCommandCallback([&](const hmi3::ProjectLoadCommand&) { ++dispatched; });
+    ASSERT_TRUE(receiver->start());
+
+    sf::TcpSocket socket;
+    ASSERT_EQ(socket.connect(sf::IpAddress::LocalHost, receiver->getLocalPort()), sf::Socket::Status::Done);
+    std::size_t sent = 0;
+    for (std::size_t size : {100u, 1000u, 10000u}) {
+        hmi3::ProjectLoadCommand command;
+        command.projectName = "stats";
+        command.projectData = std::string(size, 's');
+        std::string frame = hmi3::encodeFrame(command);
+        ASSERT_EQ(socket.send(frame.data(), frame.size()), sf::Socket::Status::Done);
+        sent += frame.size();
+    }
+    // Испорченная нагрузка: кадр отвергается, соединение живёт дальше
+    hmi3::ProjectLoadCommand broken;
+    broken.projectName = "broken";
+    broken.projectData = std::string(50, 'x');
+    std::string frame = hmi3::encodeFrame(broken);
+    frame.back() = 'y';
+    ASSERT_EQ(socket.send(frame.data(), frame.size()), sf::Socket::Status::Done);
+    sent += frame.size();
+
+    auto deadline = Clock::now() + std::chrono::seconds(2);
+    while (receiver->getStats().commandsRejected == 0 && Clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    // Команды полежали в очереди до pump()
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(receiver->getStats().queueDepth, 3u);
+    EXPECT_EQ(receiver->pump(), 3u);
+
+    auto stats = receiver->getStats();
+    EXPECT_EQ(stats.connectionsAccepted, 1u);
+    EXPECT_EQ(stats.connectionsActive, 1u);
+    EXPECT_EQ(stats.bytesReceived, sent);
+    EXPECT_EQ(stats.commandsAccepted, 3u);
+    EXPECT_EQ(stats.commandsRejected, 1u);
+    EXPECT_EQ(stats.commandsDispatched, 3u);
+    EXPECT_EQ(stats.queueDepth, 0u);
+    EXPECT_EQ(stats.payloadBytes.count, 3u);
+    EXPECT_EQ(stats.payloadBytes.sum, 11100u);
+    EXPECT_EQ(stats.payloadBytes.max, 10000u);
+    EXPECT_EQ(stats.dispatchLatencyUs.count, 3u);
+    EXPECT_GE(stats.dispatchLatencyUs.percentile(0.5), 20000u);
+    EXPECT_EQ(dispatched, 3u);
+
+    socket.disconnect();
+    deadline = Clock::now() + std::chrono::seconds(2);
+    while (receiver->getStats().connectionsActive != 0 && Clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(receiver->getStats().connectionsActive, 0u);
+}
+
+TEST_F(NetworkCommandReceiverTest, MetricsEndpointServesPlaintextSnapshot) {
+    receiver->stop();
+    receiver = std::make_unique<hmi3::NetworkCommandReceiver>(0);
+    receiver->setMetricsPort(0);
+    receiver->setCommandCallback([](const hmi3::ProjectLoadCommand&) {});
+    ASSERT_TRUE(receiver->start());
+    ASSERT_NE(receiver->getMetricsPort(), 0);
+
+    ASSERT_TRUE(sendRaw("Hello HMI3!"));
+    auto deadline = Clock::now() + std::chrono::seconds(2);
+    while (receiver->getStats().commandsAccepted == 0 && Clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    sf::TcpSocket socket;
+    ASSERT_EQ(socket.connect(sf::IpAddress::LocalHost, receiver->getMetricsPort()), sf::Socket::Status::Done);
+    std::string request = "GET /metrics HTTP/1.0\r\n\r\n";
+    ASSERT_EQ(socket.send(request.data(), request.size()), sf::Socket::Status::Done);
+
+    std::string response;
+    char buffer[4096];
+    std::size_t received = 0;
+    while (socket.receive(buffer, sizeof(buffer), received) == sf::Socket::Status::Done) {
+        response.append(buffer, received);
+    }
+
+    EXPECT_EQ(response.rfind("HTTP/1.0 200 OK\r\n", 0), 0u);
+    EXPECT_NE(response.find("hmi3_receiver_commands_accepted_total 1\n"), std::string::npos);
+    EXPECT_NE(response.find("hmi3_receiver_payload_bytes_max 11\n"), std::string::npos);
+    EXPECT_NE(response.find("hmi3_receiver_dispatch_latency_us{quantile=\"0.99\"}"), std::string::npos);
+    EXPECT_NE(response.find("# TYPE hmi3_receiver_queue_depth gauge"), std::string::npos);
+    EXPECT_NE(response.find("# TYPE hmi3_atoms_live gauge"), std::string::npos);
+
+    // Порт сводки занят только пока приёмник работает
+    receiver->stop();
+    sf::TcpSocket late;
+    EXPECT_NE(late.connect(sf::IpAddress::LocalHost, receiver->getMetricsPort(), sf::milliseconds(200)),
+              sf::Socket::Status::Done);
 }
\ No newline at end of file
@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "hmi3/compiled_project.hpp"
+#include "hmi3/components/rectangle_component.hpp"
+#include "hmi3/container.hpp"
+#include "hmi3/project_loader.hpp"
+#include "test_helpers.hpp"
+
+namespace {
+
+const char* kProject =
+    "root background=40,40,80\n"
+    "container panel position=10,10 size=300,100\n"
+    "rectangle lamp1 parent=panel position=20,20 size=10,10 fill=0,255,0\n"
+    "rectangle lamp2 parent=panel position=40,20 size=10,10 fill=0,255,0\n"
+    "rectangle label position=10,200 size=80,20 fill=\"255,255,255\"\n";
+
+std::vector<char> compile(const std::string& text, std::uint32_t version = 1) {
+    hmi3::ProjectDescription description;
+    std::string error;
+    EXPECT_TRUE(hmi3::parseProject(text, description, error)) << error;
+    std::vector<char> output;
+    EXPECT_TRUE(hmi3::compileProject(description, version, output, error)) << error;
+    return output;
+}
+
+// Скомпилированный проект во временном файле, удаляется в конце теста
+struct TempFile : hmi3::test::TempPath {
+    explicit TempFile(const std::vector<char>& data) : TempPath("hmi3_compiled", ".hmi3c") {
+        std::ofstream out(path, std::ios::binary);
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+};
+
+} // namespace
+
+TEST(CompiledProjectTest, RoundTripsDescriptionWithInternedStrings) {
+    std::vector<char> data = compile(kProject, 7);
+
+    hmi3::CompiledProject project;
+    std::string error;
+    ASSERT_TRUE(project.openMemory(data.data(), data.size(), error)) << error;
+    EXPECT_EQ(project.getVersion(), 7u);
+    ASSERT_EQ(project.getComponentCount(), 4u);
+    ASSERT_EQ(project.getRootPropertyCount(), 1u);
+    EXPECT_EQ(project.getRootProperty(0).name, "background");
+    EXPECT_EQ(project.getRootProperty(0).value, "40,40,80");
+
+    EXPECT_EQ(project.getType(1), "rectangle");
+    EXPECT_EQ(project.getId(1), "lamp1");
+    EXPECT_EQ(project.getParent(1), 0u);
+    EXPECT_EQ(project.getParent(3), hmi3::CompiledProject::noParent);
+    ASSERT_EQ(project.getPropertyCount(1), 3u);
+    EXPECT_EQ(project.getProperty(1, 2).name, "fill");
+    EXPECT_EQ(project.getProperty(1, 2).value, "0,255,0");
+
+    // Повторы ("rectangle", "position", "10,10", "0,255,0" и т.д.) хранятся один раз:
+    // 19 разных строк из 32 ссылок
+    EXPECT_EQ(project.getStringCount(), 19u);
+}
+
+TEST(CompiledProjectTest, RejectsDamagedData) {
+    std::vector<char> data = compile(kProject);
+    hmi3::CompiledProject project;
+    std::string error;
+
+    EXPECT_FALSE(project.openMemory(kProject, 60, error));
+    EXPECT_FALSE(project.isOpen());
+
+    std::vector<char> truncated(data.begin(), data.end() - 4);
+    EXPECT_FALSE(project.openMemory(truncated.data(), truncated.size(), error));
+    EXPECT_NE(error.find("truncated"), std::string::npos);
+
+    // Ссылка на строку за пределами пула
+    std::vector<char> corrupted = data;
+    std::uint32_t componentsOffset = 0;
+    std::memcpy(&componentsOffset, corrupted.data() + 36, 4);
+    std::uint32_t badString = 1000;
+    std::memcpy(corrupted.data() + componentsOffset + 4, &badString, 4);
+    EXPECT_FALSE(project.openMemory(corrupted.data(), corrupted.size(), error));
+    EXPECT_NE(error.find("component 0"), std::string::npos);
+
+    // Два компонента с одним id: lamp2 ссылается на строку lamp1
+    std::vector<char> duplicate = data;
+    std::memcpy(duplicate.data() + componentsOffset + 2 * 20 + 4, duplicate.data() + componentsOffset + 20 + 4, 4);
+    EXPECT_FALSE(project.openMemory(duplicate.data(), duplicate.size(), error));
+    EXPECT_NE(error.find("duplicate component id 'lamp1'"), std::string::npos);
+
+    EXPECT_FALSE(project.open("/nonexistent/project.hmi3c", error));
+}
+
+TEST(CompiledProjectTest, LoaderBuildsTreeFromMappedFile) {
+    TempFile file(compile(kProject));
+    hmi3::CompiledProject project;
+    std::string error;
+    ASSERT_TRUE(project.open(file.path, error)) << error;
+
+    hmi3::Container root("root");
+    hmi3::ProjectLoader loader;
+    auto result = loader.apply(root, project);
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_TRUE(result.fullRebuild);
+    EXPECT_EQ(result.created, 4u);
+    EXPECT_TRUE(result.warnings.empty());
+
+    ASSERT_EQ(root.getComponentCount(), 2u);
+    auto panel = std::dynamic_pointer_cast<hmi3::Container>(root.getComponent("panel"));
+    ASSERT_NE(panel, nullptr);
+    EXPECT_EQ(panel->getComponentCount(), 2u);
+    auto lamp = std::dynamic_pointer_cast<hmi3::RectangleComponent>(loader.findComponent("lamp2"));
+    ASSERT_NE(lamp, nullptr);
+    EXPECT_EQ(lamp->getParent(), panel.get());
+    EXPECT_EQ(lamp->getPosition(), sf::Vector2f(40.0f, 20.0f));
+    EXPECT_EQ(lamp->getFillColor(), sf::Color(0, 255, 0));
+}
+
+TEST(CompiledProjectTest, ChildrenOfRejectedComponentAreSkipped) {
+    std::vector<char> data = compile(kProject);
+    hmi3::CompiledProject project;
+    std::string error;
+    ASSERT_TRUE(project.openMemory(data.data(), data.size(), error)) << error;
+
+    // id "panel" уже занят компонентом приложения
+    hmi3::Container root("root");
+    root.addComponent(std::make_shared<hmi3::RectangleComponent>("panel", sf::Vector2f(5, 5), sf::Color::Red));
+    hmi3::ProjectLoader loader;
+    auto result = loader.apply(root, project);
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_EQ(result.created, 1u);
+    ASSERT_EQ(result.warnings.size(), 3u);
+    EXPECT_NE(result.warnings[1].find("lamp1: skipped"), std::string::npos);
+    EXPECT_EQ(loader.findComponent("lamp1"), nullptr);
+    EXPECT_NE(loader.findComponent("label"), nullptr);
+    EXPECT_EQ(root.getComponentCount(), 2u);
+}
+
+TEST(CompiledProjectTest, CommandPayloadMayCarryCompiledProject) {
+    std::vector<char> data = compile(kProject);
+    hmi3::ProjectLoadCommand command;
+    command.projectData = std::string_view(data.data(), data.size());
+
+    hmi3::Container root("root");
+    hmi3::ProjectLoader loader;
+    ASSERT_TRUE(loader.apply(root, command).success);
+    EXPECT_EQ(root.getComponentCount(), 2u);
+
+    // Текстовая загрузка после скомпилированной пересобирает всё
+    command.projectData = "rectangle label position=0,0 size=5,5\n";
+    auto result = loader.apply(root, command);
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_TRUE(result.fullRebuild);
+    EXPECT_EQ(result.removed, 4u);
+    EXPECT_EQ(root.getComponentCount(), 1u);
+}
+
+TEST(CompiledProjectTest, CompiledFileBuildsSameTreeAsTextPayload) {
+    // Время запуска сравнивает BM_ProjectStartup* в hmi3_bench
+    const int count = 5000;
+    std::string text = "root background=40,40,80\n";
+    for (int panel = 0; panel < count / 100; ++panel) {
+        text += "container p" + std::to_string(panel) + " position=0,0 size=1000,1000\n";
+        for (int i = 1; i < 100; ++i) {
+            text += "rectangle r" + std::to_string(panel * 100 + i) + " parent=p" + std::to_string(panel) +
+                    " position=" + std::to_string(i % 10 * 10) + "," + std::to_string(i / 10 * 10) +
+                    " size=8,8 fill=0,255,0\n";
+        }
+    }
+    TempFile file(compile(text));
+
+    hmi3::ProjectLoadCommand command;
+    command.projectData = text;
+    hmi3::Container textRoot("root");
+    hmi3::ProjectLoader textLoader;
+    ASSERT_TRUE(textLoader.apply(textRoot, command).success);
+
+    hmi3::Container compiledRoot("root");
+    hmi3::ProjectLoader compiledLoader;
+    hmi3::CompiledProject project;
+    std::string error;
+    ASSERT_TRUE(project.open(file.path, error)) << error;
+    ASSERT_TRUE(compiledLoader.apply(compiledRoot, project).success);
+
+    EXPECT_EQ(compiledRoot.getComponentCount(), textRoot.getComponentCount());
+    ASSERT_NE(compiledRoot.findByPath("p49/r4999"), nullptr);
+    EXPECT_EQ(compiledRoot.findByPath("p49/r4999")->getPosition(), textRoot.findByPath("p49/r4999")->getPosition());
+}
\ No newline at end of file
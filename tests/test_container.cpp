@@ -1,73 +1,636 @@
-#include <gtest/gtest.h>
-#include <memory>
-#include <vector>
-#include <string>
-#include <unordered_map>
-#include <algorithm>
-#include "hmi3/components/component.hpp"
-#include "hmi3/container.hpp"
-
-// Mock компонент для тестов
-class TestComponent : public hmi3::Component {
-public:
-    TestComponent(std::string id) : Component(std::move(id)), updateCount(0) {}
-    
-    void update(float dt) override { updateCount++; }
-    void handleEvent(const sf::Event& event) override { 
-        eventHandled = true;
-    }
-    void draw(sf::RenderTarget& target, sf::RenderStates states) const override {}
-    
-    int updateCount = 0;
-    bool eventHandled = false;
-};
-
-class ContainerTest : public ::testing::Test {
-protected:
-    void SetUp() override {
-        container = std::make_unique<hmi3::Container>();
-    }
-
-    std::unique_ptr<hmi3::Container> container;
-};
-
-TEST_F(ContainerTest, AddComponent) {
-    auto component = std::make_shared<TestComponent>("test_component");
-    container->addComponent(component);
-    
-    EXPECT_EQ(container->getComponentCount(), 1);
-    EXPECT_EQ(container->getComponent("test_component"), component);
-}
-
-TEST_F(ContainerTest, RemoveComponent) {
-    auto component = std::make_shared<TestComponent>("test_component");
-    container->addComponent(component);
-    
-    EXPECT_TRUE(container->removeComponent("test_component"));
-    EXPECT_EQ(container->getComponentCount(), 0);
-    EXPECT_FALSE(container->getComponent("test_component"));
-}
-
-TEST_F(ContainerTest, UpdateComponents) {
-    auto component1 = std::make_shared<TestComponent>("comp1");
-    auto component2 = std::make_shared<TestComponent>("comp2");
-    
-    container->addComponent(component1);
-    container->addComponent(component2);
-    
-    container->update(0.1f);
-    
-    EXPECT_EQ(component1->updateCount, 1);
-    EXPECT_EQ(component2->updateCount, 1);
-}
-
-TEST_F(ContainerTest, ClearComponents) {
-    container->addComponent(std::make_shared<TestComponent>("comp1"));
-    container->addComponent(std::make_shared<TestComponent>("comp2"));
-    
-    EXPECT_EQ(container->getComponentCount(), 2);
-    
-    container->clear();
-    
-    EXPECT_EQ(container->getComponentCount(), 0);
-}
\ No newline at end of file
+#include <gtest/gtest.h>
+#include <limits>
+#include <memory>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <algorithm>
+#include "hmi3/components/component.hpp"
+#include "hmi3/container.hpp"
+
+// Mock компонент для тестов
+class TestComponent : public hmi3::Component {
+public:
+    TestComponent(std::string id) : Component(std::move(id)), updateCount(0) {}
+    
+    void update(float dt) override { updateCount++; }
+    void handleEvent(const sf::Event& event) override { 
+        eventHandled = true;
+        eventCount++;
+    }
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override {}
+    
+    int updateCount = 0;
+    int eventCount = 0;
+    bool eventHandled = false;
+};
+
+class ContainerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        container = std::make_unique<hmi3::Container>();
+    }
+
+    std::unique_ptr<hmi3::Container> container;
+};
+
+TEST_F(ContainerTest, AddComponent) {
+    auto component = std::make_shared<TestComponent>("test_component");
+    container->addComponent(component);
+    
+    EXPECT_EQ(container->getComponentCount(), 1);
+    EXPECT_EQ(container->getComponent("test_component"), component);
+}
+
+TEST_F(ContainerTest, RemoveComponent) {
+    auto component = std::make_shared<TestComponent>("test_component");
+    container->addComponent(component);
+    
+    EXPECT_TRUE(container->removeComponent("test_component"));
+    EXPECT_EQ(container->getComponentCount(), 0);
+    EXPECT_FALSE(container->getComponent("test_component"));
+}
+
+TEST_F(ContainerTest, UpdateComponents) {
+    auto component1 = std::make_shared<TestComponent>("comp1");
+    auto component2 = std::make_shared<TestComponent>("comp2");
+    
+    container->addComponent(component1);
+    container->addComponent(component2);
+    
+    container->update(0.1f);
+    
+    EXPECT_EQ(component1->updateCount, 1);
+    EXPECT_EQ(component2->updateCount, 1);
+}
+
+TEST_F(ContainerTest, ClearComponents) {
+    container->addComponent(std::make_shared<TestComponent>("comp1"));
+    container->addComponent(std::make_shared<TestComponent>("comp2"));
+    
+    EXPECT_EQ(container->getComponentCount(), 2);
+    
+    container->clear();
+    
+    EXPECT_EQ(container->getComponentCount(), 0);
+}
+
+namespace {
+
+sf::Event mousePress(int x, int y) {
+    return sf::Event(sf::Event::MouseButtonPressed{sf::Mouse::Button::Left, {x, y}});
+}
+
+std::shared_ptr<TestComponent> makeBounded(const std::string& id, sf::Vector2f position, sf::Vector2f size) {
+    auto component = std::make_shared<TestComponent>(id);
+    component->setPosition(position);
+    component->setSize(size);
+    return component;
+}
+
+} // namespace
+
+TEST_F(ContainerTest, PointerEventReachesTopmostComponentOnly) {
+    auto below = makeBounded("below", {0, 0}, {100, 100});
+    auto above = makeBounded("above", {50, 50}, {100, 100});
+    auto aside = makeBounded("aside", {300, 300}, {10, 10});
+    container->addComponent(below);
+    container->addComponent(above);
+    container->addComponent(aside);
+
+    container->handleEvent(mousePress(75, 75));
+    EXPECT_EQ(above->eventCount, 1);
+    EXPECT_EQ(below->eventCount, 0);
+    EXPECT_EQ(aside->eventCount, 0);
+
+    container->handleEvent(mousePress(10, 10));
+    EXPECT_EQ(below->eventCount, 1);
+    EXPECT_EQ(container->hitTest({305, 305}), aside.get());
+    EXPECT_EQ(container->hitTest({200, 200}), nullptr);
+}
+
+TEST_F(ContainerTest, IndexFollowsPositionAndVisibility) {
+    auto component = makeBounded("moving", {0, 0}, {20, 20});
+    container->addComponent(component);
+
+    component->setPosition({400, 400});
+    EXPECT_EQ(container->hitTest({10, 10}), nullptr);
+    EXPECT_EQ(container->hitTest({410, 410}), component.get());
+
+    component->setVisible(false);
+    EXPECT_EQ(container->hitTest({410, 410}), nullptr);
+    component->setVisible(true);
+    EXPECT_EQ(container->hitTest({410, 410}), component.get());
+
+    container->removeComponent("moving");
+    EXPECT_EQ(container->hitTest({410, 410}), nullptr);
+    EXPECT_EQ(component->getParent(), nullptr);
+}
+
+TEST_F(ContainerTest, ComponentsWithoutBoundsStillReceivePointerEvents) {
+    auto legacy = std::make_shared<TestComponent>("legacy");
+    auto bounded = makeBounded("bounded", {0, 0}, {10, 10});
+    container->addComponent(legacy);
+    container->addComponent(bounded);
+
+    container->handleEvent(mousePress(500, 500));
+    EXPECT_EQ(legacy->eventCount, 1);
+    EXPECT_EQ(bounded->eventCount, 0);
+}
+
+TEST_F(ContainerTest, KeyboardEventsAreBroadcast) {
+    auto first = makeBounded("first", {0, 0}, {10, 10});
+    auto second = makeBounded("second", {100, 100}, {10, 10});
+    container->addComponent(first);
+    container->addComponent(second);
+
+    container->handleEvent(sf::Event(sf::Event::KeyPressed{sf::Keyboard::Key::A}));
+    EXPECT_EQ(first->eventCount, 1);
+    EXPECT_EQ(second->eventCount, 1);
+}
+
+TEST_F(ContainerTest, MouseMoveOverLargeScreenTouchesOneComponent) {
+    // Мнемосхема 100x100 символов: движение мыши не должно обходить их все
+    std::vector<std::shared_ptr<TestComponent>> symbols;
+    for (int y = 0; y < 100; ++y) {
+        for (int x = 0; x < 100; ++x) {
+            auto symbol = makeBounded("s" + std::to_string(y * 100 + x),
+                {x * 10.0f, y * 10.0f}, {8.0f, 8.0f});
+            container->addComponent(symbol);
+            symbols.push_back(symbol);
+        }
+    }
+
+    for (int i = 0; i < 1000; ++i) {
+        container->handleEvent(sf::Event(sf::Event::MouseMoved{{(i * 7) % 1000, (i * 13) % 1000}}));
+    }
+
+    int delivered = 0;
+    for (const auto& symbol : symbols) {
+        delivered += symbol->eventCount;
+    }
+    EXPECT_LE(delivered, 1000);
+    EXPECT_GT(delivered, 0);
+}
+
+
+TEST_F(ContainerTest, ChangesMarkAncestorsDirty) {
+    auto panel = std::make_shared<hmi3::Container>("panel");
+    auto lamp = makeBounded("lamp", {0, 0}, {10, 10});
+    panel->addComponent(lamp);
+    container->addComponent(panel);
+
+    EXPECT_TRUE(container->isDirty());
+    EXPECT_TRUE(panel->isDirty());
+
+    // Перерисовка кэша снимает отметки со всего поддерева
+    container->setCacheEnabled(true);
+    hmi3::RenderBatch batch;
+    container->appendGeometry(batch);
+    if (container->getCacheRenderCount() == 0) {
+        GTEST_SKIP() << "RenderTexture is not available";
+    }
+    EXPECT_FALSE(container->isDirty());
+    EXPECT_FALSE(panel->isDirty());
+    EXPECT_FALSE(lamp->isDirty());
+
+    lamp->setPosition({5, 5});
+    EXPECT_TRUE(lamp->isDirty());
+    EXPECT_TRUE(panel->isDirty());
+    EXPECT_TRUE(container->isDirty());
+}
+
+
+TEST_F(ContainerTest, HandlesSurviveRemovalOfSiblings) {
+    auto first = std::make_shared<TestComponent>("first");
+    auto second = std::make_shared<TestComponent>("second");
+    hmi3::ComponentHandle firstHandle = container->addComponent(first);
+    hmi3::ComponentHandle secondHandle = container->addComponent(second);
+
+    EXPECT_FALSE(container->addComponent(std::make_shared<TestComponent>("first")).isValid());
+    EXPECT_EQ(container->getHandle("second"), secondHandle);
+    EXPECT_EQ(second->getHandle(), secondHandle);
+
+    EXPECT_TRUE(container->removeComponent(firstHandle));
+    EXPECT_FALSE(container->removeComponent(firstHandle));
+    EXPECT_EQ(container->getComponent(firstHandle), nullptr);
+    EXPECT_EQ(container->getComponent(secondHandle), second.get());
+    EXPECT_FALSE(first->getHandle().isValid());
+}
+
+TEST_F(ContainerTest, RebuildKeepsDrawOrder) {
+    const int count = 20000;
+    for (int i = 0; i < count; ++i) {
+        container->addComponent(std::make_shared<TestComponent>("c" + std::to_string(i)));
+    }
+    // Удаление по одному - без сдвига остальных элементов
+    for (int i = 0; i < count; i += 2) {
+        EXPECT_TRUE(container->removeComponent("c" + std::to_string(i)));
+    }
+    for (int i = count; i < count + 100; ++i) {
+        container->addComponent(std::make_shared<TestComponent>("c" + std::to_string(i)));
+    }
+
+    std::vector<std::string> order;
+    container->forEachComponent([&order](hmi3::Component& component) {
+        order.push_back(component.getId());
+    });
+    ASSERT_EQ(order.size(), static_cast<size_t>(count / 2 + 100));
+    EXPECT_EQ(order.front(), "c1");
+    EXPECT_EQ(order[1], "c3");
+    EXPECT_EQ(order.back(), "c" + std::to_string(count + 99));
+}
+
+TEST_F(ContainerTest, AddingToAnotherContainerMovesComponent) {
+    auto other = std::make_shared<hmi3::Container>("other");
+    auto component = std::make_shared<TestComponent>("moving");
+    container->addComponent(component);
+    other->addComponent(component);
+
+    EXPECT_EQ(container->getComponentCount(), 0);
+    EXPECT_EQ(other->getComponent("moving"), component);
+    EXPECT_EQ(component->getParent(), other.get());
+}
+
+
+namespace {
+
+// Запоминает полученные события, наведение и фокус
+class PointerProbe : public TestComponent {
+public:
+    using TestComponent::TestComponent;
+
+    void handleEvent(const sf::Event& event) override {
+        TestComponent::handleEvent(event);
+        if (auto* moved = event.getIf<sf::Event::MouseMoved>()) lastMove = moved->position;
+        if (event.is<sf::Event::MouseButtonReleased>()) ++releases;
+        if (event.is<sf::Event::KeyPressed>()) ++keys;
+    }
+    void onHoverChanged(bool value) override { hovered = value; ++hoverChanges; }
+    void onFocusChanged(bool value) override { focused = value; }
+
+    sf::Vector2i lastMove;
+    int releases = 0;
+    int keys = 0;
+    bool hovered = false;
+    int hoverChanges = 0;
+    bool focused = false;
+};
+
+std::shared_ptr<PointerProbe> makeProbe(const std::string& id, sf::Vector2f position, sf::Vector2f size) {
+    auto probe = std::make_shared<PointerProbe>(id);
+    probe->setPosition(position);
+    probe->setSize(size);
+    return probe;
+}
+
+sf::Event mouseMove(int x, int y) {
+    return sf::Event(sf::Event::MouseMoved{{x, y}});
+}
+
+sf::Event mouseRelease(int x, int y) {
+    return sf::Event(sf::Event::MouseButtonReleased{sf::Mouse::Button::Left, {x, y}});
+}
+
+} // namespace
+
+TEST_F(ContainerTest, PressedComponentCapturesPointer) {
+    auto slider = makeProbe("slider", {0, 0}, {100, 20});
+    auto other = makeProbe("other", {0, 100}, {100, 100});
+    container->addComponent(slider);
+    container->addComponent(other);
+
+    container->handleEvent(mousePress(10, 10));
+    EXPECT_EQ(container->getPointerCapture(), slider.get());
+
+    // Курсор ушёл на соседа, но движения и отпускание - нажатому
+    container->handleEvent(mouseMove(50, 150));
+    container->handleEvent(mouseRelease(50, 150));
+    EXPECT_EQ(slider->lastMove, sf::Vector2i(50, 150));
+    EXPECT_EQ(slider->releases, 1);
+    EXPECT_EQ(other->eventCount, 0);
+    EXPECT_EQ(container->getPointerCapture(), nullptr);
+
+    // После отпускания события снова идут по попаданию
+    container->handleEvent(mouseMove(60, 160));
+    EXPECT_EQ(other->eventCount, 1);
+    EXPECT_EQ(slider->eventCount, 3);
+}
+
+TEST_F(ContainerTest, KeyboardGoesToFocusedComponent) {
+    auto first = makeProbe("first", {0, 0}, {10, 10});
+    auto second = makeProbe("second", {100, 100}, {10, 10});
+    container->addComponent(first);
+    container->addComponent(second);
+
+    container->handleEvent(mousePress(105, 105));
+    container->handleEvent(mouseRelease(105, 105));
+    EXPECT_TRUE(second->focused);
+    EXPECT_EQ(container->getFocus(), second.get());
+
+    container->handleEvent(sf::Event(sf::Event::KeyPressed{sf::Keyboard::Key::A}));
+    EXPECT_EQ(second->keys, 1);
+    EXPECT_EQ(first->keys, 0);
+
+    // Щелчок мимо компонентов снимает фокус, клавиатура снова для всех
+    container->handleEvent(mousePress(500, 500));
+    EXPECT_FALSE(second->focused);
+    container->handleEvent(sf::Event(sf::Event::KeyPressed{sf::Keyboard::Key::A}));
+    EXPECT_EQ(first->keys, 1);
+    EXPECT_EQ(second->keys, 2);
+
+    EXPECT_TRUE(container->setFocus(first->getHandle()));
+    EXPECT_TRUE(first->focused);
+    container->removeComponent("first");
+    EXPECT_FALSE(first->focused);
+    EXPECT_EQ(container->getFocus(), nullptr);
+}
+
+TEST_F(ContainerTest, FocusAndHoverFollowNestedContainers) {
+    auto panel = std::make_shared<hmi3::Container>("panel");
+    panel->setPosition({100, 100});
+    panel->setSize({200, 200});
+    auto lamp = makeProbe("lamp", {150, 150}, {20, 20});
+    panel->addComponent(lamp);
+    auto button = makeProbe("button", {0, 0}, {50, 50});
+    container->addComponent(panel);
+    container->addComponent(button);
+
+    container->handleEvent(mouseMove(160, 160));
+    EXPECT_TRUE(lamp->hovered);
+    EXPECT_EQ(container->getHovered(), panel.get());
+    container->handleEvent(mouseMove(165, 165));
+    EXPECT_EQ(lamp->hoverChanges, 1);
+
+    // Уход с панели - уход и с её лампы
+    container->handleEvent(mouseMove(10, 10));
+    EXPECT_FALSE(lamp->hovered);
+    EXPECT_TRUE(button->hovered);
+    container->handleEvent(sf::Event(sf::Event::MouseLeft{}));
+    EXPECT_FALSE(button->hovered);
+
+    container->handleEvent(mousePress(160, 160));
+    container->handleEvent(mouseRelease(160, 160));
+    EXPECT_TRUE(lamp->focused);
+    container->handleEvent(sf::Event(sf::Event::KeyPressed{sf::Keyboard::Key::A}));
+    EXPECT_EQ(lamp->keys, 1);
+    EXPECT_EQ(button->keys, 0);
+
+    container->handleEvent(mousePress(10, 10));
+    EXPECT_FALSE(lamp->focused);
+    EXPECT_TRUE(button->focused);
+}
+
+TEST_F(ContainerTest, ChildOutsideUnclippedParentReceivesPointer) {
+    auto group = std::make_shared<hmi3::Container>("group");
+    group->setPosition({0, 0});
+    group->setSize({50, 50});
+    auto inner = std::make_shared<hmi3::Container>("inner");
+    inner->setPosition({0, 0});
+    inner->setSize({40, 40});
+    // Внук далеко за прямоугольниками обоих контейнеров; рисуется, так как они не обрезают
+    auto far = makeProbe("far", {300, 300}, {20, 20});
+    inner->addComponent(far);
+    group->addComponent(inner);
+    auto below = makeProbe("below", {290, 290}, {40, 40});
+    container->addComponent(below);
+    container->addComponent(group);
+
+    container->handleEvent(mousePress(310, 310));
+    container->handleEvent(mouseRelease(310, 310));
+    EXPECT_TRUE(far->focused);
+    EXPECT_FALSE(below->focused);
+    EXPECT_EQ(container->getFocus(), group.get());
+
+    // Мимо внука - нижний компонент, а не контейнер
+    container->handleEvent(mousePress(295, 295));
+    container->handleEvent(mouseRelease(295, 295));
+    EXPECT_TRUE(below->focused);
+    EXPECT_FALSE(far->focused);
+
+    // Обрезающий контейнер за своими границами не перехватывает указатель
+    group->setClipEnabled(true);
+    container->handleEvent(mousePress(310, 310));
+    container->handleEvent(mouseRelease(310, 310));
+    EXPECT_TRUE(below->focused);
+    EXPECT_FALSE(far->focused);
+}
+
+TEST_F(ContainerTest, CoalescedMotionIsDeliveredOncePerFrame) {
+    auto lamp = makeProbe("lamp", {0, 0}, {100, 100});
+    container->addComponent(lamp);
+    container->setMotionCoalescing(true);
+
+    for (int i = 0; i < 30; ++i) {
+        container->handleEvent(mouseMove(i, i));
+    }
+    EXPECT_EQ(lamp->eventCount, 0);
+    container->update(0.016f);
+    EXPECT_EQ(lamp->eventCount, 1);
+    EXPECT_EQ(lamp->lastMove, sf::Vector2i(29, 29));
+
+    // Нажатие выталкивает накопленное движение раньше себя
+    container->handleEvent(mouseMove(40, 40));
+    container->handleEvent(mousePress(41, 41));
+    EXPECT_EQ(lamp->eventCount, 3);
+    EXPECT_EQ(lamp->lastMove, sf::Vector2i(40, 40));
+}
+
+TEST_F(ContainerTest, PathIndexFollowsTreeChanges) {
+    auto area = std::make_shared<hmi3::Container>("area1");
+    auto pump = std::make_shared<hmi3::Container>("pump3");
+    auto status = std::make_shared<TestComponent>("status");
+    pump->addComponent(status);
+    area->addComponent(pump);
+    container->addComponent(area);
+
+    EXPECT_EQ(container->findByPath("area1/pump3/status"), status.get());
+    EXPECT_EQ(container->findByPath("area1/pump3"), pump.get());
+    EXPECT_EQ(container->findByPath("area1/status"), nullptr);
+    // От вложенного контейнера путь считается от него
+    EXPECT_EQ(area->findByPath("pump3/status"), status.get());
+
+    // Добавление на любом уровне сразу видно корню
+    auto level = std::make_shared<TestComponent>("level");
+    pump->addComponent(level);
+    EXPECT_EQ(container->findByPath("area1/pump3/level"), level.get());
+    EXPECT_EQ(container->getHandle(hmi3::internAtom("area1")), container->getHandle("area1"));
+
+    // Перенос поддерева меняет пути всех его компонентов
+    auto area2 = std::make_shared<hmi3::Container>("area2");
+    container->addComponent(area2);
+    area2->addComponent(pump);
+    EXPECT_EQ(container->findByPath("area1/pump3/status"), nullptr);
+    EXPECT_EQ(container->findByPath("area2/pump3/status"), status.get());
+
+    // Отсоединённое поддерево - самостоятельный корень со своим индексом
+    container->removeComponent("area2");
+    EXPECT_EQ(container->findByPath("area2/pump3/status"), nullptr);
+    EXPECT_EQ(area2->findByPath("pump3/status"), status.get());
+    pump->removeComponent("status");
+    EXPECT_EQ(area2->findByPath("pump3/status"), nullptr);
+    EXPECT_EQ(area2->findByPath("pump3/level"), level.get());
+
+    container->clear();
+    EXPECT_EQ(container->findByPath("area1"), nullptr);
+    EXPECT_EQ(area->findByPath("pump3"), nullptr);
+}
+
+
+namespace {
+
+// Запоминает dt каждого update()
+class TickProbe : public TestComponent {
+public:
+    using TestComponent::TestComponent;
+
+    void update(float dt) override {
+        TestComponent::update(dt);
+        ticks.push_back(dt);
+        if (sleepAfterUpdate) sleep();
+    }
+
+    std::vector<float> ticks;
+    bool sleepAfterUpdate = false;
+};
+
+} // namespace
+
+TEST_F(ContainerTest, SleepingComponentGetsNoUpdates) {
+    auto lamp = std::make_shared<TickProbe>("lamp");
+    auto animation = std::make_shared<TickProbe>("animation");
+    container->addComponent(lamp);
+    container->addComponent(animation);
+    lamp->sleep();
+    EXPECT_EQ(container->getAwakeCount(), 1u);
+
+    for (int i = 0; i < 10; ++i) container->update(0.016f);
+    EXPECT_EQ(lamp->updateCount, 0);
+    EXPECT_EQ(animation->updateCount, 10);
+
+    // Смена данных будит; компонент сам засыпает после обновления
+    lamp->sleepAfterUpdate = true;
+    lamp->markDirty();
+    container->update(0.016f);
+    container->update(0.016f);
+    EXPECT_EQ(lamp->updateCount, 1);
+    EXPECT_TRUE(lamp->isSleeping());
+}
+
+TEST_F(ContainerTest, InfiniteSleepWaitsForWake) {
+    auto lamp = std::make_shared<TickProbe>("lamp");
+    container->addComponent(lamp);
+    lamp->sleepFor(std::numeric_limits<float>::infinity());
+    EXPECT_TRUE(lamp->isSleeping());
+    EXPECT_EQ(container->getTimerCount(), 0u);
+    lamp->setUpdateInterval(std::numeric_limits<float>::infinity());
+
+    for (int i = 0; i < 10; ++i) container->update(0.016f);
+    EXPECT_EQ(lamp->updateCount, 0);
+    lamp->wake();
+    container->update(0.016f);
+    EXPECT_EQ(lamp->updateCount, 1);
+}
+
+TEST_F(ContainerTest, TargetedEventWakesComponent) {
+    auto button = std::make_shared<TickProbe>("button");
+    button->setPosition({0, 0});
+    button->setSize({50, 50});
+    container->addComponent(button);
+    button->sleep();
+
+    container->handleEvent(sf::Event(sf::Event::MouseButtonPressed{sf::Mouse::Button::Left, {10, 10}}));
+    EXPECT_FALSE(button->isSleeping());
+    EXPECT_EQ(button->eventCount, 1);
+    container->update(0.016f);
+    EXPECT_EQ(button->updateCount, 1);
+}
+
+TEST_F(ContainerTest, SleepForWakesByTimer) {
+    auto blinker = std::make_shared<TickProbe>("blinker");
+    container->addComponent(blinker);
+    blinker->sleepFor(0.5f);
+    EXPECT_EQ(container->getTimerCount(), 1u);
+
+    for (int i = 0; i < 30; ++i) container->update(0.016f);
+    EXPECT_EQ(blinker->updateCount, 0);
+    // 0.496 - ещё спит, 0.512 и 0.528 - обновляется
+    for (int i = 0; i < 3; ++i) container->update(0.016f);
+    EXPECT_EQ(blinker->updateCount, 2);
+    EXPECT_FALSE(blinker->isSleeping());
+    EXPECT_FLOAT_EQ(blinker->ticks.front(), 0.016f);
+
+    // Разбуженный раньше срока не получает второго пробуждения от старого таймера
+    blinker->sleepFor(0.1f);
+    blinker->wake();
+    blinker->sleep();
+    for (int i = 0; i < 20; ++i) container->update(0.016f);
+    EXPECT_EQ(blinker->updateCount, 2);
+}
+
+TEST_F(ContainerTest, UpdateIntervalTicksAtLowerRate) {
+    auto clock = std::make_shared<TickProbe>("clock");
+    container->addComponent(clock);
+    clock->setUpdateInterval(1.0f);
+    EXPECT_EQ(container->getAwakeCount(), 0u);
+
+    // 3 секунды по 10 мс
+    for (int i = 0; i < 300; ++i) container->update(0.01f);
+    ASSERT_EQ(clock->updateCount, 2);
+    // dt накапливается с прошлого вызова
+    EXPECT_NEAR(clock->ticks[0], 1.0f, 0.02f);
+    EXPECT_NEAR(clock->ticks[1], 1.0f, 0.02f);
+
+    clock->setUpdateInterval(0.0f);
+    container->update(0.01f);
+    EXPECT_EQ(clock->updateCount, 3);
+}
+
+TEST_F(ContainerTest, ScheduledUpdatesKeepDrawOrder) {
+    std::vector<std::string> order;
+    class OrderProbe : public TestComponent {
+    public:
+        OrderProbe(std::string id, std::vector<std::string>& order) : TestComponent(std::move(id)), m_order(order) {}
+        void update(float) override { m_order.push_back(getId()); }
+
+    private:
+        std::vector<std::string>& m_order;
+    };
+
+    auto a = std::make_shared<OrderProbe>("a", order);
+    auto b = std::make_shared<OrderProbe>("b", order);
+    auto c = std::make_shared<OrderProbe>("c", order);
+    container->addComponent(a);
+    container->addComponent(b);
+    container->addComponent(c);
+    b->sleepFor(0.0f);
+    container->bringToFront(a->getHandle());
+
+    container->update(0.016f);
+    EXPECT_EQ(order, (std::vector<std::string>{"b", "c", "a"}));
+}
+
+
+TEST_F(ContainerTest, ScrolledContainerRoutesPointerInContentCoordinates) {
+    container->setSize({200, 200});
+    container->setScroll({500, 0});
+    container->setClipEnabled(true);
+    auto visible = makeProbe("visible", {600, 0}, {50, 50});
+    auto hidden = makeProbe("hidden", {740, 0}, {50, 50});
+    container->addComponent(visible);
+    container->addComponent(hidden);
+
+    container->handleEvent(mouseMove(110, 10));
+    EXPECT_EQ(visible->lastMove, sf::Vector2i(610, 10));
+    EXPECT_EQ(container->getHovered(), visible.get());
+
+    // Правее границ контейнера - компонент прокручен за край и обрезан
+    container->handleEvent(mouseMove(250, 10));
+    EXPECT_EQ(hidden->eventCount, 0);
+    EXPECT_EQ(container->getHovered(), nullptr);
+
+    // При уменьшении вдвое в окно попадает и второй
+    container->setZoom(0.5f);
+    container->handleEvent(mouseMove(120, 20));
+    EXPECT_EQ(hidden->lastMove, sf::Vector2i(740, 40));
+}
@@ -0,0 +1,52 @@
+#ifndef HMI3_TEST_HELPERS_HPP
+#define HMI3_TEST_HELPERS_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <system_error>
+#include "hmi3/project_load_command.hpp"
+
+namespace hmi3::test {
+
+// Уникальный путь во временном каталоге. Случайная часть разводит
+// параллельные процессы (ctest -j, несколько сборок на одной машине),
+// счётчик - тесты одного процесса
+inline std::string uniqueTempPath(const std::string& prefix, const std::string& extension = "") {
+    static const std::string processTag = [] {
+        std::random_device random;
+        return std::to_string((static_cast<std::uint64_t>(random()) << 32) | random());
+    }();
+    static std::atomic<std::uint64_t> counter{0};
+    std::string name = prefix + "_" + processTag + "_" + std::to_string(counter++) + extension;
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// Временный файл или каталог, удаляется в конце теста
+struct TempPath {
+    explicit TempPath(const std::string& prefix, const std::string& extension = "")
+        : path(uniqueTempPath(prefix, extension)) {}
+    ~TempPath() {
+        std::error_code ec;
+        std::filesystem::remove_all(path, ec);
+    }
+
+    TempPath(const TempPath&) = delete;
+    TempPath& operator=(const TempPath&) = delete;
+
+    std::string path;
+};
+
+inline ProjectLoadCommand makeCommand(const std::string& name, const std::string& data, std::uint32_t version = 1) {
+    ProjectLoadCommand command;
+    command.projectName = name;
+    command.projectData = data;
+    command.version = version;
+    return command;
+}
+
+} // namespace hmi3::test
+
+#endif // HMI3_TEST_HELPERS_HPP
\ No newline at end of file
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "hmi3/logger.hpp"
+
+namespace {
+
+// Журнал общий на процесс: тест ставит свой вывод и уровень и возвращает их
+class LoggerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_previousLevel = hmi3::Logger::instance().getLevel();
+        hmi3::Logger::instance().flush();
+        hmi3::Logger::instance().setSink([this](hmi3::LogLevel level, const std::string& message) {
+            std::lock_guard<std::mutex> lock(mutex);
+            lines.push_back(std::string(hmi3::logLevelName(level)) + ": " + message);
+        });
+    }
+
+    void TearDown() override {
+        hmi3::Logger::instance().flush();
+        hmi3::Logger::instance().setSink(nullptr);
+        hmi3::Logger::instance().setLevel(m_previousLevel);
+    }
+
+    std::vector<std::string> takeLines() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return std::move(lines);
+    }
+
+    std::mutex mutex;
+    std::vector<std::string> lines;
+
+private:
+    hmi3::LogLevel m_previousLevel = hmi3::LogLevel::Info;
+};
+
+} // namespace
+
+TEST_F(LoggerTest, FiltersByLevelBeforeFormatting) {
+    hmi3::Logger::instance().setLevel(hmi3::LogLevel::Warning);
+
+    int formatted = 0;
+    auto expensive = [&formatted] {
+        ++formatted;
+        return 42;
+    };
+    HMI3_LOG_DEBUG("debug " << expensive());
+    HMI3_LOG_INFO("info " << expensive());
+    HMI3_LOG_WARNING("warning " << expensive());
+    HMI3_LOG_ERROR("error " << expensive());
+    hmi3::Logger::instance().flush();
+
+    EXPECT_EQ(formatted, 2);
+    EXPECT_EQ(takeLines(), (std::vector<std::string>{"warning: warning 42", "error: error 42"}));
+
+    hmi3::Logger::instance().setLevel(hmi3::LogLevel::Off);
+    HMI3_LOG_ERROR("silenced");
+    hmi3::Logger::instance().flush();
+    EXPECT_TRUE(takeLines().empty());
+}
+
+TEST_F(LoggerTest, SlowOutputDoesNotBlockCallers) {
+    hmi3::Logger::instance().setLevel(hmi3::LogLevel::Info);
+    // Вывод стоит, пока тест держит замок: вызывающие не должны его ждать
+    std::mutex gate;
+    std::unique_lock<std::mutex> closed(gate);
+    hmi3::Logger::instance().setSink([this, &gate](hmi3::LogLevel, const std::string& message) {
+        std::lock_guard<std::mutex> wait(gate);
+        std::lock_guard<std::mutex> lock(mutex);
+        lines.push_back(message);
+    });
+
+    const int count = 200;
+    for (int i = 0; i < count; ++i) {
+        HMI3_LOG_INFO("line " << i);
+    }
+    EXPECT_TRUE(takeLines().empty());
+
+    closed.unlock();
+    hmi3::Logger::instance().flush();
+    auto written = takeLines();
+    ASSERT_EQ(written.size(), static_cast<std::size_t>(count));
+    EXPECT_EQ(written.front(), "line 0");
+    EXPECT_EQ(written.back(), "line 199");
+}
+
+TEST_F(LoggerTest, OverflowDropsInsteadOfBlocking) {
+    hmi3::Logger::instance().setLevel(hmi3::LogLevel::Info);
+    std::mutex gate;
+    std::unique_lock<std::mutex> closed(gate);
+    hmi3::Logger::instance().setSink([&gate](hmi3::LogLevel, const std::string&) {
+        std::lock_guard<std::mutex> wait(gate);
+    });
+
+    std::uint64_t droppedBefore = hmi3::Logger::instance().getDroppedCount();
+    const std::size_t extra = 100;
+    for (std::size_t i = 0; i < hmi3::Logger::kQueueCapacity + extra; ++i) {
+        HMI3_LOG_INFO("flood");
+    }
+    // Писатель мог забрать одну запись до того, как встал на замке
+    EXPECT_GE(hmi3::Logger::instance().getDroppedCount() - droppedBefore, extra - 1);
+
+    closed.unlock();
+    hmi3::Logger::instance().flush();
+}
\ No newline at end of file
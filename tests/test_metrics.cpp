@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include "hmi3/metrics.hpp"
+
+TEST(HistogramTest, BucketsCoverValuesWithBoundedError) {
+    for (std::uint64_t value = 0; value < 100000; value += value < 64 ? 1 : 37) {
+        std::size_t index = hmi3::Histogram::bucketIndex(value);
+        ASSERT_LT(index, hmi3::Histogram::kBucketCount);
+        std::uint64_t upper = hmi3::Histogram::bucketUpperBound(index);
+        ASSERT_GE(upper, value);
+        // Верхняя граница корзины не дальше 12.5% от значения
+        ASSERT_LE(upper - value, value / 8) << value;
+        if (index > 0) {
+            ASSERT_LT(hmi3::Histogram::bucketUpperBound(index - 1), value);
+        }
+    }
+    EXPECT_EQ(hmi3::Histogram::bucketIndex(UINT64_MAX), hmi3::Histogram::kBucketCount - 1);
+    EXPECT_EQ(hmi3::Histogram::bucketUpperBound(hmi3::Histogram::kBucketCount - 1), UINT64_MAX);
+}
+
+TEST(HistogramTest, PercentilesFromSnapshot) {
+    hmi3::Histogram histogram;
+    EXPECT_EQ(histogram.snapshot().percentile(0.5), 0u);
+
+    for (std::uint64_t value = 1; value <= 1000; ++value) {
+        histogram.record(value);
+    }
+    auto snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count, 1000u);
+    EXPECT_EQ(snapshot.sum, 500500u);
+    EXPECT_EQ(snapshot.max, 1000u);
+    EXPECT_DOUBLE_EQ(snapshot.mean(), 500.5);
+    EXPECT_GE(snapshot.percentile(0.5), 500u);
+    EXPECT_LE(snapshot.percentile(0.5), 500u + 500u / 8);
+    EXPECT_GE(snapshot.percentile(0.99), 990u);
+    EXPECT_EQ(snapshot.percentile(1.0), 1000u);
+
+    histogram.reset();
+    EXPECT_EQ(histogram.snapshot().count, 0u);
+}
+
+TEST(HistogramTest, ConcurrentWritersLoseNothing) {
+    hmi3::Histogram histogram;
+    const int threadCount = 4;
+    const int perThread = 100000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&histogram, t] {
+            for (int i = 0; i < perThread; ++i) {
+                histogram.record(static_cast<std::uint64_t>(t * 1000 + i % 1000));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count, static_cast<std::uint64_t>(threadCount * perThread));
+    EXPECT_EQ(snapshot.max, 3999u);
+}
\ No newline at end of file
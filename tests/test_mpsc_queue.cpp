@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "hmi3/mpsc_queue.hpp"
+
+TEST(MpscQueueTest, PreservesOrderAndCapacity) {
+    hmi3::BoundedMpscQueue<int> queue(3);
+
+    for (int i = 0; i < 3; ++i) {
+        int value = i;
+        EXPECT_TRUE(queue.tryPush(std::move(value)));
+    }
+    int overflow = 42;
+    EXPECT_FALSE(queue.tryPush(std::move(overflow)));
+    EXPECT_EQ(overflow, 42);
+    EXPECT_EQ(queue.size(), 3);
+
+    int value = -1;
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_TRUE(queue.tryPop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(queue.tryPop(value));
+    EXPECT_EQ(queue.size(), 0);
+}
+
+TEST(MpscQueueTest, WrapsAroundManyTimes) {
+    hmi3::BoundedMpscQueue<int> queue(5);
+    int value = 0;
+    for (int i = 0; i < 1000; ++i) {
+        int pushed = i;
+        ASSERT_TRUE(queue.tryPush(std::move(pushed)));
+        ASSERT_TRUE(queue.tryPop(value));
+        EXPECT_EQ(value, i);
+    }
+}
+
+TEST(MpscQueueTest, ReleasesPoppedValues) {
+    hmi3::BoundedMpscQueue<std::shared_ptr<int>> queue(2);
+    auto item = std::make_shared<int>(7);
+    std::weak_ptr<int> weak = item;
+
+    ASSERT_TRUE(queue.tryPush(std::move(item)));
+    std::shared_ptr<int> popped;
+    ASSERT_TRUE(queue.tryPop(popped));
+    popped.reset();
+    EXPECT_TRUE(weak.expired());
+}
+
+TEST(MpscQueueTest, ManyProducersDeliverEverythingOnce) {
+    const int producerCount = 4;
+    const int itemsPerProducer = 20000;
+    hmi3::BoundedMpscQueue<int> queue(64);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < producerCount; ++p) {
+        producers.emplace_back([&queue, p] {
+            for (int i = 0; i < itemsPerProducer; ++i) {
+                int value = p * itemsPerProducer + i;
+                while (!queue.tryPush(std::move(value))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // Порядок в пределах одного производителя сохраняется
+    std::vector<int> lastSeen(producerCount, -1);
+    int total = 0;
+    int value = 0;
+    while (total < producerCount * itemsPerProducer) {
+        if (!queue.tryPop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        int producer = value / itemsPerProducer;
+        int index = value % itemsPerProducer;
+        EXPECT_GT(index, lastSeen[producer]);
+        lastSeen[producer] = index;
+        ++total;
+    }
+
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    for (int p = 0; p < producerCount; ++p) {
+        EXPECT_EQ(lastSeen[p], itemsPerProducer - 1);
+    }
+}
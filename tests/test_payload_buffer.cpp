@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+#include "hmi3/payload_buffer.hpp"
+#include "hmi3/project_load_command.hpp"
+
+namespace {
+
+hmi3::PayloadPool::Stats statsDelta(const hmi3::PayloadPool::Stats& before) {
+    auto after = hmi3::PayloadPool::instance().getStats();
+    after.allocations -= before.allocations;
+    after.reuses -= before.reuses;
+    after.copiedBytes -= before.copiedBytes;
+    return after;
+}
+
+} // namespace
+
+TEST(PayloadBufferTest, CopiesShareTheSameBytes) {
+    hmi3::PayloadBuffer buffer("project data");
+    hmi3::PayloadBuffer copy = buffer;
+
+    EXPECT_EQ(copy, "project data");
+    EXPECT_EQ(copy.data(), buffer.data());
+    EXPECT_EQ(buffer.useCount(), 2);
+
+    hmi3::PayloadBuffer moved = std::move(copy);
+    EXPECT_EQ(moved.data(), buffer.data());
+    EXPECT_EQ(buffer.useCount(), 2);
+}
+
+TEST(PayloadBufferTest, CommandCopySharesPayload) {
+    hmi3::ProjectLoadCommand command;
+    command.projectData = std::string(100000, 'p');
+
+    hmi3::ProjectLoadCommand copy = command;
+    EXPECT_EQ(copy.projectData.data(), command.projectData.data());
+    EXPECT_EQ(copy.projectData.size(), 100000);
+}
+
+TEST(PayloadBufferTest, EmptyBufferHasNoStorage) {
+    hmi3::PayloadBuffer empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty, "");
+    EXPECT_EQ(hmi3::PayloadWriter().finish().useCount(), 0);
+}
+
+TEST(PayloadBufferTest, SizeHintedWriterAllocatesOnceAndNeverCopies) {
+    const std::size_t size = 4 * 1024 * 1024;
+    auto before = hmi3::PayloadPool::instance().getStats();
+
+    hmi3::PayloadWriter writer(size);
+    for (std::size_t offset = 0; offset < size; offset += 64 * 1024) {
+        char* window = writer.prepare(64 * 1024);
+        std::memset(window, 'x', 64 * 1024);
+        writer.commit(64 * 1024);
+    }
+    auto buffer = writer.finish();
+
+    auto delta = statsDelta(before);
+    EXPECT_EQ(buffer.size(), size);
+    EXPECT_EQ(delta.allocations + delta.reuses, 1);
+    EXPECT_EQ(delta.copiedBytes, 0);
+}
+
+TEST(PayloadBufferTest, UnhintedWriterGrowsByDoubling) {
+    auto before = hmi3::PayloadPool::instance().getStats();
+
+    std::string chunk(1024, 'y');
+    hmi3::PayloadWriter writer;
+    for (int i = 0; i < 1024; ++i) {
+        writer.append(chunk.data(), chunk.size());
+    }
+    auto buffer = writer.finish();
+
+    // 1 МБ из блоков 4 КБ..1 МБ: 9 блоков, перекладки суммарно меньше итогового размера
+    auto delta = statsDelta(before);
+    EXPECT_EQ(buffer.size(), 1024 * 1024);
+    EXPECT_EQ(delta.allocations + delta.reuses, 9);
+    EXPECT_LT(delta.copiedBytes, 2 * buffer.size());
+}
+
+TEST(PayloadBufferTest, PoolReusesReleasedBlocks) {
+    auto& pool = hmi3::PayloadPool::instance();
+    {
+        hmi3::PayloadWriter writer(2 * 1024 * 1024);
+        writer.prepare(1);
+        writer.commit(1);
+        writer.finish();
+    }
+
+    auto before = pool.getStats();
+    {
+        hmi3::PayloadWriter writer(2 * 1024 * 1024);
+        writer.prepare(1);
+        writer.commit(1);
+        writer.finish();
+    }
+    auto delta = statsDelta(before);
+    EXPECT_EQ(delta.allocations, 0);
+    EXPECT_EQ(delta.reuses, 1);
+}
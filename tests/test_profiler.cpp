@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "hmi3/components/rectangle_component.hpp"
+#include "hmi3/container.hpp"
+#include "hmi3/profiler.hpp"
+
+namespace {
+
+const hmi3::Profiler::Entry* findEntry(const std::vector<hmi3::Profiler::Entry>& entries, const std::string& category,
+                                       const std::string& name) {
+    for (const auto& entry : entries) {
+        if (entry.category == category && entry.name == name) return &entry;
+    }
+    return nullptr;
+}
+
+class CountingComponent : public hmi3::Component {
+public:
+    explicit CountingComponent(std::string id) : Component(std::move(id)) {}
+    void update(float) override { ++updates; }
+    void handleEvent(const sf::Event&) override {}
+    void draw(sf::RenderTarget&, sf::RenderStates) const override {}
+
+    int updates = 0;
+};
+
+} // namespace
+
+class ProfilerTest : public ::testing::Test {
+protected:
+    void SetUp() override { hmi3::Profiler::instance().reset(); }
+    void TearDown() override { hmi3::Profiler::instance().reset(); }
+};
+
+TEST_F(ProfilerTest, SummarizesCallsPerCategoryAndName) {
+    auto& profiler = hmi3::Profiler::instance();
+    profiler.record("update", "pump1", 0, 2000000);
+    profiler.record("update", "pump1", 5000000, 6000000);
+    profiler.record("draw", "pump1", 0, 500000);
+
+    auto summary = profiler.getSummary();
+    const auto* update = findEntry(summary, "update", "pump1");
+    ASSERT_NE(update, nullptr);
+    EXPECT_EQ(update->calls, 2u);
+    EXPECT_DOUBLE_EQ(update->totalMs, 3.0);
+    EXPECT_DOUBLE_EQ(update->maxMs, 2.0);
+    // Самое дорогое - первым
+    EXPECT_EQ(&summary.front(), update);
+}
+
+TEST_F(ProfilerTest, RingBufferKeepsOnlyRecentEvents) {
+    auto& profiler = hmi3::Profiler::instance();
+    for (std::size_t i = 0; i < hmi3::Profiler::eventsPerThread + 10; ++i) {
+        profiler.record("update", "lamp", 0, 1);
+    }
+    auto summary = profiler.getSummary();
+    ASSERT_EQ(summary.size(), 1u);
+    EXPECT_EQ(summary[0].calls, hmi3::Profiler::eventsPerThread);
+}
+
+TEST_F(ProfilerTest, FramePercentilesUseRollingWindow) {
+    auto& profiler = hmi3::Profiler::instance();
+    EXPECT_EQ(profiler.getFrameStats().frames, 0u);
+
+    // Старые медленные кадры вытесняются окном
+    for (int i = 0; i < 100; ++i) profiler.recordFrame(100.0);
+    for (std::size_t i = 0; i < hmi3::Profiler::frameWindow; ++i) {
+        profiler.recordFrame(i % 50 == 49 ? 50.0 : 16.0);
+    }
+
+    auto stats = profiler.getFrameStats();
+    EXPECT_EQ(stats.frames, hmi3::Profiler::frameWindow);
+    EXPECT_DOUBLE_EQ(stats.p50Ms, 16.0);
+    EXPECT_DOUBLE_EQ(stats.p95Ms, 16.0);
+    EXPECT_DOUBLE_EQ(stats.p99Ms, 50.0);
+    EXPECT_DOUBLE_EQ(stats.maxMs, 50.0);
+}
+
+TEST_F(ProfilerTest, ChromeTraceHasEventPerIntervalAndThread) {
+    auto& profiler = hmi3::Profiler::instance();
+    profiler.record("update", "tank \"A\"", 1000, 3500);
+    std::thread([&profiler] { profiler.record("update", "worker", 2000, 3000); }).join();
+
+    std::ostringstream out;
+    profiler.writeChromeTrace(out);
+    std::string trace = out.str();
+
+    EXPECT_EQ(trace.rfind("{\"traceEvents\":[", 0), 0u);
+    EXPECT_NE(trace.find("{\"name\":\"tank \\\"A\\\"\",\"cat\":\"update\",\"ph\":\"X\",\"ts\":1.000,\"dur\":2.500"),
+              std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"worker\""), std::string::npos);
+
+    std::set<std::string> threads;
+    for (std::size_t pos = trace.find("\"tid\":"); pos != std::string::npos; pos = trace.find("\"tid\":", pos + 1)) {
+        threads.insert(trace.substr(pos, trace.find('}', pos) - pos));
+    }
+    EXPECT_EQ(threads.size(), 2u);
+}
+
+#ifdef HMI3_ENABLE_PROFILER
+
+TEST_F(ProfilerTest, ContainerRecordsEachComponentOnce) {
+    hmi3::Container root("root");
+    auto panel = std::make_shared<hmi3::Container>("panel");
+    auto lamp = std::make_shared<CountingComponent>("lamp");
+    panel->addComponent(lamp);
+    root.addComponent(panel);
+    root.addComponent(std::make_shared<hmi3::RectangleComponent>("frame", sf::Vector2f(10, 10), sf::Color::Red));
+
+    root.update(0.016f);
+    root.update(0.016f);
+    hmi3::RenderBatch batch;
+    root.appendGeometry(batch);
+
+    auto summary = hmi3::Profiler::instance().getSummary();
+    ASSERT_NE(findEntry(summary, "update", "root"), nullptr);
+    EXPECT_EQ(findEntry(summary, "update", "root")->calls, 2u);
+    // Вложенный контейнер размечен только родителем
+    ASSERT_NE(findEntry(summary, "update", "panel"), nullptr);
+    EXPECT_EQ(findEntry(summary, "update", "panel")->calls, 2u);
+    ASSERT_NE(findEntry(summary, "update", "lamp"), nullptr);
+    EXPECT_EQ(findEntry(summary, "update", "lamp")->calls, 2u);
+    EXPECT_EQ(lamp->updates, 2);
+    ASSERT_NE(findEntry(summary, "draw", "frame"), nullptr);
+    EXPECT_EQ(findEntry(summary, "draw", "frame")->calls, 1u);
+}
+
+#endif
\ No newline at end of file
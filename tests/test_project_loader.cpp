@@ -0,0 +1,210 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "hmi3/components/rectangle_component.hpp"
+#include "hmi3/container.hpp"
+#include "hmi3/project_description.hpp"
+#include "hmi3/project_loader.hpp"
+
+namespace {
+
+hmi3::ProjectLoadCommand makeCommand(const std::string& text, uint32_t version = 1, bool forceLoad = false) {
+    hmi3::ProjectLoadCommand command;
+    command.projectName = "test";
+    command.projectData = text;
+    command.version = version;
+    command.forceLoad = forceLoad;
+    return command;
+}
+
+std::vector<std::string> childIds(const hmi3::Container& container) {
+    std::vector<std::string> ids;
+    container.forEachComponent([&ids](hmi3::Component& component) { ids.push_back(component.getId()); });
+    return ids;
+}
+
+const char* kProject =
+    "# насосная станция\n"
+    "root background=40,40,80\n"
+    "container panel position=10,10 size=300,100\n"
+    "rectangle lamp1 parent=panel position=20,20 size=10,10 fill=0,255,0\n"
+    "rectangle lamp2 parent=panel position=40,20 size=10,10 fill=0,255,0\n"
+    "rectangle label position=10,200 size=80,20 fill=255,255,255\n";
+
+} // namespace
+
+TEST(ProjectDescriptionTest, ParsesComponentsAndQuotedValues) {
+    hmi3::ProjectDescription description;
+    std::string error;
+    ASSERT_TRUE(hmi3::parseProject("root background=1,2,3\r\n"
+                                   "rectangle a text=\"Pump \\\"P1\\\"\" size=1,2\n"
+                                   "\n"
+                                   "container b\n"
+                                   "rectangle c parent=b\n", description, error)) << error;
+
+    ASSERT_EQ(description.components.size(), 3u);
+    EXPECT_EQ(description.rootProperties.size(), 1u);
+    EXPECT_EQ(*description.components[0].findProperty("text"), "Pump \"P1\"");
+    EXPECT_EQ(*description.components[0].findProperty("size"), "1,2");
+    EXPECT_EQ(description.components[2].parent, "b");
+    EXPECT_EQ(description.components[2].findProperty("parent"), nullptr);
+}
+
+TEST(ProjectDescriptionTest, RejectsBrokenDescriptions) {
+    hmi3::ProjectDescription description;
+    std::string error;
+    EXPECT_FALSE(hmi3::parseProject("rectangle a\nrectangle a\n", description, error));
+    EXPECT_NE(error.find("line 2"), std::string::npos);
+    EXPECT_FALSE(hmi3::parseProject("rectangle a parent=b\ncontainer b\n", description, error));
+    EXPECT_FALSE(hmi3::parseProject("rectangle a size\n", description, error));
+    EXPECT_FALSE(hmi3::parseProject("rectangle a text=\"open\n", description, error));
+}
+
+TEST(ProjectLoaderTest, FirstLoadBuildsTree) {
+    hmi3::Container root("root");
+    hmi3::ProjectLoader loader;
+    auto result = loader.apply(root, makeCommand(kProject));
+
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_TRUE(result.fullRebuild);
+    EXPECT_EQ(result.created, 4u);
+    EXPECT_EQ(childIds(root), (std::vector<std::string>{"panel", "label"}));
+
+    auto panel = std::dynamic_pointer_cast<hmi3::Container>(root.getComponent("panel"));
+    ASSERT_TRUE(panel);
+    EXPECT_EQ(childIds(*panel), (std::vector<std::string>{"lamp1", "lamp2"}));
+    EXPECT_EQ(panel->getSize(), sf::Vector2f(300, 100));
+}
+
+TEST(ProjectLoaderTest, ReloadTouchesOnlyChangedComponents) {
+    hmi3::Container root("root");
+    hmi3::ProjectLoader loader;
+    ASSERT_TRUE(loader.apply(root, makeCommand(kProject)).success);
+
+    auto lamp1 = loader.findComponent("lamp1");
+    auto lamp2 = std::dynamic_pointer_cast<hmi3::RectangleComponent>(loader.findComponent("lamp2"));
+    auto label = loader.findComponent("label");
+
+    std::string changed = kProject;
+    changed.replace(changed.find("40,20 size=10,10 fill=0,255,0"), 29, "40,20 size=10,10 fill=255,0,0");
+    auto result = loader.apply(root, makeCommand(changed));
+
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_FALSE(result.fullRebuild);
+    EXPECT_EQ(result.created, 0u);
+    EXPECT_EQ(result.removed, 0u);
+    EXPECT_EQ(result.moved, 0u);
+    EXPECT_EQ(result.updated, 1u);
+    // Те же объекты - состояние сохраняется
+    EXPECT_EQ(loader.findComponent("lamp1"), lamp1);
+    EXPECT_EQ(loader.findComponent("lamp2"), lamp2);
+    EXPECT_EQ(loader.findComponent("label"), label);
+    EXPECT_EQ(lamp2->getFillColor(), sf::Color::Red);
+}
+
+TEST(ProjectLoaderTest, ReloadAppliesAddsRemovesAndMoves) {
+    hmi3::Container root("root");
+    hmi3::ProjectLoader loader;
+    ASSERT_TRUE(loader.apply(root, makeCommand(kProject)).success);
+    auto label = loader.findComponent("label");
+    auto lamp2 = loader.findComponent("lamp2");
+
+    const char* next =
+        "root background=40,40,80\n"
+        "container panel position=10,10 size=300,100\n"
+        "rectangle lamp2 parent=panel position=40,20 size=10,10 fill=0,255,0\n"
+        "rectangle lamp3 parent=panel position=60,20 size=10,10 fill=0,255,0\n"
+        "rectangle label parent=panel position=10,200 size=80,20 fill=255,255,255\n";
+    auto result = loader.apply(root, makeCommand(next));
+
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_EQ(result.created, 1u);
+    EXPECT_EQ(result.removed, 1u);
+    EXPECT_EQ(result.moved, 1u);
+    EXPECT_EQ(childIds(root), std::vector<std::string>{"panel"});
+
+    auto panel = std::dynamic_pointer_cast<hmi3::Container>(root.getComponent("panel"));
+    EXPECT_EQ(childIds(*panel), (std::vector<std::string>{"lamp2", "lamp3", "label"}));
+    EXPECT_EQ(loader.findComponent("label"), label);
+    EXPECT_EQ(loader.findComponent("lamp2"), lamp2);
+    EXPECT_EQ(loader.findComponent("lamp1"), nullptr);
+}
+
+TEST(ProjectLoaderTest, ReorderKeepsObjects) {
+    hmi3::Container root("root");
+    hmi3::ProjectLoader loader;
+    ASSERT_TRUE(loader.apply(root, makeCommand("rectangle a\nrectangle b\nrectangle c\nrectangle d\n")).success);
+    auto a = loader.findComponent("a");
+
+    auto result = loader.apply(root, makeCommand("rectangle b\nrectangle c\nrectangle e\nrectangle a\nrectangle d\n"));
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_EQ(childIds(root), (std::vector<std::string>{"b", "c", "e", "a", "d"}));
+    EXPECT_EQ(loader.findComponent("a"), a);
+    EXPECT_EQ(result.created, 1u);
+}
+
+TEST(ProjectLoaderTest, VersionChangeOrForceLoadRebuilds) {
+    hmi3::Container root("root");
+    hmi3::ProjectLoader loader;
+    ASSERT_TRUE(loader.apply(root, makeCommand(kProject, 1)).success);
+    auto lamp1 = loader.findComponent("lamp1");
+
+    auto result = loader.apply(root, makeCommand(kProject, 2));
+    EXPECT_TRUE(result.fullRebuild);
+    EXPECT_EQ(result.created, 4u);
+    EXPECT_EQ(result.removed, 4u);
+    EXPECT_NE(loader.findComponent("lamp1"), lamp1);
+
+    result = loader.apply(root, makeCommand(kProject, 2, true));
+    EXPECT_TRUE(result.fullRebuild);
+    EXPECT_EQ(root.getComponentCount(), 2u);
+}
+
+TEST(ProjectLoaderTest, ErrorsLeaveLiveTreeUntouched) {
+    hmi3::Container root("root");
+    auto manual = std::make_shared<hmi3::RectangleComponent>("manual", sf::Vector2f(1, 1), sf::Color::White);
+    root.addComponent(manual);
+    hmi3::ProjectLoader loader;
+    ASSERT_TRUE(loader.apply(root, makeCommand(kProject)).success);
+
+    auto result = loader.apply(root, makeCommand("gauge g\n"));
+    EXPECT_FALSE(result.success);
+    EXPECT_NE(result.error.find("gauge"), std::string::npos);
+
+    result = loader.apply(root, makeCommand("rectangle a\nrectangle b parent=a\n"));
+    EXPECT_FALSE(result.success);
+    EXPECT_EQ(root.getComponentCount(), 3u);
+
+    // Неверное свойство - предупреждение, а не отказ
+    result = loader.apply(root, makeCommand("rectangle a fill=red blink=1\n"));
+    EXPECT_TRUE(result.success);
+    EXPECT_EQ(result.warnings.size(), 2u);
+    // Компоненты, добавленные вручную, загрузчик не трогает
+    EXPECT_EQ(childIds(root), (std::vector<std::string>{"manual", "a"}));
+}
+
+TEST(ProjectLoaderTest, SmallChangeToLargeProjectUpdatesOneComponent) {
+    // Время полной сборки и перезагрузки меряет BM_ProjectReload в hmi3_bench
+    std::string text;
+    for (int i = 0; i < 10000; ++i) {
+        text += "rectangle r" + std::to_string(i) + " position=" + std::to_string(i % 100 * 10) + "," +
+                std::to_string(i / 100 * 10) + " size=8,8 fill=0,255,0\n";
+    }
+    hmi3::Container root("root");
+    hmi3::ProjectLoader loader;
+
+    ASSERT_TRUE(loader.apply(root, makeCommand(text)).success);
+
+    // Панель закэширована: перерисуется, только если что-то реально изменилось
+    root.setCacheEnabled(true);
+    hmi3::RenderBatch batch;
+    root.appendGeometry(batch);
+
+    text.replace(text.find("r5000 position=0,500 size=8,8 fill=0,255,0"), 42, "r5000 position=0,500 size=8,8 fill=255,0,0");
+    auto result = loader.apply(root, makeCommand(text));
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_EQ(result.updated, 1u);
+    EXPECT_EQ(result.created + result.removed + result.moved, 0u);
+    EXPECT_EQ(root.getComponentCount(), 10000u);
+}
@@ -0,0 +1,304 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "hmi3/protocol.hpp"
+
+namespace {
+
+hmi3::ProjectLoadCommand makeCommand(const std::string& name, const std::string& data) {
+    hmi3::ProjectLoadCommand command;
+    command.projectName = name;
+    command.projectData = data;
+    command.version = 7;
+    command.forceLoad = true;
+    return command;
+}
+
+// Подаёт поток порциями заданного размера и собирает готовые команды
+std::vector<hmi3::ProjectLoadCommand> parseInChunks(hmi3::FrameParser& parser, const std::string& stream,
+                                                    std::size_t chunkSize, int* rejected = nullptr) {
+    std::vector<hmi3::ProjectLoadCommand> commands;
+    for (std::size_t offset = 0; offset < stream.size();) {
+        std::size_t size = std::min(chunkSize, stream.size() - offset);
+        std::size_t consumed = 0;
+        auto result = parser.feed(stream.data() + offset, size, consumed);
+        offset += consumed;
+        if (result == hmi3::FrameParser::Result::FrameReady) {
+            commands.push_back(parser.takeCommand());
+        } else if (result == hmi3::FrameParser::Result::FrameRejected && rejected) {
+            ++*rejected;
+        } else if (result == hmi3::FrameParser::Result::ProtocolError) {
+            break;
+        }
+    }
+    return commands;
+}
+
+// Повторяющийся текст проекта - сжимается в разы
+std::string makeProjectText(int lamps) {
+    std::string text = "container panel position=10,10 size=300,100\n";
+    for (int i = 0; i < lamps; ++i) {
+        text += "rectangle lamp" + std::to_string(i) + " parent=panel position=20,20 size=10,10 fill=0,255,0\n";
+    }
+    return text;
+}
+
+hmi3::ProjectLoadCommand makeCompressedCommand(const std::string& name, const std::string& data) {
+    hmi3::ProjectLoadCommand command = makeCommand(name, data);
+    command.compression = hmi3::PayloadCompression::Lz4;
+    return command;
+}
+
+} // namespace
+
+TEST(ProtocolTest, Crc32MatchesReferenceValue) {
+    EXPECT_EQ(hmi3::crc32("123456789", 9), 0xCBF43926u);
+    EXPECT_EQ(hmi3::crc32("12345", 5, hmi3::crc32("", 0)), hmi3::crc32("12345", 5));
+    EXPECT_EQ(hmi3::crc32("6789", 4, hmi3::crc32("12345", 5)), 0xCBF43926u);
+}
+
+TEST(ProtocolTest, RoundTripPreservesFields) {
+    hmi3::FrameParser parser;
+    auto commands = parseInChunks(parser, hmi3::encodeFrame(makeCommand("Plant A", "payload")), 4096);
+
+    ASSERT_EQ(commands.size(), 1);
+    EXPECT_EQ(commands[0].projectName, "Plant A");
+    EXPECT_EQ(commands[0].projectData, "payload");
+    EXPECT_EQ(commands[0].version, 7);
+    EXPECT_TRUE(commands[0].forceLoad);
+    EXPECT_EQ(commands[0].checksum, "422c6a15");
+    EXPECT_TRUE(parser.isIdle());
+}
+
+TEST(ProtocolTest, ParsesByteByByte) {
+    std::string stream = hmi3::encodeFrame(makeCommand("p1", std::string(1000, 'x')));
+
+    hmi3::FrameParser parser;
+    auto commands = parseInChunks(parser, stream, 1);
+
+    ASSERT_EQ(commands.size(), 1);
+    EXPECT_EQ(commands[0].projectData, std::string(1000, 'x'));
+}
+
+TEST(ProtocolTest, ParsesSeveralFramesFromOneBuffer) {
+    std::string stream;
+    for (int i = 0; i < 5; ++i) {
+        stream += hmi3::encodeFrame(makeCommand("p" + std::to_string(i), "data" + std::to_string(i)));
+    }
+    stream += hmi3::encodeFrame(makeCommand("", ""));
+
+    hmi3::FrameParser parser;
+    auto commands = parseInChunks(parser, stream, stream.size());
+
+    ASSERT_EQ(commands.size(), 6);
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_EQ(commands[i].projectName, "p" + std::to_string(i));
+        EXPECT_EQ(commands[i].projectData, "data" + std::to_string(i));
+    }
+    EXPECT_TRUE(commands[5].projectData.empty());
+}
+
+TEST(ProtocolTest, RejectsCorruptFrameAndStaysInSync) {
+    std::string corrupt = hmi3::encodeFrame(makeCommand("bad", "abcdef"));
+    corrupt.back() ^= 0x01;
+    std::string stream = corrupt + hmi3::encodeFrame(makeCommand("good", "ok"));
+
+    int rejected = 0;
+    hmi3::FrameParser parser;
+    auto commands = parseInChunks(parser, stream, 3, &rejected);
+
+    EXPECT_EQ(rejected, 1);
+    ASSERT_EQ(commands.size(), 1);
+    EXPECT_EQ(commands[0].projectName, "good");
+}
+
+TEST(ProtocolTest, ReportsProtocolErrors) {
+    std::string badMagic = hmi3::encodeFrame(makeCommand("p", "d"));
+    badMagic[0] = 'X';
+
+    std::string badVersion = hmi3::encodeFrame(makeCommand("p", "d"));
+    badVersion[4] = 99;
+
+    for (const auto& stream : {badMagic, badVersion}) {
+        hmi3::FrameParser parser;
+        std::size_t consumed = 0;
+        EXPECT_EQ(parser.feed(stream.data(), stream.size(), consumed), hmi3::FrameParser::Result::ProtocolError);
+        EXPECT_FALSE(parser.getError().empty());
+    }
+}
+
+TEST(ProtocolTest, RejectsOversizedPayloadBeforeReadingIt) {
+    hmi3::FrameParser parser(16);
+    std::string stream = hmi3::encodeFrameHeader(makeCommand("p", std::string(1024, 'x')));
+
+    std::size_t consumed = 0;
+    EXPECT_EQ(parser.feed(stream.data(), stream.size(), consumed), hmi3::FrameParser::Result::ProtocolError);
+    EXPECT_EQ(parser.getError(), "payload too large");
+}
+
+TEST(ProtocolTest, UncompressedFramesStayVersionOne) {
+    std::string plain = hmi3::encodeFrame(makeCommand("p", "d"));
+    std::string compressed = hmi3::encodeFrame(makeCompressedCommand("p", "d"));
+    EXPECT_EQ(plain[4], 1);
+    EXPECT_EQ(compressed[4], hmi3::protocol::kVersion);
+    EXPECT_NE(compressed[5] & hmi3::protocol::FlagCompressionMask, 0);
+
+    // Первая версия не может нести сжатие
+    compressed[4] = 1;
+    hmi3::FrameParser parser;
+    std::size_t consumed = 0;
+    EXPECT_EQ(parser.feed(compressed.data(), compressed.size(), consumed),
+              hmi3::FrameParser::Result::ProtocolError);
+}
+
+TEST(ProtocolTest, DecompressesLz4PayloadInAnyChunking) {
+    std::string text = makeProjectText(2000);
+    std::string stream = hmi3::encodeFrame(makeCompressedCommand("Plant A", text));
+    EXPECT_LT(stream.size(), text.size() / 4);
+
+    for (std::size_t chunk : {std::size_t(1), std::size_t(7), std::size_t(4096), stream.size()}) {
+        hmi3::FrameParser parser;
+        auto commands = parseInChunks(parser, stream, chunk);
+        ASSERT_EQ(commands.size(), 1) << "chunk " << chunk;
+        EXPECT_EQ(commands[0].projectData, text);
+        EXPECT_EQ(commands[0].compression, hmi3::PayloadCompression::Lz4);
+        EXPECT_TRUE(commands[0].forceLoad);
+
+        const auto& stats = parser.getFrameStats();
+        EXPECT_EQ(stats.wireBytes, stream.size() - hmi3::protocol::kHeaderSize - 7);
+        EXPECT_EQ(stats.payloadBytes, text.size());
+        EXPECT_GT(stats.decodeSeconds, 0.0);
+        EXPECT_GE(stats.peakMemory, text.size());
+    }
+}
+
+// Окно под чтение из сокета - промежуточный буфер, а не весь сжатый кадр;
+// результат выделяется один раз по размеру из заголовка LZ4
+TEST(ProtocolTest, StreamsCompressedPayloadThroughSmallWindow) {
+    std::string text = makeProjectText(50000);
+    std::string stream = hmi3::encodeFrame(makeCompressedCommand("big", text));
+    ASSERT_GT(stream.size(), hmi3::FrameParser::kStagingSize * 2);
+
+    auto before = hmi3::PayloadPool::instance().getStats();
+    hmi3::FrameParser parser;
+    std::size_t headerSize = hmi3::protocol::kHeaderSize + 3;
+    std::size_t consumed = 0;
+    ASSERT_EQ(parser.feed(stream.data(), headerSize, consumed), hmi3::FrameParser::Result::NeedMoreData);
+
+    std::size_t offset = headerSize;
+    auto result = hmi3::FrameParser::Result::NeedMoreData;
+    while (result == hmi3::FrameParser::Result::NeedMoreData) {
+        std::size_t window = 0;
+        char* data = parser.payloadWindow(window);
+        ASSERT_NE(data, nullptr);
+        EXPECT_LE(window, hmi3::FrameParser::kStagingSize);
+        std::size_t count = std::min(window, stream.size() - offset);
+        std::memcpy(data, stream.data() + offset, count);
+        offset += count;
+        result = parser.commitPayload(count);
+    }
+    ASSERT_EQ(result, hmi3::FrameParser::Result::FrameReady);
+    EXPECT_EQ(offset, stream.size());
+    EXPECT_EQ(parser.takeCommand().projectData, text);
+
+    auto after = hmi3::PayloadPool::instance().getStats();
+    EXPECT_EQ(after.allocations + after.reuses - before.allocations - before.reuses, 1u);
+    EXPECT_LT(parser.getFrameStats().peakMemory, text.size() * 2);
+}
+
+TEST(ProtocolTest, RejectsCorruptCompressedFrameAndStaysInSync) {
+    // CRC кадра пересчитан - ошибку должен поймать сам распаковщик
+    hmi3::PayloadBuffer payload;
+    std::string error;
+    ASSERT_TRUE(hmi3::compressPayload(hmi3::PayloadCompression::Lz4, makeProjectText(100), payload, error));
+    std::string damaged = payload.toString();
+    damaged[damaged.size() / 2] ^= 0x55;
+    auto command = makeCompressedCommand("bad", "");
+    std::string corrupt = hmi3::encodeFrameHeader(command, damaged) + damaged;
+
+    std::string truncated = payload.toString().substr(0, payload.size() / 2);
+    std::string partial = hmi3::encodeFrameHeader(command, truncated) + truncated;
+
+    std::string stream = corrupt + partial + hmi3::encodeFrame(makeCompressedCommand("good", "ok"));
+    int rejected = 0;
+    hmi3::FrameParser parser;
+    auto commands = parseInChunks(parser, stream, 100, &rejected);
+
+    EXPECT_EQ(rejected, 2);
+    ASSERT_EQ(commands.size(), 1);
+    EXPECT_EQ(commands[0].projectData, "ok");
+}
+
+TEST(ProtocolTest, LimitsDecompressedSize) {
+    std::string stream = hmi3::encodeFrame(makeCompressedCommand("bomb", std::string(1024 * 1024, 'z')));
+    hmi3::FrameParser parser(64 * 1024);
+
+    int rejected = 0;
+    auto commands = parseInChunks(parser, stream, stream.size(), &rejected);
+    EXPECT_TRUE(commands.empty());
+    EXPECT_EQ(rejected, 1);
+    EXPECT_NE(parser.getError().find("too large"), std::string::npos);
+}
+
+// Память под несжатую нагрузку растёт по мере прихода байт: один заголовок
+// с огромной длиной не занимает её целиком
+TEST(ProtocolTest, DoesNotPresizeFromDeclaredPayloadLength) {
+    std::string header = hmi3::encodeFrameHeader(makeCommand("p", std::string(8 * 1024 * 1024, 'x')));
+    hmi3::FrameParser parser;
+    std::size_t consumed = 0;
+    ASSERT_EQ(parser.feed(header.data(), header.size(), consumed), hmi3::FrameParser::Result::NeedMoreData);
+    ASSERT_EQ(consumed, header.size());
+
+    std::size_t window = 0;
+    ASSERT_NE(parser.payloadWindow(window), nullptr);
+    EXPECT_EQ(window, hmi3::FrameParser::kMaxPresize);
+    EXPECT_EQ(parser.commitPayload(window), hmi3::FrameParser::Result::NeedMoreData);
+    parser.payloadWindow(window);
+    EXPECT_LE(window, 2 * hmi3::FrameParser::kMaxPresize);
+}
+
+// Заявленный в заголовке LZ4 размер не выделяется целиком: кадр в сотню
+// килобайт не может заставить приёмник занять десятки мегабайт заранее
+TEST(ProtocolTest, DoesNotPresizeFromDeclaredContentSize) {
+    std::string text(32 * 1024 * 1024, 'z');
+    hmi3::PayloadBuffer payload;
+    std::string error;
+    ASSERT_TRUE(hmi3::compressPayload(hmi3::PayloadCompression::Lz4, text, payload, error));
+    ASSERT_LT(payload.size(), text.size() / 64);
+
+    hmi3::StreamDecompressor decoder(hmi3::PayloadCompression::Lz4);
+    decoder.reset(payload.size());
+    hmi3::PayloadWriter out;
+    ASSERT_TRUE(decoder.feed(payload.data(), 64, out, hmi3::protocol::kDefaultMaxPayloadSize));
+    EXPECT_LT(out.capacity(), text.size() / 4);
+
+    ASSERT_TRUE(decoder.feed(payload.data() + 64, payload.size() - 64, out, hmi3::protocol::kDefaultMaxPayloadSize));
+    EXPECT_TRUE(decoder.isComplete());
+    EXPECT_EQ(out.finish(), text);
+}
+
+TEST(ProtocolTest, RefusesToSendPayloadThatCannotBeCompressed) {
+    auto command = makeCompressedCommand("future", "data");
+    command.compression = static_cast<hmi3::PayloadCompression>(2);
+
+    hmi3::PayloadBuffer payload;
+    std::string error;
+    EXPECT_FALSE(hmi3::encodeFramePayload(command, payload, error));
+    EXPECT_NE(error.find("unsupported"), std::string::npos);
+    EXPECT_TRUE(hmi3::encodeFrame(command).empty());
+    EXPECT_TRUE(hmi3::encodeFrameHeader(command).empty());
+}
+
+TEST(ProtocolTest, SkipsUnknownCompression) {
+    std::string unknown = hmi3::encodeFrame(makeCompressedCommand("future", "data"));
+    unknown[5] = static_cast<char>(unknown[5] | hmi3::protocol::FlagCompressionMask);
+    std::string stream = unknown + hmi3::encodeFrame(makeCommand("good", "ok"));
+
+    int rejected = 0;
+    hmi3::FrameParser parser;
+    auto commands = parseInChunks(parser, stream, 5, &rejected);
+    EXPECT_EQ(rejected, 1);
+    ASSERT_EQ(commands.size(), 1);
+    EXPECT_EQ(commands[0].projectName, "good");
+}
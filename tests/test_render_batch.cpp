@@ -0,0 +1,285 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "hmi3/components/rectangle_component.hpp"
+#include "hmi3/container.hpp"
+#include "hmi3/render_batch.hpp"
+
+namespace {
+
+// Компонент без пакетного пути - рисуется отдельным вызовом
+class PlainComponent : public hmi3::Component {
+public:
+    explicit PlainComponent(std::string id) : Component(std::move(id)) {}
+
+    void update(float) override {}
+    void handleEvent(const sf::Event&) override {}
+    void draw(sf::RenderTarget&, sf::RenderStates) const override {}
+};
+
+// Контейнер со своей отрисовкой поверх содержимого
+class OverlayContainer : public hmi3::Container {
+public:
+    explicit OverlayContainer(std::string id) : Container(std::move(id)) {}
+
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override {
+        ++draws;
+        Container::draw(target, states);
+    }
+
+    mutable int draws = 0;
+};
+
+// Наследник без своей отрисовки разрешает раскрытие
+class PlainPanel : public hmi3::Container {
+public:
+    explicit PlainPanel(std::string id) : Container(std::move(id)) {}
+    bool isFlattenable() const override { return true; }
+};
+
+// Запоминает ножницы вида и преобразование, с которыми его нарисовали
+class ClipProbe : public sf::Drawable {
+public:
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override {
+        scissor = target.getView().getScissor();
+        origin = states.transform.transformPoint({0.0f, 0.0f});
+    }
+
+    mutable sf::FloatRect scissor;
+    mutable sf::Vector2f origin;
+};
+
+void expectRect(const sf::FloatRect& actual, const sf::FloatRect& expected, float tolerance = 1e-3f) {
+    EXPECT_NEAR(actual.position.x, expected.position.x, tolerance);
+    EXPECT_NEAR(actual.position.y, expected.position.y, tolerance);
+    EXPECT_NEAR(actual.size.x, expected.size.x, tolerance);
+    EXPECT_NEAR(actual.size.y, expected.size.y, tolerance);
+}
+
+std::shared_ptr<hmi3::RectangleComponent> makeLamp(int index) {
+    auto lamp = std::make_shared<hmi3::RectangleComponent>(
+        "lamp" + std::to_string(index), sf::Vector2f(8, 8), sf::Color::Green);
+    lamp->setPosition({static_cast<float>(index % 100) * 10.0f, static_cast<float>(index / 100) * 10.0f});
+    lamp->setOutlineColor(sf::Color::White);
+    lamp->setOutlineThickness(1.0f);
+    return lamp;
+}
+
+} // namespace
+
+TEST(RenderBatchTest, ConsecutiveGeometryShareOneDrawCall) {
+    hmi3::RenderBatch batch;
+    batch.appendRect(sf::FloatRect({0, 0}, {10, 10}), sf::Color::Red);
+    batch.appendRect(sf::FloatRect({20, 0}, {10, 10}), sf::Color::Blue);
+    batch.appendRect(sf::FloatRect({40, 0}, {10, 10}), sf::Color::Transparent);
+
+    EXPECT_EQ(batch.getDrawCallCount(), 1u);
+    EXPECT_EQ(batch.getVertexCount(), 12u);
+}
+
+TEST(RenderBatchTest, StateChangesAndDrawablesKeepOrder) {
+    sf::Texture texture;
+    PlainComponent plain("plain");
+    hmi3::RenderBatch batch;
+
+    batch.appendRect(sf::FloatRect({0, 0}, {10, 10}), sf::Color::Red);
+    batch.geometry(&texture).append(sf::Vertex{{0, 0}, sf::Color::White, {}});
+    batch.appendDrawable(plain);
+    batch.appendRect(sf::FloatRect({0, 0}, {10, 10}), sf::Color::Red);
+
+    EXPECT_EQ(batch.getDrawCallCount(), 4u);
+    EXPECT_EQ(batch.getBatchCount(), 3u);
+
+    // Массивы остаются в пуле, но кадр начинается с нуля
+    batch.clear();
+    EXPECT_EQ(batch.getDrawCallCount(), 0u);
+    EXPECT_EQ(batch.getVertexCount(), 0u);
+}
+
+TEST(RenderBatchTest, PageOfPrimitivesRendersInHandfulOfDrawCalls) {
+    hmi3::Container page("page");
+    page.setBackgroundColor(sf::Color(40, 40, 80));
+
+    auto panel = std::make_shared<hmi3::Container>("panel");
+    panel->setBackgroundColor(sf::Color(60, 60, 60));
+    page.addComponent(panel);
+
+    const int lampCount = 500;
+    for (int i = 0; i < lampCount; ++i) {
+        (i % 2 ? page : *panel).addComponent(makeLamp(i));
+    }
+    page.addComponent(std::make_shared<PlainComponent>("legacy"));
+
+    // Время сборки кадра меряет BM_ContainerDraw в hmi3_bench
+    hmi3::RenderBatch batch;
+    page.appendGeometry(batch);
+
+    // Фоны, лампы и рамки - один пакет, плюс компонент без пакетного пути
+    EXPECT_EQ(batch.getDrawCallCount(), 2u);
+    EXPECT_EQ(batch.getVertexCount(), (2 + lampCount * 5) * 6u);
+}
+
+TEST(RenderBatchTest, ContainerWithOwnDrawIsNotFlattened) {
+    hmi3::Container page("page");
+    auto overlay = std::make_shared<OverlayContainer>("overlay");
+    overlay->addComponent(makeLamp(0));
+    page.addComponent(overlay);
+    auto plain = std::make_shared<PlainPanel>("plain");
+    plain->addComponent(makeLamp(1));
+    page.addComponent(plain);
+
+    hmi3::RenderBatch batch;
+    page.appendGeometry(batch);
+    // Лампа plain - в пакете, overlay со своей лампой - вызовом своего draw()
+    EXPECT_EQ(batch.getDrawCallCount(), 2u);
+    EXPECT_EQ(batch.getVertexCount(), 5 * 6u);
+
+    sf::RenderTexture target;
+    if (!target.resize({100, 100})) {
+        GTEST_SKIP() << "RenderTexture is not available";
+    }
+    batch.draw(target, sf::RenderStates::Default);
+    EXPECT_EQ(overlay->draws, 1);
+}
+
+TEST(RenderBatchTest, CachedContainerRedrawsOnlyWhenDirty) {
+    hmi3::Container page("page");
+    auto panel = std::make_shared<hmi3::Container>("panel");
+    panel->setSize({1000, 1000});
+    panel->setCacheEnabled(true);
+    std::vector<std::shared_ptr<hmi3::RectangleComponent>> lamps;
+    for (int i = 0; i < 1000; ++i) {
+        lamps.push_back(makeLamp(i));
+        panel->addComponent(lamps.back());
+    }
+    panel->addComponent(std::make_shared<PlainComponent>("legacy"));
+    page.addComponent(panel);
+
+    hmi3::RenderBatch batch;
+    for (int frame = 0; frame < 10; ++frame) {
+        batch.clear();
+        page.appendGeometry(batch);
+    }
+    if (panel->getCacheRenderCount() == 0) {
+        GTEST_SKIP() << "RenderTexture is not available";
+    }
+
+    // Простой экран - один текстурированный прямоугольник на контейнер
+    EXPECT_EQ(panel->getCacheRenderCount(), 1u);
+    EXPECT_EQ(batch.getDrawCallCount(), 1u);
+    EXPECT_EQ(batch.getVertexCount(), 6u);
+
+    lamps[10]->setFillColor(sf::Color::Red);
+    batch.clear();
+    page.appendGeometry(batch);
+    EXPECT_EQ(panel->getCacheRenderCount(), 2u);
+
+    // Изменения вне панели не трогают её кэш
+    page.setBackgroundColor(sf::Color::Blue);
+    batch.clear();
+    page.appendGeometry(batch);
+    EXPECT_EQ(panel->getCacheRenderCount(), 2u);
+    EXPECT_EQ(batch.getDrawCallCount(), 2u);
+}
+
+
+TEST(RenderBatchTest, NestedLayersCombineTransformAndClip) {
+    hmi3::RenderBatch batch;
+    EXPECT_FALSE(batch.getVisibleArea());
+    batch.setVisibleArea(sf::FloatRect({0, 0}, {1000, 1000}));
+
+    batch.appendRect(sf::FloatRect({0, 0}, {10, 10}), sf::Color::Red);
+    batch.pushLayer(sf::Transform().translate({100, 0}), sf::FloatRect({0, 0}, {500, 500}));
+    expectRect(*batch.getVisibleArea(), sf::FloatRect({-100, 0}, {500, 500}));
+    batch.appendRect(sf::FloatRect({0, 0}, {10, 10}), sf::Color::Red);
+
+    batch.pushLayer(sf::Transform().scale({2, 2}), sf::FloatRect({0, 0}, {400, 400}));
+    expectRect(*batch.getVisibleArea(), sf::FloatRect({0, 0}, {200, 200}));
+    ClipProbe probe;
+    batch.appendDrawable(probe);
+    batch.popLayer();
+    batch.popLayer();
+    batch.appendRect(sf::FloatRect({0, 0}, {10, 10}), sf::Color::Red);
+
+    // Геометрия разных слоёв не сливается
+    EXPECT_EQ(batch.getDrawCallCount(), 4u);
+    EXPECT_EQ(batch.getLayerCount(), 3u);
+    expectRect(*batch.getVisibleArea(), sf::FloatRect({0, 0}, {1000, 1000}));
+
+    sf::RenderTexture target;
+    if (!target.resize({1000, 1000})) {
+        GTEST_SKIP() << "RenderTexture is not available";
+    }
+    batch.draw(target, sf::RenderStates::Default);
+    // Отсечение внутреннего слоя пересечено с внешним: x 100..500, y 0..400,
+    // с точностью до пикселя
+    expectRect(probe.scissor, sf::FloatRect({0.1f, 0.0f}, {0.4f, 0.4f}), 2e-3f);
+    EXPECT_EQ(probe.origin, sf::Vector2f(100, 0));
+    // Вид цели восстановлен
+    expectRect(target.getView().getScissor(), sf::FloatRect({0, 0}, {1, 1}));
+}
+
+// Обзор 100x100 ламп, увеличенный в 10 раз: рисуется только видимый угол
+TEST(RenderBatchTest, ZoomedContainerCullsHiddenChildren) {
+    hmi3::Container overview("overview");
+    overview.setSize({1000, 1000});
+    for (int i = 0; i < 10000; ++i) {
+        auto lamp = std::make_shared<hmi3::RectangleComponent>(
+            "lamp" + std::to_string(i), sf::Vector2f(8, 8), sf::Color::Green);
+        lamp->setPosition({static_cast<float>(i % 100) * 10.0f, static_cast<float>(i / 100) * 10.0f});
+        overview.addComponent(lamp);
+    }
+    auto legend = std::make_shared<PlainComponent>("legend");
+    overview.addComponent(legend);
+
+    hmi3::RenderBatch batch;
+    batch.setVisibleArea(sf::FloatRect({0, 0}, {1000, 1000}));
+    overview.appendGeometry(batch);
+    EXPECT_EQ(batch.getVertexCount(), 10000u * 6);
+
+    overview.setZoom(10.0f);
+    overview.setScroll({200, 300});
+    overview.setClipEnabled(true);
+    batch.clear();
+    batch.setVisibleArea(sf::FloatRect({0, 0}, {1000, 1000}));
+    overview.appendGeometry(batch);
+    // 10x10 ламп, плюс задетые краем, и компонент без границ
+    std::size_t lamps = batch.getVertexCount() / 6;
+    EXPECT_GE(lamps, 100u);
+    EXPECT_LE(lamps, 121u);
+    EXPECT_EQ(batch.getDrawCallCount(), 2u);
+}
+
+TEST(RenderBatchTest, UnclippedPanelIsNotCulledByItsOwnBounds) {
+    hmi3::Container page("page");
+    page.setSize({1000, 1000});
+    // Маленькая панель, чей ребёнок лежит далеко за её границами
+    auto panel = std::make_shared<hmi3::Container>("panel");
+    panel->setSize({10, 10});
+    auto lamp = std::make_shared<hmi3::RectangleComponent>("far", sf::Vector2f(8, 8), sf::Color::Green);
+    lamp->setPosition({500, 500});
+    panel->addComponent(lamp);
+    page.addComponent(panel);
+
+    auto drawn = [&page](std::size_t fillers) {
+        for (std::size_t i = page.getComponentCount() - 1; i < fillers; ++i) {
+            auto filler = std::make_shared<hmi3::RectangleComponent>(
+                "filler" + std::to_string(i), sf::Vector2f(8, 8), sf::Color::Red);
+            filler->setPosition({static_cast<float>(i % 100) * 10.0f, 900.0f + static_cast<float>(i / 100) * 10.0f});
+            page.addComponent(filler);
+        }
+        hmi3::RenderBatch batch;
+        batch.setVisibleArea(sf::FloatRect({480, 480}, {40, 40}));
+        page.appendGeometry(batch);
+        return batch.getVertexCount() / 6;
+    };
+
+    // Проверка границ каждого ребёнка и запрос к индексу при малой видимой части
+    EXPECT_EQ(drawn(0), 1u);
+    EXPECT_EQ(drawn(1000), 1u);
+
+    // С отсечением ребёнок за границами панели не виден, панель отсекается
+    panel->setClipEnabled(true);
+    EXPECT_EQ(drawn(1000), 0u);
+}
\ No newline at end of file
@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "hmi3/components/rectangle_component.hpp"
+#include "hmi3/container.hpp"
+#include "hmi3/scene_stager.hpp"
+
+namespace {
+
+hmi3::ProjectLoadCommand makeCommand(const std::string& text, uint32_t version = 1) {
+    hmi3::ProjectLoadCommand command;
+    command.projectName = "test";
+    command.projectData = text;
+    command.version = version;
+    return command;
+}
+
+std::string makeProject(std::size_t count, const char* fill = "0,200,0") {
+    std::string text = "root size=800,600\n";
+    for (std::size_t i = 0; i < count; ++i) {
+        text += "rectangle r" + std::to_string(i) + " position=" + std::to_string(i % 400 * 2) + "," +
+                std::to_string(i / 400 % 300 * 2) + " size=2,2 fill=" + fill + "\n";
+    }
+    return text;
+}
+
+std::vector<std::string> childIds(const hmi3::Container& container) {
+    std::vector<std::string> ids;
+    container.forEachComponent([&ids](hmi3::Component& component) { ids.push_back(component.getId()); });
+    return ids;
+}
+
+} // namespace
+
+TEST(SceneStagerTest, BuildsSceneOffThread) {
+    hmi3::SceneStager stager;
+    EXPECT_EQ(stager.acquire(), nullptr);
+
+    stager.submit(makeCommand(makeProject(10)));
+    stager.waitIdle();
+
+    auto scene = stager.acquire();
+    ASSERT_NE(scene, nullptr);
+    ASSERT_TRUE(scene->result.success) << scene->result.error;
+    ASSERT_NE(scene->root, nullptr);
+    EXPECT_EQ(scene->root->getId(), "project");
+    EXPECT_EQ(scene->root->getComponentCount(), 10u);
+    EXPECT_EQ(scene->root->getSize(), sf::Vector2f(800, 600));
+    EXPECT_EQ(scene->command.projectName, "test");
+    ASSERT_NE(scene->loader, nullptr);
+    EXPECT_EQ(scene->loader->findComponent("r3").get(), scene->root->getComponent("r3").get());
+
+    // Забрать можно один раз
+    EXPECT_EQ(stager.acquire(), nullptr);
+    EXPECT_EQ(stager.getStats().built, 1u);
+}
+
+TEST(SceneStagerTest, PublishesFailedBuild) {
+    hmi3::SceneStager stager;
+    stager.submit(makeCommand("rectangle a\nrectangle a\n"));
+    stager.waitIdle();
+
+    auto scene = stager.acquire();
+    ASSERT_NE(scene, nullptr);
+    EXPECT_FALSE(scene->result.success);
+    EXPECT_FALSE(scene->result.error.empty());
+    EXPECT_EQ(scene->root, nullptr);
+    EXPECT_EQ(stager.getStats().failed, 1u);
+}
+
+TEST(SceneStagerTest, NewestSceneWins) {
+    hmi3::SceneStager stager;
+    for (int i = 1; i <= 5; ++i) {
+        stager.submit(makeCommand(makeProject(static_cast<std::size_t>(i) * 100), static_cast<uint32_t>(i)));
+    }
+    stager.waitIdle();
+
+    auto scene = stager.acquire();
+    ASSERT_NE(scene, nullptr);
+    EXPECT_EQ(scene->command.version, 5u);
+    EXPECT_EQ(scene->root->getComponentCount(), 500u);
+
+    // Остальные заменены до сборки или вытеснены собранными позже
+    auto stats = stager.getStats();
+    EXPECT_EQ(stats.submitted, 5u);
+    EXPECT_EQ(stats.superseded, 4u);
+}
+
+TEST(SceneStagerTest, ReplaceComponentKeepsHandleAndOrder) {
+    hmi3::Container container("main");
+    container.addComponent(std::make_shared<hmi3::RectangleComponent>("below", sf::Vector2f(10, 10), sf::Color::Red));
+    auto first = std::make_shared<hmi3::Container>("project");
+    hmi3::ComponentHandle handle = container.addComponent(first);
+    auto above = std::make_shared<hmi3::RectangleComponent>("above", sf::Vector2f(10, 10), sf::Color::Red);
+    above->setPosition({100, 100});
+    container.addComponent(above);
+    ASSERT_TRUE(container.setFocus(handle));
+
+    auto second = std::make_shared<hmi3::Container>("project");
+    second->setSize({50, 50});
+    auto lamp = std::make_shared<hmi3::RectangleComponent>("lamp", sf::Vector2f(20, 20), sf::Color::Green);
+    second->addComponent(lamp);
+
+    auto previous = container.replaceComponent(handle, second);
+    EXPECT_EQ(previous, first);
+    EXPECT_EQ(first->getParent(), nullptr);
+    EXPECT_EQ(second->getParent(), &container);
+    EXPECT_EQ(container.getHandle("project"), handle);
+    EXPECT_EQ(container.getComponent(handle), second.get());
+    EXPECT_EQ(childIds(container), (std::vector<std::string>{"below", "project", "above"}));
+    // Фокус был у прежнего компонента
+    EXPECT_EQ(container.getFocus(), nullptr);
+    // Новое поддерево доступно по путям и для указателя
+    EXPECT_EQ(container.findByPath("project/lamp"), lamp.get());
+    EXPECT_EQ(container.hitTest({5, 5}), second.get());
+
+    // id, занятый другим компонентом, не принимается
+    auto clash = std::make_shared<hmi3::Container>("above");
+    EXPECT_EQ(container.replaceComponent(handle, clash), nullptr);
+    EXPECT_EQ(container.getComponent(handle), second.get());
+}
+
+TEST(SceneStagerTest, RenderThreadKeepsRunningWhileSceneBuilds) {
+    // Время кадров при сборке 100k компонентов меряет BM_SceneStagerFrames
+    // в hmi3_bench; здесь сборка стоит, пока тест не откроет замок
+    std::mutex gate;
+    std::unique_lock<std::mutex> closed(gate);
+    hmi3::ComponentFactory factory = hmi3::ComponentFactory::withBuiltins();
+    factory.registerType("slow", [&gate](const std::string& id) {
+        std::lock_guard<std::mutex> wait(gate);
+        return std::make_shared<hmi3::RectangleComponent>(id, sf::Vector2f(2, 2), sf::Color::Green);
+    });
+
+    hmi3::Container container("main");
+    container.setSize({800, 600});
+    hmi3::ComponentHandle handle = container.addComponent(std::make_shared<hmi3::Container>("project"));
+    hmi3::SceneStager stager(factory);
+    stager.submit(makeCommand(makeProject(1000) + "slow blocker position=0,0 size=2,2\n"));
+
+    // Кадры потока отрисовки идут, пока фоновая сборка стоит
+    for (int frame = 0; frame < 10; ++frame) {
+        EXPECT_EQ(stager.acquire(), nullptr);
+        container.update(1.0f / 60.0f);
+    }
+    EXPECT_EQ(stager.getStats().built, 0u);
+
+    closed.unlock();
+    stager.waitIdle();
+    std::shared_ptr<hmi3::SceneStager::Scene> scene = stager.acquire();
+    ASSERT_NE(scene, nullptr);
+    ASSERT_TRUE(scene->result.success) << scene->result.error;
+    stager.retire(container.replaceComponent(handle, scene->root));
+    EXPECT_EQ(container.findByPath("project/r999")->getId(), "r999");
+    EXPECT_NE(container.findByPath("project/blocker"), nullptr);
+
+    // Замена на новую сцену: прежнее дерево освобождается в фоне
+    stager.submit(makeCommand(makeProject(10), 2));
+    stager.waitIdle();
+    std::shared_ptr<hmi3::SceneStager::Scene> next = stager.acquire();
+    ASSERT_NE(next, nullptr);
+    stager.retire(container.replaceComponent(handle, next->root));
+    stager.retire(std::move(scene));
+    stager.waitIdle();
+    EXPECT_EQ(container.findByPath("project/r999"), nullptr);
+    EXPECT_EQ(stager.getStats().retired, 3u);
+}
\ No newline at end of file
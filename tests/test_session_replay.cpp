@@ -0,0 +1,306 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "hmi3/container.hpp"
+#include "hmi3/project_loader.hpp"
+#include "hmi3/scene_stager.hpp"
+#include "hmi3/session_recorder.hpp"
+#include "hmi3/session_replayer.hpp"
+#include "test_helpers.hpp"
+
+namespace {
+
+// Временный файл записи, удаляется в конце теста
+struct TempFile : hmi3::test::TempPath {
+    TempFile() : TempPath("hmi3_session", ".hms") {}
+};
+
+hmi3::ProjectLoadCommand makeCommand(const std::string& text, std::uint32_t version = 1) {
+    return hmi3::test::makeCommand("session", text, version);
+}
+
+const char* kProject =
+    "rectangle left position=0,0 size=100,100 fill=255,0,0\n"
+    "rectangle right position=200,0 size=100,100 fill=0,255,0\n";
+
+void click(hmi3::Container& root, int x, int y) {
+    root.handleEvent(sf::Event(sf::Event::MouseButtonPressed{sf::Mouse::Button::Left, {x, y}}));
+    root.handleEvent(sf::Event(sf::Event::MouseButtonReleased{sf::Mouse::Button::Left, {x, y}}));
+}
+
+// Панель для записи и воспроизведения: проект приходит командой
+struct Panel {
+    Panel() : root(std::make_shared<hmi3::Container>("root")) {
+        root->setSize({800, 600});
+        receiver.setDispatchMode(hmi3::DispatchMode::Pump);
+        receiver.setCommandCallback([this](const hmi3::ProjectLoadCommand& command) {
+            results.push_back(loader.apply(*root, command));
+        });
+    }
+
+    std::shared_ptr<hmi3::Container> root;
+    hmi3::ProjectLoader loader;
+    hmi3::ReplayCommandReceiver receiver;
+    std::vector<hmi3::ProjectLoader::Result> results;
+};
+
+// Панель, как в демо: команда собирается в фоне, сцена подменяет
+// дочерний контейнер "project"
+struct StagedPanel {
+    StagedPanel() : root(std::make_shared<hmi3::Container>("root")) {
+        root->setSize({800, 600});
+        auto project = std::make_shared<hmi3::Container>("project");
+        project->setSize(root->getSize());
+        projectHandle = root->addComponent(project);
+        receiver.setDispatchMode(hmi3::DispatchMode::Pump);
+        receiver.setCommandCallback([this](const hmi3::ProjectLoadCommand& command) { stager.submit(command); });
+    }
+
+    // Подменяет сцену, если она готова, и возвращает её команду
+    std::shared_ptr<hmi3::SceneStager::Scene> swap(hmi3::Container& tree) {
+        stager.waitIdle();
+        auto scene = stager.acquire();
+        if (scene && scene->result.success) {
+            stager.retire(tree.replaceComponent(projectHandle, scene->root));
+        }
+        return scene;
+    }
+
+    std::shared_ptr<hmi3::Container> root;
+    hmi3::ComponentHandle projectHandle;
+    hmi3::SceneStager stager;
+    hmi3::ReplayCommandReceiver receiver;
+};
+
+} // namespace
+
+TEST(SessionRecorderTest, RoundTripsEventsUpdatesAndCommands) {
+    TempFile file;
+    hmi3::SessionRecorder recorder;
+    std::string error;
+    ASSERT_TRUE(recorder.open(file.path, error)) << error;
+
+    recorder.recordEvent(sf::Event(sf::Event::MouseMoved{{10, 20}}));
+    recorder.recordEvent(sf::Event(sf::Event::KeyPressed{sf::Keyboard::Key::A, sf::Keyboard::Scancode::A, false, true,
+                                                         false, false}));
+    recorder.recordEvent(sf::Event(sf::Event::Resized{{1024, 768}}));
+    recorder.recordEvent(sf::Event(sf::Event::FocusLost{}));
+    // Не пишется
+    recorder.recordEvent(sf::Event(sf::Event::Closed{}));
+    recorder.recordUpdate(0.016f);
+    hmi3::ProjectLoadCommand command = makeCommand(kProject, 7);
+    command.forceLoad = true;
+    recorder.recordCommand(command);
+    recorder.recordUpdate(0.017f);
+    EXPECT_EQ(recorder.getRecordCount(), 7u);
+    recorder.close();
+
+    hmi3::SessionRecording recording;
+    ASSERT_TRUE(recording.load(file.path, error)) << error;
+    const auto& records = recording.getRecords();
+    ASSERT_EQ(records.size(), 7u);
+    EXPECT_EQ(recording.getFrameCount(), 2u);
+    EXPECT_EQ(recording.getSkippedBytes(), 0u);
+
+    auto* moved = records[0].event->getIf<sf::Event::MouseMoved>();
+    ASSERT_NE(moved, nullptr);
+    EXPECT_EQ(moved->position, sf::Vector2i(10, 20));
+    auto* key = records[1].event->getIf<sf::Event::KeyPressed>();
+    ASSERT_NE(key, nullptr);
+    EXPECT_EQ(key->code, sf::Keyboard::Key::A);
+    EXPECT_TRUE(key->control);
+    auto* resized = records[2].event->getIf<sf::Event::Resized>();
+    ASSERT_NE(resized, nullptr);
+    EXPECT_EQ(resized->size, sf::Vector2u(1024, 768));
+    EXPECT_TRUE(records[3].event->is<sf::Event::FocusLost>());
+
+    EXPECT_EQ(records[4].type, hmi3::SessionRecord::Type::Update);
+    EXPECT_FLOAT_EQ(records[4].dt, 0.016f);
+    ASSERT_EQ(records[5].type, hmi3::SessionRecord::Type::Command);
+    EXPECT_EQ(records[5].command.projectName, "session");
+    EXPECT_EQ(records[5].command.projectData, kProject);
+    EXPECT_EQ(records[5].command.version, 7u);
+    EXPECT_TRUE(records[5].command.forceLoad);
+
+    // Отметки времени не убывают
+    for (std::size_t i = 1; i < records.size(); ++i) {
+        EXPECT_GE(records[i].timeNs, records[i - 1].timeNs);
+    }
+}
+
+TEST(SessionRecorderTest, TruncatedTailIsSkipped) {
+    TempFile file;
+    {
+        hmi3::SessionRecorder recorder;
+        std::string error;
+        ASSERT_TRUE(recorder.open(file.path, error)) << error;
+        recorder.recordUpdate(0.016f);
+        recorder.recordCommand(makeCommand(kProject));
+    }
+    std::filesystem::resize_file(file.path, std::filesystem::file_size(file.path) - 5);
+
+    hmi3::SessionRecording recording;
+    std::string error;
+    ASSERT_TRUE(recording.load(file.path, error)) << error;
+    EXPECT_EQ(recording.getRecords().size(), 1u);
+    EXPECT_GT(recording.getSkippedBytes(), 0u);
+
+    EXPECT_FALSE(recording.parse("not a session", error));
+}
+
+TEST(SessionRecorderTest, WriteErrorStopsRecording) {
+    // Устройство, на котором любая запись кончается ENOSPC
+    if (!std::filesystem::exists("/dev/full")) {
+        GTEST_SKIP() << "/dev/full is not available";
+    }
+    hmi3::SessionRecorder recorder;
+    std::string error;
+    ASSERT_TRUE(recorder.open("/dev/full", error)) << error;
+    EXPECT_FALSE(recorder.hasWriteFailed());
+
+    // Тело больше буфера stdio пишется сразу и получает ошибку
+    recorder.recordCommand(makeCommand(std::string(1024 * 1024, 'x')));
+    EXPECT_TRUE(recorder.hasWriteFailed());
+    EXPECT_FALSE(recorder.isOpen());
+    EXPECT_EQ(recorder.getRecordCount(), 0u);
+    recorder.recordUpdate(0.016f);
+    EXPECT_EQ(recorder.getRecordCount(), 0u);
+}
+
+TEST(SessionReplayerTest, ReplayReproducesRecordedSession) {
+    TempFile file;
+    std::string error;
+    std::string liveFocus;
+    {
+        // Живой сеанс: контейнер и приёмник пишут сами
+        hmi3::SessionRecorder recorder;
+        ASSERT_TRUE(recorder.open(file.path, error)) << error;
+        Panel live;
+        live.root->setSessionRecorder(&recorder);
+        live.receiver.setSessionRecorder(&recorder);
+
+        live.receiver.inject(makeCommand(kProject));
+        live.receiver.pump();
+        live.root->update(0.016f);
+        click(*live.root, 250, 50);
+        live.root->update(0.016f);
+        click(*live.root, 50, 50);
+        live.root->update(0.016f);
+        ASSERT_NE(live.root->getFocus(), nullptr);
+        liveFocus = live.root->getFocus()->getId();
+    }
+    EXPECT_EQ(liveFocus, "left");
+
+    hmi3::SessionRecording recording;
+    ASSERT_TRUE(recording.load(file.path, error)) << error;
+    EXPECT_EQ(recording.getFrameCount(), 3u);
+
+    Panel replay;
+    hmi3::SessionReplayer replayer(recording);
+    std::size_t callbacks = 0;
+    replayer.setFrameCallback([&callbacks](hmi3::Container&) { ++callbacks; });
+    auto report = replayer.run(*replay.root, replay.receiver);
+
+    ASSERT_EQ(replay.results.size(), 1u);
+    EXPECT_TRUE(replay.results[0].success);
+    EXPECT_EQ(replay.root->getComponentCount(), 2u);
+    ASSERT_NE(replay.root->getFocus(), nullptr);
+    EXPECT_EQ(replay.root->getFocus()->getId(), liveFocus);
+
+    ASSERT_EQ(report.frames.size(), 3u);
+    EXPECT_EQ(callbacks, 3u);
+    EXPECT_EQ(report.events, 4u);
+    EXPECT_EQ(report.commands, 1u);
+    EXPECT_EQ(report.frames[0].commands, 1u);
+    EXPECT_EQ(report.frames[1].events, 2u);
+    EXPECT_FLOAT_EQ(report.frames[2].dt, 0.016f);
+    EXPECT_GE(report.maxMs, report.p50Ms);
+    EXPECT_EQ(replay.receiver.getStats().commandsDispatched, 1u);
+    EXPECT_FALSE(hmi3::SessionReplayer::formatReport(report).empty());
+}
+
+TEST(SessionReplayerTest, StagedSceneIsSwappedInRecordedFrame) {
+    TempFile file;
+    std::string error;
+    {
+        hmi3::SessionRecorder recorder;
+        ASSERT_TRUE(recorder.open(file.path, error)) << error;
+        StagedPanel live;
+        live.root->setSessionRecorder(&recorder);
+        live.receiver.setSessionRecorder(&recorder);
+
+        live.receiver.inject(makeCommand(kProject));
+        live.receiver.pump();
+        live.root->update(0.016f);
+        auto scene = live.swap(*live.root);
+        ASSERT_NE(scene, nullptr);
+        recorder.recordScene(scene->command);
+        live.root->update(0.016f);
+        ASSERT_NE(live.root->findByPath("project/left"), nullptr);
+    }
+
+    hmi3::SessionRecording recording;
+    ASSERT_TRUE(recording.load(file.path, error)) << error;
+    const auto& records = recording.getRecords();
+    ASSERT_EQ(records.size(), 4u);
+    ASSERT_EQ(records[2].type, hmi3::SessionRecord::Type::Scene);
+    EXPECT_EQ(records[2].command.projectData, kProject);
+
+    // Без обработчика сцен подмены пропускаются
+    StagedPanel skipped;
+    hmi3::SessionReplayer replayer(recording);
+    auto report = replayer.run(*skipped.root, skipped.receiver);
+    EXPECT_EQ(report.scenes, 1u);
+    EXPECT_EQ(skipped.root->findByPath("project/left"), nullptr);
+
+    StagedPanel replay;
+    std::size_t swaps = 0;
+    replayer.setSceneCallback([&](hmi3::Container& tree, const hmi3::ProjectLoadCommand& command) {
+        auto scene = replay.swap(tree);
+        ASSERT_NE(scene, nullptr);
+        EXPECT_EQ(scene->command.projectData.view(), command.projectData.view());
+        ++swaps;
+    });
+    report = replayer.run(*replay.root, replay.receiver);
+    EXPECT_EQ(swaps, 1u);
+    EXPECT_EQ(report.commands, 1u);
+    EXPECT_EQ(report.scenes, 1u);
+    ASSERT_EQ(report.frames.size(), 2u);
+    EXPECT_EQ(report.frames[0].scenes, 0u);
+    EXPECT_EQ(report.frames[1].scenes, 1u);
+    EXPECT_NE(replay.root->findByPath("project/left"), nullptr);
+    EXPECT_NE(replay.root->findByPath("project/right"), nullptr);
+}
+
+TEST(SessionReplayerTest, PaceFollowsRecordingOnlyWhenAsked) {
+    TempFile file;
+    std::string error;
+    {
+        hmi3::SessionRecorder recorder;
+        ASSERT_TRUE(recorder.open(file.path, error)) << error;
+        for (int i = 0; i < 10; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            recorder.recordEvent(sf::Event(sf::Event::MouseMoved{{i, i}}));
+            recorder.recordUpdate(0.01f);
+        }
+    }
+    hmi3::SessionRecording recording;
+    ASSERT_TRUE(recording.load(file.path, error)) << error;
+    ASSERT_GE(recording.getDurationSeconds(), 0.1);
+
+    hmi3::SessionReplayer replayer(recording);
+    Panel recorded;
+    auto paced = replayer.run(*recorded.root, recorded.receiver, hmi3::SessionReplayer::Pace::Recorded);
+    Panel unthrottled;
+    auto fast = replayer.run(*unthrottled.root, unthrottled.receiver);
+
+    // Темп записи выдерживается сном, поэтому быстрее записи не бывает;
+    // без темпа повторяются те же кадры
+    EXPECT_GE(paced.wallSeconds, recording.getDurationSeconds());
+    EXPECT_EQ(paced.frames.size(), 10u);
+    EXPECT_EQ(fast.frames.size(), 10u);
+}
\ No newline at end of file
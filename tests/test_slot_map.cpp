@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "hmi3/slot_map.hpp"
+
+namespace {
+
+std::vector<int> collect(const hmi3::SlotMap<int>& map) {
+    std::vector<int> values;
+    map.forEach([&values](hmi3::SlotHandle, int value) { values.push_back(value); });
+    return values;
+}
+
+} // namespace
+
+TEST(SlotMapTest, StaleHandleDoesNotResolve) {
+    hmi3::SlotMap<std::string> map;
+    hmi3::SlotHandle first = map.insert("first");
+    ASSERT_TRUE(map.contains(first));
+    EXPECT_EQ(*map.get(first), "first");
+
+    EXPECT_TRUE(map.erase(first));
+    EXPECT_FALSE(map.erase(first));
+    EXPECT_EQ(map.get(first), nullptr);
+
+    // Слот переиспользуется с новым поколением
+    hmi3::SlotHandle second = map.insert("second");
+    EXPECT_EQ(second.index, first.index);
+    EXPECT_NE(second, first);
+    EXPECT_EQ(map.get(first), nullptr);
+    EXPECT_EQ(*map.get(second), "second");
+    EXPECT_FALSE(map.contains(hmi3::SlotHandle()));
+}
+
+TEST(SlotMapTest, EraseKeepsInsertionOrder) {
+    hmi3::SlotMap<int> map;
+    std::vector<hmi3::SlotHandle> handles;
+    for (int i = 0; i < 1000; ++i) {
+        handles.push_back(map.insert(i));
+    }
+    for (int i = 0; i < 1000; i += 3) {
+        map.erase(handles[i]);
+    }
+    // Вставки после массового удаления уплотняют массив
+    for (int i = 1000; i < 1100; ++i) {
+        handles.push_back(map.insert(i));
+    }
+
+    std::vector<int> expected;
+    for (int i = 0; i < 1100; ++i) {
+        if (i >= 1000 || i % 3 != 0) expected.push_back(i);
+    }
+    EXPECT_EQ(collect(map), expected);
+    EXPECT_EQ(map.size(), expected.size());
+    EXPECT_EQ(*map.get(handles[1]), 1);
+    EXPECT_EQ(*map.get(handles[1099]), 1099);
+}
+
+TEST(SlotMapTest, ModificationDuringIterationIsSafe) {
+    hmi3::SlotMap<int> map;
+    std::vector<hmi3::SlotHandle> handles;
+    for (int i = 0; i < 100; ++i) {
+        handles.push_back(map.insert(i));
+    }
+    for (int i = 0; i < 80; ++i) {
+        map.erase(handles[i]);
+    }
+
+    std::vector<int> visited;
+    map.forEach([&](hmi3::SlotHandle, int value) {
+        visited.push_back(value);
+        if (value == 80) {
+            map.erase(handles[81]);
+            map.insert(1000);
+        }
+    });
+
+    // Вставленный за проход элемент виден только следующему проходу
+    std::vector<int> expected{80};
+    for (int i = 82; i < 100; ++i) expected.push_back(i);
+    EXPECT_EQ(visited, expected);
+    expected.push_back(1000);
+    EXPECT_EQ(collect(map), expected);
+
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.get(handles[99]), nullptr);
+}
+
+TEST(SlotMapTest, ErasedValueLivesUntilHandlerReturns) {
+    hmi3::SlotMap<std::shared_ptr<int>> map;
+    map.insert(std::make_shared<int>(1));
+    std::weak_ptr<int> erased;
+    bool aliveInHandler = false;
+    map.forEach([&](hmi3::SlotHandle handle, const std::shared_ptr<int>& value) {
+        erased = value;
+        map.erase(handle);
+        aliveInHandler = !erased.expired() && *value == 1;
+    });
+    EXPECT_TRUE(aliveInHandler);
+    EXPECT_TRUE(erased.expired());
+    EXPECT_TRUE(map.empty());
+
+    // То же для clear() и moveToBack() посреди обхода
+    hmi3::SlotHandle first = map.insert(std::make_shared<int>(2));
+    map.insert(std::make_shared<int>(3));
+    std::vector<int> seen;
+    map.forEach([&](hmi3::SlotHandle handle, const std::shared_ptr<int>& value) {
+        if (handle == first) {
+            map.moveToBack(handle);
+            seen.push_back(*value);
+            map.clear();
+            seen.push_back(*value);
+            erased = value;
+        }
+    });
+    EXPECT_EQ(seen, (std::vector<int>{2, 2}));
+    EXPECT_TRUE(erased.expired());
+    EXPECT_TRUE(map.empty());
+}
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include "hmi3/components/component.hpp"
+#include "hmi3/spatial_grid.hpp"
+
+namespace {
+
+class GridComponent : public hmi3::Component {
+public:
+    explicit GridComponent(std::string id) : Component(std::move(id)) {}
+
+    void update(float) override {}
+    void handleEvent(const sf::Event&) override {}
+    void draw(sf::RenderTarget&, sf::RenderStates) const override {}
+};
+
+sf::FloatRect rect(float x, float y, float w, float h) {
+    return sf::FloatRect({x, y}, {w, h});
+}
+
+} // namespace
+
+TEST(SpatialGridTest, PointQueryReturnsOnlyContainingItems) {
+    hmi3::SpatialGrid grid(50.0f);
+    GridComponent a("a"), b("b"), c("c");
+    grid.insert(&a, rect(0, 0, 40, 40));
+    grid.insert(&b, rect(30, 30, 40, 40));
+    grid.insert(&c, rect(500, 500, 10, 10));
+
+    std::vector<hmi3::Component*> hits;
+    grid.query(sf::Vector2f(35, 35), hits);
+    std::sort(hits.begin(), hits.end());
+    std::vector<hmi3::Component*> expected{&a, &b};
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ(hits, expected);
+
+    hits.clear();
+    grid.query(sf::Vector2f(200, 200), hits);
+    EXPECT_TRUE(hits.empty());
+}
+
+TEST(SpatialGridTest, UpdateMovesItemBetweenCells) {
+    hmi3::SpatialGrid grid(50.0f);
+    GridComponent a("a");
+    grid.insert(&a, rect(0, 0, 20, 20));
+    grid.update(&a, rect(300, -300, 20, 20));
+
+    std::vector<hmi3::Component*> hits;
+    grid.query(sf::Vector2f(10, 10), hits);
+    EXPECT_TRUE(hits.empty());
+
+    grid.query(sf::Vector2f(310, -290), hits);
+    ASSERT_EQ(hits.size(), 1u);
+    EXPECT_EQ(hits[0], &a);
+
+    EXPECT_TRUE(grid.remove(&a));
+    EXPECT_FALSE(grid.remove(&a));
+    EXPECT_EQ(grid.size(), 0u);
+}
+
+TEST(SpatialGridTest, AreaQueryHasNoDuplicates) {
+    hmi3::SpatialGrid grid(10.0f, 4);
+    GridComponent spanning("spanning"), huge("huge"), outside("outside");
+    grid.insert(&spanning, rect(5, 5, 15, 15));
+    grid.insert(&huge, rect(-1000, -1000, 5000, 5000));
+    grid.insert(&outside, rect(100, 100, 5, 5));
+
+    std::vector<hmi3::Component*> hits;
+    grid.query(rect(0, 0, 30, 30), hits);
+    std::sort(hits.begin(), hits.end());
+    std::vector<hmi3::Component*> expected{&spanning, &huge};
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ(hits, expected);
+}
+
+TEST(SpatialGridTest, HugeAndNonFiniteBoundsStayInRange) {
+    hmi3::SpatialGrid grid(10.0f, 4);
+    GridComponent far("far"), infinite("infinite"), broken("broken"), near("near");
+    const float inf = std::numeric_limits<float>::infinity();
+    grid.insert(&far, rect(1e30f, -1e30f, 10, 10));
+    grid.insert(&infinite, rect(-inf, -inf, inf, inf));
+    grid.insert(&broken, rect(std::numeric_limits<float>::quiet_NaN(), 0, 10, 10));
+    grid.insert(&near, rect(0, 0, 10, 10));
+    EXPECT_EQ(grid.size(), 4u);
+
+    std::vector<hmi3::Component*> hits;
+    grid.query(sf::Vector2f(5, 5), hits);
+    EXPECT_NE(std::find(hits.begin(), hits.end(), &near), hits.end());
+    EXPECT_EQ(std::find(hits.begin(), hits.end(), &far), hits.end());
+
+    grid.update(&far, rect(1e30f, 1e30f, 10, 10));
+    EXPECT_TRUE(grid.remove(&far));
+    EXPECT_TRUE(grid.remove(&infinite));
+    EXPECT_TRUE(grid.remove(&broken));
+    EXPECT_EQ(grid.size(), 1u);
+}
+
+TEST(SpatialGridTest, PointQueryClampsLikeInsert) {
+    hmi3::SpatialGrid grid(10.0f, 4);
+    GridComponent far("far"), near("near");
+    // Все ячейки далёкого элемента зажимаются в одну крайнюю
+    grid.insert(&far, rect(1e12f, 0, 1e6f, 10));
+    grid.insert(&near, rect(0, 0, 10, 10));
+
+    std::vector<hmi3::Component*> hits;
+    grid.query(sf::Vector2f(1e12f + 5e5f, 5), hits);
+    EXPECT_EQ(hits, std::vector<hmi3::Component*>{&far});
+
+    const float inf = std::numeric_limits<float>::infinity();
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    hits.clear();
+    grid.query(sf::Vector2f(1e30f, -1e30f), hits);
+    grid.query(sf::Vector2f(-inf, inf), hits);
+    grid.query(sf::Vector2f(nan, nan), hits);
+    EXPECT_TRUE(hits.empty());
+}
\ No newline at end of file
@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "hmi3/tag_database.hpp"
+
+TEST(TagDatabaseTest, LatestValueWinsOncePerDispatch) {
+    hmi3::TagDatabase tags;
+    hmi3::TagId level = tags.addTag("tank1.level", 0.0);
+    hmi3::TagId idle = tags.addTag("tank1.pump", false);
+
+    std::vector<double> levels;
+    int idleCalls = 0;
+    auto levelSubscription = tags.subscribe(level, [&](hmi3::TagId, const hmi3::TagValue& value) {
+        levels.push_back(std::get<double>(value));
+    });
+    auto idleSubscription = tags.subscribe(idle, [&](hmi3::TagId, const hmi3::TagValue&) { ++idleCalls; });
+
+    EXPECT_TRUE(tags.publish(level, 1.0));
+    EXPECT_TRUE(tags.publish(level, 2.0));
+    EXPECT_TRUE(tags.publish(level, 3.0));
+
+    EXPECT_EQ(tags.dispatch(), 1u);
+    EXPECT_EQ(levels, std::vector<double>{3.0});
+    EXPECT_EQ(std::get<double>(tags.getValue(level)), 3.0);
+    EXPECT_EQ(idleCalls, 0);
+
+    EXPECT_EQ(tags.dispatch(), 0u);
+    EXPECT_EQ(levels.size(), 1u);
+}
+
+TEST(TagDatabaseTest, RejectsUnknownTagsAndWrongTypes) {
+    hmi3::TagDatabase tags(2);
+    hmi3::TagId name = tags.addTag("batch.name", std::string("none"));
+
+    EXPECT_EQ(tags.addTag("batch.name"), hmi3::TagDatabase::kInvalidTag);
+    EXPECT_EQ(tags.findTag("batch.name"), name);
+    EXPECT_EQ(tags.getTagName(name), "batch.name");
+
+    EXPECT_FALSE(tags.publish(name, 1.0));
+    EXPECT_FALSE(tags.publish(42, 1.0));
+    EXPECT_TRUE(tags.publish(name, "B-17"));
+
+    EXPECT_NE(tags.addTag("second"), hmi3::TagDatabase::kInvalidTag);
+    EXPECT_EQ(tags.addTag("third"), hmi3::TagDatabase::kInvalidTag);
+
+    tags.dispatch();
+    EXPECT_EQ(std::get<std::string>(tags.getValue(name)), "B-17");
+}
+
+TEST(TagDatabaseTest, SubscriptionEndsWithItsHandle) {
+    hmi3::TagDatabase tags;
+    hmi3::TagId tag = tags.addTag("valve.open", false);
+
+    int calls = 0;
+    hmi3::TagSubscription self;
+    {
+        auto subscription = tags.subscribe(tag, [&](hmi3::TagId, const hmi3::TagValue&) { ++calls; });
+        tags.publish(tag, true);
+        tags.dispatch();
+    }
+    tags.publish(tag, false);
+    tags.dispatch();
+    EXPECT_EQ(calls, 1);
+
+    // Отписка из собственного обработчика
+    self = tags.subscribe(tag, [&](hmi3::TagId, const hmi3::TagValue&) {
+        ++calls;
+        self.reset();
+    });
+    tags.publish(tag, true);
+    tags.dispatch();
+    tags.publish(tag, false);
+    tags.dispatch();
+    EXPECT_EQ(calls, 2);
+}
+
+TEST(TagDatabaseTest, HandlerOutlivesItsOwnUnsubscribe) {
+    hmi3::TagDatabase tags;
+    hmi3::TagId tag = tags.addTag("alarm.text", std::string());
+
+    // Захват больше встроенного буфера std::string и std::function:
+    // обработчик читает его после своей отписки
+    std::string prefix(64, '!');
+    std::vector<std::string> seen;
+    hmi3::TagSubscription self;
+    self = tags.subscribe(tag, [&self, &seen, prefix](hmi3::TagId, const hmi3::TagValue& value) {
+        self.reset();
+        seen.push_back(prefix + std::get<std::string>(value));
+    });
+    tags.publish(tag, "high");
+    tags.dispatch();
+    tags.publish(tag, "low");
+    tags.dispatch();
+    ASSERT_EQ(seen.size(), 1u);
+    EXPECT_EQ(seen[0], std::string(64, '!') + "high");
+}
+
+TEST(TagDatabaseTest, SubscriptionMayOutliveDatabase) {
+    hmi3::TagSubscription subscription;
+    {
+        hmi3::TagDatabase tags;
+        hmi3::TagId tag = tags.addTag("motor.speed", 0.0);
+        subscription = tags.subscribe(tag, [](hmi3::TagId, const hmi3::TagValue&) {});
+        EXPECT_TRUE(subscription.isActive());
+    }
+    EXPECT_FALSE(subscription.isActive());
+    subscription.reset();
+}
+
+TEST(TagDatabaseTest, TagsSpanSeveralBlocks) {
+    hmi3::TagDatabase tags(3000);
+    for (int i = 0; i < 3000; ++i) {
+        ASSERT_EQ(tags.addTag("tag" + std::to_string(i), static_cast<double>(i)), static_cast<hmi3::TagId>(i));
+    }
+    EXPECT_EQ(tags.addTag("overflow"), hmi3::TagDatabase::kInvalidTag);
+    EXPECT_TRUE(tags.publish(2999, 1.5));
+    tags.dispatch();
+    EXPECT_EQ(std::get<double>(tags.getValue(2999)), 1.5);
+    EXPECT_EQ(tags.getTagName(1500), "tag1500");
+}
+
+TEST(TagDatabaseTest, ConcurrentProducerIsCoalescedPerDispatch) {
+    // Пропускную способность и стоимость рассылки меряют BM_Tag* в hmi3_bench
+    const std::size_t tagCount = 20000;
+    const std::size_t subscribersPerTag = 5;
+    const std::size_t hotTags = 1000;
+    const std::size_t updates = 200000;
+
+    hmi3::TagDatabase tags(tagCount);
+    std::vector<hmi3::TagId> ids;
+    std::vector<hmi3::TagSubscription> subscriptions;
+    std::size_t handlerCalls = 0;
+    for (std::size_t i = 0; i < tagCount; ++i) {
+        ids.push_back(tags.addTag("tag" + std::to_string(i), 0.0));
+        for (std::size_t s = 0; s < subscribersPerTag; ++s) {
+            subscriptions.push_back(tags.subscribe(ids.back(),
+                [&handlerCalls](hmi3::TagId, const hmi3::TagValue&) { ++handlerCalls; }));
+        }
+    }
+
+    // Без изменений рассылка ничего не стоит, сколько бы ни было подписок
+    EXPECT_EQ(tags.dispatch(), 0u);
+    EXPECT_EQ(handlerCalls, 0u);
+
+    std::atomic<bool> done{false};
+    std::thread producer([&] {
+        for (std::size_t i = 0; i < updates; ++i) {
+            EXPECT_TRUE(tags.publish(ids[(i * 7919) % hotTags], static_cast<double>(i)));
+        }
+        done = true;
+    });
+
+    std::size_t notifiedTags = 0;
+    while (!done) {
+        notifiedTags += tags.dispatch();
+        std::this_thread::yield();
+    }
+    producer.join();
+    notifiedTags += tags.dispatch();
+    // Всё опубликованное уже разослано
+    EXPECT_EQ(tags.dispatch(), 0u);
+
+    // Коалесцирование: уведомлений не больше, чем обновлений, и каждое - всем подписчикам
+    EXPECT_LE(notifiedTags, updates);
+    EXPECT_EQ(handlerCalls, notifiedTags * subscribersPerTag);
+    for (std::size_t i = 0; i < hotTags; ++i) {
+        EXPECT_NE(std::get<double>(tags.getValue(ids[i])), 0.0);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include "hmi3/timing_wheel.hpp"
+
+TEST(TimingWheelTest, FiresAtDeadline) {
+    hmi3::TimingWheel<int> wheel(0.01, 16);
+    wheel.schedule(0.05, 1);
+    wheel.schedule(0.02, 2);
+    EXPECT_EQ(wheel.size(), 2u);
+
+    std::vector<int> expired;
+    wheel.advance(0.015, expired);
+    EXPECT_TRUE(expired.empty());
+    wheel.advance(0.02, expired);
+    EXPECT_EQ(expired, std::vector<int>{2});
+    wheel.advance(0.049, expired);
+    EXPECT_EQ(expired.size(), 1u);
+    wheel.advance(0.05, expired);
+    EXPECT_EQ(expired, (std::vector<int>{2, 1}));
+    EXPECT_TRUE(wheel.empty());
+}
+
+// Срок дальше оборота колеса ждёт нужного оборота
+TEST(TimingWheelTest, LongDeadlinesSurviveRotations) {
+    hmi3::TimingWheel<int> wheel(0.01, 8);
+    wheel.schedule(1.0, 7);
+    std::vector<int> expired;
+    double now = 0.0;
+    for (int frame = 0; frame < 99; ++frame) {
+        now += 0.01;
+        wheel.advance(now, expired);
+    }
+    EXPECT_TRUE(expired.empty());
+    wheel.advance(1.0 + 1e-9, expired);
+    EXPECT_EQ(expired, std::vector<int>{7});
+}
+
+TEST(TimingWheelTest, PastDeadlineFiresOnNextTick) {
+    hmi3::TimingWheel<int> wheel(0.01, 8);
+    std::vector<int> expired;
+    wheel.advance(0.5, expired);
+    wheel.schedule(0.1, 1);
+    wheel.advance(0.5, expired);
+    EXPECT_TRUE(expired.empty());
+    wheel.advance(0.51, expired);
+    EXPECT_EQ(expired, std::vector<int>{1});
+}
+
+// Скачок времени больше оборота: каждая запись срабатывает один раз
+TEST(TimingWheelTest, LargeJumpExpiresEverythingDue) {
+    hmi3::TimingWheel<int> wheel(0.01, 8);
+    for (int i = 0; i < 20; ++i) {
+        wheel.schedule(0.01 * (i + 1), i);
+    }
+    wheel.schedule(10.0, 100);
+    std::vector<int> expired;
+    wheel.advance(1.0, expired);
+    std::sort(expired.begin(), expired.end());
+    ASSERT_EQ(expired.size(), 20u);
+    EXPECT_EQ(expired.front(), 0);
+    EXPECT_EQ(expired.back(), 19);
+    EXPECT_EQ(wheel.size(), 1u);
+}
+
+// Бесконечный и сверхдальний срок не переполняет номер тика и не наступает
+TEST(TimingWheelTest, InfiniteDeadlineNeverFires) {
+    hmi3::TimingWheel<int> wheel(0.01, 8);
+    wheel.schedule(std::numeric_limits<double>::infinity(), 1);
+    wheel.schedule(1e300, 2);
+    wheel.schedule(0.05, 3);
+    std::vector<int> expired;
+    wheel.advance(1e6, expired);
+    wheel.advance(std::numeric_limits<double>::quiet_NaN(), expired);
+    EXPECT_EQ(expired, std::vector<int>{3});
+    EXPECT_EQ(wheel.size(), 2u);
+}
\ No newline at end of file
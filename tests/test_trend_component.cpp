@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "hmi3/component_factory.hpp"
+#include "hmi3/components/trend_component.hpp"
+#include "hmi3/render_batch.hpp"
+
+namespace {
+
+std::vector<float> makeNoise(std::size_t count, unsigned seed) {
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<float> value(-50.0f, 150.0f);
+    std::vector<float> samples(count);
+    for (auto& sample : samples) {
+        sample = value(random);
+    }
+    return samples;
+}
+
+void expectSameBuckets(const std::deque<hmi3::TrendComponent::Bucket>& actual,
+                       const std::deque<hmi3::TrendComponent::Bucket>& expected) {
+    ASSERT_EQ(actual.size(), expected.size());
+    for (std::size_t i = 0; i < actual.size(); ++i) {
+        EXPECT_EQ(actual[i].min, expected[i].min) << "bucket " << i;
+        EXPECT_EQ(actual[i].max, expected[i].max) << "bucket " << i;
+    }
+}
+
+} // namespace
+
+TEST(TrendComponentTest, FindMinMaxMatchesScalarScan) {
+    auto samples = makeNoise(1000, 1);
+    for (std::size_t count : {1u, 3u, 15u, 16u, 17u, 64u, 333u, 1000u}) {
+        for (std::size_t offset : {0u, 1u, 3u}) {
+            std::size_t size = std::min(count, samples.size() - offset);
+            auto expected = std::minmax_element(samples.begin() + offset, samples.begin() + offset + size);
+            float min = 0.0f;
+            float max = 0.0f;
+            hmi3::findMinMax(samples.data() + offset, size, min, max);
+            EXPECT_EQ(min, *expected.first) << count << "+" << offset;
+            EXPECT_EQ(max, *expected.second) << count << "+" << offset;
+        }
+    }
+}
+
+TEST(TrendComponentTest, DecimationKeepsSpikes) {
+    hmi3::TrendComponent trend("trend", 4096);
+    std::size_t pen = trend.addPen(sf::Color::Green);
+    std::vector<float> samples(4096, 50.0f);
+    samples[1234] = 90.0f;
+    samples[3000] = 10.0f;
+    trend.addSamples(pen, samples.data(), samples.size());
+
+    const auto& buckets = trend.getBuckets(pen, 64);
+    ASSERT_EQ(buckets.size(), 64u);
+    EXPECT_EQ(buckets[1234 / 64].max, 90.0f);
+    EXPECT_EQ(buckets[1234 / 64].min, 50.0f);
+    EXPECT_EQ(buckets[3000 / 64].min, 10.0f);
+    EXPECT_EQ(buckets[0].min, 50.0f);
+    EXPECT_EQ(buckets[0].max, 50.0f);
+}
+
+TEST(TrendComponentTest, ExpiredSpikeLeavesOldestBucket) {
+    hmi3::TrendComponent trend("trend", 8);
+    trend.addPen(sf::Color::Red);
+    trend.addSample(0, 90.0f);
+    for (int i = 0; i < 7; ++i) {
+        trend.addSample(0, 50.0f);
+    }
+    EXPECT_EQ(trend.getBuckets(0, 4).front().max, 90.0f);
+
+    // Всплеск перезаписан в кольце, корзина [0, 4) держит только 1..3
+    trend.addSample(0, 50.0f);
+    const auto& buckets = trend.getBuckets(0, 4);
+    ASSERT_EQ(buckets.size(), 3u);
+    EXPECT_EQ(buckets.front().max, 50.0f);
+    EXPECT_EQ(buckets.front().min, 50.0f);
+}
+
+// Ряд, дополнявшийся по мере прихода выборок, совпадает с построенным с нуля,
+// в том числе после переполнения кольца
+TEST(TrendComponentTest, IncrementalUpdateMatchesFullRebuild) {
+    const std::size_t capacity = 1000;
+    auto samples = makeNoise(3500, 2);
+
+    hmi3::TrendComponent incremental("a", capacity);
+    incremental.addPen(sf::Color::Red);
+    std::mt19937 random(3);
+    std::size_t updates = 0;
+    for (std::size_t offset = 0; offset < samples.size();) {
+        std::size_t count = std::min<std::size_t>(random() % 97 + 1, samples.size() - offset);
+        incremental.addSamples(0, samples.data() + offset, count);
+        offset += count;
+        incremental.getBuckets(0, 16);
+        ++updates;
+    }
+
+    hmi3::TrendComponent rebuilt("b", capacity);
+    rebuilt.addPen(sf::Color::Red);
+    rebuilt.addSamples(0, samples.data(), samples.size());
+
+    // Включая самую старую корзину, наполовину ушедшую из окна
+    expectSameBuckets(incremental.getBuckets(0, 16), rebuilt.getBuckets(0, 16));
+
+    auto stats = incremental.getStats();
+    EXPECT_EQ(stats.levelBuilds, 1u);
+    // Каждая выборка просмотрена один раз, плюс пересчёт корзины на границе
+    // окна при каждом обновлении
+    EXPECT_LE(stats.scannedSamples, samples.size() + updates * 15);
+    EXPECT_EQ(incremental.getSampleCount(0), capacity);
+}
+
+TEST(TrendComponentTest, CachesLevelsPerZoom) {
+    hmi3::TrendComponent trend("trend", 10000);
+    trend.addPen(sf::Color::White);
+    auto samples = makeNoise(10000, 4);
+    trend.addSamples(0, samples.data(), samples.size());
+
+    trend.getBuckets(0, 64);
+    trend.getBuckets(0, 64);
+    EXPECT_EQ(trend.getStats().levelBuilds, 1u);
+    EXPECT_EQ(trend.getStats().scannedSamples, 10000u);
+
+    // Новая выборка и 63 оставшиеся в первой корзине после сдвига окна
+    trend.addSample(0, 1.0f);
+    trend.getBuckets(0, 64);
+    EXPECT_EQ(trend.getStats().levelBuilds, 1u);
+    EXPECT_EQ(trend.getStats().scannedSamples, 10001u + 63u);
+
+    for (std::size_t size : {2u, 4u, 8u, 16u}) {
+        trend.getBuckets(0, size);
+    }
+    EXPECT_EQ(trend.getStats().levelBuilds, 5u);
+    // 64 вытеснен как самый давний
+    trend.getBuckets(0, 64);
+    EXPECT_EQ(trend.getStats().levelBuilds, 6u);
+}
+
+TEST(TrendComponentTest, DrawsAboutOneColumnPerPixel) {
+    hmi3::TrendComponent trend("trend", 100000);
+    trend.setSize({200.0f, 100.0f});
+    trend.setRange(-50.0f, 150.0f);
+    auto samples = makeNoise(100000, 5);
+    for (int pen = 0; pen < 2; ++pen) {
+        trend.addPen(sf::Color::Yellow);
+        trend.addSamples(static_cast<std::size_t>(pen), samples.data(), samples.size());
+    }
+
+    hmi3::RenderBatch batch;
+    ASSERT_TRUE(trend.appendGeometry(batch));
+    std::size_t columns = batch.getVertexCount() / 6 / 2;
+    EXPECT_GE(columns, 200u);
+    EXPECT_LE(columns, 401u);
+    EXPECT_EQ(batch.getBatchCount(), 1u);
+
+    // Выборок в окне меньше, чем пикселей - столбец на выборку
+    trend.setVisibleSamples(50);
+    batch.clear();
+    trend.appendGeometry(batch);
+    EXPECT_EQ(batch.getVertexCount(), 50u * 6 * 2);
+}
+
+TEST(TrendComponentTest, CreatedByFactoryWithProperties) {
+    auto component = hmi3::ComponentFactory::withBuiltins().create("trend", "t1");
+    ASSERT_NE(component, nullptr);
+    EXPECT_TRUE(component->applyProperty("range", "0,10"));
+    EXPECT_FALSE(component->applyProperty("range", "10,0"));
+    EXPECT_TRUE(component->applyProperty("visibleSamples", "600"));
+    EXPECT_TRUE(component->applyProperty("background", "0,0,0"));
+    EXPECT_EQ(std::static_pointer_cast<hmi3::TrendComponent>(component)->getVisibleSamples(), 600u);
+}
\ No newline at end of file
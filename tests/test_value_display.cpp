@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "hmi3/component_factory.hpp"
+#include "hmi3/components/value_display_component.hpp"
+#include "hmi3/render_batch.hpp"
+
+TEST(ValueDisplayTest, FormatsValueWithPrecisionAndUnit) {
+    hmi3::ValueDisplayComponent display("pressure");
+    EXPECT_EQ(display.getText(), "0.0");
+
+    display.setPrecision(2);
+    display.setValue(3.14159);
+    EXPECT_EQ(display.getText(), "3.14");
+
+    display.setUnit(" bar");
+    display.setValue(-12.5);
+    EXPECT_EQ(display.getText(), "-12.50 bar");
+
+    // Не влезает в буфер
+    display.setPrecision(9);
+    display.setValue(1e30);
+    EXPECT_EQ(display.getText(), "#### bar");
+}
+
+TEST(ValueDisplayTest, RewritesOnlyChangedGlyphs) {
+    auto font = std::make_shared<sf::Font>();
+    hmi3::ValueDisplayComponent display("flow");
+    display.setFont(font, 20);
+    display.setValue(12.5);
+    std::uint64_t writes = display.getGlyphWrites();
+
+    display.setValue(12.7);
+    EXPECT_EQ(display.getGlyphWrites(), writes + 1);
+    display.setValue(13.7);
+    EXPECT_EQ(display.getGlyphWrites(), writes + 2);
+
+    // То же показание - квады не трогаются
+    display.setValue(13.71);
+    EXPECT_EQ(display.getGlyphWrites(), writes + 2);
+
+    hmi3::RenderBatch batch;
+    display.appendGeometry(batch);
+    EXPECT_EQ(batch.getVertexCount(), display.getText().size() * 6);
+}
+
+TEST(ValueDisplayTest, ReadoutsShareOneGlyphBatch) {
+    auto font = std::make_shared<sf::Font>();
+    std::vector<std::unique_ptr<hmi3::ValueDisplayComponent>> readouts;
+    for (int i = 0; i < 100; ++i) {
+        auto display = std::make_unique<hmi3::ValueDisplayComponent>("v" + std::to_string(i));
+        display->setFont(font, 14);
+        display->setPosition({0.0f, 16.0f * i});
+        display->setValue(i * 1.5);
+        readouts.push_back(std::move(display));
+    }
+
+    hmi3::RenderBatch batch;
+    std::size_t vertices = 0;
+    for (const auto& display : readouts) {
+        ASSERT_TRUE(display->appendGeometry(batch));
+        vertices += display->getText().size() * 6;
+    }
+    EXPECT_EQ(batch.getBatchCount(), 1u);
+    EXPECT_EQ(batch.getVertexCount(), vertices);
+
+    // Общий кэш глифов на шрифт и размер
+    EXPECT_EQ(hmi3::GlyphCache::get(font, 14), hmi3::GlyphCache::get(font, 14));
+    EXPECT_NE(hmi3::GlyphCache::get(font, 14), hmi3::GlyphCache::get(font, 15));
+}
+
+TEST(ValueDisplayTest, WithoutFontDrawsNothing) {
+    hmi3::ValueDisplayComponent display("level");
+    display.setValue(42.0);
+
+    hmi3::RenderBatch batch;
+    EXPECT_TRUE(display.appendGeometry(batch));
+    EXPECT_EQ(batch.getVertexCount(), 0u);
+    EXPECT_EQ(display.getText(), "42.0");
+}
+
+TEST(ValueDisplayTest, CreatedByFactoryWithProperties) {
+    auto component = hmi3::ComponentFactory::withBuiltins().create("value", "v1");
+    ASSERT_NE(component, nullptr);
+    EXPECT_TRUE(component->applyProperty("precision", "3"));
+    EXPECT_TRUE(component->applyProperty("value", "2.5"));
+    EXPECT_TRUE(component->applyProperty("unit", " m3/h"));
+    EXPECT_TRUE(component->applyProperty("align", "left"));
+    EXPECT_FALSE(component->applyProperty("align", "center"));
+    EXPECT_FALSE(component->applyProperty("font", "no/such/font.ttf"));
+    EXPECT_EQ(std::static_pointer_cast<hmi3::ValueDisplayComponent>(component)->getText(), "2.500 m3/h");
+}
\ No newline at end of file
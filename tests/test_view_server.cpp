@@ -0,0 +1,333 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <SFML/Network.hpp>
+#include "hmi3/container.hpp"
+#include "hmi3/view_protocol.hpp"
+#include "hmi3/view_server.hpp"
+
+namespace {
+
+class ClickCounter : public hmi3::Component {
+public:
+    explicit ClickCounter(std::string id) : Component(std::move(id)) {}
+    void update(float) override {}
+    void handleEvent(const sf::Event& event) override {
+        if (event.is<sf::Event::MouseButtonPressed>()) ++clicks;
+    }
+    void draw(sf::RenderTarget&, sf::RenderStates) const override {}
+
+    int clicks = 0;
+};
+
+// Кадр: однотонный фон и шумная полоса, которая сжимается плохо
+std::vector<std::uint8_t> makeImage(unsigned width, unsigned height, unsigned seed) {
+    std::vector<std::uint8_t> pixels(static_cast<std::size_t>(width) * height * 4);
+    std::mt19937 random(seed);
+    for (unsigned y = 0; y < height; ++y) {
+        for (unsigned x = 0; x < width; ++x) {
+            std::uint8_t* pixel = &pixels[(static_cast<std::size_t>(y) * width + x) * 4];
+            if (y < 32) {
+                for (int c = 0; c < 4; ++c) pixel[c] = static_cast<std::uint8_t>(random());
+            } else {
+                pixel[0] = 40;
+                pixel[1] = 40;
+                pixel[2] = 80;
+                pixel[3] = 255;
+            }
+        }
+    }
+    return pixels;
+}
+
+template <typename Predicate>
+bool waitUntil(Predicate predicate) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+class TestViewer {
+public:
+    bool connect(unsigned short port) {
+        if (m_socket.connect(sf::IpAddress::LocalHost, port) != sf::Socket::Status::Done) return false;
+        m_socket.setBlocking(false);
+        return true;
+    }
+
+    // false - кадр не пришёл или поток повреждён
+    bool readFrame() {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        for (;;) {
+            while (m_offset < m_data.size()) {
+                std::size_t consumed = 0;
+                auto result = decoder.feed(m_data.data() + m_offset, m_data.size() - m_offset, consumed);
+                m_offset += consumed;
+                if (result == hmi3::ViewDecoder::Result::FrameReady) return true;
+                if (result == hmi3::ViewDecoder::Result::ProtocolError) return false;
+            }
+            char buffer[65536];
+            std::size_t received = 0;
+            auto status = m_socket.receive(buffer, sizeof(buffer), received);
+            if (status == sf::Socket::Status::Done) {
+                m_data.assign(buffer, received);
+                m_offset = 0;
+            } else if (status == sf::Socket::Status::NotReady) {
+                if (std::chrono::steady_clock::now() > deadline) return false;
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            } else {
+                return false;
+            }
+        }
+    }
+
+    bool sendInput(const sf::Event& event) {
+        std::string message;
+        hmi3::appendViewMessage(message, hmi3::view::Input, hmi3::encodeInputEvent(event));
+        m_socket.setBlocking(true);
+        bool sent = m_socket.send(message.data(), message.size()) == sf::Socket::Status::Done;
+        m_socket.setBlocking(false);
+        return sent;
+    }
+
+    hmi3::ViewDecoder decoder;
+
+private:
+    sf::TcpSocket m_socket;
+    std::string m_data;
+    std::size_t m_offset = 0;
+};
+
+class ViewServerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        server.setMaxFrameRate(0);
+        ASSERT_TRUE(server.start());
+    }
+
+    void connect(TestViewer& viewer, std::size_t expectedViewers = 1) {
+        ASSERT_TRUE(viewer.connect(server.getLocalPort()));
+        ASSERT_TRUE(waitUntil([&] { return server.getViewerCount() == expectedViewers; }));
+    }
+
+    hmi3::ViewServer server{0, 32};
+};
+
+} // namespace
+
+TEST(ViewProtocolTest, TilesRoundTripInSmallChunks) {
+    const unsigned width = 100, height = 70, tile = 32;
+    auto pixels = makeImage(width, height, 1);
+
+    std::string stream;
+    hmi3::appendViewMessage(stream, hmi3::view::Hello, std::string(hmi3::view::kMagic, 4) + '\x01');
+    std::string begin(14, '\0');
+    begin[4] = static_cast<char>(width);
+    begin[6] = static_cast<char>(height);
+    begin[8] = static_cast<char>(tile);
+    hmi3::appendViewMessage(stream, hmi3::view::FrameBegin, begin);
+    for (unsigned row = 0; row * tile < height; ++row) {
+        for (unsigned column = 0; column * tile < width; ++column) {
+            hmi3::PixelRect rect{pixels.data(), width, column * tile, row * tile,
+                                 std::min(tile, width - column * tile), std::min(tile, height - row * tile)};
+            std::size_t before = stream.size();
+            hmi3::appendTileMessage(stream, column, row, rect);
+            // Шумная полоса идёт как есть, заливка - сериями
+            std::size_t raw = static_cast<std::size_t>(rect.width) * rect.height * 4;
+            if (row == 0) {
+                EXPECT_EQ(stream[before + 9], static_cast<char>(hmi3::view::Raw));
+            } else {
+                EXPECT_EQ(stream[before + 9], static_cast<char>(hmi3::view::Rle));
+                EXPECT_LT(stream.size() - before, raw / 2);
+            }
+        }
+    }
+    hmi3::appendViewMessage(stream, hmi3::view::FrameEnd, std::string());
+
+    hmi3::ViewDecoder decoder;
+    hmi3::ViewDecoder::Result result = hmi3::ViewDecoder::Result::NeedMoreData;
+    for (std::size_t i = 0; i < stream.size(); i += 7) {
+        std::size_t consumed = 0;
+        result = decoder.feed(stream.data() + i, std::min<std::size_t>(7, stream.size() - i), consumed);
+        ASSERT_NE(result, hmi3::ViewDecoder::Result::ProtocolError) << decoder.getError();
+    }
+    ASSERT_EQ(result, hmi3::ViewDecoder::Result::FrameReady);
+    EXPECT_EQ(decoder.getTileCount(), 12u);
+    EXPECT_EQ(decoder.getPixels(), pixels);
+}
+
+TEST(ViewProtocolTest, RejectsForeignStream) {
+    hmi3::ViewDecoder decoder;
+    std::size_t consumed = 0;
+    const char garbage[] = "GET / HTTP/1.1\r\n\r\n";
+    EXPECT_EQ(decoder.feed(garbage, sizeof(garbage) - 1, consumed), hmi3::ViewDecoder::Result::ProtocolError);
+}
+
+TEST(ViewProtocolTest, InputEventsRoundTrip) {
+    sf::Event::KeyPressed key;
+    key.code = sf::Keyboard::Key::P;
+    key.control = true;
+    key.shift = true;
+    std::string body = hmi3::encodeInputEvent(key);
+    auto decoded = hmi3::decodeInputEvent(body.data(), body.size());
+    ASSERT_TRUE(decoded.has_value());
+    ASSERT_TRUE(decoded->is<sf::Event::KeyPressed>());
+    EXPECT_EQ(decoded->getIf<sf::Event::KeyPressed>()->code, sf::Keyboard::Key::P);
+    EXPECT_TRUE(decoded->getIf<sf::Event::KeyPressed>()->control);
+    EXPECT_FALSE(decoded->getIf<sf::Event::KeyPressed>()->alt);
+
+    body = hmi3::encodeInputEvent(sf::Event::MouseWheelScrolled{sf::Mouse::Wheel::Vertical, -1.5f, {-3, 40}});
+    decoded = hmi3::decodeInputEvent(body.data(), body.size());
+    ASSERT_TRUE(decoded.has_value());
+    const auto* wheel = decoded->getIf<sf::Event::MouseWheelScrolled>();
+    ASSERT_NE(wheel, nullptr);
+    EXPECT_FLOAT_EQ(wheel->delta, -1.5f);
+    EXPECT_EQ(wheel->position, sf::Vector2i(-3, 40));
+
+    // Окно зрителя закрывается локально и на сервер не пересылается
+    EXPECT_TRUE(hmi3::encodeInputEvent(sf::Event::Closed{}).empty());
+    EXPECT_FALSE(hmi3::decodeInputEvent(body.data(), body.size() - 1).has_value());
+}
+
+TEST_F(ViewServerTest, NothingIsPublishedWithoutViewers) {
+    auto pixels = makeImage(64, 64, 1);
+    EXPECT_FALSE(server.publishFrame(pixels.data(), 64, 64));
+    EXPECT_EQ(server.getStats().framesPublished, 0u);
+}
+
+TEST_F(ViewServerTest, ViewerReconstructsFrame) {
+    TestViewer viewer;
+    connect(viewer);
+
+    auto pixels = makeImage(100, 70, 1);
+    ASSERT_TRUE(server.publishFrame(pixels.data(), 100, 70));
+    ASSERT_TRUE(viewer.readFrame()) << viewer.decoder.getError();
+    EXPECT_EQ(viewer.decoder.getWidth(), 100u);
+    EXPECT_EQ(viewer.decoder.getHeight(), 70u);
+    EXPECT_EQ(viewer.decoder.getTileCount(), 12u);
+    EXPECT_EQ(viewer.decoder.getPixels(), pixels);
+}
+
+TEST_F(ViewServerTest, NextFrameCarriesOnlyChangedTiles) {
+    TestViewer viewer;
+    connect(viewer);
+
+    auto pixels = makeImage(100, 70, 1);
+    ASSERT_TRUE(server.publishFrame(pixels.data(), 100, 70));
+    ASSERT_TRUE(viewer.readFrame());
+
+    // Один пиксель в плитке (2, 1) и кадр без изменений
+    pixels[(40 * 100 + 70) * 4] ^= 0xFF;
+    ASSERT_TRUE(server.publishFrame(pixels.data(), 100, 70));
+    ASSERT_TRUE(viewer.readFrame());
+    EXPECT_EQ(viewer.decoder.getTileCount(), 1u);
+    EXPECT_EQ(viewer.decoder.getPixels(), pixels);
+
+    ASSERT_TRUE(waitUntil([&] { return server.getStats().framesSent == 2; }));
+    ASSERT_TRUE(server.publishFrame(pixels.data(), 100, 70));
+    pixels[(60 * 100 + 5) * 4] ^= 0xFF;
+    ASSERT_TRUE(server.publishFrame(pixels.data(), 100, 70));
+    ASSERT_TRUE(viewer.readFrame());
+    EXPECT_EQ(viewer.decoder.getTileCount(), 1u);
+    EXPECT_EQ(viewer.decoder.getPixels(), pixels);
+    EXPECT_EQ(server.getStats().tilesSent, 14u);
+}
+
+TEST_F(ViewServerTest, FrameRateLimitsPublishing) {
+    TestViewer viewer;
+    connect(viewer);
+    server.setMaxFrameRate(10);
+
+    auto pixels = makeImage(64, 64, 1);
+    EXPECT_TRUE(server.publishFrame(pixels.data(), 64, 64));
+    EXPECT_FALSE(server.publishFrame(pixels.data(), 64, 64));
+    std::this_thread::sleep_for(std::chrono::milliseconds(120));
+    EXPECT_TRUE(server.publishFrame(pixels.data(), 64, 64));
+}
+
+TEST_F(ViewServerTest, BindsToLocalhostAndIgnoresInputByDefault) {
+    EXPECT_EQ(server.getBindAddress(), sf::IpAddress::LocalHost);
+    EXPECT_FALSE(server.isInputEnabled());
+
+    TestViewer viewer;
+    connect(viewer);
+    hmi3::Container root("root");
+    auto button = std::make_shared<ClickCounter>("button");
+    button->setSize({50, 20});
+    root.addComponent(button);
+
+    ASSERT_TRUE(viewer.sendInput(sf::Event::MouseButtonPressed{sf::Mouse::Button::Left, {20, 15}}));
+    ASSERT_TRUE(waitUntil([&] { return server.getStats().inputIgnored == 1; }));
+    EXPECT_EQ(server.pumpInput(root), 0u);
+    EXPECT_EQ(button->clicks, 0);
+}
+
+TEST_F(ViewServerTest, RejectsFramesWiderThanProtocolAllows) {
+    TestViewer viewer;
+    connect(viewer);
+
+    std::vector<std::uint8_t> pixels(static_cast<std::size_t>(hmi3::view::kMaxFrameSize + 1) * 4);
+    EXPECT_FALSE(server.publishFrame(pixels.data(), hmi3::view::kMaxFrameSize + 1, 1));
+    EXPECT_EQ(server.getStats().framesPublished, 0u);
+}
+
+TEST_F(ViewServerTest, ViewerInputIsDeliveredOnPump) {
+    server.setInputEnabled(true);
+    TestViewer viewer;
+    connect(viewer);
+
+    hmi3::Container root("root");
+    auto button = std::make_shared<ClickCounter>("button");
+    button->setPosition({10, 10});
+    button->setSize({50, 20});
+    root.addComponent(button);
+
+    ASSERT_TRUE(viewer.sendInput(sf::Event::MouseButtonPressed{sf::Mouse::Button::Left, {20, 15}}));
+    // Событие не трогает дерево, пока поток отрисовки его не заберёт
+    std::size_t delivered = 0;
+    ASSERT_TRUE(waitUntil([&] {
+        delivered += server.pumpInput(root);
+        return delivered > 0;
+    }));
+    EXPECT_EQ(delivered, 1u);
+    EXPECT_EQ(button->clicks, 1);
+}
+
+TEST_F(ViewServerTest, StalledViewerDoesNotBlockPublishing) {
+    TestViewer stalled;
+    connect(stalled);
+    TestViewer active;
+    connect(active, 2);
+
+    // Зритель, который не читает, быстро заполняет буферы сокета;
+    // публикация при этом не ждёт ни его, ни поток отправки
+    const unsigned size = 512;
+    for (unsigned i = 0; i < 100; ++i) {
+        auto pixels = makeImage(size, size, i);
+        std::mt19937 random(i);
+        for (auto& byte : pixels) byte = static_cast<std::uint8_t>(random());
+        ASSERT_TRUE(server.publishFrame(pixels.data(), size, size));
+    }
+
+    // Второй зритель получает последний кадр, пропуская промежуточные
+    auto last = makeImage(size, size, 1000);
+    ASSERT_TRUE(server.publishFrame(last.data(), size, size));
+    bool gotLast = false;
+    for (int i = 0; i < 200 && !gotLast; ++i) {
+        ASSERT_TRUE(active.readFrame());
+        gotLast = active.decoder.getPixels() == last;
+    }
+    EXPECT_TRUE(gotLast);
+
+    // Остановка не ждёт, пока зритель дочитает
+    server.stop();
+    EXPECT_EQ(server.getViewerCount(), 0u);
+}
\ No newline at end of file
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "hmi3/container.hpp"
+#include "hmi3/worker_pool.hpp"
+
+namespace {
+
+// Синтетический тяжёлый компонент: считает в update(), публикует в commitUpdate()
+class HeavyComponent : public hmi3::Component {
+public:
+    HeavyComponent(std::string id, int work, std::vector<double>& sink, std::size_t slot)
+        : Component(std::move(id)), m_work(work), m_sink(sink), m_slot(slot) {}
+
+    bool isUpdateThreadSafe() const override { return true; }
+
+    void update(float dt) override {
+        double value = m_state;
+        for (int i = 0; i < m_work; ++i) {
+            value = std::sin(value + dt) * 0.5 + std::sqrt(static_cast<double>(i % 17) + value * value);
+        }
+        m_state = value;
+    }
+
+    void commitUpdate() override { m_sink[m_slot] = m_state; }
+
+    void handleEvent(const sf::Event&) override {}
+    void draw(sf::RenderTarget&, sf::RenderStates) const override {}
+
+private:
+    int m_work;
+    double m_state = 0.0;
+    std::vector<double>& m_sink;
+    std::size_t m_slot;
+};
+
+// Обычный компонент видит результаты фиксации
+class ReaderComponent : public hmi3::Component {
+public:
+    ReaderComponent(std::vector<double>& sink) : Component("reader"), m_sink(sink) {}
+
+    void update(float) override { seen = m_sink; }
+    void handleEvent(const sf::Event&) override {}
+    void draw(sf::RenderTarget&, sf::RenderStates) const override {}
+
+    std::vector<double> seen;
+
+private:
+    std::vector<double>& m_sink;
+};
+
+} // namespace
+
+TEST(WorkerPoolTest, ParallelForVisitsEveryIndexOnce) {
+    hmi3::WorkerPool pool(3);
+    std::vector<std::atomic<int>> visits(10007);
+    for (auto& visit : visits) visit = 0;
+
+    pool.parallelFor(visits.size(), [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) ++visits[i];
+    }, 64);
+
+    for (auto& visit : visits) {
+        ASSERT_EQ(visit.load(), 1);
+    }
+}
+
+TEST(WorkerPoolTest, ExceptionReachesCaller) {
+    hmi3::WorkerPool pool(2);
+    EXPECT_THROW(pool.parallelFor(1000, [](std::size_t begin, std::size_t) {
+        if (begin >= 500) throw std::runtime_error("chunk failed");
+    }, 10), std::runtime_error);
+
+    // Пул остаётся рабочим
+    std::atomic<std::size_t> total{0};
+    pool.parallelFor(100, [&](std::size_t begin, std::size_t end) { total += end - begin; }, 10);
+    EXPECT_EQ(total.load(), 100u);
+}
+
+TEST(WorkerPoolTest, NestedParallelForRunsInline) {
+    hmi3::WorkerPool pool(2);
+    std::atomic<std::size_t> total{0};
+    pool.parallelFor(8, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            pool.parallelFor(10, [&](std::size_t b, std::size_t e) { total += e - b; });
+        }
+    }, 1);
+    EXPECT_EQ(total.load(), 80u);
+}
+
+TEST(WorkerPoolTest, ParallelUpdateMatchesSerial) {
+    // Ускорение меряет BM_ContainerUpdateParallel в hmi3_bench
+    const std::size_t count = 400;
+    const int work = 2000;
+    const int frames = 5;
+
+    auto run = [&](hmi3::WorkerPool* pool, std::vector<double>& sink) {
+        hmi3::Container screen("screen");
+        screen.setWorkerPool(pool);
+        auto panel = std::make_shared<hmi3::Container>("panel");
+        screen.addComponent(panel);
+        for (std::size_t i = 0; i < count; ++i) {
+            // Разная стоимость - чтобы была неравномерная нагрузка
+            auto heavy = std::make_shared<HeavyComponent>("h" + std::to_string(i), work * (1 + i % 3), sink, i);
+            (i % 2 ? screen : *panel).addComponent(heavy);
+        }
+        auto reader = std::make_shared<ReaderComponent>(sink);
+        screen.addComponent(reader);
+
+        for (int frame = 0; frame < frames; ++frame) {
+            screen.update(0.016f);
+        }
+        return reader->seen;
+    };
+
+    std::vector<double> serialSink(count), parallelSink(count);
+    auto serialSeen = run(nullptr, serialSink);
+
+    hmi3::WorkerPool pool;
+    auto parallelSeen = run(&pool, parallelSink);
+
+    // Детерминизм: побитово те же результаты и та же картина в последовательной фазе
+    EXPECT_EQ(serialSink, parallelSink);
+    EXPECT_EQ(serialSeen, parallelSeen);
+    EXPECT_EQ(parallelSeen, parallelSink);
+}
\ No newline at end of file
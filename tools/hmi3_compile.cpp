@@ -0,0 +1,72 @@
+// Компилятор проектов: текстовое описание -> файл для CompiledProject
+//
+//   hmi3_compile project.txt project.hmi3c [--version N]
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "hmi3/compiled_project.hpp"
+#include "hmi3/project_description.hpp"
+
+int main(int argc, char* argv[]) {
+    std::string input;
+    std::string output;
+    std::uint32_t version = 1;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--version" && i + 1 < argc) {
+            version = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (input.empty()) {
+            input = arg;
+        } else if (output.empty()) {
+            output = arg;
+        } else {
+            input.clear();
+            break;
+        }
+    }
+    if (input.empty() || output.empty()) {
+        std::cerr << "Usage: hmi3_compile <project.txt> <project.hmi3c> [--version N]" << std::endl;
+        return 2;
+    }
+
+    std::ifstream in(input, std::ios::binary);
+    if (!in) {
+        std::cerr << "Cannot read " << input << std::endl;
+        return 1;
+    }
+    std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    hmi3::ProjectDescription description;
+    std::string error;
+    if (!hmi3::parseProject(text, description, error)) {
+        std::cerr << input << ": " << error << std::endl;
+        return 1;
+    }
+
+    std::vector<char> compiled;
+    if (!hmi3::compileProject(description, version, compiled, error)) {
+        std::cerr << input << ": " << error << std::endl;
+        return 1;
+    }
+
+    std::ofstream out(output, std::ios::binary | std::ios::trunc);
+    out.write(compiled.data(), static_cast<std::streamsize>(compiled.size()));
+    if (!out) {
+        std::cerr << "Cannot write " << output << std::endl;
+        return 1;
+    }
+
+    // Проверка результата тем же кодом, что и при загрузке
+    hmi3::CompiledProject project;
+    if (!project.openMemory(compiled.data(), compiled.size(), error)) {
+        std::cerr << output << ": " << error << std::endl;
+        return 1;
+    }
+    std::cout << output << ": " << project.getComponentCount() << " components, " << project.getStringCount()
+              << " strings, " << compiled.size() << " bytes (text " << text.size() << " bytes)" << std::endl;
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,145 @@
+// Воспроизведение записанного сеанса как замера: события и dt идут в
+// корневой контейнер без окна, проект - в его дочерний контейнер --target
+// (по умолчанию "project", как у SceneStager и демо). Если в записи есть
+// подмены сцен, команды собираются SceneStager в фоне, как в приложении,
+// а сцена подменяется в записанном кадре; иначе команды применяет
+// ProjectLoader сразу. Компоненты, созданные приложением в коде, а не
+// проектом, не восстанавливаются.
+//
+//   hmi3_replay session.hms [--recorded-pace] [--repeat N] [--draw WxH] [--target ID]
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <SFML/Graphics.hpp>
+#include "hmi3/container.hpp"
+#include "hmi3/project_loader.hpp"
+#include "hmi3/scene_stager.hpp"
+#include "hmi3/session_recorder.hpp"
+#include "hmi3/session_replayer.hpp"
+
+int main(int argc, char* argv[]) {
+    std::string input;
+    auto pace = hmi3::SessionReplayer::Pace::Unthrottled;
+    int repeat = 1;
+    std::optional<sf::Vector2u> drawSize;
+    std::string target = "project";
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--recorded-pace") {
+            pace = hmi3::SessionReplayer::Pace::Recorded;
+        } else if (arg == "--repeat" && i + 1 < argc) {
+            repeat = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--draw" && i + 1 < argc) {
+            std::string size = argv[++i];
+            std::size_t x = size.find('x');
+            if (x == std::string::npos) {
+                input.clear();
+                break;
+            }
+            drawSize = sf::Vector2u(static_cast<unsigned>(std::atoi(size.substr(0, x).c_str())),
+                                    static_cast<unsigned>(std::atoi(size.substr(x + 1).c_str())));
+        } else if (arg == "--target" && i + 1 < argc) {
+            target = argv[++i];
+        } else if (input.empty()) {
+            input = arg;
+        } else {
+            input.clear();
+            break;
+        }
+    }
+    if (input.empty()) {
+        std::cerr << "Usage: hmi3_replay <session.hms> [--recorded-pace] [--repeat N] [--draw WxH] [--target ID]"
+                  << std::endl;
+        return 2;
+    }
+
+    hmi3::SessionRecording recording;
+    std::string error;
+    if (!recording.load(input, error)) {
+        std::cerr << input << ": " << error << std::endl;
+        return 1;
+    }
+    if (recording.getSkippedBytes() > 0) {
+        std::cerr << input << ": ignoring " << recording.getSkippedBytes() << " bytes of truncated tail" << std::endl;
+    }
+
+    const auto& records = recording.getRecords();
+    bool staged = std::any_of(records.begin(), records.end(), [](const hmi3::SessionRecord& record) {
+        return record.type == hmi3::SessionRecord::Type::Scene;
+    });
+
+    // Отрисовка во внеэкранную текстуру входит во время кадра
+    std::optional<sf::RenderTexture> texture;
+    if (drawSize) {
+        texture.emplace();
+        if (!texture->resize(*drawSize)) {
+            std::cerr << "Cannot create " << drawSize->x << "x" << drawSize->y << " render texture" << std::endl;
+            return 1;
+        }
+    }
+
+    hmi3::SessionReplayer replayer(recording);
+    if (texture) {
+        replayer.setFrameCallback([&texture](hmi3::Container& root) {
+            texture->clear();
+            texture->draw(root);
+            texture->display();
+        });
+    }
+
+    // Каждый прогон - с чистого дерева, чтобы прогоны были сравнимы
+    for (int run = 0; run < repeat; ++run) {
+        auto root = std::make_shared<hmi3::Container>("main_container");
+        if (drawSize) {
+            root->setSize(sf::Vector2f(*drawSize));
+        }
+        auto project = std::make_shared<hmi3::Container>(target);
+        project->setSize(root->getSize());
+        hmi3::ComponentHandle projectHandle = root->addComponent(project);
+
+        hmi3::ProjectLoader loader;
+        hmi3::SceneStager stager(hmi3::ComponentFactory::withBuiltins(), target);
+        hmi3::ReplayCommandReceiver receiver;
+        receiver.setDispatchMode(hmi3::DispatchMode::Pump);
+        receiver.setCommandCallback([&](const hmi3::ProjectLoadCommand& command) {
+            if (staged) {
+                stager.submit(command);
+                return;
+            }
+            auto result = loader.apply(*project, command);
+            if (!result.success) {
+                std::cerr << "Project '" << command.projectName << "' rejected: " << result.error << std::endl;
+            }
+        });
+        // Сборка, которую воспроизведение обогнало, дожидается здесь и
+        // попадает во время кадра. Если готова другая сцена (в приложении
+        // она уступила бы записанной), собирается записанная команда
+        replayer.setSceneCallback([&](hmi3::Container& tree, const hmi3::ProjectLoadCommand& command) {
+            stager.waitIdle();
+            auto scene = stager.acquire();
+            if (!scene || scene->command.projectName != command.projectName ||
+                scene->command.version != command.version ||
+                scene->command.projectData.view() != command.projectData.view()) {
+                stager.retire(std::move(scene));
+                stager.submit(command);
+                stager.waitIdle();
+                scene = stager.acquire();
+            }
+            if (!scene || !scene->root) {
+                std::cerr << "Project '" << command.projectName << "' rejected: "
+                          << (scene ? scene->result.error : std::string("no scene")) << std::endl;
+                return;
+            }
+            stager.retire(tree.replaceComponent(projectHandle, scene->root));
+            stager.retire(std::move(scene));
+        });
+
+        auto report = replayer.run(*root, receiver, pace);
+        std::cout << "run " << run + 1 << ": " << hmi3::SessionReplayer::formatReport(report) << std::endl;
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+// Удалённый просмотр панели, опубликованной ViewServer
+//
+//   hmi3_viewer [host] [port]
+
+#include <SFML/Graphics.hpp>
+#include <SFML/Network.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "hmi3/view_protocol.hpp"
+
+int main(int argc, char* argv[]) {
+    std::string host = argc > 1 ? argv[1] : "127.0.0.1";
+    unsigned short port = static_cast<unsigned short>(argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 8081);
+
+    auto address = sf::IpAddress::resolve(host);
+    if (!address) {
+        std::cerr << "Cannot resolve " << host << std::endl;
+        return 1;
+    }
+
+    sf::TcpSocket socket;
+    if (socket.connect(*address, port, sf::seconds(5)) != sf::Socket::Status::Done) {
+        std::cerr << "Cannot connect to " << host << ":" << port << std::endl;
+        return 1;
+    }
+    // Окно продолжает обрабатывать события, пока сеть молчит
+    socket.setBlocking(false);
+
+    sf::RenderWindow window(sf::VideoMode({800, 600}), "HMI3 Viewer - " + host);
+    window.setFramerateLimit(60);
+
+    hmi3::ViewDecoder decoder;
+    sf::Texture texture;
+    std::vector<char> buffer(256 * 1024);
+    std::string pending;
+
+    while (window.isOpen()) {
+        for (auto event = window.pollEvent(); event.has_value(); event = window.pollEvent()) {
+            if (event->is<sf::Event::Closed>()) {
+                window.close();
+                continue;
+            }
+            std::string body = hmi3::encodeInputEvent(*event);
+            if (!body.empty()) {
+                hmi3::appendViewMessage(pending, hmi3::view::Input, body);
+            }
+        }
+
+        while (!pending.empty()) {
+            std::size_t sent = 0;
+            auto status = socket.send(pending.data(), pending.size(), sent);
+            pending.erase(0, sent);
+            if (status != sf::Socket::Status::Partial && status != sf::Socket::Status::Done) break;
+        }
+
+        for (;;) {
+            std::size_t received = 0;
+            auto status = socket.receive(buffer.data(), buffer.size(), received);
+            if (status == sf::Socket::Status::Disconnected || status == sf::Socket::Status::Error) {
+                std::cerr << "Server closed the connection" << std::endl;
+                return 0;
+            }
+            if (status != sf::Socket::Status::Done) break;
+
+            std::size_t offset = 0;
+            while (offset < received) {
+                std::size_t consumed = 0;
+                auto result = decoder.feed(buffer.data() + offset, received - offset, consumed);
+                offset += consumed;
+                if (result == hmi3::ViewDecoder::Result::ProtocolError) {
+                    std::cerr << "Protocol error: " << decoder.getError() << std::endl;
+                    return 1;
+                }
+                if (result == hmi3::ViewDecoder::Result::FrameReady) {
+                    sf::Vector2u size(decoder.getWidth(), decoder.getHeight());
+                    if (texture.getSize() != size) {
+                        if (!texture.resize(size)) return 1;
+                        window.setSize(size);
+                        window.setView(sf::View(sf::FloatRect({0, 0}, sf::Vector2f(size))));
+                    }
+                    texture.update(decoder.getPixels().data());
+                }
+            }
+        }
+
+        window.clear();
+        if (texture.getSize().x > 0) {
+            window.draw(sf::Sprite(texture));
+        }
+        window.display();
+    }
+    return 0;
+}
\ No newline at end of file